@@ -0,0 +1,302 @@
+// Benchmark de la capa de persistencia de Pedidos
+//
+// Genera archivos pedidos.bin sintéticos (10k, 100k y 1M pedidos de 1 a 50
+// líneas) en un directorio temporal y mide:
+//   - cargarDesdeArchivoBin / guardarEnArchivoBin (latencia y MB/s)
+//   - generarIdUnico
+//   - publicación de instantánea y búsquedas por ID
+// El resultado se imprime en stdout como JSON; el progreso va a stderr.
+//
+// Uso: bench_pedidos [--json ruta] [cantidad ...]   (por defecto 10000 100000 1000000)
+// Con --json el resultado también se escribe en 'ruta'. Los IDs sintéticos son
+// consecutivos desde 3400 aunque superen el rango que usa la aplicación.
+// pico_rss_kb es el pico acumulado del proceso al terminar cada tamaño.
+// Compila en Windows y en Linux sin bibliotecas adicionales.
+
+#include "pedidos.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _WIN32
+// Con PSAPI_VERSION 2 la consulta de memoria está en kernel32: no hace falta enlazar psapi
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#include <direct.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using Reloj = chrono::steady_clock;
+
+// Primer ID del rango de pedidos (ver pedidos.cpp)
+static const int ID_BASE = 3400;
+
+// Estadísticas de una serie de mediciones (en milisegundos)
+struct Serie {
+    vector<double> ms;
+
+    double percentil(double p) const {
+        if (ms.empty()) return 0.0;
+        vector<double> orden = ms;
+        sort(orden.begin(), orden.end());
+        size_t pos = static_cast<size_t>(p * (orden.size() - 1) + 0.5);
+        return orden[min(pos, orden.size() - 1)];
+    }
+};
+
+// Milisegundos transcurridos desde 'inicio'
+static double msDesde(Reloj::time_point inicio) {
+    return chrono::duration<double, milli>(Reloj::now() - inicio).count();
+}
+
+// Pico de memoria residente del proceso en KB
+static long picoRssKB() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return static_cast<long>(pmc.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;  // KB en Linux
+#endif
+}
+
+// Crea un directorio temporal de trabajo y se cambia a él
+static string entrarDirectorioTemporal() {
+#ifdef _WIN32
+    char base[MAX_PATH];
+    GetTempPathA(MAX_PATH, base);
+    string ruta = string(base) + "bench_pedidos_" + to_string(GetCurrentProcessId());
+    _mkdir(ruta.c_str());
+    _chdir(ruta.c_str());
+    return ruta;
+#else
+    char plantilla[] = "/tmp/bench_pedidos_XXXXXX";
+    if (mkdtemp(plantilla) == nullptr || chdir(plantilla) != 0) {
+        cerr << "No se pudo crear el directorio temporal\n";
+        exit(1);
+    }
+    return plantilla;
+#endif
+}
+
+// Sale del directorio temporal y lo elimina
+static void salirDirectorioTemporal(const string& ruta) {
+    remove("pedidos.bin");
+#ifdef _WIN32
+    _chdir("..");
+    _rmdir(ruta.c_str());
+#else
+    if (chdir("/") == 0) rmdir(ruta.c_str());
+#endif
+}
+
+// Escribe una cadena con el mismo formato que Pedidos::guardarEnArchivoBin
+static void escribirCadena(ofstream& archivo, const string& texto) {
+    size_t len = texto.size();
+    archivo.write(reinterpret_cast<const char*>(&len), sizeof(len));
+    archivo.write(texto.c_str(), len);
+}
+
+// Genera pedidos.bin con 'cantidad' pedidos de 1 a 50 líneas; devuelve el total de líneas
+static size_t generarArchivo(size_t cantidad, mt19937& rng) {
+    static const char* estados[] = {"pendiente", "procesado", "completado", "enviado", "entregado", "cancelado"};
+    uniform_int_distribution<int> lineas(1, 50);
+    uniform_int_distribution<int> cliente(3100, 3199);
+    uniform_int_distribution<int> almacen(3300, 3309);
+    uniform_int_distribution<int> producto(3200, 3299);
+    uniform_int_distribution<int> unidades(1, 100);
+    uniform_int_distribution<int> estado(0, 5);
+    uniform_real_distribution<double> precio(1.0, 500.0);
+
+    ofstream archivo("pedidos.bin", ios::binary | ios::trunc);
+    archivo.write(reinterpret_cast<const char*>(&cantidad), sizeof(cantidad));
+
+    size_t totalLineas = 0;
+    time_t fecha = time(nullptr);
+    for (size_t i = 0; i < cantidad; ++i) {
+        escribirCadena(archivo, to_string(ID_BASE + i));
+        escribirCadena(archivo, to_string(cliente(rng)));
+        escribirCadena(archivo, to_string(almacen(rng)));
+        archivo.write(reinterpret_cast<const char*>(&fecha), sizeof(fecha));
+        escribirCadena(archivo, estados[estado(rng)]);
+
+        size_t n = static_cast<size_t>(lineas(rng));
+        archivo.write(reinterpret_cast<const char*>(&n), sizeof(n));
+        for (size_t j = 0; j < n; ++j) {
+            escribirCadena(archivo, to_string(producto(rng)));
+            int cant = unidades(rng);
+            double p = precio(rng);
+            archivo.write(reinterpret_cast<const char*>(&cant), sizeof(cant));
+            archivo.write(reinterpret_cast<const char*>(&p), sizeof(p));
+        }
+        totalLineas += n;
+    }
+    return totalLineas;
+}
+
+// Tamaño de pedidos.bin en bytes
+static double tamanoArchivo() {
+    ifstream archivo("pedidos.bin", ios::binary | ios::ate);
+    return archivo ? static_cast<double>(archivo.tellg()) : 0.0;
+}
+
+// Repeticiones según el tamaño, para que 1M no domine el tiempo total
+static int repeticiones(size_t cantidad) {
+    if (cantidad <= 10000) return 15;
+    if (cantidad <= 100000) return 7;
+    return 3;
+}
+
+// Emite una serie como objeto JSON
+static void jsonSerie(ostream& out, const string& nombre, const Serie& s, double bytes) {
+    out << "        \"" << nombre << "\": {\"repeticiones\": " << s.ms.size()
+        << ", \"p50_ms\": " << s.percentil(0.50)
+        << ", \"p99_ms\": " << s.percentil(0.99);
+    if (bytes > 0) {
+        double p50 = s.percentil(0.50);
+        out << ", \"mb_s\": " << (p50 > 0 ? (bytes / (1024.0 * 1024.0)) / (p50 / 1000.0) : 0.0);
+    }
+    out << "}";
+}
+
+int main(int argc, char* argv[]) {
+    vector<size_t> cantidades;
+    string rutaJson;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc) {
+            rutaJson = argv[++i];
+        } else {
+            size_t cantidad = static_cast<size_t>(strtoull(argv[i], nullptr, 10));
+            if (cantidad > 0) cantidades.push_back(cantidad);
+        }
+    }
+    if (cantidades.empty()) cantidades = {10000, 100000, 1000000};
+
+    // Se abre antes de cambiar de directorio para respetar rutas relativas
+    ofstream salida;
+    if (!rutaJson.empty()) {
+        salida.open(rutaJson);
+        if (!salida) {
+            cerr << "No se pudo abrir " << rutaJson << "\n";
+            return 1;
+        }
+    }
+
+    string directorio = entrarDirectorioTemporal();
+    mt19937 rng(20250518);
+
+    ostringstream json;
+    json << fixed << setprecision(3);
+    json << "{\n  \"benchmark\": \"pedidos\",\n  \"resultados\": [\n";
+
+    for (size_t k = 0; k < cantidades.size(); ++k) {
+        size_t cantidad = cantidades[k];
+        int reps = repeticiones(cantidad);
+        cerr << "[bench] " << cantidad << " pedidos..." << endl;
+
+        size_t totalLineas = generarArchivo(cantidad, rng);
+        double bytes = tamanoArchivo();
+
+        // Carga
+        Serie carga;
+        vector<Pedidos> lista;
+        for (int r = 0; r < reps; ++r) {
+            auto inicio = Reloj::now();
+            Pedidos::cargarDesdeArchivoBin(lista);
+            carga.ms.push_back(msDesde(inicio));
+        }
+
+        // Guardado (sobrescribe el mismo archivo con el mismo contenido)
+        Serie guardado;
+        for (int r = 0; r < reps; ++r) {
+            auto inicio = Reloj::now();
+            Pedidos::guardarEnArchivoBin(lista);
+            guardado.ms.push_back(msDesde(inicio));
+        }
+
+        // Generación de ID: el rango fijo queda ocupado, es el peor caso (recorre todo)
+        Serie ids;
+        for (int r = 0; r < reps; ++r) {
+            auto inicio = Reloj::now();
+            string id = Pedidos::generarIdUnico(lista);
+            ids.ms.push_back(msDesde(inicio));
+            if (r == 0 && !id.empty()) cerr << "[bench] ID libre: " << id << endl;
+        }
+
+        // Publicación de instantánea (costo por cada confirmación de cambios)
+        Serie publicacion;
+        for (int r = 0; r < reps; ++r) {
+            auto inicio = Reloj::now();
+            Pedidos::publicarInstantanea(lista);
+            publicacion.ms.push_back(msDesde(inicio));
+        }
+
+        // Búsquedas por ID en la instantánea, en lotes de 1000
+        shared_ptr<const InstantaneaPedidos> vista = Pedidos::obtenerInstantanea();
+        uniform_int_distribution<size_t> elegir(0, cantidad - 1);
+        const int LOTE = 1000;
+        const int LOTES = 200;
+        vector<string> claves(LOTE);
+        Serie busqueda;
+        size_t encontrados = 0;
+        for (int b = 0; b < LOTES; ++b) {
+            for (auto& clave : claves) clave = to_string(ID_BASE + elegir(rng));
+            auto inicio = Reloj::now();
+            for (const auto& clave : claves) {
+                if (vista->buscar(clave) != nullptr) ++encontrados;
+            }
+            busqueda.ms.push_back(msDesde(inicio));
+        }
+        double p50Lote = busqueda.percentil(0.50);
+        double busquedasPorSegundo = p50Lote > 0 ? LOTE / (p50Lote / 1000.0) : 0.0;
+        vista.reset();
+
+        json << "    {\n"
+             << "      \"pedidos\": " << cantidad << ",\n"
+             << "      \"lineas\": " << totalLineas << ",\n"
+             << "      \"bytes_archivo\": " << static_cast<long long>(bytes) << ",\n"
+             << "      \"operaciones\": {\n";
+        jsonSerie(json, "cargarDesdeArchivoBin", carga, bytes);
+        json << ",\n";
+        jsonSerie(json, "guardarEnArchivoBin", guardado, bytes);
+        json << ",\n";
+        jsonSerie(json, "generarIdUnico", ids, 0);
+        json << ",\n";
+        jsonSerie(json, "publicarInstantanea", publicacion, 0);
+        json << ",\n";
+        jsonSerie(json, "buscar_lote_1000", busqueda, 0);
+        json << ",\n        \"busquedas_por_segundo\": " << busquedasPorSegundo
+             << ",\n        \"busquedas_encontradas\": " << encontrados << "\n"
+             << "      },\n"
+             << "      \"pico_rss_kb\": " << picoRssKB() << "\n"
+             << "    }" << (k + 1 < cantidades.size() ? "," : "") << "\n";
+
+        // Liberar antes del siguiente tamaño
+        vector<Pedidos>().swap(lista);
+        Pedidos::publicarInstantanea(lista);
+    }
+
+    json << "  ]\n}\n";
+    salirDirectorioTemporal(directorio);
+
+    cout << json.str();
+    if (salida.is_open()) salida << json.str();
+    return 0;
+}
@@ -64,8 +64,11 @@ public:
     static std::vector<ItemInventario> obtenerProductosPorAlmacen(const std::string& idAlmacen);
     static int obtenerStockTotalProducto(const std::string& idProducto);
 
+    // Existencias por almacen (inventario.bin)
+    static std::vector<ItemInventario> cargarInventarioDesdeArchivo();
+    static void guardarInventarioEnArchivo(const std::vector<ItemInventario>& inventario);
+
 private:
-    std::vector<ItemInventario> cargarInventarioDesdeArchivo();
     static std::string generarIdRegistroUnico(const std::vector<ItemInventario>& inventario);
 };
 
@@ -0,0 +1,114 @@
+#ifndef ABASTECIMIENTO_H
+#define ABASTECIMIENTO_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include "Inventario.h"
+#include "almacen.h"
+
+/**
+ * @class Abastecimiento
+ * @brief Elige el almacen (o los almacenes) que surten cada pedido.
+ *
+ * Mantiene un indice precalculado de existencias por producto y almacen
+ * (solo almacenes en estado "operativo"). Con el indice, decidir el origen
+ * de un pedido cuesta unas pocas operaciones por linea, sin leer archivos.
+ */
+class Abastecimiento {
+public:
+    /// Linea solicitada en un pedido
+    struct LineaSolicitada {
+        std::string codigoProducto;
+        int cantidad;
+    };
+
+    /// Cantidad de un producto que sale de un almacen
+    struct Asignacion {
+        std::string idAlmacen;
+        std::string codigoProducto;
+        int cantidad;
+    };
+
+    /// Resultado de la planificacion de un pedido
+    struct Plan {
+        bool completo = false;                    ///< true si todas las lineas quedaron cubiertas
+        std::vector<std::string> almacenes;       ///< Almacenes usados, en orden de eleccion
+        std::vector<Asignacion> asignaciones;     ///< Detalle de lo que sale de cada almacen
+        std::vector<LineaSolicitada> faltantes;   ///< Cantidades que ningun almacen puede cubrir
+    };
+
+    /// Distancia entre un almacen y un cliente (menor es mejor)
+    using FuncionDistancia = std::function<double(const std::string& idAlmacen, const std::string& idCliente)>;
+
+    /**
+     * @brief Construye el indice de existencias por almacen.
+     * @param inventario Registros de inventario (producto, almacen, cantidad).
+     * @param almacenes Lista de almacenes; solo se indexan los "operativo".
+     */
+    static void construirIndice(const std::vector<Inventario::ItemInventario>& inventario,
+                                const std::vector<Almacen>& almacenes);
+
+    /**
+     * @brief Indica si el indice tiene existencias por almacen registradas.
+     */
+    static bool indiceDisponible();
+
+    /**
+     * @brief Unidades disponibles de un producto sumando todos los almacenes operativos.
+     */
+    static int disponibleTotal(const std::string& codigoProducto);
+
+    /**
+     * @brief Unidades disponibles de un producto en un almacen operativo.
+     */
+    static int disponibleEnAlmacen(const std::string& idAlmacen, const std::string& codigoProducto);
+
+    /**
+     * @brief Decide de que almacenes sale cada linea.
+     *
+     * Prefiere un solo almacen que cubra todo el pedido (el mas cercano);
+     * si no existe, divide el pedido eligiendo cada vez el almacen que cubre
+     * mas unidades pendientes, con la distancia como desempate.
+     *
+     * @param lineas Lineas del pedido.
+     * @param idCliente Cliente destino (para la distancia).
+     * @return Plan con las asignaciones por almacen.
+     */
+    static Plan planificar(const std::vector<LineaSolicitada>& lineas, const std::string& idCliente);
+
+    /**
+     * @brief Descuenta del indice las cantidades del plan y guarda inventario.bin.
+     */
+    static void confirmar(const Plan& plan);
+
+    /**
+     * @brief Registra una entrada de mercancia en un almacen y guarda inventario.bin.
+     */
+    static void registrarEntrada(const std::string& idAlmacen, const std::string& codigoProducto, int cantidad);
+
+    /**
+     * @brief Cambia el criterio de distancia usado como desempate.
+     */
+    static void setFuncionDistancia(FuncionDistancia funcion);
+
+private:
+    static const size_t MAX_ALMACENES = 64;  ///< Un bit por almacen en las mascaras de cobertura
+
+    static std::vector<std::string> idsAlmacen;                      ///< Columna -> ID de almacen operativo
+    static std::unordered_map<std::string, size_t> columnaAlmacen;   ///< ID de almacen -> columna
+    static std::unordered_map<std::string, size_t> filaProducto;     ///< Codigo de producto -> fila
+    static std::vector<int> existencias;                             ///< Matriz fila * columnas
+    static std::vector<int> totalProducto;                           ///< Suma por fila
+
+    static std::vector<Inventario::ItemInventario> inventario;           ///< Inventario consolidado
+    static std::unordered_map<std::string, size_t> posicionInventario;   ///< "producto|almacen" -> posicion
+    static FuncionDistancia distancia;
+
+    static void ajustar(const std::string& idAlmacen, const std::string& codigoProducto, int delta);
+    static double distanciaA(size_t columna, const std::string& idCliente);
+};
+
+#endif // ABASTECIMIENTO_H
@@ -0,0 +1,99 @@
+#ifndef ANTIGUEDAD_H
+#define ANTIGUEDAD_H
+
+#include <array>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <ctime>
+#include "dinero.h"
+#include "facturacion.h"
+
+/**
+ * @class Antiguedad
+ * @brief Antigüedad de saldos: importes sin pagar por tramo de días vencidos.
+ *
+ * Tramos según los días transcurridos desde el vencimiento: 0-30 (incluye
+ * las que aún no vencen), 31-60, 61-90 y más de 90. Los totales por cliente
+ * y generales se actualizan al crear, pagar o eliminar una factura; con
+ * pagos parciales cuenta solo el saldo pendiente.
+ *
+ * El paso de los días usa una rueda de temporizadores por día: cada factura
+ * queda agendada en el día en que cruza al tramo siguiente, así avanzar un
+ * día solo toca las facturas que cambian de tramo. La rueda cubre 128 días;
+ * los cruces más lejanos esperan en un mapa ordenado hasta entrar en ella.
+ */
+class Antiguedad {
+public:
+    static const int TRAMOS = 4;
+
+    /// Importe y cantidad de facturas por tramo
+    struct Tramos {
+        std::array<Dinero, TRAMOS> importe{};
+        std::array<size_t, TRAMOS> facturas{};
+        Dinero total() const;
+    };
+
+    /// Nombre del tramo ("0-30", "31-60", "61-90", "90+")
+    static const char* nombreTramo(int tramo);
+
+    /// Descarta todo y carga las facturas sin pagar de 'facturas' a la fecha 'hoy'
+    static void reiniciar(const std::vector<Factura>& facturas, std::time_t hoy);
+
+    /// true después de reiniciar(); antes de eso agregar()/quitar() no hacen nada
+    static bool iniciada();
+
+    /// Suma una factura (si no está pagada ni eliminada)
+    static void agregar(const Factura& factura);
+
+    /// Quita una factura (pagada o eliminada); no hace nada si no estaba
+    static void quitar(int idFactura);
+
+    /// Cambia el importe pendiente de una factura (pago parcial); en cero la quita
+    static void ajustar(int idFactura, Dinero saldo);
+
+    /// Avanza día por día hasta 'hoy' moviendo solo las facturas que cruzan de tramo
+    static void avanzarHasta(std::time_t hoy);
+
+    static Tramos totales();
+    static Tramos deCliente(int idCliente);
+
+    /// Tramos de todos los clientes con saldo
+    static std::vector<std::pair<int, Tramos>> porCliente();
+
+private:
+    static const int RANURAS = 128;   ///< Días que cubre la rueda
+
+    struct Item {
+        int idCliente = 0;
+        Dinero importe;
+        int64_t diaVencimiento = 0;
+        int tramo = 0;
+    };
+
+    struct Evento {
+        int idFactura;
+        int64_t dia;
+    };
+
+    static std::mutex mutexTramos;
+    static bool cargada;
+    static int64_t diaActual;
+    static std::unordered_map<int, Item> items;                 ///< ID de factura -> estado
+    static std::unordered_map<int, Tramos> tramosPorCliente;
+    static Tramos tramosTotales;
+    static std::vector<std::vector<Evento>> rueda;              ///< Ranura = día % RANURAS
+    static std::multimap<int64_t, int> lejanos;                 ///< Cruces fuera de la rueda
+
+    static int64_t diaDe(std::time_t fecha);
+    static int tramoDe(int64_t diasVencida);
+    static int64_t proximoCruce(const Item& item);
+    static void programar(int idFactura, int64_t dia);
+    static void sumar(const Item& item, int signo);
+    static void agregarSinBloqueo(const Factura& factura);
+    static void avanzarSinBloqueo(int64_t dia);
+};
+
+#endif // ANTIGUEDAD_H
@@ -0,0 +1,123 @@
+#ifndef ARCHIVADOR_H
+#define ARCHIVADOR_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include <ctime>
+#include "pedidos.h"
+#include "envios.h"
+
+/**
+ * @class Archivador
+ * @brief Archivo histórico de pedidos y envíos cerrados (carpeta "historico").
+ *
+ * archivar() saca de pedidos.bin y envios.bin los registros en estado final
+ * (entregado, cancelado o completado) con más de N días y los agrega a
+ * archivos por mes: historico/pedidos_AAAA-MM.lz y historico/envios_AAAA-MM.lz.
+ * Cada corrida agrega a cada archivo un segmento comprimido (comprimirLZ)
+ * con su cabecera y CRC-32; lo ya archivado no se reescribe.
+ *
+ * historico/indice.bin relaciona cada ID (pedido, envío y envíos por pedido)
+ * con su segmento. Se reescribe ordenado al final de cada corrida y fuera de
+ * eso es de solo lectura: una búsqueda es una búsqueda binaria en memoria
+ * más la lectura de un segmento (los últimos leídos quedan en caché).
+ *
+ * historico/clientes.bin guarda los acumulados por cliente de los pedidos
+ * archivados para que Pedidos los siga contando en el valor histórico.
+ */
+class Archivador {
+public:
+    /// Antigüedad mínima por defecto para archivar
+    static const int DIAS_POR_DEFECTO = 180;
+
+    /// Resumen de una corrida de archivar()
+    struct Resultado {
+        size_t pedidos = 0;
+        size_t envios = 0;
+        size_t sinFactura = 0;  ///< Pedidos entregados o completados que no se archivan por no tener factura
+        size_t segmentos = 0;
+        uint64_t bytesOriginales = 0;
+        uint64_t bytesComprimidos = 0;
+        bool correcto = true;   ///< false si no se pudo archivar (no se tocó nada)
+    };
+
+    /**
+     * @brief Mueve al histórico los pedidos y envíos cerrados con más de 'dias' días.
+     *
+     * La fecha de un envío es la de su último evento (EventosEnvios) o, si no
+     * tiene, la de su pedido. Un pedido al que le queda algún envío en
+     * envios.bin (abierto o cerrado hace menos de 'dias') no se archiva: el
+     * archivo activo nunca apunta a un pedido que ya está en el histórico.
+     * Tampoco un pedido entregado o completado que todavía no tiene factura
+     * (índice de Facturacion por pedido): el histórico no se factura.
+     * Primero se escriben los segmentos, el índice y los acumulados; solo
+     * entonces se reescriben pedidos.bin y envios.bin sin esos registros.
+     */
+    static Resultado archivar(int dias, std::time_t ahora = 0);
+
+    /// Pedido archivado por ID
+    static bool buscarPedido(const std::string& idPedido, Pedidos& pedido);
+
+    /// Envío archivado por ID
+    static bool buscarEnvio(const std::string& idEnvio, Envio& envio);
+
+    /// Envíos archivados de un pedido
+    static std::vector<Envio> enviosDePedido(const std::string& idPedido);
+
+    /// true si el ID ya se usó en un pedido o envío archivado (no se debe reutilizar)
+    static bool contienePedido(const std::string& idPedido);
+    static bool contieneEnvio(const std::string& idEnvio);
+
+    /// Acumulados por cliente de los pedidos archivados
+    static const std::unordered_map<std::string, Pedidos::AgregadosCliente>& agregadosArchivados();
+
+    /**
+     * @brief Descarta el índice, los acumulados y los segmentos en caché
+     *        (otro proceso archivó; se vuelven a leer en la próxima consulta).
+     */
+    static void recargar();
+
+    /// Opción de menú: archivar con la antigüedad que indique el usuario
+    static void archivarInteractivo();
+
+    /// Opción de menú: buscar un pedido o envío (activo o archivado)
+    static void consultarInteractivo();
+
+private:
+    enum Tipo : uint8_t { PEDIDO = 1, ENVIO = 2, ENVIO_DE_PEDIDO = 3 };
+
+    /// Entrada del índice: clave -> segmento de un archivo mensual
+    struct Entrada {
+        std::string clave;
+        uint8_t tipo = 0;
+        int32_t particion = 0;        ///< AAAAMM
+        uint64_t desplazamiento = 0;  ///< Inicio del segmento en su archivo
+
+        bool operator<(const Entrada& otra) const;
+        bool operator==(const Entrada& otra) const;
+    };
+
+    /// Registros de un segmento ya descomprimido
+    struct Segmento {
+        std::vector<Pedidos> pedidos;
+        std::vector<Envio> envios;
+    };
+
+    static std::vector<Entrada> indice;   ///< Ordenado por (tipo, clave)
+    static bool indiceCargado;
+    static std::unordered_map<std::string, Pedidos::AgregadosCliente> agregados;
+    static bool agregadosCargados;
+    static std::vector<std::pair<std::string, std::shared_ptr<const Segmento>>> segmentosRecientes;
+
+    static void asegurarIndice();
+    static std::vector<Entrada> buscarEntradas(uint8_t tipo, const std::string& clave);
+    static std::shared_ptr<const Segmento> leerSegmento(uint8_t tipo, int32_t particion, uint64_t desplazamiento);
+    static std::string rutaParticion(uint8_t tipo, int32_t particion);
+    static bool escribirIndice(const std::vector<Entrada>& entradas);
+    static bool escribirAgregados(const std::unordered_map<std::string, Pedidos::AgregadosCliente>& datos);
+};
+
+#endif // ARCHIVADOR_H
@@ -0,0 +1,80 @@
+#ifndef CARTERA_H
+#define CARTERA_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include "dinero.h"
+#include "facturacion.h"
+#include "pagos.h"
+
+/**
+ * @class Cartera
+ * @brief Cuentas por cobrar: saldo abierto, lo aplicado por tipo y saldo por cliente.
+ *
+ * Trabaja sobre una copia columnar de las facturas vigentes tomada del libro
+ * de pagos (saldo abierto y lo cobrado, acreditado y castigado, en centavos,
+ * más el cliente como índice denso), así las sumas son enteras y exactas y
+ * un pago parcial reduce el saldo. Las sumas usan AVX2 cuando el procesador
+ * lo tiene (4 importes por instrucción) y un recorrido escalar si no; los
+ * bloques se reparten entre los hilos de GrupoHilos.
+ */
+class Cartera {
+public:
+    /// Copia columnar de las facturas (todos los importes en centavos)
+    struct Columnas {
+        std::vector<int64_t> saldo;            ///< Pendiente de cobro según el libro
+        std::vector<int64_t> cobrado;          ///< Movimientos de pago
+        std::vector<int64_t> notasCredito;
+        std::vector<int64_t> castigos;
+        std::vector<uint32_t> cliente;         ///< Posición del cliente en 'idsCliente'
+        std::vector<int> idsCliente;           ///< ID de cliente por índice denso
+
+        void agregar(const Factura& factura, const Pagos::ResumenFactura& resumen);
+        size_t size() const { return saldo.size(); }
+
+    private:
+        std::vector<uint32_t> densos;                 ///< ID de cliente -> índice + 1 (IDs hasta 2^20)
+        std::unordered_map<int, uint32_t> dispersos;  ///< Resto de los IDs
+        uint32_t indiceDe(int idCliente);
+    };
+
+    /// Saldo de un cliente
+    struct SaldoCliente {
+        int idCliente = 0;
+        Dinero abierto;
+        Dinero cobrado;
+        size_t facturasAbiertas = 0;
+    };
+
+    /// Resultado de resumir()
+    struct Resumen {
+        Dinero totalAbierto;
+        Dinero totalCobrado;          ///< Solo pagos; las notas de crédito y castigos van aparte
+        Dinero totalNotasCredito;
+        Dinero totalCastigos;
+        size_t facturas = 0;
+        size_t abiertas = 0;          ///< Con saldo mayor que cero
+        std::vector<SaldoCliente> porCliente;  ///< Ordenado por saldo abierto (mayor primero)
+    };
+
+    /// Totales y saldos por cliente de las facturas de 'columnas'
+    static Resumen resumir(const Columnas& columnas);
+
+    /**
+     * @brief Núcleo de totales: suma una columna de importes de un bloque.
+     *
+     * Elige la versión AVX2 o la escalar según el procesador; ambas dan el
+     * mismo resultado exacto.
+     */
+    static int64_t sumar(const int64_t* importes, size_t cantidad);
+
+    /// true si sumar() usa instrucciones AVX2 en este equipo
+    static bool usaAvx2();
+
+private:
+    static int64_t sumarEscalar(const int64_t* importes, size_t cantidad);
+};
+
+#endif // CARTERA_H
@@ -5,6 +5,7 @@
 
 #include <vector>
 #include <string>
+#include "dinero.h"
 
 /**
  * @class Clientes
@@ -27,6 +28,9 @@ private:
     /// Nmero de Identificacin Tributaria (NIT) del cliente
     std::string nit;
 
+    /// Lmite de crdito (cero = sin lmite); se guarda aparte, en creditos.bin
+    Dinero limiteCredito;
+
 public:
     // ===================== MTODOS CRUD =====================
 
@@ -104,6 +108,9 @@ public:
     std::string getDireccion() const { return direccion; }
     std::string getTelefono() const { return telefono; }
     std::string getNit() const { return nit; }
+    Dinero getLimiteCredito() const { return limiteCredito; }
+
+    void setLimiteCredito(Dinero limite) { limiteCredito = limite; }
 };
 
 #endif // CLIENTES_H
@@ -0,0 +1,137 @@
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "facturacion.h"
+
+/**
+ * @class ArchivoColumnar
+ * @brief Archivo columnar autodescriptivo para exportar facturas a análisis.
+ *
+ * Formato (".col"): cabecera, descriptores de columna (nombre y tipo),
+ * bloques de datos y al final un directorio con una entrada por bloque y
+ * columna: posición, bytes, codificación, CRC-32 y mínimo/máximo del bloque.
+ * Cada bloque de una columna se guarda con la codificación que ocupa menos:
+ * plana (ancho del tipo), diccionario (valores distintos + índice de 1 o 2
+ * bytes por fila) o RLE (valor + repeticiones).
+ *
+ * El lector solo lee de disco las columnas que pide la proyección o los
+ * filtros, y salta los bloques cuyo mínimo/máximo no cruza el rango de
+ * algún filtro. Todos los valores se manejan como enteros de 64 bits
+ * (los importes en centavos, las fechas en segundos desde 1970).
+ */
+class ArchivoColumnar {
+public:
+    /// Tipo lógico de una columna; define el ancho en la codificación plana
+    enum Tipo : uint8_t {
+        TIPO_ENTERO32 = 1,
+        TIPO_ENTERO64 = 2,
+        TIPO_LOGICO = 3,
+        TIPO_DINERO = 4,     ///< Centavos
+        TIPO_FECHA = 5       ///< Segundos desde 1970
+    };
+
+    enum Codificacion : uint8_t {
+        CODIFICACION_PLANA = 1,
+        CODIFICACION_DICCIONARIO = 2,
+        CODIFICACION_RLE = 3
+    };
+
+    static const uint32_t FILAS_POR_BLOQUE = 8192;
+
+    struct Columna {
+        std::string nombre;
+        uint8_t tipo = TIPO_ENTERO64;
+    };
+
+    /// Entrada del directorio: un bloque de una columna
+    struct Bloque {
+        uint64_t desplazamiento = 0;
+        uint32_t bytes = 0;
+        uint32_t filas = 0;
+        uint8_t codificacion = CODIFICACION_PLANA;
+        uint32_t crc = 0;
+        int64_t minimo = 0;
+        int64_t maximo = 0;
+    };
+
+    /// Filtro por rango cerrado [minimo, maximo] sobre una columna
+    struct Rango {
+        std::string columna;
+        int64_t minimo;
+        int64_t maximo;
+    };
+
+    /// Resultado de leer(): una fila por cada índice de las columnas proyectadas
+    struct Resultado {
+        std::vector<std::string> columnas;
+        std::vector<std::vector<int64_t>> valores;   ///< valores[c][fila]
+        size_t bloquesLeidos = 0;
+        size_t bloquesOmitidos = 0;                  ///< Descartados por mínimo/máximo
+        uint64_t bytesLeidos = 0;                    ///< Solo datos de columnas, sin directorio
+        size_t filas() const { return valores.empty() ? 0 : valores[0].size(); }
+    };
+
+    // --- Escritura ---
+
+    /// Columnas con que se exportan las facturas
+    static std::vector<Columna> columnasFactura();
+
+    /**
+     * @brief Exporta las facturas (sin el nombre de cliente ni el monto en float del formato anterior).
+     * @param saldos Saldo pendiente de cada factura (libro de pagos), en el mismo orden que 'facturas'.
+     */
+    static bool exportarFacturas(const std::vector<Factura>& facturas, const std::vector<Dinero>& saldos,
+                                 const std::string& ruta, uint32_t filasPorBloque = FILAS_POR_BLOQUE);
+
+    /**
+     * @brief Escribe un archivo columnar; valores[c] tiene las filas de la columna c.
+     *
+     * Se escribe en un temporal y se reemplaza el archivo al terminar.
+     * @return false si las columnas no tienen la misma cantidad de filas o falla la escritura.
+     */
+    static bool escribir(const std::string& ruta, const std::vector<Columna>& columnas,
+                         const std::vector<std::vector<int64_t>>& valores,
+                         uint32_t filasPorBloque = FILAS_POR_BLOQUE);
+
+    // --- Lectura ---
+
+    /// Lee la cabecera, los descriptores y el directorio (no los datos)
+    bool abrir(const std::string& ruta);
+
+    const std::vector<Columna>& getColumnas() const { return columnas; }
+    uint64_t getFilas() const { return filas; }
+    size_t getBloques() const { return cantidadBloques; }
+    const Bloque& getBloque(size_t bloque, size_t columna) const { return directorio[bloque * columnas.size() + columna]; }
+
+    /// Posición de la columna o -1 si no existe
+    int indiceColumna(const std::string& nombre) const;
+
+    /**
+     * @brief Lee las columnas de 'proyeccion' de las filas que cumplen todos los filtros.
+     * @return false si una columna no existe o algún bloque está dañado.
+     */
+    bool leer(const std::vector<std::string>& proyeccion, const std::vector<Rango>& filtros,
+              Resultado& resultado);
+
+    static const char* nombreTipo(uint8_t tipo);
+    static const char* nombreCodificacion(uint8_t codificacion);
+
+private:
+    std::ifstream archivo;
+    std::vector<Columna> columnas;
+    std::vector<Bloque> directorio;      ///< Por bloque y dentro de cada bloque por columna
+    uint64_t filas = 0;
+    size_t cantidadBloques = 0;
+
+    static std::string codificar(const int64_t* valores, size_t cantidad, uint8_t tipo, uint8_t& codificacion);
+    static bool decodificar(const std::string& datos, uint8_t codificacion, uint8_t tipo, size_t cantidad,
+                            std::vector<int64_t>& valores);
+    bool leerBloque(const Bloque& bloque, uint8_t tipo, std::vector<int64_t>& valores, uint64_t& bytesLeidos);
+};
+
+#endif // COLUMNAR_H
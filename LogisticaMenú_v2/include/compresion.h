@@ -0,0 +1,30 @@
+#ifndef COMPRESION_H
+#define COMPRESION_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Comprime un bloque con LZ77 (variante LZSS, ventana de 64 KB).
+ *
+ * Formato: grupos de un byte de banderas seguido de hasta 8 elementos; con
+ * la bandera en 1 el elemento es una coincidencia de 3 bytes (distancia de
+ * 16 bits y longitud - 4), con la bandera en 0 es un byte literal.
+ * No guarda el tamaño original: quien comprime lo debe registrar aparte.
+ *
+ * @param datos Bytes a comprimir.
+ * @return Datos comprimidos.
+ */
+std::string comprimirLZ(const std::string& datos);
+
+/**
+ * @brief Descomprime un bloque de comprimirLZ().
+ *
+ * @param comprimido Datos comprimidos.
+ * @param tamOriginal Tamaño esperado del resultado.
+ * @param datos Resultado.
+ * @return false si los datos están dañados o no dan el tamaño esperado.
+ */
+bool descomprimirLZ(const std::string& comprimido, std::size_t tamOriginal, std::string& datos);
+
+#endif // COMPRESION_H
@@ -0,0 +1,78 @@
+#ifndef CONSOLIDACION_H
+#define CONSOLIDACION_H
+
+#include <vector>
+#include <string>
+
+/**
+ * @class Consolidacion
+ * @brief Agrupa pedidos listos para envío en cargas por zona y vehículo.
+ *
+ * Los pedidos se agrupan por zona (tomada de la dirección del cliente, p. ej.
+ * "Zona 17") y por cliente; luego se empacan en los vehículos disponibles con
+ * primer ajuste decreciente, seguido de una búsqueda local que intenta vaciar
+ * las cargas menos llenas. Cada carga resultante es un manifiesto de varias
+ * paradas asignado a un transportista; al mostrarlo, las paradas se ordenan
+ * por recorrido con Rutas cuando hay coordenadas.
+ */
+class Consolidacion {
+public:
+    /// Pedido listo para enviar
+    struct EnvioPendiente {
+        std::string idPedido;
+        std::string idCliente;
+        std::string direccion;
+        int unidades = 0;
+    };
+
+    /// Vehículo disponible para la planificación
+    struct Vehiculo {
+        std::string idTransportista;
+        std::string tipo;
+        int capacidad = 0;  ///< Unidades que puede llevar
+    };
+
+    /// Entrega a un cliente dentro de un manifiesto
+    struct Parada {
+        std::string idCliente;
+        std::string direccion;
+        std::vector<std::string> pedidos;
+        int unidades = 0;
+    };
+
+    /// Carga de un vehículo
+    struct Manifiesto {
+        Vehiculo vehiculo;
+        std::string zona;
+        std::vector<Parada> paradas;
+        int unidades = 0;
+        double distanciaKm = 0.0;  ///< Recorrido ida y vuelta (0 si no hay coordenadas)
+    };
+
+    /// Resultado de una planificación
+    struct Resultado {
+        std::vector<Manifiesto> manifiestos;
+        std::vector<EnvioPendiente> sinAsignar;  ///< Sin vehículo o mayores que cualquier capacidad
+    };
+
+    /**
+     * @brief Obtiene la zona de una dirección ("Zona N"); si no la tiene, la dirección normalizada.
+     */
+    static std::string zonaDe(const std::string& direccion);
+
+    /**
+     * @brief Arma los manifiestos; no lee ni escribe archivos.
+     * @param pendientes Pedidos a enviar.
+     * @param vehiculos Vehículos disponibles (cada uno se usa a lo sumo una vez).
+     */
+    static Resultado planificar(const std::vector<EnvioPendiente>& pendientes,
+                                const std::vector<Vehiculo>& vehiculos);
+
+    /**
+     * @brief Opción de menú: planifica los pedidos "procesado", muestra los
+     * manifiestos y, si se confirma, crea los envíos y guarda manifiestos.txt.
+     */
+    static void consolidarEnvios();
+};
+
+#endif // CONSOLIDACION_H
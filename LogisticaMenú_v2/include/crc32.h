@@ -0,0 +1,20 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Calcula el CRC-32 (polinomio IEEE 802.3) de un bloque de datos.
+ *
+ * Se puede encadenar pasando el resultado anterior en 'crc' para cubrir
+ * varios bloques como si fueran uno solo.
+ *
+ * @param datos Puntero a los datos.
+ * @param tam Cantidad de bytes.
+ * @param crc CRC acumulado de bloques previos (0 para empezar).
+ * @return CRC-32 de los datos.
+ */
+uint32_t calcularCrc32(const void* datos, std::size_t tam, uint32_t crc = 0);
+
+#endif // CRC32_H
@@ -0,0 +1,56 @@
+#ifndef CREDITO_H
+#define CREDITO_H
+
+#include <string>
+#include "dinero.h"
+
+class Clientes;
+
+/**
+ * @class Credito
+ * @brief Control de crédito al registrar pedidos.
+ *
+ * La exposición de un cliente es todo lo que debe o va a deber:
+ *
+ *  - Saldo de sus facturas sin pagar (Pagos, O(1)).
+ *  - Pedidos pendientes o procesados (acumulados de Pedidos, O(1)).
+ *  - Pedidos retenidos por crédito, líneas que esperan mercancía
+ *    (ListaEspera) y pedidos completados o entregados que todavía no tienen
+ *    factura. Estos se suman en una pasada por los pedidos activos de la
+ *    instantánea vigente; los archivados ya están facturados (Archivador).
+ *
+ * Ninguna parte lee facturas.bin ni pedidos.bin. Pagos se inicia una vez
+ * al arrancar el programa (main).
+ */
+class Credito {
+public:
+    struct Exposicion {
+        Dinero facturasPendientes;   ///< Saldo de facturas sin pagar (con IVA)
+        Dinero pedidosAbiertos;      ///< Pedidos pendientes o procesados
+        Dinero pedidosRetenidos;     ///< Pedidos retenidos por crédito
+        Dinero lineasEnEspera;       ///< Líneas de sus pedidos que esperan mercancía
+        Dinero sinFacturar;          ///< Pedidos completados o entregados sin factura
+        Dinero total() const {
+            return facturasPendientes + pedidosAbiertos + pedidosRetenidos + lineasEnEspera + sinFacturar;
+        }
+    };
+
+    struct Evaluacion {
+        Dinero limite;               ///< Cero = sin límite
+        Exposicion exposicion;
+        Dinero monto;                ///< Pedido que se quiere registrar
+        bool aprobado = true;
+        Dinero disponible() const { return limite - exposicion.total(); }
+    };
+
+    /// Exposición actual de un cliente, sin contar el pedido 'idPedidoExcluido'
+    static Exposicion exposicion(const std::string& idCliente, const std::string& idPedidoExcluido = "");
+
+    /// ¿Cabe un pedido de 'monto' dentro del límite del cliente? (un pedido ya registrado se excluye por ID)
+    static Evaluacion evaluar(const Clientes& cliente, Dinero monto, const std::string& idPedidoExcluido = "");
+
+    /// Detalle de una evaluación para mostrar en pantalla
+    static void mostrar(const Evaluacion& evaluacion);
+};
+
+#endif // CREDITO_H
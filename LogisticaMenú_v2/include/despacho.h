@@ -0,0 +1,113 @@
+#ifndef DESPACHO_H
+#define DESPACHO_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include "reservas.h"
+
+/**
+ * @class Despacho
+ * @brief Reparte los envíos nuevos entre los transportistas disponibles.
+ *
+ * Lleva la cuenta de envíos "en camino" de cada transportista y los ordena
+ * en montículos de mínimos (uno general y uno por tipo de vehículo). Elegir
+ * un transportista, registrar una asignación o liberarla cuesta O(log n).
+ *
+ * Modos:
+ *  - MenosCargado: el de menor carga relativa (envíos en curso / peso).
+ *  - RoundRobinPonderado: turnos proporcionales al peso del vehículo.
+ *
+ * asignarConReserva() además reserva capacidad en una franja del transportista
+ * (ver Reservas); los que no tienen lugar se saltan en orden de prioridad.
+ *
+ * El estado se arma la primera vez que se usa (registro de transportistas y
+ * envíos en curso) y se descarta con invalidar() cuando cambian los datos o
+ * cuando el registro se recarga porque transportistas.bin cambió.
+ */
+class Despacho {
+public:
+    enum class Modo { MenosCargado, RoundRobinPonderado };
+
+    /**
+     * @brief Elige un transportista y le suma un envío en curso.
+     * @param tipoVehiculo Tipo requerido ("moto", "pickup", "panel", "camion", "otro") o "" para cualquiera.
+     * @return ID del transportista o "" si no hay ninguno disponible del tipo pedido.
+     */
+    static std::string asignar(const std::string& tipoVehiculo = "");
+
+    /**
+     * @brief Como asignar(), pero solo elige a un transportista con lugar para la carga y se la reserva.
+     * @param idEnvio Envío al que queda asociada la reserva.
+     * @param reserva Franja reservada (si se pudo asignar).
+     * @return ID del transportista o "" si ninguno del tipo pedido tiene lugar.
+     */
+    static std::string asignarConReserva(const std::string& idEnvio, const Reservas::Carga& carga,
+                                         Reservas::Reserva& reserva, const std::string& tipoVehiculo = "");
+
+    /**
+     * @brief Registra un envío en curso asignado manualmente.
+     */
+    static void registrar(const std::string& idTransportista);
+
+    /**
+     * @brief Resta un envío en curso (entregado, cancelado o eliminado).
+     */
+    static void liberar(const std::string& idTransportista);
+
+    /**
+     * @brief Descarta el estado; se vuelve a armar en el próximo uso.
+     */
+    static void invalidar();
+
+    static void setModo(Modo nuevoModo);
+    static Modo getModo();
+
+    /**
+     * @brief Envíos en curso de un transportista.
+     */
+    static int enviosEnCurso(const std::string& idTransportista);
+
+private:
+    struct EstadoTransportista {
+        std::string id;
+        std::string tipo;
+        int peso = 1;      ///< Capacidad relativa del vehículo
+        int enCurso = 0;   ///< Envíos "en camino"
+        double turno = 0;  ///< Próximo turno virtual (round-robin ponderado)
+    };
+
+    /// Montículo de mínimos sobre posiciones de 'transportistas' con actualización de clave
+    class MonticuloMin {
+    public:
+        void insertar(size_t t);
+        size_t extraerMinimo();
+        void actualizar(size_t t);
+        bool vacio() const { return datos.empty(); }
+        size_t minimo() const { return datos.front(); }
+
+    private:
+        std::vector<size_t> datos;
+        std::unordered_map<size_t, size_t> posicion;  ///< transportista -> índice en 'datos'
+
+        bool menor(size_t a, size_t b) const;
+        void intercambiar(size_t i, size_t j);
+        void subir(size_t i);
+        void bajar(size_t i);
+    };
+
+    static std::vector<EstadoTransportista> transportistas;
+    static std::unordered_map<std::string, size_t> indicePorId;
+    static MonticuloMin general;
+    static std::unordered_map<std::string, MonticuloMin> porTipo;
+    static Modo modo;
+    static bool listo;
+    static unsigned long versionTransportistas;  ///< Versión del registro usada al armar el estado
+
+    static double clave(size_t t);
+    static void asegurarListo();
+    static void reordenar(size_t t);
+    static void sumarEnvio(size_t t);
+};
+
+#endif // DESPACHO_H
@@ -0,0 +1,102 @@
+#ifndef DINERO_H
+#define DINERO_H
+
+#include <cstdint>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <ostream>
+
+/**
+ * @class Dinero
+ * @brief Importe en centavos sobre un entero de 64 bits (punto fijo, 2 decimales).
+ *
+ * Las sumas y comparaciones son exactas. Los archivos que ya guardaban
+ * importes como double (pedidos.bin, productos.bin, lista de espera) se
+ * siguen leyendo y escribiendo igual: deDecimal() redondea al centavo y,
+ * para importes de menos de 2^53 centavos, aDecimal() vuelve al mismo valor.
+ */
+class Dinero {
+public:
+    constexpr Dinero() : valor(0) {}
+
+    static constexpr Dinero deCentavos(int64_t centavos) { return Dinero(centavos); }
+
+    /// Redondea al centavo más cercano
+    static Dinero deDecimal(double importe) { return Dinero(std::llround(importe * 100.0)); }
+
+    /**
+     * @brief Convierte un texto como "1234.5", "-3" o "0.07" sin pasar por double.
+     * @return false si el texto no es un importe válido o tiene más de 2 decimales.
+     */
+    static bool deTexto(const std::string& texto, Dinero& importe) {
+        size_t i = 0;
+        bool negativo = false;
+        if (i < texto.size() && (texto[i] == '-' || texto[i] == '+')) negativo = texto[i++] == '-';
+
+        int64_t entero = 0, decimales = 0;
+        int digitos = 0, digitosDecimales = -1;
+        for (; i < texto.size(); ++i) {
+            char c = texto[i];
+            if (c == '.' && digitosDecimales < 0) {
+                digitosDecimales = 0;
+            } else if (c >= '0' && c <= '9') {
+                if (digitosDecimales < 0) {
+                    if (entero > (INT64_MAX / 100 - 9) / 10) return false;
+                    entero = entero * 10 + (c - '0');
+                } else {
+                    if (++digitosDecimales > 2) return false;
+                    decimales = decimales * 10 + (c - '0');
+                }
+                digitos++;
+            } else {
+                return false;
+            }
+        }
+        if (digitos == 0) return false;
+        if (digitosDecimales == 1) decimales *= 10;
+
+        int64_t centavos = entero * 100 + decimales;
+        importe = Dinero(negativo ? -centavos : centavos);
+        return true;
+    }
+
+    constexpr int64_t centavos() const { return valor; }
+    double aDecimal() const { return static_cast<double>(valor) / 100.0; }
+
+    /// Texto con dos decimales, p. ej. "-1234.05"
+    std::string texto() const {
+        uint64_t absoluto = valor < 0 ? 0 - static_cast<uint64_t>(valor) : static_cast<uint64_t>(valor);
+        std::string resultado = std::to_string(absoluto / 100) + ".";
+        unsigned resto = static_cast<unsigned>(absoluto % 100);
+        resultado += static_cast<char>('0' + resto / 10);
+        resultado += static_cast<char>('0' + resto % 10);
+        return valor < 0 ? "-" + resultado : resultado;
+    }
+
+    constexpr Dinero operator+(Dinero otro) const { return Dinero(valor + otro.valor); }
+    constexpr Dinero operator-(Dinero otro) const { return Dinero(valor - otro.valor); }
+    constexpr Dinero operator-() const { return Dinero(-valor); }
+    constexpr Dinero operator*(int64_t factor) const { return Dinero(valor * factor); }
+    Dinero& operator+=(Dinero otro) { valor += otro.valor; return *this; }
+    Dinero& operator-=(Dinero otro) { valor -= otro.valor; return *this; }
+
+    constexpr bool operator==(Dinero otro) const { return valor == otro.valor; }
+    constexpr bool operator!=(Dinero otro) const { return valor != otro.valor; }
+    constexpr bool operator<(Dinero otro) const { return valor < otro.valor; }
+    constexpr bool operator<=(Dinero otro) const { return valor <= otro.valor; }
+    constexpr bool operator>(Dinero otro) const { return valor > otro.valor; }
+    constexpr bool operator>=(Dinero otro) const { return valor >= otro.valor; }
+
+private:
+    int64_t valor;   ///< Centavos
+
+    constexpr explicit Dinero(int64_t centavos) : valor(centavos) {}
+};
+
+inline Dinero operator*(int64_t factor, Dinero importe) { return importe * factor; }
+
+/// Siempre con dos decimales, sin depender de fixed/setprecision del flujo
+inline std::ostream& operator<<(std::ostream& salida, Dinero importe) { return salida << importe.texto(); }
+
+#endif // DINERO_H
@@ -5,6 +5,7 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include "transportistas.h"
 
 /**
@@ -29,6 +30,12 @@ struct Envio {
  * Esta clase permite gestionar los envíos dentro del sistema, incluyendo
  * la generación automática de IDs, persistencia en archivos binarios,
  * y selección de transportistas disponibles.
+ *
+ * Formato de envios.bin (versión 2): cabecera con firma "ENVS", versión,
+ * tamaño de registro, registros por bloque, cantidad y CRC de la cabecera;
+ * luego bloques de registros de tamaño fijo, cada uno seguido de su CRC-32.
+ * Los archivos antiguos (sin cabecera) se siguen leyendo y se convierten al
+ * formato nuevo en la primera escritura.
  */
 class Envios {
 public:
@@ -56,20 +63,105 @@ public:
     void mostrarEnvios();
 
     /**
-     * @brief Carga todos los envíos desde el archivo binario "envios.dat".
+     * @brief Carga todos los envíos desde el archivo binario "envios.bin".
+     *
+     * Verifica el CRC de cada bloque; los bloques dañados se omiten con un aviso
+     * y la próxima reescritura completa respalda antes el archivo.
+     * También reconstruye los índices por ID de envío y por ID de pedido.
+     *
      * @return Vector con todos los envíos cargados.
      */
     static std::vector<Envio> cargarEnviosDesdeArchivo();
 
     /**
-     * @brief Guarda todos los envíos en el archivo binario "envios.dat".
+     * @brief Reescribe completo el archivo binario "envios.bin".
+     *
+     * Si la última carga omitió bloques dañados o un final truncado, antes se
+     * copia el archivo a "envios_danado_<fecha>.bin". Si la cabecera estaba
+     * dañada no se escribe nada.
+     *
      * @param envios Vector de envíos a guardar.
+     * @return true si el archivo quedó escrito.
      */
-    static void guardarEnviosEnArchivo(const std::vector<Envio>& envios);
+    static bool guardarEnviosEnArchivo(const std::vector<Envio>& envios);
+
+    /**
+     * @brief Indica si la última carga leyó todos los envíos de "envios.bin".
+     */
+    static bool cargaCompleta() { return !cargaParcial && !cabeceraDanada; }
+
+    /**
+     * @brief Busca un envío por su ID usando el índice primario.
+     * @return Puntero al envío o nullptr si no existe.
+     */
+    static const Envio* buscarEnvio(const std::string& idEnvio);
+
+    /**
+     * @brief Busca un envío activo y, si no está, en el archivo histórico.
+     * @return true si se encontró (copiado en 'envio').
+     */
+    static bool consultarEnvio(const std::string& idEnvio, Envio& envio);
+
+    /**
+     * @brief Envíos asociados a un pedido (índice secundario), incluidos los archivados.
+     */
+    static std::vector<Envio> enviosDePedido(const std::string& idPedido);
+
+    /**
+     * @brief Indica si todos los envíos no cancelados de un pedido están entregados.
+     */
+    static bool pedidoEntregado(const std::string& idPedido);
+
+    /**
+     * @brief Agrega un envío al final del archivo sin reescribir los anteriores.
+     *
+     * También deja su estado inicial en el historial (EventosEnvios).
+     * @return true si se guardó correctamente; si no, el envío no queda en memoria.
+     */
+    static bool agregarEnvio(const Envio& envio);
+
+    /**
+     * @brief Cambia el estado de un envío escribiendo solo su registro y el CRC de su bloque.
+     *
+     * Si el estado cambia, el cambio se agrega al historial (EventosEnvios).
+     * @return true si el envío existe y se guardó el cambio.
+     */
+    static bool actualizarEstadoEnvio(const std::string& idEnvio, const std::string& nuevoEstado);
+
+    /**
+     * @brief Resumen de una importación de manifiesto de entregas.
+     */
+    struct ResultadoImportacion {
+        size_t lineas = 0;         ///< Líneas de datos leídas
+        size_t aplicadas = 0;      ///< Cambios de estado aplicados
+        size_t sinCambio = 0;      ///< El envío ya tenía ese estado
+        size_t noEncontradas = 0;  ///< ID de envío inexistente
+        size_t invalidas = 0;      ///< Formato, estado o fecha no válidos
+        size_t rechazadas = 0;     ///< Envío cancelado o ya entregado
+        size_t pedidosEntregados = 0;
+        std::vector<std::string> errores;  ///< Primeros errores, con número de línea
+    };
+
+    /**
+     * @brief Importa un manifiesto de entregas del transportista (idEnvio,estado,fecha).
+     *
+     * Las líneas se ordenan por ID de envío y fecha y se cruzan en una sola
+     * pasada con los envíos ordenados por ID. Los cambios se aplican en memoria
+     * y se confirman una sola vez: envios.bin, los eventos del historial y los
+     * pedidos que pasan a "entregado" (los que ya no tienen envíos sin entregar).
+     *
+     * @param ruta Archivo CSV; la fecha puede ser epoch o "AAAA-MM-DD HH:MM[:SS]".
+     */
+    static ResultadoImportacion importarManifiesto(const std::string& ruta);
+
+    /**
+     * @brief Cantidad de envíos "en camino" por transportista (usa la tabla ya cargada).
+     */
+    static std::unordered_map<std::string, int> enCursoPorTransportista();
 
     /**
      * @brief Genera automáticamente un ID único dentro del rango 3500–3599.
-     * @return El ID numérico disponible convertido a entero.
+     * @return El ID numérico disponible convertido a entero (0 si el rango está completo).
      */
     static int generarIdEnvio();
 
@@ -85,6 +177,17 @@ private:
      * @brief Vector estático que contiene todos los envíos cargados en memoria.
      */
     static std::vector<Envio> envios;
+
+    static std::unordered_map<std::string, size_t> indicePorEnvio;               ///< ID de envío -> posición
+    static std::unordered_map<std::string, std::vector<size_t>> indicePorPedido; ///< ID de pedido -> posiciones
+    static bool enviosCargados;    ///< true cuando 'envios' refleja el archivo
+    static bool formatoVigente;    ///< false si el archivo es antiguo o tenía bloques dañados
+    static bool cargaParcial;      ///< true si al cargar se omitieron bloques o registros
+    static bool cabeceraDanada;    ///< true si la cabecera no pasó el CRC (no se escribe)
+
+    static void asegurarCargados();
+    static void reconstruirIndices();
+    static bool escribirRegistro(size_t posicion);
 };
 
 #endif // ENVIOS_H
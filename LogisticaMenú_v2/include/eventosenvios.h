@@ -0,0 +1,103 @@
+#ifndef EVENTOSENVIOS_H
+#define EVENTOSENVIOS_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+#include "envios.h"
+
+/**
+ * @class EventosEnvios
+ * @brief Historial de cambios de estado de los envíos (eventos_envios.bin).
+ *
+ * Cada cambio de estado se agrega al final del archivo como un registro de
+ * tamaño fijo con su propio CRC-32; nunca se reescriben eventos anteriores.
+ * Al crear el envío se copian en el evento el almacén y la fecha del pedido,
+ * de modo que el análisis de tiempos se hace en una sola pasada secuencial
+ * sin consultar pedidos.bin.
+ */
+class EventosEnvios {
+public:
+    /// Cambio de estado de un envío
+    struct Evento {
+        std::string idEnvio;
+        std::string idPedido;
+        std::string idTransportista;
+        std::string idAlmacen;
+        std::string estado;
+        std::time_t fecha = 0;        ///< Momento del cambio
+        std::time_t fechaPedido = 0;  ///< Fecha del pedido (0 si no se conoce)
+    };
+
+    /// Acumulado de una medida de tiempo (en segundos)
+    struct Estadistica {
+        size_t cantidad = 0;
+        double suma = 0;
+        double minimo = 0;
+        double maximo = 0;
+
+        void agregar(double segundos);
+        double promedio() const { return cantidad ? suma / cantidad : 0.0; }
+    };
+
+    /// Tiempos de un grupo de envíos (total, un transportista o un almacén)
+    struct TiemposEntrega {
+        Estadistica pedidoADespacho;   ///< Fecha del pedido -> salida ("en camino")
+        Estadistica despachoAEntrega;  ///< Salida -> "entregado"
+        Estadistica pedidoAEntrega;    ///< Fecha del pedido -> "entregado"
+        size_t retrasos = 0;           ///< Entregas que superaron el plazo
+        size_t cancelados = 0;
+    };
+
+    /// Resultado del análisis
+    struct Analisis {
+        TiemposEntrega total;
+        std::map<std::string, TiemposEntrega> porTransportista;
+        std::map<std::string, TiemposEntrega> porAlmacen;
+        size_t eventos = 0;
+        size_t enCurso = 0;       ///< Despachados y aún sin entregar
+        size_t descartados = 0;   ///< Registros con CRC inválido
+    };
+
+    /// Plazo de entrega por defecto: 3 días desde la fecha del pedido
+    static const std::time_t PLAZO_ENTREGA = 3 * 24 * 60 * 60;
+
+    /**
+     * @brief Agrega al historial el estado 'estado' del envío.
+     * @param fecha Momento del cambio (0 = ahora).
+     * @return true si el evento quedó escrito.
+     */
+    static bool registrar(const Envio& envio, const std::string& estado, std::time_t fecha = 0);
+
+    /**
+     * @brief Agrega varios eventos con una sola escritura al final del archivo.
+     *
+     * Se usan idEnvio, idPedido, idTransportista, estado y fecha (0 = ahora);
+     * el almacén y la fecha del pedido se completan desde la instantánea de pedidos.
+     */
+    static bool registrarVarios(const std::vector<Evento>& eventos);
+
+    /**
+     * @brief Eventos de un envío en orden cronológico.
+     */
+    static std::vector<Evento> historial(const std::string& idEnvio);
+
+    /**
+     * @brief Todos los eventos válidos del archivo, en el orden en que se registraron.
+     */
+    static std::vector<Evento> cargarTodos();
+
+    /**
+     * @brief Calcula los tiempos de entrega recorriendo el archivo una sola vez.
+     * @param plazo Segundos desde el pedido a partir de los cuales una entrega cuenta como retraso.
+     */
+    static Analisis analizar(std::time_t plazo = PLAZO_ENTREGA);
+
+    /**
+     * @brief Muestra en consola el historial de un envío elegido por el usuario.
+     */
+    static void mostrarHistorial();
+};
+
+#endif // EVENTOSENVIOS_H
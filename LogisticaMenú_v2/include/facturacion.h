@@ -5,6 +5,13 @@
 #define FACTURACION_H
 
 #include <iostream>
+#include <fstream>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "dinero.h"
 using namespace std;
 
 // Estructura que representa una factura individual
@@ -12,9 +19,42 @@ struct Factura {
     int idFactura;          // Identificador nico de la factura
     int idCliente;          // Identificador del cliente asociado
     int idPedido;           // Identificador del pedido relacionado
-    float monto;            // Monto total de la factura
-    bool pagada;            // Estado de pago de la factura (true si est pagada)
+    float monto;            // Monto total (formato anterior); se conserva como referencia, el exacto es 'importe'
+    bool pagada;            // true cuando el libro de pagos dej el saldo en cero
     char cliente[50];       // Nombre del cliente (no se usa activamente, pero se mantiene por compatibilidad)
+    bool eliminada;         // Marca de borrado (formato 2); ocupa el byte de relleno del registro original
+    Dinero importe;         // Monto exacto en centavos (formato 3)
+    int64_t fechaEmision;   // Fecha de emisin, segundos desde 1970 (formato 4)
+    int64_t fechaVencimiento; // Fecha de vencimiento para el cobro (formato 4)
+    Dinero impuesto;        // IVA incluido en 'importe' (formato 5)
+};
+
+// Cabecera de facturas.bin; le siguen 'cantidad' registros Factura.
+// Los archivos anteriores (sin cabecera o de versiones previas) se convierten al primer uso
+struct CabeceraFacturas {
+    char firma[4];          // "FACT"
+    uint32_t version;       // Versin del formato
+    uint32_t tamRegistro;   // sizeof(Factura) con que se escribi el archivo
+    int32_t siguienteId;    // Prximo ID de factura a asignar
+    uint32_t cantidad;      // Registros escritos despus de la cabecera (incluye eliminados)
+    uint32_t eliminadas;    // Registros marcados como eliminados (formato 2)
+};
+
+// Entrada de facturas.idx: la entrada i describe el registro i de facturas.bin
+struct EntradaIndiceFactura {
+    int32_t idFactura;
+    int32_t idPedido;
+    uint8_t eliminada;
+    uint8_t reservado[3];
+};
+
+// Resumen de una corrida de facturacin por lote
+struct ResultadoLoteFacturas {
+    size_t facturas = 0;        // Facturas generadas
+    size_t yaFacturados = 0;    // Pedidos cerrados que ya tenan factura
+    size_t omitidos = 0;        // Pedidos con ID de pedido o cliente no numrico
+    Dinero montoTotal;          // Suma de los montos facturados
+    bool correcto = true;       // false si no se pudo escribir el archivo
 };
 
 // Clase que maneja las operaciones relacionadas con facturacin
@@ -35,9 +75,59 @@ private:
     // Muestra informacin de los pedidos (definicin pendiente)
     void mostrarPedidos();
 
-    // Genera un nuevo ID nico para una factura
+    // Genera un nuevo ID nico para una factura (ledo de la cabecera)
     int generarIdFactura();
 
+    // Abre facturas.bin para lectura/escritura y lee su cabecera;
+    // crea el archivo o convierte el formato anterior si hace falta
+    bool abrirArchivo(fstream& archivo, CabeceraFacturas& cabecera);
+
+    // Reescribe la cabecera al inicio del archivo
+    bool escribirCabecera(fstream& archivo, const CabeceraFacturas& cabecera);
+
+    // Convierte un facturas.bin sin cabecera o de una versin anterior al formato actual
+    bool convertirFormatoAnterior();
+
+    // Exportacin columnar de las facturas para anlisis (ver ArchivoColumnar)
+    const char* archivoColumnar = "facturas.col";
+
+    // Nombre del ndice persistente (idFactura / idPedido -> posicin del registro)
+    const char* archivoIndice = "facturas.idx";
+
+    // ndice en memoria, compartido por todas las instancias y protegido por mutexArchivo
+    static mutex mutexArchivo;
+    static unordered_map<int, uint32_t> posicionPorFactura;
+    static unordered_map<int, uint32_t> posicionPorPedido;
+    static uint32_t registrosIndexados;   // Registros de facturas.bin ya reflejados en el ndice
+    static bool indiceCargado;
+    static bool compactacionPendiente;
+
+    // Pone el ndice al da con la cabecera: lo carga de facturas.idx y, si le
+    // faltan registros al final (o no coincide con el archivo), los lee de facturas.bin
+    void sincronizarIndice(fstream& archivo, const CabeceraFacturas& cabecera);
+
+    // Agrega al ndice (memoria y facturas.idx) registros recin escritos desde 'primera'
+    void indexarFacturas(const Factura* facturas, uint32_t cantidad, uint32_t primera);
+
+    // Reescribe la entrada de facturas.idx de un registro
+    void escribirEntradaIndice(uint32_t posicion, const Factura& factura);
+
+    // Busca una factura vigente por ID con el ndice; devuelve su posicin y el registro
+    bool buscarFactura(fstream& archivo, const CabeceraFacturas& cabecera, int idFactura,
+                       uint32_t& posicion, Factura& factura);
+
+    // Reescribe un registro en su posicin
+    bool escribirFactura(fstream& archivo, uint32_t posicion, const Factura& factura);
+
+    // Facturas vigentes de facturas.bin; quien llama ya tiene mutexArchivo
+    bool leerFacturasVigentes(vector<Factura>& facturas);
+
+    // Inicia los saldos del libro de pagos si hace falta; quien llama ya tiene mutexArchivo
+    bool asegurarPagos();
+
+    // Encola compactar() en segundo plano si la proporcin de eliminados supera el umbral
+    void programarCompactacion(const CabeceraFacturas& cabecera);
+
     // Registra una accin en la bitcora (como crear, modificar, eliminar una factura)
     void registrarBitacora(const Factura& factura, const string& accion, const string& usuario = "Usuario");
 
@@ -51,11 +141,49 @@ public:
     // Muestra todas las facturas existentes
     void mostrarFacturas();
 
-    // Permite modificar los datos de una factura
-    void modificarFactura();
+    // Registra un pago, nota de crdito o castigo sobre una factura (ver Pagos)
+    void registrarPago();
+
+    // Agrega un movimiento al libro de pagos; al quedar el saldo en cero marca la factura como pagada
+    bool registrarMovimiento(int idFactura, uint8_t tipo, Dinero importe, const string& referencia, Dinero& saldo);
 
     // Elimina una factura del archivo
     void eliminarFactura();
+
+    // Factura todos los pedidos completados o entregados que an no tienen factura.
+    // Las facturas se arman en paralelo y se agregan al archivo en una sola escritura
+    ResultadoLoteFacturas facturarPedidosCerrados();
+
+    // Opcin de men: corre facturarPedidosCerrados() y muestra el resumen
+    void facturarLote();
+
+    // Reescribe facturas.bin sin los registros eliminados y reconstruye el ndice
+    bool compactar();
+
+    // Facturas vigentes (no eliminadas) ledas por bloques
+    bool cargarFacturas(vector<Factura>& facturas);
+
+    // IDs de los pedidos que ya tienen factura, desde el ndice (sin leer los registros)
+    bool pedidosFacturados(unordered_set<int>& pedidos);
+
+    // Opcin de men: totales abiertos/pagados y clientes con mayor saldo (ver Cartera)
+    void mostrarCuentasPorCobrar();
+
+    // Carga los saldos del libro de pagos la primera vez (despus Pagos responde en O(1))
+    bool prepararPagos();
+
+    // Carga las facturas en Antiguedad la primera vez y la avanza hasta hoy
+    bool prepararAntiguedad();
+
+    // Opcin de men: saldos sin pagar por tramo de vencimiento (ver Antiguedad)
+    void mostrarAntiguedadSaldos();
+
+    // Opcin de men: escribe las facturas vigentes en facturas.col (ver ArchivoColumnar)
+    void exportarColumnar();
+
+    // Opcin de men: totales de un rango de emisin ledos de facturas.col
+    // (solo las columnas necesarias y sin los bloques fuera del rango)
+    void consultarExportacion();
 };
 
 #endif
@@ -0,0 +1,75 @@
+#ifndef GRUPOHILOS_H
+#define GRUPOHILOS_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+
+/**
+ * @class GrupoHilos
+ * @brief Grupo fijo de hilos que ejecuta tareas de una cola compartida.
+ *
+ * Los hilos se crean una vez y se reutilizan; encolar() devuelve un future
+ * con el resultado de la tarea y paraCada() reparte un rango de índices en
+ * bloques y espera a que terminen todos.
+ */
+class GrupoHilos {
+public:
+    /**
+     * @param hilos Cantidad de hilos (0 = los que informe el hardware, al menos 1).
+     */
+    explicit GrupoHilos(size_t hilos = 0);
+
+    /// Termina las tareas pendientes y une los hilos
+    ~GrupoHilos();
+
+    GrupoHilos(const GrupoHilos&) = delete;
+    GrupoHilos& operator=(const GrupoHilos&) = delete;
+
+    /**
+     * @brief Agrega una tarea a la cola.
+     * @return future con el resultado (o la excepción) de la tarea.
+     */
+    template <typename Tarea>
+    std::future<decltype(std::declval<Tarea&>()())> encolar(Tarea tarea) {
+        using Resultado = decltype(std::declval<Tarea&>()());
+        auto empaquetada = std::make_shared<std::packaged_task<Resultado()>>(std::move(tarea));
+        std::future<Resultado> futuro = empaquetada->get_future();
+        {
+            std::lock_guard<std::mutex> bloqueo(mutex);
+            cola.emplace([empaquetada]() { (*empaquetada)(); });
+        }
+        hayTrabajo.notify_one();
+        return futuro;
+    }
+
+    /**
+     * @brief Ejecuta tarea(i) para i en [0, cantidad) repartido entre los hilos.
+     *
+     * Bloquea hasta que terminan todos los bloques; si alguna tarea lanza una
+     * excepción, se relanza aquí.
+     */
+    void paraCada(size_t cantidad, const std::function<void(size_t)>& tarea);
+
+    size_t cantidadHilos() const { return hilos.size(); }
+
+    /// Grupo compartido por los módulos que procesan en paralelo
+    static GrupoHilos& global();
+
+private:
+    std::vector<std::thread> hilos;
+    std::queue<std::function<void()>> cola;
+    std::mutex mutex;
+    std::condition_variable hayTrabajo;
+    bool detener = false;
+
+    void trabajar();
+};
+
+#endif // GRUPOHILOS_H
@@ -0,0 +1,61 @@
+#ifndef INTEGRIDAD_H
+#define INTEGRIDAD_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @class Integridad
+ * @brief Verificación de integridad referencial entre los archivos de datos.
+ *
+ * Lee en paralelo (GrupoHilos) clientes, almacenes, productos,
+ * transportistas, pedidos, envíos y facturas; cada lectura arma de una vez
+ * el conjunto hash de sus claves y cuenta las repetidas. Después revisa
+ * cada relación en una sola pasada, también en paralelo:
+ *
+ *  - Pedidos: cliente, almacén y código de producto de cada línea.
+ *  - Envíos: pedido, transportista y cliente.
+ *  - Facturas: pedido (una factura por pedido) y cliente.
+ *
+ * Un pedido que ya no está en pedidos.bin pero sí en el archivo histórico
+ * (Archivador) no cuenta como huérfano. Solo lee los archivos: no corrige
+ * nada. Se puede correr desde el menú Archivo o con
+ * "--verificar-integridad" sin iniciar sesión.
+ */
+class Integridad {
+public:
+    /// Ejemplos que se guardan por relación (los conteos son completos)
+    static const size_t MAXIMO_EJEMPLOS = 10;
+
+    /// Resultado de una relación o de un archivo
+    struct Relacion {
+        std::string nombre;
+        size_t registros = 0;
+        size_t huerfanos = 0;              ///< Referencias a claves que no existen
+        size_t duplicados = 0;             ///< Claves repetidas
+        std::vector<std::string> ejemplos;
+
+        void anotar(size_t& contador, const std::string& detalle);
+    };
+
+    struct Informe {
+        std::vector<Relacion> relaciones;
+        double segundosCarga = 0.0;
+        double segundosRevision = 0.0;
+        size_t problemas() const;
+    };
+
+    /// Carga todos los archivos y revisa todas las relaciones
+    static Informe verificar();
+
+    static void mostrar(const Informe& informe);
+
+    /// Opción de menú: verificar, mostrar y registrar en la bitácora
+    static void verificarInteractivo();
+
+    /// Para "--verificar-integridad": muestra el informe; devuelve 0 si no hay problemas y 1 si los hay
+    static int verificarDesdeLineaDeComandos();
+};
+
+#endif // INTEGRIDAD_H
@@ -0,0 +1,105 @@
+#ifndef LISTAESPERA_H
+#define LISTAESPERA_H
+
+#include <vector>
+#include <string>
+#include <ctime>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include "dinero.h"
+
+/**
+ * @class ListaEspera
+ * @brief Lineas de pedido sin existencias que esperan la llegada de mercancia.
+ *
+ * Cada producto tiene su propia cola de prioridad (mayor prioridad primero y,
+ * a igual prioridad, el pedido mas antiguo). Al registrar una entrada solo se
+ * revisa la cola de ese producto, de modo que el costo de asignar depende de
+ * las lineas atendidas y no del total de pedidos. Se guarda en listaespera.bin.
+ */
+class ListaEspera {
+public:
+    /// Linea pendiente de surtir
+    struct Entrada {
+        std::string idPedido;
+        std::string idCliente;
+        std::string codigoProducto;
+        int cantidad = 0;             ///< Unidades que aun faltan
+        Dinero precioUnitario;        ///< Precio pactado al crear el pedido
+        int prioridad = 0;            ///< Mayor valor = se atiende antes
+        std::time_t fecha = 0;        ///< Fecha del pedido original
+        uint64_t secuencia = 0;       ///< Desempate estable entre lineas de la misma fecha
+    };
+
+    /// Unidades recibidas que se destinan a una linea en espera
+    struct Asignacion {
+        std::string idPedido;
+        std::string idCliente;
+        std::string codigoProducto;
+        std::string idAlmacen;
+        int cantidad;
+        Dinero precioUnitario;
+    };
+
+    /// Indica si un pedido todavia puede recibir mercancia
+    using PedidoVigente = std::function<bool(const std::string& idPedido)>;
+
+    /**
+     * @brief Pone en espera una linea y guarda el archivo.
+     */
+    static void agregar(Entrada entrada);
+
+    /**
+     * @brief Reparte una entrada de mercancia entre las lineas en espera del producto.
+     *
+     * Las lineas de pedidos que ya no estan vigentes se descartan al encontrarlas.
+     *
+     * @param codigoProducto Producto recibido.
+     * @param idAlmacen Almacen donde se recibio.
+     * @param cantidad Unidades recibidas.
+     * @param vigente Criterio para saber si el pedido sigue abierto.
+     * @return Asignaciones realizadas (puede estar vacio).
+     */
+    static std::vector<Asignacion> asignarEntrada(const std::string& codigoProducto,
+                                                  const std::string& idAlmacen,
+                                                  int cantidad,
+                                                  const PedidoVigente& vigente);
+
+    /**
+     * @brief Quita todas las lineas en espera de un pedido (cancelado o completado).
+     */
+    static void retirarPedido(const std::string& idPedido);
+
+    /**
+     * @brief Numero de lineas en espera de un pedido.
+     */
+    static int lineasPendientes(const std::string& idPedido);
+
+    /**
+     * @brief Valor (cantidad que falta por precio pactado) de las lineas en espera de un pedido.
+     */
+    static Dinero montoPendiente(const std::string& idPedido);
+
+    /**
+     * @brief Unidades en espera de un producto.
+     */
+    static int unidadesEnEspera(const std::string& codigoProducto);
+
+private:
+    static std::unordered_map<std::string, std::vector<Entrada>> colas;  ///< Producto -> heap
+    static std::unordered_map<std::string, int> pendientesPorPedido;     ///< Pedido -> lineas en espera
+    static std::unordered_map<std::string, Dinero> montoPorPedido;       ///< Pedido -> valor en espera
+    static std::unordered_map<std::string, int> unidadesPorProducto;     ///< Producto -> unidades en espera
+    static uint64_t siguienteSecuencia;
+    static bool cargado;
+
+    static bool atiendeDespues(const Entrada& a, const Entrada& b);
+    static void asegurarCargado();
+    static void cargarDesdeArchivo();
+    static void guardarEnArchivo();
+    static void descontarPedido(const std::string& idPedido);
+    static void ajustarUnidades(const std::string& codigoProducto, int delta);
+};
+
+#endif // LISTAESPERA_H
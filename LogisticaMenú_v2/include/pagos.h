@@ -0,0 +1,104 @@
+#ifndef PAGOS_H
+#define PAGOS_H
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include "dinero.h"
+#include "facturacion.h"
+
+/// Tipos de movimiento del libro de pagos
+enum TipoMovimientoPago : uint8_t {
+    MOVIMIENTO_PAGO = 1,          ///< Pago del cliente
+    MOVIMIENTO_NOTA_CREDITO = 2,  ///< Nota de crédito (devolución, bonificación)
+    MOVIMIENTO_CASTIGO = 3        ///< Saldo dado por incobrable
+};
+
+/// Registro de pagos.bin (64 bytes)
+struct MovimientoPago {
+    int32_t idMovimiento;
+    int32_t idFactura;
+    int32_t idCliente;
+    uint8_t tipo;             ///< TipoMovimientoPago
+    uint8_t reservado[3];
+    int64_t fecha;            ///< Segundos desde 1970
+    Dinero importe;           ///< Siempre positivo; se descuenta del saldo
+    char referencia[32];      ///< Recibo, número de nota, motivo...
+};
+
+/**
+ * @class Pagos
+ * @brief Libro de pagos (pagos.bin, solo se agregan registros) y saldos abiertos.
+ *
+ * El saldo de una factura es su importe menos los movimientos aplicados. El
+ * libro se recorre una sola vez, al iniciar(); desde ahí los saldos por
+ * factura y por cliente se mantienen en memoria con cada factura nueva,
+ * eliminada o movimiento registrado, así consultar un saldo es O(1).
+ *
+ * Las facturas marcadas como pagadas antes de existir el libro reciben al
+ * iniciar un pago de apertura por su saldo, para que el libro las explique.
+ */
+class Pagos {
+public:
+    /// Saldo de una factura y lo que se le aplicó, separado por tipo de movimiento
+    struct ResumenFactura {
+        Dinero saldo;
+        Dinero pagos;
+        Dinero notasCredito;
+        Dinero castigos;
+    };
+
+    /// Saldos a partir de las facturas vigentes y del libro
+    static bool iniciar(const std::vector<Factura>& facturas);
+    static bool iniciado();
+
+    /// Factura nueva: su saldo es el importe completo
+    static void agregarFactura(const Factura& factura);
+
+    /// Factura eliminada: sale de los saldos (sus movimientos quedan en el libro)
+    static void quitarFactura(int idFactura);
+
+    /**
+     * @brief Agrega un movimiento al libro y lo descuenta del saldo.
+     *
+     * Completa idMovimiento, idCliente y fecha. Falla si la factura no
+     * existe, si el importe no es positivo o si supera el saldo.
+     * @param saldo Saldo de la factura después del movimiento.
+     */
+    static bool registrar(MovimientoPago& movimiento, Dinero& saldo);
+
+    static bool existeFactura(int idFactura);
+    static Dinero saldoFactura(int idFactura);
+    static Dinero saldoCliente(int idCliente);
+    /// true si el pedido tiene alguna factura vigente
+    static bool pedidoFacturado(int idPedido);
+    static ResumenFactura resumenFactura(int idFactura);
+
+    /// Movimientos de una factura en el orden en que se registraron
+    static std::vector<MovimientoPago> movimientosDe(int idFactura);
+
+    static const char* nombreTipo(uint8_t tipo);
+
+private:
+    struct EstadoFactura {
+        int idCliente = 0;
+        int idPedido = 0;
+        Dinero saldo;
+        Dinero pagos;                        ///< Aplicado por tipo de movimiento
+        Dinero notasCredito;
+        Dinero castigos;
+        std::vector<uint32_t> movimientos;   ///< Posiciones en pagos.bin
+    };
+
+    static std::mutex mutexPagos;
+    static bool cargado;
+    static std::unordered_map<int, EstadoFactura> porFactura;
+    static std::unordered_map<int, Dinero> porCliente;
+    static std::unordered_map<int, int> facturasPorPedido;   ///< Pedido -> facturas vigentes
+
+    static bool agregarAlLibro(MovimientoPago& movimiento, uint32_t& posicion);
+    static void aplicar(const MovimientoPago& movimiento, uint32_t posicion);
+};
+
+#endif // PAGOS_H
@@ -5,6 +5,9 @@
 #include <string>
 #include <ctime>
 #include <stdexcept>
+#include <unordered_map>
+#include <memory>
+#include <iosfwd>
 #include "usuarios.h"
 #include "bitacora.h"
 #include "clientes.h"
@@ -12,10 +15,13 @@
 #include "almacen.h"
 #include "envios.h"
 #include "transportistas.h"
+#include "listaespera.h"
+#include "dinero.h"
 
 class Clientes;
 class Producto;
 class Almacen;
+struct InstantaneaPedidos;
 
 extern usuarios usuarioRegistrado;
 extern bitacora auditoria;
@@ -25,7 +31,21 @@ public:
     struct DetallePedido {
         std::string codigoProducto;
         int cantidad;
-        double precioUnitario;
+        Dinero precioUnitario;
+    };
+
+    // Totales materializados del pedido (se actualizan con cada cambio de lineas)
+    struct TotalesPedido {
+        Dinero neto;         // Suma de cantidad * precioUnitario
+        int lineas = 0;      // Numero de lineas del pedido
+        int unidades = 0;    // Suma de cantidades de todas las lineas
+    };
+
+    // Acumulados por cliente, mantenidos de forma incremental
+    struct AgregadosCliente {
+        Dinero montoAbierto;          // Monto de pedidos pendientes o procesados
+        Dinero valorHistorico;        // Monto de todos los pedidos no cancelados
+        int cantidadPedidos = 0;      // Pedidos registrados del cliente
     };
 
     // Declaracin del constructor (sin implementacin aqu)
@@ -46,18 +66,67 @@ public:
                         const std::vector<Producto>& productos,
                         const std::vector<Almacen>& almacenes);
     void cancelarPedido();
+    // Pasa un pedido retenido por crdito a su estado normal (revisa de nuevo el lmite)
+    void liberarPedido(const std::vector<Clientes>& clientes);
     void completarPedido(std::vector<Producto>& productos);
     void verHistorial();
 
+    // Cambia solo el estado de esta copia; para pedidos de listaPedidos usar cambiarEstado
     void setEstado(const std::string& nuevoEstado) { estado = nuevoEstado; }
 
-    static void guardarEnArchivoBin(const std::vector<Pedidos>& lista);
+    // Manejo de lineas manteniendo los totales al dia
+    void agregarDetalle(const DetallePedido& detalle);
+    void limpiarDetalles();
+
+    // Primer ID libre del rango de pedidos ("" si el rango est lleno)
+    static std::string generarIdUnico(const std::vector<Pedidos>& lista);
+
+    static bool guardarEnArchivoBin(const std::vector<Pedidos>& lista);
     static void cargarDesdeArchivoBin(std::vector<Pedidos>& lista);
 
+    // Un pedido en el formato de pedidos.bin (tambin lo usa el archivo histrico)
+    static void escribirPedido(std::ostream& archivo, const Pedidos& pedido);
+    static bool leerPedido(std::istream& archivo, Pedidos& pedido);
+
+    // Busca en la instantnea y, si no est, en el archivo histrico (ver Archivador)
+    static bool consultarPedido(const std::string& idPedido, Pedidos& pedido);
+
+    // Guarda listaPedidos y publica una nueva instantnea para los lectores
+    static bool confirmarCambios();
+    // Igual, pero solo escribe los pedidos indicados (agregados al final de pedidos.bin)
+    static bool confirmarCambios(const std::vector<std::string>& idsPedido);
+
+    // Instantnea inmutable de la tabla de pedidos (copia al escribir).
+    // Los lectores la conservan mientras la usan; los escritores la reemplazan
+    // de forma atmica despus de cada guardado, sin esperar a los lectores.
+    static std::shared_ptr<const InstantaneaPedidos> obtenerInstantanea();
+    static void publicarInstantanea(const std::vector<Pedidos>& lista);
+
     std::string getId() const { return id; }
     std::string getDetalles() const;
     std::string getEstado() const { return estado; }
     std::string getIdCliente() const { return idCliente; }
+    std::string getIdAlmacen() const { return idAlmacen; }
+    std::time_t getFechaPedido() const { return fechaPedido; }
+    const std::vector<DetallePedido>& getLineas() const { return detalles; }
+    const TotalesPedido& getTotales() const { return totales; }
+
+    // Acumulados por cliente en O(1); se reconstruyen al cargar listaPedidos
+    static AgregadosCliente obtenerAgregadosCliente(const std::string& idCliente);
+    static void reconstruirAgregados(const std::vector<Pedidos>& lista);
+    // Estados que cuentan en montoAbierto (pendiente o procesado)
+    static bool esEstadoAbierto(const std::string& estado);
+    // Suma (signo = 1) o resta (signo = -1) un pedido a un mapa de acumulados cualquiera
+    static void aplicarAgregados(std::unordered_map<std::string, AgregadosCliente>& destino,
+                                 const Pedidos& pedido, int signo);
+
+    // Cambia el estado de un pedido localizndolo por ndice y confirma el cambio
+    static bool actualizarEstado(const std::string& idPedido, const std::string& nuevoEstado);
+    static bool actualizarEstados(const std::vector<std::string>& idsPedido, const std::string& nuevoEstado);
+
+    // Lista de espera: vigencia de un pedido y entrega de la mercanca asignada
+    static bool admiteReposicion(const std::string& idPedido);
+    static void aplicarReposicion(const std::vector<ListaEspera::Asignacion>& asignaciones);
 
 private:
     // Orden correcto de miembros para coincidir con la inicializacin
@@ -67,12 +136,33 @@ private:
     std::time_t fechaPedido;
     std::string estado;
     std::vector<DetallePedido> detalles;
+    TotalesPedido totales;
 
-    static std::string generarIdUnico(const std::vector<Pedidos>& lista);
+    static std::unordered_map<std::string, AgregadosCliente> agregadosClientes;
+    static std::shared_ptr<const InstantaneaPedidos> instantanea;
+    static std::streamoff finArchivoBin;
+
+    void recalcularTotales();
+    static bool anexarEnArchivoBin(const std::vector<const Pedidos*>& pedidos);
+    static void aplicarAgregados(const Pedidos& pedido, int signo);
+    static std::shared_ptr<const InstantaneaPedidos> construirInstantanea(std::vector<Pedidos> lista);
+    static void cambiarEstado(Pedidos& pedido, const std::string& nuevoEstado);
+    static Pedidos* buscarEnLista(const std::string& idPedido);
+    static bool dividirPorAlmacen(const Pedidos& pedido, std::vector<Pedidos>& partes);
     static bool idDisponible(const std::vector<Pedidos>& lista, const std::string& id);
     static bool validarCliente(const std::string& idCliente, const std::vector<Clientes>& clientes);
     static bool validarProducto(const std::string& codigoProducto, const std::vector<Producto>& productos);
     static bool validarAlmacen(const std::string& idAlmacen, const std::vector<Almacen>& almacenes);
 };
 
+// Vista de solo lectura de todos los pedidos en un momento dado
+struct InstantaneaPedidos {
+    std::vector<Pedidos> pedidos;
+    std::unordered_map<std::string, size_t> indicePorId;  // ID de pedido -> posicin
+    std::unordered_map<std::string, Pedidos::AgregadosCliente> agregados;  // Acumulados de esta vista
+
+    // Devuelve el pedido con ese ID o nullptr si no existe
+    const Pedidos* buscar(const std::string& id) const;
+};
+
 #endif // PEDIDOS_H
@@ -10,6 +10,7 @@
 #include <fstream>  // Para ifstream/ofstream
 #include <iostream> // Para cerr
 #include "bitacora.h"
+#include "dinero.h"
 
 class Producto {
 private:
@@ -17,7 +18,7 @@ private:
     std::string codigo;
     std::string nombre;
     std::string descripcion;
-    double precio;
+    Dinero precio;
     int stock;
     int stockMinimo;
 
@@ -29,7 +30,7 @@ public:
     std::string getCodigo() const;
     std::string getNombre() const;
     std::string getDescripcion() const;
-    double getPrecio() const;
+    Dinero getPrecio() const;
     int getStock() const;
     int getStockMinimo() const;
 
@@ -38,7 +39,7 @@ public:
     void setCodigo(const std::string& codigo);
     void setNombre(const std::string& nombre);
     void setDescripcion(const std::string& descripcion);
-    void setPrecio(double precio);
+    void setPrecio(Dinero precio);
     void setStock(int stock);
     void setStockMinimo(int stockMinimo);
 
@@ -0,0 +1,129 @@
+#ifndef RESERVAS_H
+#define RESERVAS_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include "transportistas.h"
+
+/**
+ * @class Reservas
+ * @brief Agenda de franjas de los transportistas (reservas.bin).
+ *
+ * Cada envío ocupa capacidad (unidades, kg y m3) en una franja de un día de
+ * su transportista. La tabla en memoria se indexa por transportista y por día,
+ * así que ver cuánto queda libre en una franja no recorre ningún archivo.
+ *
+ * reservas.bin es un registro de solo agregado: una reserva o una liberación
+ * por registro, cada uno con su CRC-32. Al cargar se reproducen en orden y se
+ * descartan las reservas de días pasados. Cuando el archivo tiene muchos más
+ * registros que reservas vigentes se reescribe solo con estas (compactación).
+ *
+ * Una franja se identifica por su hora de inicio (las franjas de un vehículo
+ * no se solapan), no por su posición: agregar o quitar una franja no mueve
+ * las reservas de las demás.
+ */
+class Reservas {
+public:
+    /// Capacidad ocupada por un envío o por una franja
+    struct Carga {
+        int unidades = 0;
+        double pesoKg = 0.0;
+        double volumenM3 = 0.0;
+
+        /// Carga estimada de 'unidades' de producto con KG_POR_UNIDAD y M3_POR_UNIDAD
+        static Carga deUnidades(int unidades);
+    };
+
+    /// Franja reservada para un envío
+    struct Reserva {
+        std::string idEnvio;
+        std::string idTransportista;
+        int dia = 0;         ///< Días desde 1970-01-01 (hora local)
+        int franja = 0;      ///< Hora de inicio de la franja del vehículo
+        Carga carga;
+    };
+
+    /**
+     * Supuesto de carga por unidad de producto. Producto no registra peso ni
+     * volumen, así que todas las unidades se estiman igual; ajustar estos
+     * valores al surtido real (reservas ya hechas conservan su carga).
+     */
+    static constexpr double KG_POR_UNIDAD = 5.0;
+    static constexpr double M3_POR_UNIDAD = 0.02;
+
+    /// Días hacia adelante en que se busca lugar
+    static const int DIAS_AGENDA = 7;
+
+    /**
+     * @brief Reserva la primera franja con lugar del transportista a partir de 'desde'.
+     *
+     * La búsqueda, la escritura en reservas.bin y la actualización de la tabla
+     * se hacen bajo un mismo bloqueo; si la escritura falla no queda nada reservado.
+     *
+     * @param desde Momento a partir del cual se busca (0 = ahora); se saltan las franjas ya terminadas.
+     * @return false si no hay lugar en DIAS_AGENDA días o el envío ya tenía reserva.
+     */
+    static bool reservar(const std::string& idEnvio, const std::string& idTransportista,
+                         const Carga& carga, Reserva& reserva, std::time_t desde = 0);
+
+    /**
+     * @brief Indica si el transportista tiene alguna franja con lugar para la carga (no reserva).
+     */
+    static bool hayLugar(const std::string& idTransportista, const Carga& carga, std::time_t desde = 0);
+
+    /**
+     * @brief Devuelve la capacidad reservada por un envío (cancelado, entregado o eliminado).
+     * @return false si el envío no tenía reserva.
+     */
+    static bool liberar(const std::string& idEnvio);
+
+    /**
+     * @brief Reserva vigente de un envío.
+     */
+    static bool reservaDe(const std::string& idEnvio, Reserva& reserva);
+
+    /**
+     * @brief Capacidad ocupada en una franja de un día.
+     * @param franja Hora de inicio de la franja.
+     */
+    static Carga ocupado(const std::string& idTransportista, int dia, int franja);
+
+    /// Día (desde 1970-01-01, hora local) de una fecha
+    static int diaDe(std::time_t fecha);
+
+    /// "AAAA-MM-DD" de un día
+    static std::string textoDia(int dia);
+
+    /**
+     * @brief Opción de menú: ocupación de las franjas de los próximos días.
+     */
+    static void mostrarAgenda();
+
+private:
+    /// Ocupación de un día por hora de inicio de franja
+    struct Dia {
+        std::unordered_map<int, Carga> porFranja;
+    };
+
+    static std::unordered_map<std::string, std::unordered_map<int, Dia>> tabla;  ///< Transportista -> día -> franjas
+    static std::unordered_map<std::string, Reserva> porEnvio;
+    static bool cargadas;
+    static size_t registrosEnArchivo;   ///< Registros en reservas.bin (vigentes o no)
+    static uint32_t versionArchivo;     ///< Versión de la cabecera de reservas.bin
+    static std::mutex mutex;
+
+    // Suponen el bloqueo tomado
+    static void asegurarCargadas();
+    static void aplicar(const Reserva& reserva, int signo);
+    static bool buscarFranja(const std::string& idTransportista, const Carga& carga, std::time_t desde,
+                             int& dia, int& franja);
+    static bool escribir(const Reserva& reserva, bool liberacion);
+    static bool compactar();
+};
+
+#endif // RESERVAS_H
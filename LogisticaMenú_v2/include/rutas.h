@@ -0,0 +1,138 @@
+#ifndef RUTAS_H
+#define RUTAS_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+
+/**
+ * @class Rutas
+ * @brief Planificación de rutas de reparto con varias paradas.
+ *
+ * Las coordenadas de cada dirección se leen de coordenadas.txt (una línea
+ * "latitud,longitud,direccion" por dirección; se ignoran mayúsculas y
+ * espacios repetidos). Las distancias son en línea recta (haversine, km).
+ *
+ * planificar() arma las rutas con el algoritmo de ahorros de Clarke-Wright
+ * sobre los vecinos más cercanos de cada parada, asigna cada ruta al vehículo
+ * más chico que la puede llevar y mejora cada ruta con 2-opt. La matriz de
+ * distancias y la mejora de rutas se reparten entre los hilos de GrupoHilos.
+ */
+class Rutas {
+public:
+    /// Coordenada geográfica en grados
+    struct Punto {
+        double latitud = 0.0;
+        double longitud = 0.0;
+
+        bool operator==(const Punto& otro) const {
+            return latitud == otro.latitud && longitud == otro.longitud;
+        }
+    };
+
+    /// Parada a visitar (normalmente un pedido)
+    struct Parada {
+        std::string id;
+        std::string descripcion;  ///< Texto libre para mostrar (cliente, dirección)
+        Punto punto;
+        int demanda = 0;          ///< Unidades que se entregan
+    };
+
+    /// Vehículo disponible
+    struct VehiculoRuta {
+        std::string id;
+        std::string tipo;
+        int capacidad = 0;
+    };
+
+    /// Recorrido de un vehículo: sale del depósito, visita las paradas en orden y vuelve
+    struct Ruta {
+        VehiculoRuta vehiculo;
+        std::vector<Parada> paradas;
+        int carga = 0;
+        double distanciaKm = 0.0;
+    };
+
+    /// Resultado de una planificación
+    struct Plan {
+        std::vector<Ruta> rutas;
+        std::vector<Parada> sinAsignar;  ///< Sin vehículo con capacidad suficiente
+        double distanciaTotalKm = 0.0;
+    };
+
+    /**
+     * @brief Coordenada de una dirección según coordenadas.txt.
+     * @return false si la dirección no está en el archivo.
+     */
+    static bool coordenadaDe(const std::string& direccion, Punto& punto);
+
+    /**
+     * @brief Descarta las coordenadas, direcciones y distancias en caché.
+     */
+    static void recargarCoordenadas();
+
+    /**
+     * @brief Distancia en km entre dos puntos (fórmula de haversine).
+     */
+    static double distanciaKm(const Punto& a, const Punto& b);
+
+    /**
+     * @brief Distancia de un almacén a un cliente por sus direcciones, con caché.
+     *
+     * Pensada para Abastecimiento::setFuncionDistancia; si falta alguna
+     * coordenada devuelve SIN_DISTANCIA.
+     */
+    static double distanciaAlmacenCliente(const std::string& idAlmacen, const std::string& idCliente);
+
+    /// Distancia usada cuando no se conocen las coordenadas
+    static constexpr double SIN_DISTANCIA = 1.0e9;
+
+    /**
+     * @brief Arma las rutas de reparto desde un depósito.
+     * @param deposito Punto de salida y regreso.
+     * @param paradas Paradas con coordenadas y demanda.
+     * @param vehiculos Vehículos disponibles (cada uno hace a lo sumo una ruta).
+     */
+    static Plan planificar(const Punto& deposito, const std::vector<Parada>& paradas,
+                           const std::vector<VehiculoRuta>& vehiculos);
+
+    /**
+     * @brief Ordena las paradas de un solo vehículo (vecino más cercano y 2-opt).
+     * @return Distancia del recorrido en km, ida y vuelta al depósito.
+     */
+    static double ordenarParadas(const Punto& deposito, std::vector<Parada>& paradas);
+
+    /**
+     * @brief Opción de menú: planifica las rutas de los pedidos "procesado" de un almacén.
+     */
+    static void planificarRutas();
+
+private:
+    /// Matriz simétrica de distancias; el índice 0 es el depósito
+    class MatrizDistancias {
+    public:
+        explicit MatrizDistancias(const std::vector<Punto>& puntos);
+        float operator()(size_t i, size_t j) const { return datos[i * n + j]; }
+        size_t tamano() const { return n; }
+
+    private:
+        size_t n;
+        std::vector<float> datos;
+    };
+
+    static std::unordered_map<std::string, Punto> coordenadas;           ///< Dirección normalizada -> punto
+    static bool coordenadasCargadas;
+    static std::unordered_map<std::string, std::string> direccionAlmacen;  ///< ID -> dirección
+    static std::unordered_map<std::string, std::string> direccionCliente;  ///< ID -> dirección
+    static std::unordered_map<std::string, double> distanciasAlmacenCliente;
+    static std::vector<Punto> puntosMatriz;                               ///< Puntos de la última matriz
+    static std::shared_ptr<const MatrizDistancias> matrizCache;
+
+    static void asegurarCoordenadas();
+    static std::shared_ptr<const MatrizDistancias> obtenerMatriz(const std::vector<Punto>& puntos);
+    static double longitudRecorrido(const MatrizDistancias& matriz, const std::vector<size_t>& recorrido);
+    static void mejorar2Opt(const MatrizDistancias& matriz, std::vector<size_t>& recorrido);
+};
+
+#endif // RUTAS_H
@@ -0,0 +1,119 @@
+#ifndef TARIFAS_H
+#define TARIFAS_H
+
+#include <array>
+#include <vector>
+#include <map>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include "dinero.h"
+
+class Clientes;
+class Producto;
+
+/**
+ * @class Tarifas
+ * @brief Precio de venta de una línea: descuento por nivel de cliente y
+ *        categoría de producto, descuento por volumen e IVA por categoría.
+ *
+ * Las reglas se guardan en tarifas.bin; sin archivo se usan los valores por
+ * defecto, generados en tiempo de compilación. Al cargar o guardar, las
+ * reglas se compilan en arreglos planos (Tablas) que se publican como una
+ * instantánea inmutable: calcular el precio de una línea son unas pocas
+ * consultas por índice, sin recorrer reglas, y se puede hacer desde varios
+ * hilos a la vez.
+ *
+ * Los porcentajes van en puntos básicos (1 = 0.01 %, 10000 = 100 %).
+ */
+class Tarifas {
+public:
+    static constexpr int NIVELES = 4;          ///< Niveles de cliente (0 = General)
+    static constexpr int CATEGORIAS = 8;       ///< Categorías de producto (0 = General)
+    static constexpr int TRAMOS_VOLUMEN = 8;   ///< Máximo de tramos de descuento por volumen
+    static constexpr int32_t CIEN_POR_CIENTO = 10000;
+    static constexpr int32_t CANTIDAD_MAXIMA_TRAMO = 100000;
+
+    /// Descuento que se aplica desde 'desde' unidades en una línea
+    struct DescuentoVolumen {
+        int32_t desde;
+        int32_t descuento;     ///< Puntos básicos
+    };
+
+    /// Reglas editables; es lo que se guarda en tarifas.bin
+    struct Reglas {
+        std::array<int32_t, NIVELES * CATEGORIAS> descuentoNivel{};  ///< [nivel * CATEGORIAS + categoría]
+        std::array<int32_t, CATEGORIAS> iva{};
+        std::vector<DescuentoVolumen> volumen;                       ///< Ordenado por 'desde'
+        std::map<int, int> nivelCliente;                             ///< Sin entrada = nivel 0
+        std::map<int, int> categoriaProducto;                        ///< Sin entrada = categoría 0
+
+        static Reglas porDefecto();
+    };
+
+    /// Reglas compiladas en arreglos planos
+    class Tablas {
+    public:
+        /// Precio unitario antes de IVA con los descuentos de nivel, categoría y volumen
+        Dinero precioUnitario(const std::string& idCliente, const std::string& codigoProducto,
+                              int cantidad, Dinero precioLista) const;
+
+        /// IVA de un subtotal según la categoría del producto
+        Dinero iva(const std::string& codigoProducto, Dinero subtotal) const;
+
+        /// Descuento total en puntos básicos (sin pasar de 100 %)
+        int32_t descuento(int nivel, int categoria, int cantidad) const;
+
+        int nivelDe(const std::string& idCliente) const;
+        int categoriaDe(const std::string& codigoProducto) const;
+
+    private:
+        friend class Tarifas;
+        std::array<int32_t, NIVELES * CATEGORIAS> descuentoNivel{};
+        std::array<int32_t, CATEGORIAS> ivaCategoria{};
+        std::vector<int32_t> descuentoCantidad;   ///< Índice = cantidad; más allá del final vale el último
+        int primerCliente = 0;
+        std::vector<uint8_t> nivelPorCliente;     ///< Índice = ID - primerCliente
+        int primerProducto = 0;
+        std::vector<uint8_t> categoriaPorProducto;
+    };
+
+    /// Tablas vigentes (las carga de tarifas.bin la primera vez)
+    static std::shared_ptr<const Tablas> vigentes();
+
+    /// Atajos sobre vigentes()
+    static Dinero precioUnitario(const std::string& idCliente, const std::string& codigoProducto,
+                                 int cantidad, Dinero precioLista);
+    static Dinero iva(const std::string& codigoProducto, Dinero subtotal);
+
+    /// Copia de las reglas vigentes
+    static Reglas reglas();
+
+    /// Guarda las reglas en tarifas.bin y publica sus tablas
+    static bool guardar(const Reglas& nuevas);
+
+    /// ID numérico sin lanzar excepciones (se usa desde varios hilos); false si no es un entero
+    static bool aEntero(const std::string& texto, int& valor);
+
+    static const char* nombreNivel(int nivel);
+    static const char* nombreCategoria(int categoria);
+
+    /// Menú de tarifas (catálogos); los IDs se validan contra las listas cargadas
+    static void menuInteractivo(const std::vector<Clientes>& clientes, const std::vector<Producto>& productos);
+
+private:
+    struct Vigentes {
+        Reglas reglas;
+        std::shared_ptr<const Tablas> tablas;
+    };
+
+    static std::shared_ptr<const Vigentes> actual;   ///< Solo con atomic_load/atomic_store
+
+    static std::shared_ptr<const Vigentes> obtener();
+    static std::shared_ptr<const Tablas> compilar(const Reglas& reglas);
+    static bool leerArchivo(Reglas& reglas);
+    static bool escribirArchivo(const Reglas& reglas);
+    static void mostrarTablas(const Reglas& reglas);
+};
+
+#endif // TARIFAS_H
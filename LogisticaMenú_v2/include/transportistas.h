@@ -7,17 +7,57 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <ctime>
 
 class Transportistas{
 
 public:
+    // Franja horaria de trabajo [horaInicio, horaFin); cada franja es un viaje del vehículo
+    struct Franja {
+        int horaInicio = 0;
+        int horaFin = 0;
+    };
+
+    // Capacidad del vehículo por viaje y franjas diarias en que trabaja
+    struct Vehiculo {
+        std::string tipo;            // moto, pickup, panel, camion u otro (se elige al registrar)
+        int unidades = 0;            // Unidades de producto
+        double pesoKg = 0.0;
+        double volumenM3 = 0.0;
+        std::vector<Franja> franjas;
+    };
+
     std::string id;
     std::string nombre;
     std::string telefono;
-    std::string vehiculo;
+    std::string vehiculo;        // Descripción libre (marca, placa...)
     std::string disponibilidad;
+    Vehiculo especificacion;     // Se guarda a continuación de la disponibilidad
+
+    // Valores por omisión de un tipo de vehículo
+    static Vehiculo vehiculoDeTipo(const std::string& tipo);
+    // true si es uno de los tipos de Vehiculo::tipo
+    static bool esTipoVehiculo(const std::string& tipo);
+    // "8-12;13-17" <-> franjas; false si el texto no es válido
+    static bool leerFranjas(const std::string& texto, std::vector<Franja>& franjas);
+    static std::string textoFranjas(const std::vector<Franja>& franjas);
+
+    // Especificación de un transportista del registro en O(1); nullptr si no existe
+    static const Vehiculo* vehiculoDe(const std::string& id);
+
+    // Disponibles (opcionalmente de un tipo de vehículo, ver Vehiculo::tipo)
+    static std::vector<Transportistas> getTransportistasDisponibles(const std::string& tipo = "");
 
-    static std::vector<Transportistas> getTransportistasDisponibles();
+    // Registro en memoria de transportistas.bin. Se vuelve a leer solo si el archivo
+    // cambió (fecha de modificación, inodo o tamaño); si no, no toca el disco.
+    static const std::vector<Transportistas>& registro();
+    static bool disponibleEnRegistro(size_t posicion);
+    // Aumenta cada vez que el registro se recarga o se guarda
+    static unsigned long versionRegistro();
+
+    // true si la disponibilidad es "disponible" (sin distinguir mayúsculas ni espacios)
+    static bool estaDisponible(const Transportistas& t);
 
     // M todos est ticos
     static std::string generarIdUnico(const std::vector<Transportistas>& lista);
@@ -32,6 +72,31 @@ public:
     static void cargarDesdeArchivo(std::vector<Transportistas>& lista);
     static void guardarEnArchivo(const std::vector<Transportistas>& lista);
 
+private:
+    // Identifica una versión del archivo en disco
+    struct FirmaArchivo {
+        bool existe = false;
+        unsigned long long inodo = 0;
+        long long tamano = 0;
+        std::time_t modificado = 0;
+        long nanosegundos = 0;
+
+        bool operator==(const FirmaArchivo& otra) const;
+    };
+
+    static std::vector<Transportistas> cache;
+    static std::vector<bool> disponibles;                                        // Bitmap por posición
+    static std::unordered_map<std::string, std::vector<size_t>> indicePorTipo;   // Tipo de vehículo -> posiciones
+    static std::unordered_map<std::string, size_t> indicePorId;                  // ID -> posición
+    static FirmaArchivo firmaCache;
+    static bool cacheCargado;
+    static unsigned long version;
+
+    static FirmaArchivo firmaActual();
+    static void leerArchivo(std::vector<Transportistas>& lista);
+    static void asegurarRegistro();
+    static void reconstruirIndices();
+    static void pedirEspecificacion(Transportistas& t);
 };
 
 #endif // TRANSPORTISTAS_H
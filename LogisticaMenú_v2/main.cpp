@@ -12,8 +12,17 @@
 #include "transportistas.h"
 #include "globals.h"
 #include "Inventario.h"
+#include "abastecimiento.h"
+#include "rutas.h"
+#include "integridad.h"
+#include "facturacion.h"
+
+int main(int argc, char* argv[]) {
+    // Verificacin nocturna: revisa los archivos y sale sin iniciar sesin
+    if (argc > 1 && std::string(argv[1]) == "--verificar-integridad") {
+        return Integridad::verificarDesdeLineaDeComandos();
+    }
 
-int main() {
     std::cout << "Inicio del programa..." << std::endl;
 
     // Inicializar todas las listas necesarias
@@ -44,8 +53,18 @@ int main() {
     std::cout << "Cargando proveedores..." << std::endl;
     Proveedor::cargarDesdeArchivo(listaProveedores);
 
+    // Saldos de facturas para el control de crdito; despus Pagos los mantiene al da
+    std::cout << "Cargando saldos de facturas..." << std::endl;
+    Facturacion facturacion;
+    if (!facturacion.prepararPagos()) {
+        std::cerr << "Error: no se pudieron cargar los saldos de facturas." << std::endl;
+    }
+
     std::cout << "Datos cargados correctamente.\n";
 
+    // Distancias reales almacn-cliente segn coordenadas.txt
+    Abastecimiento::setFuncionDistancia(Rutas::distanciaAlmacenCliente);
+
     // Sistema de login
     if (usuarioRegistrado.loginUsuarios()) {
         std::cout << "Login exitoso.\n";
@@ -13,6 +13,9 @@
 #include <vector>
 #include "usuarios.h"
 #include "bitacora.h"
+#include "abastecimiento.h"
+#include "listaespera.h"
+#include "pedidos.h"
 #include <algorithm>
 #include <numeric>
 #include <cstring> // Para strncpy
@@ -320,7 +323,7 @@ void crearProductoInteractivo() {
         cin.clear();
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
     }
-    nuevo.setPrecio(precio);
+    nuevo.setPrecio(Dinero::deDecimal(precio));
 
     // Stock
     int stock;
@@ -587,8 +590,10 @@ vector<Inventario::ItemInventario> Inventario::cargarInventarioDesdeArchivo() {
     }
 
     try {
-        size_t numItems;
-        archivo.read(reinterpret_cast<char*>(&numItems), sizeof(numItems));
+        size_t numItems = 0;
+        if (!archivo.read(reinterpret_cast<char*>(&numItems), sizeof(numItems))) {
+            return inventario; // Archivo vacio
+        }
 
         inventario.resize(numItems);
 
@@ -607,6 +612,9 @@ vector<Inventario::ItemInventario> Inventario::cargarInventarioDesdeArchivo() {
             inventario[i].idAlmacen.resize(len);
             archivo.read(&inventario[i].idAlmacen[0], len);
         }
+        if (!archivo) {
+            throw runtime_error("Archivo de inventario incompleto");
+        }
     } catch (...) {
         cerr << "Error al leer archivo de inventario\n";
         inventario.clear();
@@ -615,16 +623,42 @@ vector<Inventario::ItemInventario> Inventario::cargarInventarioDesdeArchivo() {
     return inventario;
 }
 
+void Inventario::guardarInventarioEnArchivo(const vector<ItemInventario>& inventario) {
+    ofstream archivo("inventario.bin", ios::binary | ios::trunc);
+    if (!archivo) {
+        cerr << "Error al abrir el archivo de inventario para escritura.\n";
+        return;
+    }
+
+    size_t numItems = inventario.size();
+    archivo.write(reinterpret_cast<const char*>(&numItems), sizeof(numItems));
+
+    for (const auto& item : inventario) {
+        size_t len = item.idProducto.size();
+        archivo.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        archivo.write(item.idProducto.c_str(), len);
+
+        archivo.write(reinterpret_cast<const char*>(&item.cantidad), sizeof(item.cantidad));
+
+        len = item.idAlmacen.size();
+        archivo.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        archivo.write(item.idAlmacen.c_str(), len);
+    }
+    archivo.close();
+}
+
 void Inventario::registrarMercancias() {
     system("cls");
     cout << "\t\t========================================" << endl;
     cout << "\t\t| REGISTRAR MERCANCIA NUEVA            |" << endl;
     cout << "\t\t========================================" << endl;
 
-    // Cargar datos actualizados
-    vector<Producto> productos = cargarProductosDesdeArchivo();
-    vector<Almacen> almacenes = cargarAlmacenesDesdeArchivo();
-    vector<Proveedor> proveedores = cargarProveedoresDesdeArchivo();
+    // Cargar datos actualizados (mismos archivos que usan Pedidos y Almacen)
+    vector<Producto> productos;
+    Producto::cargarDesdeArchivoBin(productos);
+    vector<Almacen> almacenes;
+    Almacen::cargarDesdeArchivo(almacenes);
+    vector<ItemInventario> inventario = cargarInventarioDesdeArchivo();
 
     // Validar datos mínimos requeridos
     if (productos.empty()) {
@@ -642,17 +676,17 @@ void Inventario::registrarMercancias() {
     // Mostrar productos disponibles
     cout << "\n\t\tPRODUCTOS DISPONIBLES:\n";
     for (const auto& p : productos) {
-        cout << "\t\tID: " << p.getId() << " | Nombre: " << p.getNombre() << endl;
+        cout << "\t\tCodigo: " << p.getCodigo() << " | Nombre: " << p.getNombre() << endl;
     }
 
     // Selección de producto
-    string idProducto;
-    cout << "\t\tID del producto a registrar: ";
-    cin >> idProducto;
+    string codigoProducto;
+    cout << "\t\tCodigo del producto a registrar: ";
+    cin >> codigoProducto;
 
     // Buscar producto
     auto productoIt = find_if(productos.begin(), productos.end(),
-        [&idProducto](const Producto& p) { return p.getId() == idProducto; });
+        [&codigoProducto](const Producto& p) { return p.getCodigo() == codigoProducto; });
 
     if (productoIt == productos.end()) {
         cout << "\n\t\tError: Producto no encontrado." << endl;
@@ -663,7 +697,8 @@ void Inventario::registrarMercancias() {
     // Mostrar almacenes disponibles
     cout << "\n\t\tALMACENES DISPONIBLES:\n";
     for (const auto& a : almacenes) {
-        cout << "\t\tID: " << a.getId() << " | Nombre: " << a.getNombre() << endl;
+        cout << "\t\tID: " << a.getId() << " | Direccion: " << a.getDireccion()
+             << " | Estado: " << a.getEstado() << endl;
     }
 
     // Selección de almacén
@@ -690,35 +725,57 @@ void Inventario::registrarMercancias() {
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
     }
 
-    // Verificar espacio disponible
-    if (almacenIt->getEspacioDisponible() < cantidad) {
+    // Verificar espacio disponible (capacidad menos lo ya registrado en el almacén)
+    int ocupado = accumulate(inventario.begin(), inventario.end(), 0,
+        [&idAlmacen](int total, const ItemInventario& item) {
+            return item.idAlmacen == idAlmacen ? total + item.cantidad : total;
+        });
+    int espacioDisponible = almacenIt->getCapacidad() - ocupado;
+    if (espacioDisponible < cantidad) {
         cout << "\n\t\tError: Espacio insuficiente en el almacén." << endl;
-        cout << "\t\tEspacio disponible: " << almacenIt->getEspacioDisponible() << endl;
+        cout << "\t\tEspacio disponible: " << espacioDisponible << endl;
         system("pause");
         return;
     }
 
-    // Crear nuevo registro de inventario
-    ItemInventario nuevoRegistro;
-    nuevoRegistro.idProducto = idProducto;
-    nuevoRegistro.idAlmacen = idAlmacen;
-    nuevoRegistro.cantidad = cantidad;
-
-    // Actualizar registros
+    // Actualizar registros: stock global del producto y existencias del almacén
     productoIt->setStock(productoIt->getStock() + cantidad);
-    almacenIt->setEspacioDisponible(almacenIt->getEspacioDisponible() - cantidad);
-
-    // Guardar cambios
-    guardarProductosEnArchivo(productos);
-    guardarAlmacenesEnArchivo(almacenes);
-
-    // Aquí deberías implementar guardarInventarioEnArchivo(nuevoRegistro);
+    Producto::guardarEnArchivoBin(productos);
+
+    Abastecimiento::construirIndice(inventario, almacenes);
+    Abastecimiento::registrarEntrada(idAlmacen, codigoProducto, cantidad);
+
+    auditoria.registrar(usuarioRegistrado.getNombre(), "INVENTARIO",
+                        "Entrada " + codigoProducto + " x" + to_string(cantidad) + " en " + idAlmacen);
+
+    // Surtir primero las líneas en espera de este producto
+    vector<ListaEspera::Asignacion> asignaciones =
+        ListaEspera::asignarEntrada(codigoProducto, idAlmacen, cantidad, Pedidos::admiteReposicion);
+    int asignado = 0;
+    if (!asignaciones.empty()) {
+        Abastecimiento::Plan salida;
+        for (const auto& a : asignaciones) {
+            salida.asignaciones.push_back({a.idAlmacen, a.codigoProducto, a.cantidad});
+            asignado += a.cantidad;
+        }
+        Abastecimiento::confirmar(salida);
+        productoIt->setStock(productoIt->getStock() - asignado);
+        Producto::guardarEnArchivoBin(productos);
+        Pedidos::aplicarReposicion(asignaciones);
+    }
 
     // Mostrar resumen de la operación
     cout << "\n\t\tREGISTRO EXITOSO:" << endl;
-    cout << "\t\tProducto: " << productoIt->getNombre() << " (ID: " << productoIt->getId() << ")" << endl;
+    cout << "\t\tProducto: " << productoIt->getNombre() << " (Codigo: " << productoIt->getCodigo() << ")" << endl;
     cout << "\t\tCantidad registrada: " << cantidad << endl;
-    cout << "\t\tAlmacén destino: " << almacenIt->getNombre() << endl;
+    cout << "\t\tAlmacén destino: " << almacenIt->getId() << endl;
+    if (!asignaciones.empty()) {
+        cout << "\t\tAsignado a pedidos en espera: " << asignado << " unidades" << endl;
+        for (const auto& a : asignaciones) {
+            cout << "\t\t  Pedido " << a.idPedido << " (cliente " << a.idCliente << "): "
+                 << a.cantidad << endl;
+        }
+    }
 
     system("pause");
 }
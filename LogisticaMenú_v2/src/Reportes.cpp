@@ -1,5 +1,6 @@
 // 9959-24-11603 GABRIELA ESCOBAR
 #include "Reportes.h"
+#include "eventosenvios.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -212,7 +213,35 @@ void Reportes::informeVentas(bitacora& auditoria, const usuarios& usuario) {
     system("pause");
 }
 
-// Genera un analisis de tiempos de entrega
+// Dias con dos decimales a partir de segundos
+static string enDias(double segundos) {
+    stringstream texto;
+    texto << fixed << setprecision(2) << segundos / 86400.0;
+    return texto.str();
+}
+
+// Una fila de la tabla de tiempos: envios entregados, promedios en dias, retrasos y cancelados
+static void filaTiempos(stringstream& contenido, const string& nombre, const EventosEnvios::TiemposEntrega& t) {
+    contenido << "\t\t" << left << setw(14) << nombre
+              << right << setw(10) << t.pedidoAEntrega.cantidad
+              << setw(12) << enDias(t.pedidoADespacho.promedio())
+              << setw(12) << enDias(t.despachoAEntrega.promedio())
+              << setw(12) << enDias(t.pedidoAEntrega.promedio())
+              << setw(10) << t.retrasos
+              << setw(11) << t.cancelados << "\n";
+}
+
+static void encabezadoTiempos(stringstream& contenido, const string& grupo) {
+    contenido << "\t\t" << left << setw(14) << grupo
+              << right << setw(10) << "Entregas"
+              << setw(12) << "Ped->Desp"
+              << setw(12) << "Desp->Entr"
+              << setw(12) << "Total"
+              << setw(10) << "Retrasos"
+              << setw(11) << "Cancelados" << "\n";
+}
+
+// Genera un analisis de tiempos de entrega a partir del historial de envios
 void Reportes::analisisTiemposEntrega(bitacora& auditoria, const usuarios& usuario) {
     mostrarProcesando("Analizando tiempos de entrega");
 
@@ -222,10 +251,39 @@ void Reportes::analisisTiemposEntrega(bitacora& auditoria, const usuarios& usuar
     nuevoReporte.fechaGeneracion = time(nullptr);
 
     stringstream contenido;
+    EventosEnvios::Analisis analisis = EventosEnvios::analizar();
+    const EventosEnvios::TiemposEntrega& total = analisis.total;
+
     contenido << "\t\t=== ANALISIS DE TIEMPOS ===\n";
     contenido << "\t\tID: " << nuevoReporte.id << "\n";
-    contenido << "\t\tTiempo promedio: 2.3 dias\n";
-    contenido << "\t\tRetrasos: 5\n";
+    contenido << "\t\tFecha: " << ctime(&nuevoReporte.fechaGeneracion);
+    contenido << "\t\tEventos analizados: " << analisis.eventos << "\n";
+    if (total.pedidoAEntrega.cantidad == 0 && total.pedidoADespacho.cantidad == 0) {
+        contenido << "\t\tSin entregas registradas en el historial de envios.\n";
+    } else {
+        contenido << "\t\tPedido -> despacho: " << enDias(total.pedidoADespacho.promedio()) << " dias en promedio ("
+                  << total.pedidoADespacho.cantidad << " envios)\n";
+        contenido << "\t\tDespacho -> entrega: " << enDias(total.despachoAEntrega.promedio()) << " dias en promedio ("
+                  << total.despachoAEntrega.cantidad << " envios)\n";
+        contenido << "\t\tTiempo promedio: " << enDias(total.pedidoAEntrega.promedio()) << " dias (min "
+                  << enDias(total.pedidoAEntrega.minimo) << ", max " << enDias(total.pedidoAEntrega.maximo) << ")\n";
+        contenido << "\t\tRetrasos (mas de " << EventosEnvios::PLAZO_ENTREGA / 86400 << " dias): " << total.retrasos << "\n";
+    }
+    contenido << "\t\tEnvios en curso: " << analisis.enCurso << "\n";
+    if (analisis.descartados > 0) {
+        contenido << "\t\tRegistros danados omitidos: " << analisis.descartados << "\n";
+    }
+
+    if (!analisis.porTransportista.empty()) {
+        contenido << "\n\t\t--- Por transportista (dias) ---\n";
+        encabezadoTiempos(contenido, "Transportista");
+        for (const auto& par : analisis.porTransportista) filaTiempos(contenido, par.first, par.second);
+    }
+    if (!analisis.porAlmacen.empty()) {
+        contenido << "\n\t\t--- Por almacen (dias) ---\n";
+        encabezadoTiempos(contenido, "Almacen");
+        for (const auto& par : analisis.porAlmacen) filaTiempos(contenido, par.first, par.second);
+    }
 
     nuevoReporte.contenido = contenido.str();
     listaReportes.push_back(nuevoReporte);
@@ -0,0 +1,255 @@
+#include "abastecimiento.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+// Definicion de los miembros estaticos del indice
+vector<string> Abastecimiento::idsAlmacen;
+unordered_map<string, size_t> Abastecimiento::columnaAlmacen;
+unordered_map<string, size_t> Abastecimiento::filaProducto;
+vector<int> Abastecimiento::existencias;
+vector<int> Abastecimiento::totalProducto;
+vector<Inventario::ItemInventario> Abastecimiento::inventario;
+unordered_map<string, size_t> Abastecimiento::posicionInventario;
+Abastecimiento::FuncionDistancia Abastecimiento::distancia;
+
+// Clave de un registro consolidado de inventario
+static string claveInventario(const string& codigoProducto, const string& idAlmacen) {
+    return codigoProducto + "|" + idAlmacen;
+}
+
+// Construye el indice denso producto x almacen operativo
+// Los registros repetidos de un mismo producto y almacen se consolidan en uno
+void Abastecimiento::construirIndice(const vector<Inventario::ItemInventario>& items,
+                                     const vector<Almacen>& almacenes) {
+    idsAlmacen.clear();
+    columnaAlmacen.clear();
+    filaProducto.clear();
+    existencias.clear();
+    totalProducto.clear();
+    inventario.clear();
+    posicionInventario.clear();
+
+    for (const auto& almacen : almacenes) {
+        if (almacen.getEstado() != "operativo") continue;
+        if (idsAlmacen.size() >= MAX_ALMACENES) break;
+        if (columnaAlmacen.count(almacen.getId())) continue;
+        columnaAlmacen[almacen.getId()] = idsAlmacen.size();
+        idsAlmacen.push_back(almacen.getId());
+    }
+
+    for (const auto& item : items) {
+        string clave = claveInventario(item.idProducto, item.idAlmacen);
+        auto pos = posicionInventario.find(clave);
+        if (pos == posicionInventario.end()) {
+            posicionInventario[clave] = inventario.size();
+            inventario.push_back(item);
+        } else {
+            inventario[pos->second].cantidad += item.cantidad;
+        }
+    }
+
+    for (const auto& item : inventario) {
+        auto columna = columnaAlmacen.find(item.idAlmacen);
+        if (columna == columnaAlmacen.end() || item.cantidad <= 0) continue;
+
+        auto fila = filaProducto.find(item.idProducto);
+        size_t f;
+        if (fila == filaProducto.end()) {
+            f = totalProducto.size();
+            filaProducto[item.idProducto] = f;
+            totalProducto.push_back(0);
+            existencias.resize(existencias.size() + idsAlmacen.size(), 0);
+        } else {
+            f = fila->second;
+        }
+        existencias[f * idsAlmacen.size() + columna->second] += item.cantidad;
+        totalProducto[f] += item.cantidad;
+    }
+}
+
+// Indica si hay existencias por almacen que permitan elegir el origen automaticamente
+bool Abastecimiento::indiceDisponible() {
+    return !idsAlmacen.empty() && !filaProducto.empty();
+}
+
+// Unidades de un producto en todos los almacenes operativos
+int Abastecimiento::disponibleTotal(const string& codigoProducto) {
+    auto fila = filaProducto.find(codigoProducto);
+    return fila == filaProducto.end() ? 0 : totalProducto[fila->second];
+}
+
+// Unidades de un producto en un almacen operativo
+int Abastecimiento::disponibleEnAlmacen(const string& idAlmacen, const string& codigoProducto) {
+    auto fila = filaProducto.find(codigoProducto);
+    auto columna = columnaAlmacen.find(idAlmacen);
+    if (fila == filaProducto.end() || columna == columnaAlmacen.end()) return 0;
+    return existencias[fila->second * idsAlmacen.size() + columna->second];
+}
+
+// Distancia de un almacen al cliente; 0 si no hay criterio configurado
+double Abastecimiento::distanciaA(size_t columna, const string& idCliente) {
+    return distancia ? distancia(idsAlmacen[columna], idCliente) : 0.0;
+}
+
+// Decide el origen de cada linea del pedido
+Abastecimiento::Plan Abastecimiento::planificar(const vector<LineaSolicitada>& lineas, const string& idCliente) {
+    Plan plan;
+    const size_t columnas = idsAlmacen.size();
+
+    // Consolidar lineas repetidas del mismo producto
+    vector<LineaSolicitada> pedido;
+    unordered_map<string, size_t> posicion;
+    for (const auto& linea : lineas) {
+        if (linea.cantidad <= 0) continue;
+        auto it = posicion.find(linea.codigoProducto);
+        if (it == posicion.end()) {
+            posicion[linea.codigoProducto] = pedido.size();
+            pedido.push_back(linea);
+        } else {
+            pedido[it->second].cantidad += linea.cantidad;
+        }
+    }
+    if (pedido.empty()) {
+        plan.completo = true;
+        return plan;
+    }
+
+    // Fila de cada linea y almacenes que pueden surtir todo el pedido
+    const size_t SIN_FILA = numeric_limits<size_t>::max();
+    vector<size_t> filas(pedido.size(), SIN_FILA);
+    uint64_t candidatos = columnas == 64 ? ~0ULL : ((1ULL << columnas) - 1);
+
+    for (size_t i = 0; i < pedido.size(); ++i) {
+        auto fila = filaProducto.find(pedido[i].codigoProducto);
+        if (fila == filaProducto.end()) {
+            candidatos = 0;
+            continue;
+        }
+        filas[i] = fila->second;
+        const int* existenciasFila = &existencias[fila->second * columnas];
+        uint64_t cubre = 0;
+        for (size_t c = 0; c < columnas; ++c) {
+            if (existenciasFila[c] >= pedido[i].cantidad) cubre |= (1ULL << c);
+        }
+        candidatos &= cubre;
+    }
+
+    // Caso ideal: un solo almacen cubre todo, se elige el mas cercano
+    if (candidatos != 0) {
+        size_t mejor = SIN_FILA;
+        double mejorDistancia = 0.0;
+        for (size_t c = 0; c < columnas; ++c) {
+            if (!(candidatos & (1ULL << c))) continue;
+            double d = distanciaA(c, idCliente);
+            if (mejor == SIN_FILA || d < mejorDistancia) {
+                mejor = c;
+                mejorDistancia = d;
+            }
+        }
+        plan.almacenes.push_back(idsAlmacen[mejor]);
+        for (const auto& linea : pedido) {
+            plan.asignaciones.push_back({idsAlmacen[mejor], linea.codigoProducto, linea.cantidad});
+        }
+        plan.completo = true;
+        return plan;
+    }
+
+    // Division: cada ronda toma el almacen que cubre mas unidades pendientes
+    vector<int> pendiente(pedido.size());
+    for (size_t i = 0; i < pedido.size(); ++i) pendiente[i] = pedido[i].cantidad;
+    uint64_t usados = 0;
+
+    while (true) {
+        size_t mejor = SIN_FILA;
+        long mejorUnidades = 0;
+        double mejorDistancia = 0.0;
+
+        for (size_t c = 0; c < columnas; ++c) {
+            if (usados & (1ULL << c)) continue;
+            long unidades = 0;
+            for (size_t i = 0; i < pedido.size(); ++i) {
+                if (filas[i] == SIN_FILA || pendiente[i] == 0) continue;
+                unidades += min(pendiente[i], existencias[filas[i] * columnas + c]);
+            }
+            if (unidades == 0) continue;
+            double d = distanciaA(c, idCliente);
+            if (unidades > mejorUnidades || (unidades == mejorUnidades && d < mejorDistancia)) {
+                mejor = c;
+                mejorUnidades = unidades;
+                mejorDistancia = d;
+            }
+        }
+        if (mejor == SIN_FILA) break;
+
+        usados |= (1ULL << mejor);
+        plan.almacenes.push_back(idsAlmacen[mejor]);
+        for (size_t i = 0; i < pedido.size(); ++i) {
+            if (filas[i] == SIN_FILA || pendiente[i] == 0) continue;
+            int toma = min(pendiente[i], existencias[filas[i] * columnas + mejor]);
+            if (toma <= 0) continue;
+            plan.asignaciones.push_back({idsAlmacen[mejor], pedido[i].codigoProducto, toma});
+            pendiente[i] -= toma;
+        }
+    }
+
+    for (size_t i = 0; i < pedido.size(); ++i) {
+        if (pendiente[i] > 0) {
+            plan.faltantes.push_back({pedido[i].codigoProducto, pendiente[i]});
+        }
+    }
+    plan.completo = plan.faltantes.empty();
+    return plan;
+}
+
+// Suma (o resta) unidades en el indice y en el inventario consolidado
+void Abastecimiento::ajustar(const string& idAlmacen, const string& codigoProducto, int delta) {
+    string clave = claveInventario(codigoProducto, idAlmacen);
+    auto pos = posicionInventario.find(clave);
+    if (pos == posicionInventario.end()) {
+        Inventario::ItemInventario item;
+        item.idProducto = codigoProducto;
+        item.idAlmacen = idAlmacen;
+        item.cantidad = 0;
+        posicionInventario[clave] = inventario.size();
+        inventario.push_back(item);
+        pos = posicionInventario.find(clave);
+    }
+    inventario[pos->second].cantidad += delta;
+
+    auto columna = columnaAlmacen.find(idAlmacen);
+    if (columna == columnaAlmacen.end()) return;
+
+    auto fila = filaProducto.find(codigoProducto);
+    size_t f;
+    if (fila == filaProducto.end()) {
+        f = totalProducto.size();
+        filaProducto[codigoProducto] = f;
+        totalProducto.push_back(0);
+        existencias.resize(existencias.size() + idsAlmacen.size(), 0);
+    } else {
+        f = fila->second;
+    }
+    existencias[f * idsAlmacen.size() + columna->second] += delta;
+    totalProducto[f] += delta;
+}
+
+// Descuenta lo asignado en el plan y guarda el inventario una sola vez
+void Abastecimiento::confirmar(const Plan& plan) {
+    for (const auto& asignacion : plan.asignaciones) {
+        ajustar(asignacion.idAlmacen, asignacion.codigoProducto, -asignacion.cantidad);
+    }
+    Inventario::guardarInventarioEnArchivo(inventario);
+}
+
+// Registra mercancia recibida en un almacen
+void Abastecimiento::registrarEntrada(const string& idAlmacen, const string& codigoProducto, int cantidad) {
+    ajustar(idAlmacen, codigoProducto, cantidad);
+    Inventario::guardarInventarioEnArchivo(inventario);
+}
+
+// Cambia la funcion de distancia usada como desempate
+void Abastecimiento::setFuncionDistancia(FuncionDistancia funcion) {
+    distancia = funcion;
+}
@@ -0,0 +1,174 @@
+#include "antiguedad.h"
+
+using namespace std;
+
+const int64_t SEGUNDOS_POR_DIA = 24 * 60 * 60;
+
+// Último día (desde el vencimiento) de cada tramo salvo el último
+const int64_t LIMITE_TRAMO[Antiguedad::TRAMOS - 1] = {30, 60, 90};
+
+mutex Antiguedad::mutexTramos;
+bool Antiguedad::cargada = false;
+int64_t Antiguedad::diaActual = 0;
+unordered_map<int, Antiguedad::Item> Antiguedad::items;
+unordered_map<int, Antiguedad::Tramos> Antiguedad::tramosPorCliente;
+Antiguedad::Tramos Antiguedad::tramosTotales;
+vector<vector<Antiguedad::Evento>> Antiguedad::rueda(Antiguedad::RANURAS);
+multimap<int64_t, int> Antiguedad::lejanos;
+
+Dinero Antiguedad::Tramos::total() const {
+    Dinero suma;
+    for (const auto& parte : importe) suma += parte;
+    return suma;
+}
+
+const char* Antiguedad::nombreTramo(int tramo) {
+    static const char* nombres[TRAMOS] = {"0-30", "31-60", "61-90", "90+"};
+    return tramo >= 0 && tramo < TRAMOS ? nombres[tramo] : "?";
+}
+
+// Días completos desde 1970 (UTC); redondea hacia abajo también antes de 1970
+int64_t Antiguedad::diaDe(time_t fecha) {
+    int64_t segundos = static_cast<int64_t>(fecha);
+    return segundos >= 0 ? segundos / SEGUNDOS_POR_DIA : -((-segundos + SEGUNDOS_POR_DIA - 1) / SEGUNDOS_POR_DIA);
+}
+
+int Antiguedad::tramoDe(int64_t diasVencida) {
+    int tramo = 0;
+    while (tramo < TRAMOS - 1 && diasVencida > LIMITE_TRAMO[tramo]) tramo++;
+    return tramo;
+}
+
+// Día en que la factura pasa al tramo siguiente (-1 si ya está en el último)
+int64_t Antiguedad::proximoCruce(const Item& item) {
+    if (item.tramo >= TRAMOS - 1) return -1;
+    return item.diaVencimiento + LIMITE_TRAMO[item.tramo] + 1;
+}
+
+void Antiguedad::programar(int idFactura, int64_t dia) {
+    if (dia < 0) return;
+    if (dia - diaActual < RANURAS) {
+        rueda[static_cast<size_t>(dia % RANURAS)].push_back({idFactura, dia});
+    } else {
+        lejanos.emplace(dia, idFactura);
+    }
+}
+
+void Antiguedad::sumar(const Item& item, int signo) {
+    Tramos& cliente = tramosPorCliente[item.idCliente];
+    cliente.importe[item.tramo] += item.importe * signo;
+    cliente.facturas[item.tramo] += signo;
+    tramosTotales.importe[item.tramo] += item.importe * signo;
+    tramosTotales.facturas[item.tramo] += signo;
+    // Cliente sin facturas abiertas: deja de aparecer en porCliente()
+    bool vacio = true;
+    for (size_t cantidad : cliente.facturas) vacio = vacio && cantidad == 0;
+    if (vacio) tramosPorCliente.erase(item.idCliente);
+}
+
+void Antiguedad::agregarSinBloqueo(const Factura& factura) {
+    if (factura.pagada || factura.eliminada || items.count(factura.idFactura)) return;
+
+    Item item;
+    item.idCliente = factura.idCliente;
+    item.importe = factura.importe;
+    item.diaVencimiento = diaDe(static_cast<time_t>(factura.fechaVencimiento));
+    item.tramo = tramoDe(diaActual - item.diaVencimiento);
+    items[factura.idFactura] = item;
+    sumar(item, 1);
+    programar(factura.idFactura, proximoCruce(item));
+}
+
+void Antiguedad::reiniciar(const vector<Factura>& facturas, time_t hoy) {
+    lock_guard<mutex> bloqueo(mutexTramos);
+    items.clear();
+    tramosPorCliente.clear();
+    tramosTotales = Tramos();
+    for (auto& ranura : rueda) ranura.clear();
+    lejanos.clear();
+
+    diaActual = diaDe(hoy);
+    items.reserve(facturas.size());
+    for (const auto& factura : facturas) agregarSinBloqueo(factura);
+    cargada = true;
+}
+
+bool Antiguedad::iniciada() {
+    lock_guard<mutex> bloqueo(mutexTramos);
+    return cargada;
+}
+
+void Antiguedad::agregar(const Factura& factura) {
+    lock_guard<mutex> bloqueo(mutexTramos);
+    if (cargada) agregarSinBloqueo(factura);
+}
+
+// Los eventos que quedan en la rueda se descartan al vencer (la factura ya no está)
+void Antiguedad::quitar(int idFactura) {
+    lock_guard<mutex> bloqueo(mutexTramos);
+    auto it = items.find(idFactura);
+    if (it == items.end()) return;
+    sumar(it->second, -1);
+    items.erase(it);
+}
+
+void Antiguedad::ajustar(int idFactura, Dinero saldo) {
+    lock_guard<mutex> bloqueo(mutexTramos);
+    auto it = items.find(idFactura);
+    if (it == items.end()) return;
+    sumar(it->second, -1);
+    if (saldo <= Dinero()) {
+        items.erase(it);
+        return;
+    }
+    it->second.importe = saldo;
+    sumar(it->second, 1);
+}
+
+void Antiguedad::avanzarSinBloqueo(int64_t dia) {
+    while (diaActual < dia) {
+        diaActual++;
+
+        // Cruces lejanos que ahora entran en la rueda
+        while (!lejanos.empty() && lejanos.begin()->first - diaActual < RANURAS) {
+            Evento evento{lejanos.begin()->second, lejanos.begin()->first};
+            lejanos.erase(lejanos.begin());
+            rueda[static_cast<size_t>(evento.dia % RANURAS)].push_back(evento);
+        }
+
+        vector<Evento> vencen;
+        vencen.swap(rueda[static_cast<size_t>(diaActual % RANURAS)]);
+        for (const auto& evento : vencen) {
+            auto it = items.find(evento.idFactura);
+            // Factura quitada, o evento repetido de una factura que se volvió a agregar
+            if (it == items.end() || proximoCruce(it->second) != diaActual) continue;
+
+            Item& item = it->second;
+            sumar(item, -1);
+            item.tramo = tramoDe(diaActual - item.diaVencimiento);
+            sumar(item, 1);
+            programar(evento.idFactura, proximoCruce(item));
+        }
+    }
+}
+
+void Antiguedad::avanzarHasta(time_t hoy) {
+    lock_guard<mutex> bloqueo(mutexTramos);
+    if (cargada) avanzarSinBloqueo(diaDe(hoy));
+}
+
+Antiguedad::Tramos Antiguedad::totales() {
+    lock_guard<mutex> bloqueo(mutexTramos);
+    return tramosTotales;
+}
+
+Antiguedad::Tramos Antiguedad::deCliente(int idCliente) {
+    lock_guard<mutex> bloqueo(mutexTramos);
+    auto it = tramosPorCliente.find(idCliente);
+    return it != tramosPorCliente.end() ? it->second : Tramos();
+}
+
+vector<pair<int, Antiguedad::Tramos>> Antiguedad::porCliente() {
+    lock_guard<mutex> bloqueo(mutexTramos);
+    return vector<pair<int, Tramos>>(tramosPorCliente.begin(), tramosPorCliente.end());
+}
@@ -0,0 +1,694 @@
+#include "archivador.h"
+#include "eventosenvios.h"
+#include "compresion.h"
+#include "crc32.h"
+#include "bitacora.h"
+#include "usuarios.h"
+#include "facturacion.h"
+
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <unordered_set>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+using namespace std;
+
+extern usuarios usuarioRegistrado;
+extern bitacora auditoria;
+
+// ----------- Formato de los archivos del histórico ------------
+
+const char* const DIRECTORIO_HISTORICO = "historico";
+const char* const ARCHIVO_INDICE = "historico/indice.bin";
+const char* const ARCHIVO_CLIENTES = "historico/clientes.bin";
+const char FIRMA_INDICE[4] = {'A', 'I', 'D', 'X'};
+const char FIRMA_CLIENTES[4] = {'A', 'C', 'L', 'I'};
+const char FIRMA_SEGMENTO[4] = {'S', 'E', 'G', 'M'};
+const uint32_t VERSION_HISTORICO = 1;
+
+// Segmentos descomprimidos que se conservan en memoria
+const size_t SEGMENTOS_EN_CACHE = 8;
+
+/**
+ * @brief Cabecera de un segmento comprimido (24 bytes); le siguen los datos comprimidos.
+ */
+struct CabeceraSegmento {
+    char firma[4];           ///< "SEGM"
+    uint32_t cantidad;       ///< Registros del segmento
+    uint32_t tamOriginal;    ///< Bytes sin comprimir
+    uint32_t tamComprimido;
+    uint32_t crc;            ///< CRC-32 de los datos comprimidos
+    uint32_t reservado;
+};
+
+/**
+ * @brief Cabecera de indice.bin (24 bytes).
+ */
+struct CabeceraIndice {
+    char firma[4];           ///< "AIDX"
+    uint32_t version;
+    uint32_t tamRegistro;
+    uint32_t crc;            ///< CRC-32 de todos los registros
+    uint64_t cantidad;
+};
+
+/**
+ * @brief Entrada del índice en disco (32 bytes).
+ */
+struct RegistroIndice {
+    char clave[16];
+    uint8_t tipo;
+    uint8_t reservado[3];
+    int32_t particion;
+    uint64_t desplazamiento;
+};
+
+/**
+ * @brief Cabecera de clientes.bin (16 bytes).
+ */
+struct CabeceraClientes {
+    char firma[4];           ///< "ACLI"
+    uint32_t version;
+    uint32_t tamRegistro;
+    uint32_t cantidad;
+};
+
+/**
+ * @brief Acumulados archivados de un cliente (32 bytes).
+ */
+struct RegistroCliente {
+    char idCliente[16];
+    int32_t cantidadPedidos;
+    int32_t reservado;
+    double valorHistorico;
+};
+
+// Copia un texto a un campo de tamaño fijo (siempre termina en '\0')
+static void copiarCampo(char* destino, size_t tam, const string& origen) {
+    memset(destino, 0, tam);
+    strncpy(destino, origen.c_str(), tam - 1);
+}
+
+// Lee un campo de tamaño fijo aunque no termine en '\0'
+static string leerCampo(const char* origen, size_t tam) {
+    return string(origen, strnlen(origen, tam));
+}
+
+// Texto con su longitud (32 bits) delante
+static void escribirTexto(ostream& salida, const string& texto) {
+    uint32_t tam = static_cast<uint32_t>(texto.size());
+    salida.write(reinterpret_cast<const char*>(&tam), sizeof(tam));
+    salida.write(texto.data(), tam);
+}
+
+static bool leerTexto(istream& entrada, string& texto) {
+    uint32_t tam = 0;
+    if (!entrada.read(reinterpret_cast<char*>(&tam), sizeof(tam)) || tam > (1u << 20)) return false;
+    texto.resize(tam);
+    return tam == 0 || static_cast<bool>(entrada.read(&texto[0], tam));
+}
+
+static void escribirEnvio(ostream& salida, const Envio& envio) {
+    escribirTexto(salida, envio.idEnvio);
+    escribirTexto(salida, envio.idPedido);
+    escribirTexto(salida, envio.idTransportista);
+    escribirTexto(salida, envio.idCliente);
+    escribirTexto(salida, envio.estado);
+}
+
+static bool leerEnvio(istream& entrada, Envio& envio) {
+    return leerTexto(entrada, envio.idEnvio) && leerTexto(entrada, envio.idPedido) &&
+           leerTexto(entrada, envio.idTransportista) && leerTexto(entrada, envio.idCliente) &&
+           leerTexto(entrada, envio.estado);
+}
+
+// AAAAMM del mes (hora local) de una fecha
+static int32_t particionDe(time_t fecha) {
+    tm local = *localtime(&fecha);
+    return (local.tm_year + 1900) * 100 + (local.tm_mon + 1);
+}
+
+static bool crearDirectorio(const char* ruta) {
+#ifdef _WIN32
+    _mkdir(ruta);
+#else
+    mkdir(ruta, 0755);
+#endif
+    struct stat info;
+    return stat(ruta, &info) == 0 && (info.st_mode & S_IFDIR);
+}
+
+// Reemplaza 'destino' por 'temporal' (en Windows rename no sobrescribe)
+static bool reemplazarArchivo(const string& temporal, const string& destino) {
+    remove(destino.c_str());
+    return rename(temporal.c_str(), destino.c_str()) == 0;
+}
+
+static bool pedidoCerrado(const string& estado) {
+    return estado == "entregado" || estado == "cancelado" || estado == "completado";
+}
+
+static bool envioCerrado(const string& estado) {
+    return estado == "entregado" || estado == "Cancelado";
+}
+
+// Definicion de los miembros estaticos
+vector<Archivador::Entrada> Archivador::indice;
+bool Archivador::indiceCargado = false;
+unordered_map<string, Pedidos::AgregadosCliente> Archivador::agregados;
+bool Archivador::agregadosCargados = false;
+vector<pair<string, shared_ptr<const Archivador::Segmento>>> Archivador::segmentosRecientes;
+
+// ----------- Índice ------------
+
+bool Archivador::Entrada::operator<(const Entrada& otra) const {
+    if (tipo != otra.tipo) return tipo < otra.tipo;
+    if (clave != otra.clave) return clave < otra.clave;
+    if (particion != otra.particion) return particion < otra.particion;
+    return desplazamiento < otra.desplazamiento;
+}
+
+bool Archivador::Entrada::operator==(const Entrada& otra) const {
+    return tipo == otra.tipo && clave == otra.clave && particion == otra.particion &&
+           desplazamiento == otra.desplazamiento;
+}
+
+// Lee indice.bin completo; si falta o está dañado, el histórico se considera vacío
+void Archivador::asegurarIndice() {
+    if (indiceCargado) return;
+    indiceCargado = true;
+    indice.clear();
+
+    ifstream archivo(ARCHIVO_INDICE, ios::binary);
+    if (!archivo) return;
+
+    CabeceraIndice cabecera;
+    if (!archivo.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera)) ||
+        memcmp(cabecera.firma, FIRMA_INDICE, sizeof(cabecera.firma)) != 0 ||
+        cabecera.tamRegistro != sizeof(RegistroIndice)) {
+        cerr << "\n\tError: la cabecera de " << ARCHIVO_INDICE << " no es válida.\n";
+        return;
+    }
+
+    vector<RegistroIndice> registros(cabecera.cantidad);
+    if (!archivo.read(reinterpret_cast<char*>(registros.data()), registros.size() * sizeof(RegistroIndice)) ||
+        calcularCrc32(registros.data(), registros.size() * sizeof(RegistroIndice)) != cabecera.crc) {
+        cerr << "\n\tError: " << ARCHIVO_INDICE << " está dañado; el histórico no se puede consultar.\n";
+        return;
+    }
+
+    indice.reserve(registros.size());
+    for (const auto& r : registros) {
+        Entrada e;
+        e.clave = leerCampo(r.clave, sizeof(r.clave));
+        e.tipo = r.tipo;
+        e.particion = r.particion;
+        e.desplazamiento = r.desplazamiento;
+        indice.push_back(e);
+    }
+    sort(indice.begin(), indice.end());
+}
+
+// Entradas de una clave, de la más antigua a la más reciente
+vector<Archivador::Entrada> Archivador::buscarEntradas(uint8_t tipo, const string& clave) {
+    asegurarIndice();
+    Entrada desde;
+    desde.tipo = tipo;
+    desde.clave = clave;
+    auto it = lower_bound(indice.begin(), indice.end(), desde);
+    vector<Entrada> resultado;
+    for (; it != indice.end() && it->tipo == tipo && it->clave == clave; ++it) resultado.push_back(*it);
+    return resultado;
+}
+
+bool Archivador::escribirIndice(const vector<Entrada>& entradas) {
+    vector<RegistroIndice> registros(entradas.size());
+    for (size_t i = 0; i < entradas.size(); ++i) {
+        RegistroIndice& r = registros[i];
+        memset(&r, 0, sizeof(r));
+        copiarCampo(r.clave, sizeof(r.clave), entradas[i].clave);
+        r.tipo = entradas[i].tipo;
+        r.particion = entradas[i].particion;
+        r.desplazamiento = entradas[i].desplazamiento;
+    }
+
+    CabeceraIndice cabecera;
+    memset(&cabecera, 0, sizeof(cabecera));
+    memcpy(cabecera.firma, FIRMA_INDICE, sizeof(cabecera.firma));
+    cabecera.version = VERSION_HISTORICO;
+    cabecera.tamRegistro = sizeof(RegistroIndice);
+    cabecera.crc = calcularCrc32(registros.data(), registros.size() * sizeof(RegistroIndice));
+    cabecera.cantidad = registros.size();
+
+    string temporal = string(ARCHIVO_INDICE) + ".tmp";
+    {
+        ofstream archivo(temporal, ios::binary | ios::trunc);
+        archivo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+        archivo.write(reinterpret_cast<const char*>(registros.data()), registros.size() * sizeof(RegistroIndice));
+        if (!archivo.flush()) return false;
+    }
+    return reemplazarArchivo(temporal, ARCHIVO_INDICE);
+}
+
+// ----------- Acumulados por cliente ------------
+
+const unordered_map<string, Pedidos::AgregadosCliente>& Archivador::agregadosArchivados() {
+    if (agregadosCargados) return agregados;
+    agregadosCargados = true;
+    agregados.clear();
+
+    ifstream archivo(ARCHIVO_CLIENTES, ios::binary);
+    if (!archivo) return agregados;
+
+    CabeceraClientes cabecera;
+    if (!archivo.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera)) ||
+        memcmp(cabecera.firma, FIRMA_CLIENTES, sizeof(cabecera.firma)) != 0 ||
+        cabecera.tamRegistro != sizeof(RegistroCliente)) {
+        cerr << "\n\tError: la cabecera de " << ARCHIVO_CLIENTES << " no es válida.\n";
+        return agregados;
+    }
+
+    RegistroCliente r;
+    for (uint32_t i = 0; i < cabecera.cantidad && archivo.read(reinterpret_cast<char*>(&r), sizeof(r)); ++i) {
+        Pedidos::AgregadosCliente& a = agregados[leerCampo(r.idCliente, sizeof(r.idCliente))];
+        a.cantidadPedidos = r.cantidadPedidos;
+        a.valorHistorico = Dinero::deDecimal(r.valorHistorico);
+    }
+    return agregados;
+}
+
+bool Archivador::escribirAgregados(const unordered_map<string, Pedidos::AgregadosCliente>& datos) {
+    CabeceraClientes cabecera;
+    memset(&cabecera, 0, sizeof(cabecera));
+    memcpy(cabecera.firma, FIRMA_CLIENTES, sizeof(cabecera.firma));
+    cabecera.version = VERSION_HISTORICO;
+    cabecera.tamRegistro = sizeof(RegistroCliente);
+    cabecera.cantidad = static_cast<uint32_t>(datos.size());
+
+    string temporal = string(ARCHIVO_CLIENTES) + ".tmp";
+    {
+        ofstream archivo(temporal, ios::binary | ios::trunc);
+        archivo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+        for (const auto& par : datos) {
+            RegistroCliente r;
+            memset(&r, 0, sizeof(r));
+            copiarCampo(r.idCliente, sizeof(r.idCliente), par.first);
+            r.cantidadPedidos = par.second.cantidadPedidos;
+            r.valorHistorico = par.second.valorHistorico.aDecimal();
+            archivo.write(reinterpret_cast<const char*>(&r), sizeof(r));
+        }
+        if (!archivo.flush()) return false;
+    }
+    return reemplazarArchivo(temporal, ARCHIVO_CLIENTES);
+}
+
+// ----------- Segmentos ------------
+
+string Archivador::rutaParticion(uint8_t tipo, int32_t particion) {
+    ostringstream ruta;
+    ruta << DIRECTORIO_HISTORICO << "/" << (tipo == PEDIDO ? "pedidos_" : "envios_")
+         << particion / 100 << "-" << setw(2) << setfill('0') << particion % 100 << ".lz";
+    return ruta.str();
+}
+
+// Lee, verifica y descomprime un segmento; los últimos leídos se sirven desde memoria
+shared_ptr<const Archivador::Segmento> Archivador::leerSegmento(uint8_t tipo, int32_t particion,
+                                                                  uint64_t desplazamiento) {
+    string ruta = rutaParticion(tipo, particion);
+    string clave = ruta + "@" + to_string(desplazamiento);
+    for (size_t i = 0; i < segmentosRecientes.size(); ++i) {
+        if (segmentosRecientes[i].first == clave) {
+            rotate(segmentosRecientes.begin(), segmentosRecientes.begin() + i, segmentosRecientes.begin() + i + 1);
+            return segmentosRecientes.front().second;
+        }
+    }
+
+    ifstream archivo(ruta, ios::binary);
+    CabeceraSegmento cabecera;
+    if (!archivo || !archivo.seekg(static_cast<streamoff>(desplazamiento)) ||
+        !archivo.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera)) ||
+        memcmp(cabecera.firma, FIRMA_SEGMENTO, sizeof(cabecera.firma)) != 0) {
+        cerr << "\n\tError: no se pudo leer el segmento " << clave << ".\n";
+        return nullptr;
+    }
+
+    string comprimido(cabecera.tamComprimido, '\0');
+    string datos;
+    if (!archivo.read(&comprimido[0], comprimido.size()) ||
+        calcularCrc32(comprimido.data(), comprimido.size()) != cabecera.crc ||
+        !descomprimirLZ(comprimido, cabecera.tamOriginal, datos)) {
+        cerr << "\n\tError: el segmento " << clave << " está dañado.\n";
+        return nullptr;
+    }
+
+    auto segmento = make_shared<Segmento>();
+    istringstream entrada(datos);
+    for (uint32_t i = 0; i < cabecera.cantidad; ++i) {
+        if (tipo == PEDIDO) {
+            Pedidos pedido;
+            if (!Pedidos::leerPedido(entrada, pedido)) break;
+            segmento->pedidos.push_back(pedido);
+        } else {
+            Envio envio;
+            if (!leerEnvio(entrada, envio)) break;
+            segmento->envios.push_back(envio);
+        }
+    }
+
+    segmentosRecientes.insert(segmentosRecientes.begin(), {clave, segmento});
+    if (segmentosRecientes.size() > SEGMENTOS_EN_CACHE) segmentosRecientes.pop_back();
+    return segmento;
+}
+
+// ----------- Consultas ------------
+
+bool Archivador::buscarPedido(const string& idPedido, Pedidos& pedido) {
+    vector<Entrada> entradas = buscarEntradas(PEDIDO, idPedido);
+    if (entradas.empty()) return false;
+    shared_ptr<const Segmento> segmento = leerSegmento(PEDIDO, entradas.back().particion, entradas.back().desplazamiento);
+    if (!segmento) return false;
+
+    // Los segmentos se escriben ordenados por ID
+    auto it = lower_bound(segmento->pedidos.begin(), segmento->pedidos.end(), idPedido,
+                          [](const Pedidos& p, const string& id) { return p.getId() < id; });
+    if (it == segmento->pedidos.end() || it->getId() != idPedido) return false;
+    pedido = *it;
+    return true;
+}
+
+bool Archivador::buscarEnvio(const string& idEnvio, Envio& envio) {
+    vector<Entrada> entradas = buscarEntradas(ENVIO, idEnvio);
+    if (entradas.empty()) return false;
+    shared_ptr<const Segmento> segmento = leerSegmento(ENVIO, entradas.back().particion, entradas.back().desplazamiento);
+    if (!segmento) return false;
+
+    auto it = lower_bound(segmento->envios.begin(), segmento->envios.end(), idEnvio,
+                          [](const Envio& e, const string& id) { return e.idEnvio < id; });
+    if (it == segmento->envios.end() || it->idEnvio != idEnvio) return false;
+    envio = *it;
+    return true;
+}
+
+vector<Envio> Archivador::enviosDePedido(const string& idPedido) {
+    vector<Envio> resultado;
+    for (const auto& entrada : buscarEntradas(ENVIO_DE_PEDIDO, idPedido)) {
+        shared_ptr<const Segmento> segmento = leerSegmento(ENVIO, entrada.particion, entrada.desplazamiento);
+        if (!segmento) continue;
+        for (const auto& envio : segmento->envios) {
+            if (envio.idPedido == idPedido) resultado.push_back(envio);
+        }
+    }
+    return resultado;
+}
+
+bool Archivador::contienePedido(const string& idPedido) {
+    return !buscarEntradas(PEDIDO, idPedido).empty();
+}
+
+bool Archivador::contieneEnvio(const string& idEnvio) {
+    return !buscarEntradas(ENVIO, idEnvio).empty();
+}
+
+void Archivador::recargar() {
+    indiceCargado = false;
+    agregadosCargados = false;
+    indice.clear();
+    agregados.clear();
+    segmentosRecientes.clear();
+}
+
+// ----------- Archivado ------------
+
+Archivador::Resultado Archivador::archivar(int dias, time_t ahora) {
+    Resultado resultado;
+    if (ahora == 0) ahora = time(nullptr);
+    time_t corte = ahora - static_cast<time_t>(dias) * 24 * 60 * 60;
+
+    asegurarIndice();
+    unordered_map<string, Pedidos::AgregadosCliente> nuevosAgregados = agregadosArchivados();
+
+    vector<Pedidos> pedidos;
+    Pedidos::cargarDesdeArchivoBin(pedidos);
+    vector<Envio> envios = Envios::cargarEnviosDesdeArchivo();
+    if (!Envios::cargaCompleta()) {
+        // Con envíos sin leer no se sabe qué pedidos siguen referenciados
+        cerr << "\n\tError: envios.bin no se cargó completo; no se archiva nada.\n";
+        resultado.correcto = false;
+        return resultado;
+    }
+
+    // Pedidos con factura, con el mismo texto de ID que en pedidos.bin
+    unordered_set<string> pedidosFacturados;
+    {
+        unordered_set<int> ids;
+        Facturacion facturacion;
+        if (!facturacion.pedidosFacturados(ids)) {
+            cerr << "\n\tError: no se pudo leer el índice de facturas; no se archiva nada.\n";
+            resultado.correcto = false;
+            return resultado;
+        }
+        pedidosFacturados.reserve(ids.size());
+        for (int id : ids) pedidosFacturados.insert(to_string(id));
+    }
+
+    // 1. Fecha de referencia de cada envío: su último evento o la fecha del pedido
+    unordered_map<string, time_t> ultimoEvento;
+    for (const auto& evento : EventosEnvios::cargarTodos()) {
+        time_t& fecha = ultimoEvento[evento.idEnvio];
+        fecha = max(fecha, evento.fecha);
+    }
+    unordered_map<string, time_t> fechaPedido;
+    for (const auto& p : pedidos) fechaPedido[p.getId()] = p.getFechaPedido();
+
+    // 2. Elegir qué se archiva, agrupado por mes
+    map<int32_t, vector<Envio>> enviosPorMes;
+    vector<Envio> enviosActivos;
+    unordered_set<string> pedidosConEnvioActivo;   // Pedidos que siguen referenciados desde envios.bin
+    for (const auto& envio : envios) {
+        time_t fecha = 0;
+        auto evento = ultimoEvento.find(envio.idEnvio);
+        if (evento != ultimoEvento.end()) {
+            fecha = evento->second;
+        } else {
+            auto pedido = fechaPedido.find(envio.idPedido);
+            if (pedido != fechaPedido.end()) fecha = pedido->second;
+        }
+
+        if (envioCerrado(envio.estado) && fecha != 0 && fecha < corte) {
+            enviosPorMes[particionDe(fecha)].push_back(envio);
+        } else {
+            enviosActivos.push_back(envio);
+            pedidosConEnvioActivo.insert(envio.idPedido);
+        }
+    }
+
+    map<int32_t, vector<Pedidos>> pedidosPorMes;
+    vector<Pedidos> pedidosActivos;
+    for (const auto& pedido : pedidos) {
+        bool archivable = pedidoCerrado(pedido.getEstado()) && pedido.getFechaPedido() < corte &&
+                          !pedidosConEnvioActivo.count(pedido.getId());
+        // Un pedido entregado o completado sin factura todavía se tiene que facturar
+        if (archivable && pedido.getEstado() != "cancelado" && !pedidosFacturados.count(pedido.getId())) {
+            archivable = false;
+            resultado.sinFactura++;
+        }
+        if (archivable) {
+            pedidosPorMes[particionDe(pedido.getFechaPedido())].push_back(pedido);
+            Pedidos::aplicarAgregados(nuevosAgregados, pedido, 1);
+        } else {
+            pedidosActivos.push_back(pedido);
+        }
+    }
+    if (pedidosPorMes.empty() && enviosPorMes.empty()) return resultado;
+
+    if (!crearDirectorio(DIRECTORIO_HISTORICO)) {
+        cerr << "\n\tError: no se pudo crear la carpeta " << DIRECTORIO_HISTORICO << ".\n";
+        resultado.correcto = false;
+        return resultado;
+    }
+
+    // 3. Un segmento comprimido por archivo mensual, agregado al final
+    vector<Entrada> nuevas;
+    auto agregarSegmento = [&](uint8_t tipo, int32_t particion, const string& datos, uint32_t cantidad) {
+        string ruta = rutaParticion(tipo, particion);
+        uint64_t desplazamiento = 0;
+        {
+            ifstream existente(ruta, ios::binary | ios::ate);
+            if (existente) desplazamiento = static_cast<uint64_t>(existente.tellg());
+        }
+
+        string comprimido = comprimirLZ(datos);
+        CabeceraSegmento cabecera;
+        memset(&cabecera, 0, sizeof(cabecera));
+        memcpy(cabecera.firma, FIRMA_SEGMENTO, sizeof(cabecera.firma));
+        cabecera.cantidad = cantidad;
+        cabecera.tamOriginal = static_cast<uint32_t>(datos.size());
+        cabecera.tamComprimido = static_cast<uint32_t>(comprimido.size());
+        cabecera.crc = calcularCrc32(comprimido.data(), comprimido.size());
+
+        ofstream archivo(ruta, ios::binary | ios::app);
+        archivo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+        archivo.write(comprimido.data(), comprimido.size());
+        if (!archivo.flush()) {
+            cerr << "\n\tError: no se pudo escribir " << ruta << ".\n";
+            resultado.correcto = false;
+            return desplazamiento;
+        }
+        resultado.segmentos++;
+        resultado.bytesOriginales += datos.size();
+        resultado.bytesComprimidos += sizeof(cabecera) + comprimido.size();
+        return desplazamiento;
+    };
+
+    for (auto& par : pedidosPorMes) {
+        vector<Pedidos>& lista = par.second;
+        sort(lista.begin(), lista.end(), [](const Pedidos& a, const Pedidos& b) { return a.getId() < b.getId(); });
+        ostringstream datos;
+        for (const auto& pedido : lista) Pedidos::escribirPedido(datos, pedido);
+        uint64_t desplazamiento = agregarSegmento(PEDIDO, par.first, datos.str(), static_cast<uint32_t>(lista.size()));
+        if (!resultado.correcto) return resultado;
+
+        for (const auto& pedido : lista) nuevas.push_back({pedido.getId(), PEDIDO, par.first, desplazamiento});
+        resultado.pedidos += lista.size();
+    }
+
+    for (auto& par : enviosPorMes) {
+        vector<Envio>& lista = par.second;
+        sort(lista.begin(), lista.end(), [](const Envio& a, const Envio& b) { return a.idEnvio < b.idEnvio; });
+        ostringstream datos;
+        for (const auto& envio : lista) escribirEnvio(datos, envio);
+        uint64_t desplazamiento = agregarSegmento(ENVIO, par.first, datos.str(), static_cast<uint32_t>(lista.size()));
+        if (!resultado.correcto) return resultado;
+
+        for (const auto& envio : lista) {
+            nuevas.push_back({envio.idEnvio, ENVIO, par.first, desplazamiento});
+            nuevas.push_back({envio.idPedido, ENVIO_DE_PEDIDO, par.first, desplazamiento});
+        }
+        resultado.envios += lista.size();
+    }
+
+    // 4. Índice y acumulados; si fallan, los archivos activos quedan como estaban
+    vector<Entrada> combinado = indice;
+    combinado.insert(combinado.end(), nuevas.begin(), nuevas.end());
+    sort(combinado.begin(), combinado.end());
+    combinado.erase(unique(combinado.begin(), combinado.end()), combinado.end());
+    if (!escribirIndice(combinado) || !escribirAgregados(nuevosAgregados)) {
+        cerr << "\n\tError: no se pudo actualizar el índice del histórico.\n";
+        resultado.correcto = false;
+        return resultado;
+    }
+    indice.swap(combinado);
+    agregados.swap(nuevosAgregados);
+
+    // 5. Recién ahora salen de los archivos activos
+    Pedidos::listaPedidos = pedidosActivos;
+    Pedidos::reconstruirAgregados(Pedidos::listaPedidos);
+    Pedidos::confirmarCambios();
+    Envios::guardarEnviosEnArchivo(enviosActivos);
+    return resultado;
+}
+
+// ----------- Menú ------------
+
+void Archivador::archivarInteractivo() {
+    system("cls");
+    cout << "\n--------------------------------------------------------------------------------\n";
+    cout << "                 ARCHIVAR PEDIDOS Y ENVIOS CERRADOS                              \n";
+    cout << "--------------------------------------------------------------------------------\n";
+    cout << "Se mueven a la carpeta '" << DIRECTORIO_HISTORICO << "' los pedidos y envios entregados,\n"
+         << "cancelados o completados con mas antiguedad que la indicada.\n\n";
+
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    string entrada;
+    cout << "Antiguedad minima en dias [" << DIAS_POR_DEFECTO << "]: ";
+    getline(cin, entrada);
+    int dias = entrada.empty() ? DIAS_POR_DEFECTO : atoi(entrada.c_str());
+    if (dias <= 0) {
+        cout << "\n\tCantidad de dias invalida.\n";
+        system("pause");
+        return;
+    }
+
+    cout << "Confirmar archivado de registros con mas de " << dias << " dias? (s/n): ";
+    getline(cin, entrada);
+    if (entrada.empty() || tolower(static_cast<unsigned char>(entrada[0])) != 's') return;
+
+    auto inicio = chrono::steady_clock::now();
+    Resultado resultado = archivar(dias);
+    long ms = static_cast<long>(chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count() + 0.5);
+
+    if (!resultado.correcto) {
+        cout << "\n\tNo se pudo completar el archivado; los archivos activos no se modificaron.\n";
+        system("pause");
+        return;
+    }
+    if (resultado.pedidos == 0 && resultado.envios == 0) {
+        cout << "\n\tNo hay registros cerrados con mas de " << dias << " dias.\n";
+    } else {
+        cout << "\n\tArchivados " << resultado.pedidos << " pedidos y " << resultado.envios << " envios en "
+             << resultado.segmentos << " segmentos (" << resultado.bytesOriginales << " -> "
+             << resultado.bytesComprimidos << " bytes) en " << ms << " ms.\n";
+        auditoria.registrar(usuarioRegistrado.getNombre(), "HISTORICO",
+                            "Archivados " + to_string(resultado.pedidos) + " pedidos y " +
+                            to_string(resultado.envios) + " envios de mas de " + to_string(dias) + " dias");
+    }
+    if (resultado.sinFactura > 0) {
+        cout << "\t" << resultado.sinFactura << " pedidos cerrados quedan activos porque no tienen factura "
+             << "(ver Facturar pedidos cerrados en Facturacion).\n";
+    }
+    system("pause");
+}
+
+void Archivador::consultarInteractivo() {
+    system("cls");
+    cout << "\n--------------------------------------------------------------------------------\n";
+    cout << "                 CONSULTA DE PEDIDOS Y ENVIOS (INCLUYE HISTORICO)                \n";
+    cout << "--------------------------------------------------------------------------------\n";
+
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    string id;
+    cout << "Ingrese ID de pedido o de envio (0 para salir): ";
+    getline(cin, id);
+    if (id == "0" || id.empty()) return;
+
+    bool encontrado = false;
+    Pedidos pedido;
+    if (Pedidos::consultarPedido(id, pedido)) {
+        encontrado = true;
+        time_t fecha = pedido.getFechaPedido();
+        char texto[20];
+        strftime(texto, sizeof(texto), "%Y-%m-%d %H:%M", localtime(&fecha));
+        cout << "\nPedido " << pedido.getId() << (contienePedido(id) ? " (archivado)" : "") << "\n"
+             << "  Cliente: " << pedido.getIdCliente() << " | Almacen: " << pedido.getIdAlmacen()
+             << " | Fecha: " << texto << " | Estado: " << pedido.getEstado()
+             << " | Unidades: " << pedido.getTotales().unidades << "\n";
+        for (const auto& envio : Envios::enviosDePedido(id)) {
+            cout << "  Envio " << envio.idEnvio << " - " << envio.estado
+                 << " (transportista " << envio.idTransportista << ")\n";
+        }
+    }
+
+    Envio envio;
+    if (Envios::consultarEnvio(id, envio)) {
+        encontrado = true;
+        cout << "\nEnvio " << envio.idEnvio << (contieneEnvio(id) ? " (archivado)" : "") << "\n"
+             << "  Pedido: " << envio.idPedido << " | Cliente: " << envio.idCliente
+             << " | Transportista: " << envio.idTransportista << " | Estado: " << envio.estado << "\n";
+    }
+
+    if (!encontrado) cout << "\n\tNo existe un pedido ni un envio con ID " << id << ".\n";
+    system("pause");
+}
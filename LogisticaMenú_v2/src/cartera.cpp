@@ -0,0 +1,157 @@
+#include "cartera.h"
+#include "grupohilos.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CARTERA_AVX2 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// IDs de cliente por debajo de este valor se indexan con un vector
+const int LIMITE_ID_DENSO = 1 << 20;
+
+// Facturas por bloque al repartir entre hilos
+const size_t FACTURAS_POR_BLOQUE = 1 << 16;
+
+// ----------- Columnas ------------
+
+uint32_t Cartera::Columnas::indiceDe(int idCliente) {
+    if (idCliente >= 0 && idCliente < LIMITE_ID_DENSO) {
+        size_t posicion = static_cast<size_t>(idCliente);
+        if (posicion >= densos.size()) densos.resize(posicion + 1, 0);
+        if (densos[posicion] == 0) {
+            idsCliente.push_back(idCliente);
+            densos[posicion] = static_cast<uint32_t>(idsCliente.size());
+        }
+        return densos[posicion] - 1;
+    }
+
+    auto it = dispersos.find(idCliente);
+    if (it != dispersos.end()) return it->second;
+    idsCliente.push_back(idCliente);
+    uint32_t indice = static_cast<uint32_t>(idsCliente.size() - 1);
+    dispersos.emplace(idCliente, indice);
+    return indice;
+}
+
+void Cartera::Columnas::agregar(const Factura& factura, const Pagos::ResumenFactura& resumen) {
+    saldo.push_back(resumen.saldo.centavos());
+    cobrado.push_back(resumen.pagos.centavos());
+    notasCredito.push_back(resumen.notasCredito.centavos());
+    castigos.push_back(resumen.castigos.centavos());
+    cliente.push_back(indiceDe(factura.idCliente));
+}
+
+// ----------- Núcleo de totales ------------
+
+int64_t Cartera::sumarEscalar(const int64_t* importes, size_t cantidad) {
+    int64_t suma = 0;
+    for (size_t i = 0; i < cantidad; ++i) suma += importes[i];
+    return suma;
+}
+
+#ifdef CARTERA_AVX2
+// 4 importes por iteración en cuatro sumas parciales de 64 bits
+__attribute__((target("avx2")))
+static int64_t sumarAvx2(const int64_t* importes, size_t cantidad) {
+    __m256i suma = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= cantidad; i += 4) {
+        suma = _mm256_add_epi64(suma, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(importes + i)));
+    }
+
+    alignas(32) int64_t parcial[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(parcial), suma);
+    int64_t total = parcial[0] + parcial[1] + parcial[2] + parcial[3];
+
+    // Resto que no completa un grupo de 4
+    for (; i < cantidad; ++i) total += importes[i];
+    return total;
+}
+#endif
+
+bool Cartera::usaAvx2() {
+#ifdef CARTERA_AVX2
+    static const bool disponible = __builtin_cpu_supports("avx2");
+    return disponible;
+#else
+    return false;
+#endif
+}
+
+int64_t Cartera::sumar(const int64_t* importes, size_t cantidad) {
+#ifdef CARTERA_AVX2
+    if (usaAvx2()) return sumarAvx2(importes, cantidad);
+#endif
+    return sumarEscalar(importes, cantidad);
+}
+
+// ----------- Resumen ------------
+
+Cartera::Resumen Cartera::resumir(const Columnas& columnas) {
+    const size_t n = columnas.size();
+    const size_t clientes = columnas.idsCliente.size();
+    const size_t bloques = (n + FACTURAS_POR_BLOQUE - 1) / FACTURAS_POR_BLOQUE;
+
+    // Cada bloque acumula por separado; después se combinan en orden
+    struct Parcial {
+        int64_t abierto = 0, cobrado = 0, notasCredito = 0, castigos = 0;
+        vector<int64_t> abiertoCliente, cobradoCliente;
+        vector<size_t> abiertasCliente;
+    };
+    vector<Parcial> parciales(bloques);
+
+    GrupoHilos::global().paraCada(bloques, [&](size_t b) {
+        size_t inicio = b * FACTURAS_POR_BLOQUE;
+        size_t fin = min(n, inicio + FACTURAS_POR_BLOQUE);
+        Parcial& parcial = parciales[b];
+        parcial.abierto = sumar(columnas.saldo.data() + inicio, fin - inicio);
+        parcial.cobrado = sumar(columnas.cobrado.data() + inicio, fin - inicio);
+        parcial.notasCredito = sumar(columnas.notasCredito.data() + inicio, fin - inicio);
+        parcial.castigos = sumar(columnas.castigos.data() + inicio, fin - inicio);
+
+        parcial.abiertoCliente.assign(clientes, 0);
+        parcial.cobradoCliente.assign(clientes, 0);
+        parcial.abiertasCliente.assign(clientes, 0);
+        for (size_t i = inicio; i < fin; ++i) {
+            uint32_t c = columnas.cliente[i];
+            parcial.abiertoCliente[c] += columnas.saldo[i];
+            parcial.cobradoCliente[c] += columnas.cobrado[i];
+            parcial.abiertasCliente[c] += columnas.saldo[i] > 0 ? 1 : 0;
+        }
+    });
+
+    Resumen resumen;
+    resumen.facturas = n;
+    resumen.porCliente.resize(clientes);
+    for (size_t c = 0; c < clientes; ++c) resumen.porCliente[c].idCliente = columnas.idsCliente[c];
+
+    int64_t abierto = 0, cobrado = 0, notasCredito = 0, castigos = 0;
+    for (const auto& parcial : parciales) {
+        abierto += parcial.abierto;
+        cobrado += parcial.cobrado;
+        notasCredito += parcial.notasCredito;
+        castigos += parcial.castigos;
+        for (size_t c = 0; c < clientes; ++c) {
+            SaldoCliente& saldo = resumen.porCliente[c];
+            saldo.abierto += Dinero::deCentavos(parcial.abiertoCliente[c]);
+            saldo.cobrado += Dinero::deCentavos(parcial.cobradoCliente[c]);
+            saldo.facturasAbiertas += parcial.abiertasCliente[c];
+            resumen.abiertas += parcial.abiertasCliente[c];
+        }
+    }
+    resumen.totalAbierto = Dinero::deCentavos(abierto);
+    resumen.totalCobrado = Dinero::deCentavos(cobrado);
+    resumen.totalNotasCredito = Dinero::deCentavos(notasCredito);
+    resumen.totalCastigos = Dinero::deCentavos(castigos);
+
+    sort(resumen.porCliente.begin(), resumen.porCliente.end(), [](const SaldoCliente& a, const SaldoCliente& b) {
+        if (a.abierto != b.abierto) return a.abierto > b.abierto;
+        return a.idCliente < b.idCliente;
+    });
+    return resumen;
+}
@@ -9,6 +9,8 @@
 #include <iomanip>
 #include <string>
 #include <limits>
+#include <map>
+#include <cstring>
 
 using namespace std;
 
@@ -16,6 +18,37 @@ using namespace std;
 const int CODIGO_INICIAL = 3107;
 const int CODIGO_FINAL = 3157;
 
+// Lmites de crdito: archivo aparte para no cambiar el formato de clientes.bin
+const char ARCHIVO_CREDITOS[] = "creditos.bin";
+const char FIRMA_CREDITOS[4] = {'C', 'R', 'E', 'D'};
+const uint32_t VERSION_CREDITOS = 1;
+
+struct CabeceraCreditos {
+    char firma[4];          // "CRED"
+    uint32_t version;
+    uint32_t cantidad;      // Entradas que siguen a la cabecera
+    uint32_t reservado;
+};
+
+struct EntradaCredito {
+    char idCliente[16];
+    int64_t limite;         // Centavos
+};
+
+/**
+ * Lee un lmite de crdito; vaco conserva 'actual'.
+ * @return false si el texto no es un importe vlido (no negativo, hasta 2 decimales).
+ */
+static bool leerLimite(Dinero actual, Dinero& limite) {
+    std::string texto;
+    std::getline(std::cin, texto);
+    if (texto.empty()) {
+        limite = actual;
+        return true;
+    }
+    return Dinero::deTexto(texto, limite) && limite >= Dinero();
+}
+
 /**
  * Genera un ID nico dentro del rango permitido (31073157) para un nuevo cliente.
  * @param lista Lista actual de clientes.
@@ -91,6 +124,11 @@ void Clientes::agregar(std::vector<Clientes>& lista, const std::string& usuarioA
     std::cout << "\t\tNIT: ";
     std::getline(std::cin, nuevo.nit);
 
+    std::cout << "\t\tLmite de crdito (0 = sin lmite): ";
+    while (!leerLimite(Dinero(), nuevo.limiteCredito)) {
+        std::cout << "\t\tImporte invlido. Lmite de crdito: ";
+    }
+
     lista.push_back(nuevo); // Agrega el cliente a la lista
     guardarEnArchivo(lista); // Guarda la lista actualizada de clientes
 
@@ -110,14 +148,15 @@ void Clientes::mostrar(const std::vector<Clientes>& lista) {
         cout << "\n\t--- NO HAY CLIENTES REGISTRADOS ---\n";
         cout << "\tEl archivo puede estar vaco o no se carg correctamente.\n";
     } else {
-        cout << "\n\t" << string(100, '-') << "\n";
+        cout << "\n\t" << string(115, '-') << "\n";
         cout << "\t" << left
              << setw(10) << "| ID |"
              << setw(30) << " NOMBRE COMPLETO |"
              << setw(25) << " DIRECCIN |"
              << setw(15) << " TELFONO |"
-             << setw(15) << " NIT |" << "\n";
-        cout << "\t" << string(100, '-') << "\n";
+             << setw(15) << " NIT |"
+             << setw(15) << " LMITE |" << "\n";
+        cout << "\t" << string(115, '-') << "\n";
 
         for (const auto& cliente : lista) {
             cout << "\t" << left
@@ -125,9 +164,11 @@ void Clientes::mostrar(const std::vector<Clientes>& lista) {
                  << setw(28) << cliente.nombre << "| "
                  << setw(23) << cliente.direccion << "| "
                  << setw(13) << cliente.telefono << "| "
-                 << setw(13) << cliente.nit << "|" << "\n";
+                 << setw(13) << cliente.nit << "| "
+                 << setw(13) << (cliente.limiteCredito > Dinero() ? cliente.limiteCredito.texto() : "Sin limite")
+                 << "|" << "\n";
         }
-        cout << "\t" << string(100, '-') << "\n";
+        cout << "\t" << string(115, '-') << "\n";
     }
     system("pause");
 }
@@ -160,6 +201,11 @@ void Clientes::modificar(std::vector<Clientes>& lista, const std::string& usuari
         cout << "Nuevo NIT (" << it->nit << "): ";
         getline(cin, it->nit);
 
+        cout << "Nuevo lmite de crdito (" << it->limiteCredito << ", Enter conserva, 0 = sin lmite): ";
+        while (!leerLimite(it->limiteCredito, it->limiteCredito)) {
+            cout << "Importe invlido. Lmite de crdito: ";
+        }
+
         guardarEnArchivo(lista); // Guarda los cambios en el archivo
         bitacora::registrar(usuarioActual, "CLIENTES", "Cliente modificado - ID: " + id);
         cout << "Cliente modificado!\n";
@@ -229,6 +275,28 @@ void Clientes::guardarEnArchivo(const std::vector<Clientes>& lista) {
         archivo.write(cliente.nit.c_str(), size);
     }
     archivo.close();
+
+    // Lmites de crdito (solo los clientes que tienen uno)
+    std::vector<EntradaCredito> creditos;
+    for (const auto& cliente : lista) {
+        if (cliente.limiteCredito <= Dinero()) continue;
+        EntradaCredito entrada;
+        memset(&entrada, 0, sizeof(entrada));
+        strncpy(entrada.idCliente, cliente.id.c_str(), sizeof(entrada.idCliente) - 1);
+        entrada.limite = cliente.limiteCredito.centavos();
+        creditos.push_back(entrada);
+    }
+    CabeceraCreditos cabecera;
+    memset(&cabecera, 0, sizeof(cabecera));
+    memcpy(cabecera.firma, FIRMA_CREDITOS, sizeof(cabecera.firma));
+    cabecera.version = VERSION_CREDITOS;
+    cabecera.cantidad = static_cast<uint32_t>(creditos.size());
+    std::ofstream archivoCreditos(ARCHIVO_CREDITOS, std::ios::binary | std::ios::trunc);
+    archivoCreditos.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+    archivoCreditos.write(reinterpret_cast<const char*>(creditos.data()), creditos.size() * sizeof(EntradaCredito));
+    if (!archivoCreditos) {
+        std::cerr << "Error al guardar los lmites de crdito.\n";
+    }
     std::cout << "\tDatos guardados correctamente.\n";
 }
 
@@ -278,5 +346,24 @@ void Clientes::cargarDesdeArchivo(std::vector<Clientes>& lista) {
         lista.push_back(cliente);
     }
     archivo.close();
+
+    // Lmites de crdito; sin archivo ningn cliente tiene lmite
+    std::ifstream archivoCreditos(ARCHIVO_CREDITOS, std::ios::binary);
+    CabeceraCreditos cabecera;
+    if (archivoCreditos.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera)) &&
+        memcmp(cabecera.firma, FIRMA_CREDITOS, sizeof(cabecera.firma)) == 0 &&
+        cabecera.version == VERSION_CREDITOS) {
+        std::map<std::string, Dinero> limites;
+        EntradaCredito entrada;
+        for (uint32_t i = 0; i < cabecera.cantidad &&
+             archivoCreditos.read(reinterpret_cast<char*>(&entrada), sizeof(entrada)); ++i) {
+            entrada.idCliente[sizeof(entrada.idCliente) - 1] = '\0';
+            limites[entrada.idCliente] = Dinero::deCentavos(entrada.limite);
+        }
+        for (auto& cliente : lista) {
+            auto it = limites.find(cliente.id);
+            if (it != limites.end()) cliente.limiteCredito = it->second;
+        }
+    }
     std::cout << "\tDatos cargados correctamente.\n";
 }
@@ -0,0 +1,422 @@
+#include "columnar.h"
+#include "crc32.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+using namespace std;
+
+// --- Formato del archivo columnar ---
+const char FIRMA_COLUMNAR[4] = {'F', 'C', 'O', 'L'};
+const uint32_t VERSION_COLUMNAR = 1;
+const size_t TAM_NOMBRE_COLUMNA = 24;
+const size_t MAXIMO_DICCIONARIO = 65536;   // Índices de hasta 2 bytes
+
+struct CabeceraColumnar {
+    char firma[4];              // "FCOL"
+    uint32_t version;
+    uint32_t columnas;          // Descriptores que siguen a la cabecera
+    uint32_t filasPorBloque;
+    uint64_t filas;
+    uint32_t bloques;
+    uint32_t reservado;
+    uint64_t directorio;        // Posición del directorio (bloques * columnas entradas)
+};
+
+struct DescriptorColumna {
+    char nombre[TAM_NOMBRE_COLUMNA];
+    uint8_t tipo;
+    uint8_t reservado[7];
+};
+
+struct EntradaDirectorio {
+    uint64_t desplazamiento;
+    uint32_t bytes;
+    uint32_t filas;
+    uint8_t codificacion;
+    uint8_t reservado[3];
+    uint32_t crc;               // CRC-32 de los bytes del bloque
+    int64_t minimo;
+    int64_t maximo;
+};
+
+static_assert(sizeof(CabeceraColumnar) == 40, "formato columnar");
+static_assert(sizeof(DescriptorColumna) == 32, "formato columnar");
+static_assert(sizeof(EntradaDirectorio) == 40, "formato columnar");
+
+// Bytes por valor en la codificación plana
+static size_t anchoPlano(uint8_t tipo) {
+    switch (tipo) {
+        case ArchivoColumnar::TIPO_LOGICO: return 1;
+        case ArchivoColumnar::TIPO_ENTERO32: return 4;
+        default: return 8;
+    }
+}
+
+template <typename T>
+static void agregarValor(string& datos, T valor) {
+    datos.append(reinterpret_cast<const char*>(&valor), sizeof(valor));
+}
+
+template <typename T>
+static T valorEn(const string& datos, size_t posicion) {
+    T valor;
+    memcpy(&valor, datos.data() + posicion, sizeof(valor));
+    return valor;
+}
+
+const char* ArchivoColumnar::nombreTipo(uint8_t tipo) {
+    switch (tipo) {
+        case TIPO_ENTERO32: return "entero32";
+        case TIPO_ENTERO64: return "entero64";
+        case TIPO_LOGICO: return "logico";
+        case TIPO_DINERO: return "dinero";
+        case TIPO_FECHA: return "fecha";
+        default: return "?";
+    }
+}
+
+const char* ArchivoColumnar::nombreCodificacion(uint8_t codificacion) {
+    switch (codificacion) {
+        case CODIFICACION_PLANA: return "plana";
+        case CODIFICACION_DICCIONARIO: return "diccionario";
+        case CODIFICACION_RLE: return "RLE";
+        default: return "?";
+    }
+}
+
+// Calcula el tamaño de las tres codificaciones y arma solo la más chica
+string ArchivoColumnar::codificar(const int64_t* valores, size_t cantidad, uint8_t tipo, uint8_t& codificacion) {
+    vector<int64_t> distintos(valores, valores + cantidad);
+    sort(distintos.begin(), distintos.end());
+    distintos.erase(unique(distintos.begin(), distintos.end()), distintos.end());
+
+    size_t corridas = cantidad > 0 ? 1 : 0;
+    for (size_t i = 1; i < cantidad; ++i) {
+        if (valores[i] != valores[i - 1]) corridas++;
+    }
+
+    size_t anchoIndice = distintos.size() <= 256 ? 1 : 2;
+    size_t tamPlana = cantidad * anchoPlano(tipo);
+    size_t tamDiccionario = distintos.size() <= MAXIMO_DICCIONARIO
+        ? sizeof(uint32_t) + distintos.size() * sizeof(int64_t) + cantidad * anchoIndice
+        : numeric_limits<size_t>::max();
+    size_t tamRle = corridas * (sizeof(int64_t) + sizeof(uint32_t));
+
+    string datos;
+    if (tamPlana <= tamDiccionario && tamPlana <= tamRle) {
+        codificacion = CODIFICACION_PLANA;
+        datos.reserve(tamPlana);
+        for (size_t i = 0; i < cantidad; ++i) {
+            if (tipo == TIPO_LOGICO) agregarValor(datos, static_cast<uint8_t>(valores[i]));
+            else if (tipo == TIPO_ENTERO32) agregarValor(datos, static_cast<int32_t>(valores[i]));
+            else agregarValor(datos, valores[i]);
+        }
+    } else if (tamDiccionario <= tamRle) {
+        codificacion = CODIFICACION_DICCIONARIO;
+        datos.reserve(tamDiccionario);
+        agregarValor(datos, static_cast<uint32_t>(distintos.size()));
+        for (int64_t valor : distintos) agregarValor(datos, valor);
+        for (size_t i = 0; i < cantidad; ++i) {
+            size_t indice = lower_bound(distintos.begin(), distintos.end(), valores[i]) - distintos.begin();
+            if (anchoIndice == 1) agregarValor(datos, static_cast<uint8_t>(indice));
+            else agregarValor(datos, static_cast<uint16_t>(indice));
+        }
+    } else {
+        codificacion = CODIFICACION_RLE;
+        datos.reserve(tamRle);
+        for (size_t i = 0; i < cantidad; ) {
+            size_t fin = i + 1;
+            while (fin < cantidad && valores[fin] == valores[i]) fin++;
+            agregarValor(datos, valores[i]);
+            agregarValor(datos, static_cast<uint32_t>(fin - i));
+            i = fin;
+        }
+    }
+    return datos;
+}
+
+bool ArchivoColumnar::decodificar(const string& datos, uint8_t codificacion, uint8_t tipo, size_t cantidad,
+                                  vector<int64_t>& valores) {
+    valores.clear();
+    valores.reserve(cantidad);
+
+    if (codificacion == CODIFICACION_PLANA) {
+        size_t ancho = anchoPlano(tipo);
+        if (datos.size() != cantidad * ancho) return false;
+        for (size_t i = 0; i < cantidad; ++i) {
+            if (ancho == 1) valores.push_back(valorEn<uint8_t>(datos, i));
+            else if (ancho == 4) valores.push_back(valorEn<int32_t>(datos, i * 4));
+            else valores.push_back(valorEn<int64_t>(datos, i * 8));
+        }
+        return true;
+    }
+
+    if (codificacion == CODIFICACION_DICCIONARIO) {
+        if (datos.size() < sizeof(uint32_t)) return false;
+        size_t distintos = valorEn<uint32_t>(datos, 0);
+        size_t anchoIndice = distintos <= 256 ? 1 : 2;
+        size_t inicioIndices = sizeof(uint32_t) + distintos * sizeof(int64_t);
+        if (distintos == 0 || distintos > MAXIMO_DICCIONARIO ||
+            datos.size() != inicioIndices + cantidad * anchoIndice) {
+            return false;
+        }
+        for (size_t i = 0; i < cantidad; ++i) {
+            size_t indice = anchoIndice == 1 ? valorEn<uint8_t>(datos, inicioIndices + i)
+                                             : valorEn<uint16_t>(datos, inicioIndices + i * 2);
+            if (indice >= distintos) return false;
+            valores.push_back(valorEn<int64_t>(datos, sizeof(uint32_t) + indice * sizeof(int64_t)));
+        }
+        return true;
+    }
+
+    if (codificacion == CODIFICACION_RLE) {
+        const size_t tamCorrida = sizeof(int64_t) + sizeof(uint32_t);
+        if (datos.size() % tamCorrida != 0) return false;
+        for (size_t posicion = 0; posicion < datos.size(); posicion += tamCorrida) {
+            int64_t valor = valorEn<int64_t>(datos, posicion);
+            uint32_t repeticiones = valorEn<uint32_t>(datos, posicion + sizeof(int64_t));
+            if (repeticiones == 0 || repeticiones > cantidad - valores.size()) return false;
+            valores.insert(valores.end(), repeticiones, valor);
+        }
+        return valores.size() == cantidad;
+    }
+    return false;
+}
+
+vector<ArchivoColumnar::Columna> ArchivoColumnar::columnasFactura() {
+    return {
+        {"idFactura", TIPO_ENTERO32},
+        {"idCliente", TIPO_ENTERO32},
+        {"idPedido", TIPO_ENTERO32},
+        {"pagada", TIPO_LOGICO},
+        {"importe", TIPO_DINERO},
+        {"impuesto", TIPO_DINERO},
+        {"saldo", TIPO_DINERO},
+        {"fechaEmision", TIPO_FECHA},
+        {"fechaVencimiento", TIPO_FECHA}
+    };
+}
+
+bool ArchivoColumnar::exportarFacturas(const vector<Factura>& facturas, const vector<Dinero>& saldos,
+                                       const string& ruta, uint32_t filasPorBloque) {
+    if (saldos.size() != facturas.size()) return false;
+    vector<Columna> columnas = columnasFactura();
+    vector<vector<int64_t>> valores(columnas.size());
+    for (auto& columna : valores) columna.reserve(facturas.size());
+    for (size_t i = 0; i < facturas.size(); ++i) {
+        const Factura& factura = facturas[i];
+        valores[0].push_back(factura.idFactura);
+        valores[1].push_back(factura.idCliente);
+        valores[2].push_back(factura.idPedido);
+        valores[3].push_back(factura.pagada ? 1 : 0);
+        valores[4].push_back(factura.importe.centavos());
+        valores[5].push_back(factura.impuesto.centavos());
+        valores[6].push_back(saldos[i].centavos());
+        valores[7].push_back(factura.fechaEmision);
+        valores[8].push_back(factura.fechaVencimiento);
+    }
+    return escribir(ruta, columnas, valores, filasPorBloque);
+}
+
+bool ArchivoColumnar::escribir(const string& ruta, const vector<Columna>& columnas,
+                               const vector<vector<int64_t>>& valores, uint32_t filasPorBloque) {
+    if (columnas.empty() || valores.size() != columnas.size() || filasPorBloque == 0) return false;
+    const size_t filas = valores[0].size();
+    for (size_t c = 0; c < columnas.size(); ++c) {
+        if (valores[c].size() != filas || columnas[c].nombre.empty() ||
+            columnas[c].nombre.size() >= TAM_NOMBRE_COLUMNA) {
+            return false;
+        }
+    }
+
+    CabeceraColumnar cabecera;
+    memset(&cabecera, 0, sizeof(cabecera));
+    memcpy(cabecera.firma, FIRMA_COLUMNAR, sizeof(cabecera.firma));
+    cabecera.version = VERSION_COLUMNAR;
+    cabecera.columnas = static_cast<uint32_t>(columnas.size());
+    cabecera.filasPorBloque = filasPorBloque;
+    cabecera.filas = filas;
+    cabecera.bloques = static_cast<uint32_t>((filas + filasPorBloque - 1) / filasPorBloque);
+
+    const string temporal = ruta + ".tmp";
+    {
+        ofstream salida(temporal, ios::binary | ios::trunc);
+        if (!salida) return false;
+        salida.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+        for (const auto& columna : columnas) {
+            DescriptorColumna descriptor;
+            memset(&descriptor, 0, sizeof(descriptor));
+            memcpy(descriptor.nombre, columna.nombre.c_str(), columna.nombre.size());
+            descriptor.tipo = columna.tipo;
+            salida.write(reinterpret_cast<const char*>(&descriptor), sizeof(descriptor));
+        }
+
+        // Bloques de datos; el directorio se arma a medida que se escriben
+        vector<EntradaDirectorio> directorio;
+        directorio.reserve(static_cast<size_t>(cabecera.bloques) * columnas.size());
+        uint64_t posicion = sizeof(cabecera) + columnas.size() * sizeof(DescriptorColumna);
+        for (size_t inicio = 0; inicio < filas; inicio += filasPorBloque) {
+            size_t cantidad = min<size_t>(filasPorBloque, filas - inicio);
+            for (size_t c = 0; c < columnas.size(); ++c) {
+                const int64_t* datosColumna = valores[c].data() + inicio;
+                EntradaDirectorio entrada;
+                memset(&entrada, 0, sizeof(entrada));
+                string datos = codificar(datosColumna, cantidad, columnas[c].tipo, entrada.codificacion);
+                auto extremos = minmax_element(datosColumna, datosColumna + cantidad);
+                entrada.desplazamiento = posicion;
+                entrada.bytes = static_cast<uint32_t>(datos.size());
+                entrada.filas = static_cast<uint32_t>(cantidad);
+                entrada.crc = calcularCrc32(datos.data(), datos.size());
+                entrada.minimo = *extremos.first;
+                entrada.maximo = *extremos.second;
+                salida.write(datos.data(), datos.size());
+                directorio.push_back(entrada);
+                posicion += datos.size();
+            }
+        }
+
+        cabecera.directorio = posicion;
+        salida.write(reinterpret_cast<const char*>(directorio.data()), directorio.size() * sizeof(EntradaDirectorio));
+        salida.seekp(0);
+        salida.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+        if (!salida.flush()) {
+            salida.close();
+            remove(temporal.c_str());
+            return false;
+        }
+    }
+    remove(ruta.c_str());
+    return rename(temporal.c_str(), ruta.c_str()) == 0;
+}
+
+bool ArchivoColumnar::abrir(const string& ruta) {
+    if (archivo.is_open()) archivo.close();
+    archivo.clear();
+    columnas.clear();
+    directorio.clear();
+    filas = 0;
+    cantidadBloques = 0;
+
+    archivo.open(ruta, ios::binary);
+    CabeceraColumnar cabecera;
+    if (!archivo || !archivo.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera)) ||
+        memcmp(cabecera.firma, FIRMA_COLUMNAR, sizeof(cabecera.firma)) != 0 ||
+        cabecera.version != VERSION_COLUMNAR || cabecera.columnas == 0 || cabecera.filasPorBloque == 0) {
+        return false;
+    }
+
+    for (uint32_t c = 0; c < cabecera.columnas; ++c) {
+        DescriptorColumna descriptor;
+        if (!archivo.read(reinterpret_cast<char*>(&descriptor), sizeof(descriptor))) return false;
+        descriptor.nombre[TAM_NOMBRE_COLUMNA - 1] = '\0';
+        columnas.push_back({descriptor.nombre, descriptor.tipo});
+    }
+
+    vector<EntradaDirectorio> entradas(static_cast<size_t>(cabecera.bloques) * cabecera.columnas);
+    archivo.seekg(static_cast<streamoff>(cabecera.directorio));
+    if (!archivo.read(reinterpret_cast<char*>(entradas.data()), entradas.size() * sizeof(EntradaDirectorio))) {
+        return false;
+    }
+
+    // Cada bloque tiene que caer antes del directorio y todas sus columnas las mismas filas
+    uint64_t totalFilas = 0;
+    for (size_t i = 0; i < entradas.size(); ++i) {
+        const EntradaDirectorio& entrada = entradas[i];
+        if (entrada.desplazamiento + entrada.bytes > cabecera.directorio ||
+            entrada.filas != entradas[i - i % cabecera.columnas].filas) {
+            return false;
+        }
+        if (i % cabecera.columnas == 0) totalFilas += entrada.filas;
+
+        Bloque bloque;
+        bloque.desplazamiento = entrada.desplazamiento;
+        bloque.bytes = entrada.bytes;
+        bloque.filas = entrada.filas;
+        bloque.codificacion = entrada.codificacion;
+        bloque.crc = entrada.crc;
+        bloque.minimo = entrada.minimo;
+        bloque.maximo = entrada.maximo;
+        directorio.push_back(bloque);
+    }
+    if (totalFilas != cabecera.filas) return false;
+
+    filas = cabecera.filas;
+    cantidadBloques = cabecera.bloques;
+    return true;
+}
+
+int ArchivoColumnar::indiceColumna(const string& nombre) const {
+    for (size_t c = 0; c < columnas.size(); ++c) {
+        if (columnas[c].nombre == nombre) return static_cast<int>(c);
+    }
+    return -1;
+}
+
+bool ArchivoColumnar::leerBloque(const Bloque& bloque, uint8_t tipo, vector<int64_t>& valores, uint64_t& bytesLeidos) {
+    string datos(bloque.bytes, '\0');
+    archivo.clear();
+    archivo.seekg(static_cast<streamoff>(bloque.desplazamiento));
+    if (!archivo.read(&datos[0], datos.size()) || calcularCrc32(datos.data(), datos.size()) != bloque.crc) {
+        return false;
+    }
+    bytesLeidos += datos.size();
+    return decodificar(datos, bloque.codificacion, tipo, bloque.filas, valores);
+}
+
+bool ArchivoColumnar::leer(const vector<string>& proyeccion, const vector<Rango>& filtros, Resultado& resultado) {
+    resultado = Resultado();
+    resultado.columnas = proyeccion;
+    resultado.valores.resize(proyeccion.size());
+
+    vector<int> proyectadas, filtradas;
+    for (const auto& nombre : proyeccion) {
+        proyectadas.push_back(indiceColumna(nombre));
+        if (proyectadas.back() < 0) return false;
+    }
+    for (const auto& filtro : filtros) {
+        filtradas.push_back(indiceColumna(filtro.columna));
+        if (filtradas.back() < 0) return false;
+    }
+
+    // Solo se leen de disco las columnas que se proyectan o se filtran
+    vector<bool> necesaria(columnas.size(), false);
+    for (int c : proyectadas) necesaria[c] = true;
+    for (int c : filtradas) necesaria[c] = true;
+
+    vector<vector<int64_t>> datos(columnas.size());
+    for (size_t b = 0; b < cantidadBloques; ++b) {
+        bool descartado = false;
+        for (size_t f = 0; f < filtros.size() && !descartado; ++f) {
+            const Bloque& bloque = getBloque(b, filtradas[f]);
+            descartado = bloque.maximo < filtros[f].minimo || bloque.minimo > filtros[f].maximo;
+        }
+        if (descartado) {
+            resultado.bloquesOmitidos++;
+            continue;
+        }
+
+        for (size_t c = 0; c < columnas.size(); ++c) {
+            if (necesaria[c] && !leerBloque(getBloque(b, c), columnas[c].tipo, datos[c], resultado.bytesLeidos)) {
+                return false;
+            }
+        }
+        resultado.bloquesLeidos++;
+
+        size_t cantidad = getBloque(b, 0).filas;
+        for (size_t fila = 0; fila < cantidad; ++fila) {
+            bool cumple = true;
+            for (size_t f = 0; f < filtros.size() && cumple; ++f) {
+                int64_t valor = datos[filtradas[f]][fila];
+                cumple = valor >= filtros[f].minimo && valor <= filtros[f].maximo;
+            }
+            if (!cumple) continue;
+            for (size_t p = 0; p < proyectadas.size(); ++p) {
+                resultado.valores[p].push_back(datos[proyectadas[p]][fila]);
+            }
+        }
+    }
+    return true;
+}
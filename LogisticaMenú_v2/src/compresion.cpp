@@ -0,0 +1,113 @@
+#include "compresion.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const std::size_t VENTANA = 65535;          // Distancia máxima de una coincidencia
+const std::size_t MIN_COINCIDENCIA = 4;
+const std::size_t MAX_COINCIDENCIA = MIN_COINCIDENCIA + 255;
+const int BITS_HASH = 15;
+const int PROFUNDIDAD = 32;                  // Candidatos revisados por posición
+
+inline uint32_t hashDe(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return (v * 2654435761u) >> (32 - BITS_HASH);
+}
+
+} // namespace
+
+// Cadenas de hash: cabeza[h] es la última posición con ese hash y previa[i] la anterior a i
+std::string comprimirLZ(const std::string& datos) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(datos.data());
+    const std::size_t n = datos.size();
+
+    std::string salida;
+    salida.reserve(n / 2 + 16);
+    std::vector<int64_t> cabeza(std::size_t(1) << BITS_HASH, -1);
+    std::vector<int64_t> previa(n, -1);
+
+    std::size_t posBanderas = 0;
+    int elementos = 8;
+    auto nuevoElemento = [&](bool coincidencia) {
+        if (elementos == 8) {
+            posBanderas = salida.size();
+            salida.push_back(0);
+            elementos = 0;
+        }
+        if (coincidencia) salida[posBanderas] = static_cast<char>(salida[posBanderas] | (1 << elementos));
+        elementos++;
+    };
+    auto insertar = [&](std::size_t i) {
+        if (i + MIN_COINCIDENCIA > n) return;
+        uint32_t h = hashDe(p + i);
+        previa[i] = cabeza[h];
+        cabeza[h] = static_cast<int64_t>(i);
+    };
+
+    std::size_t i = 0;
+    while (i < n) {
+        std::size_t mejorLongitud = 0, mejorDistancia = 0;
+        if (i + MIN_COINCIDENCIA <= n) {
+            std::size_t limite = std::min(MAX_COINCIDENCIA, n - i);
+            int64_t candidato = cabeza[hashDe(p + i)];
+            for (int k = 0; k < PROFUNDIDAD && candidato >= 0 && i - candidato <= VENTANA; ++k) {
+                std::size_t c = static_cast<std::size_t>(candidato);
+                std::size_t largo = 0;
+                while (largo < limite && p[c + largo] == p[i + largo]) ++largo;
+                if (largo > mejorLongitud) {
+                    mejorLongitud = largo;
+                    mejorDistancia = i - c;
+                    if (largo == limite) break;
+                }
+                candidato = previa[c];
+            }
+        }
+
+        if (mejorLongitud >= MIN_COINCIDENCIA) {
+            nuevoElemento(true);
+            salida.push_back(static_cast<char>(mejorDistancia & 0xFF));
+            salida.push_back(static_cast<char>(mejorDistancia >> 8));
+            salida.push_back(static_cast<char>(mejorLongitud - MIN_COINCIDENCIA));
+            for (std::size_t k = 0; k < mejorLongitud; ++k) insertar(i + k);
+            i += mejorLongitud;
+        } else {
+            nuevoElemento(false);
+            salida.push_back(static_cast<char>(p[i]));
+            insertar(i);
+            ++i;
+        }
+    }
+    return salida;
+}
+
+bool descomprimirLZ(const std::string& comprimido, std::size_t tamOriginal, std::string& datos) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(comprimido.data());
+    const std::size_t n = comprimido.size();
+    datos.clear();
+    datos.reserve(tamOriginal);
+
+    std::size_t i = 0;
+    while (i < n) {
+        unsigned banderas = p[i++];
+        for (int k = 0; k < 8 && i < n; ++k) {
+            if (banderas & (1u << k)) {
+                if (i + 3 > n) return false;
+                std::size_t distancia = p[i] | (static_cast<std::size_t>(p[i + 1]) << 8);
+                std::size_t largo = p[i + 2] + MIN_COINCIDENCIA;
+                i += 3;
+                if (distancia == 0 || distancia > datos.size() || datos.size() + largo > tamOriginal) return false;
+                // Byte a byte: la coincidencia puede solaparse con lo que se está copiando
+                std::size_t desde = datos.size() - distancia;
+                for (std::size_t j = 0; j < largo; ++j) datos.push_back(datos[desde + j]);
+            } else {
+                if (datos.size() >= tamOriginal) return false;
+                datos.push_back(static_cast<char>(p[i++]));
+            }
+        }
+    }
+    return datos.size() == tamOriginal;
+}
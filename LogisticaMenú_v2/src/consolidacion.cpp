@@ -0,0 +1,467 @@
+#include "consolidacion.h"
+#include "pedidos.h"
+#include "envios.h"
+#include "clientes.h"
+#include "transportistas.h"
+#include "despacho.h"
+#include "bitacora.h"
+#include "usuarios.h"
+#include "almacen.h"
+#include "rutas.h"
+#include "grupohilos.h"
+#include "reservas.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <unordered_map>
+#include <map>
+#include <chrono>
+#include <cctype>
+#include <ctime>
+
+using namespace std;
+
+extern usuarios usuarioRegistrado;
+extern bitacora auditoria;
+
+namespace {
+
+// Unidad que se empaca: los pedidos de un cliente (o uno solo si el cliente no cabe entero)
+struct Bulto {
+    string idCliente;
+    string direccion;
+    vector<size_t> pedidos;  // Posiciones en 'pendientes'
+    int unidades = 0;
+};
+
+// Carga en construcción
+struct Carga {
+    size_t vehiculo;         // Posición en 'vehiculos'
+    int usado = 0;
+    vector<size_t> bultos;   // Posiciones en el vector de bultos de la zona
+};
+
+} // namespace
+
+// Devuelve "Zona N" si la dirección menciona una zona; si no, la dirección en minúsculas
+string Consolidacion::zonaDe(const string& direccion) {
+    string texto;
+    for (char c : direccion) texto += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+
+    size_t pos = texto.find("zona");
+    if (pos != string::npos) {
+        size_t i = pos + 4;
+        while (i < texto.size() && !isdigit(static_cast<unsigned char>(texto[i]))) {
+            if (!isspace(static_cast<unsigned char>(texto[i])) && texto[i] != '.' && texto[i] != ':') break;
+            ++i;
+        }
+        size_t inicio = i;
+        while (i < texto.size() && isdigit(static_cast<unsigned char>(texto[i]))) ++i;
+        if (i > inicio) return "Zona " + to_string(stoi(texto.substr(inicio, i - inicio)));
+    }
+
+    size_t ini = texto.find_first_not_of(" \t\r\n");
+    if (ini == string::npos) return "sin zona";
+    size_t fin = texto.find_last_not_of(" \t\r\n");
+    return texto.substr(ini, fin - ini + 1);
+}
+
+Consolidacion::Resultado Consolidacion::planificar(const vector<EnvioPendiente>& pendientes,
+                                                    const vector<Vehiculo>& vehiculos) {
+    Resultado resultado;
+
+    int capacidadMaxima = 0;
+    for (const auto& v : vehiculos) capacidadMaxima = max(capacidadMaxima, v.capacidad);
+
+    // 1. Agrupar por zona y cliente
+    map<string, vector<Bulto>> zonas;
+    map<string, unordered_map<string, size_t>> clientePorZona;
+    for (size_t i = 0; i < pendientes.size(); ++i) {
+        const EnvioPendiente& p = pendientes[i];
+        if (p.unidades > capacidadMaxima) {
+            resultado.sinAsignar.push_back(p);
+            continue;
+        }
+        string zona = zonaDe(p.direccion);
+        auto& indice = clientePorZona[zona];
+        auto it = indice.find(p.idCliente);
+        if (it == indice.end()) {
+            indice[p.idCliente] = zonas[zona].size();
+            zonas[zona].push_back({p.idCliente, p.direccion, {i}, p.unidades});
+        } else {
+            Bulto& b = zonas[zona][it->second];
+            b.pedidos.push_back(i);
+            b.unidades += p.unidades;
+        }
+    }
+
+    // Un cliente que no cabe entero en ningún vehículo se reparte por pedido
+    for (auto& par : zonas) {
+        vector<Bulto> ajustados;
+        for (auto& b : par.second) {
+            if (b.unidades <= capacidadMaxima) {
+                ajustados.push_back(move(b));
+                continue;
+            }
+            for (size_t i : b.pedidos) {
+                ajustados.push_back({b.idCliente, b.direccion, {i}, pendientes[i].unidades});
+            }
+        }
+        par.second = move(ajustados);
+    }
+
+    // Zonas de mayor volumen primero, para que tomen los vehículos grandes
+    vector<pair<int, string>> ordenZonas;
+    for (const auto& par : zonas) {
+        int total = 0;
+        for (const auto& b : par.second) total += b.unidades;
+        ordenZonas.push_back({total, par.first});
+    }
+    sort(ordenZonas.begin(), ordenZonas.end(), greater<pair<int, string>>());
+
+    // Vehículos libres ordenados por capacidad (mayor al final para tomarlo con pop_back)
+    vector<size_t> libres(vehiculos.size());
+    for (size_t i = 0; i < libres.size(); ++i) libres[i] = i;
+    sort(libres.begin(), libres.end(), [&vehiculos](size_t a, size_t b) {
+        return vehiculos[a].capacidad < vehiculos[b].capacidad;
+    });
+    auto devolverVehiculo = [&libres, &vehiculos](size_t v) {
+        auto pos = lower_bound(libres.begin(), libres.end(), v, [&vehiculos](size_t a, size_t b) {
+            return vehiculos[a].capacidad < vehiculos[b].capacidad;
+        });
+        libres.insert(pos, v);
+    };
+
+    struct CargaZona {
+        string zona;
+        const vector<Bulto>* bultos;
+        Carga carga;
+    };
+    vector<CargaZona> todas;
+
+    for (const auto& oz : ordenZonas) {
+        const string& zona = oz.second;
+        vector<Bulto>& bultos = zonas[zona];
+
+        // 2. Primer ajuste decreciente
+        vector<size_t> orden(bultos.size());
+        for (size_t i = 0; i < orden.size(); ++i) orden[i] = i;
+        sort(orden.begin(), orden.end(), [&bultos](size_t a, size_t b) {
+            return bultos[a].unidades > bultos[b].unidades;
+        });
+
+        vector<Carga> cargas;
+        for (size_t b : orden) {
+            bool colocado = false;
+            for (auto& c : cargas) {
+                if (vehiculos[c.vehiculo].capacidad - c.usado >= bultos[b].unidades) {
+                    c.bultos.push_back(b);
+                    c.usado += bultos[b].unidades;
+                    colocado = true;
+                    break;
+                }
+            }
+            if (colocado) continue;
+
+            if (!libres.empty() && vehiculos[libres.back()].capacidad >= bultos[b].unidades) {
+                Carga nueva;
+                nueva.vehiculo = libres.back();
+                libres.pop_back();
+                nueva.bultos.push_back(b);
+                nueva.usado = bultos[b].unidades;
+                cargas.push_back(nueva);
+            } else {
+                for (size_t i : bultos[b].pedidos) resultado.sinAsignar.push_back(pendientes[i]);
+            }
+        }
+
+        // 3. Búsqueda local: vaciar la carga menos llena reubicando sus bultos en las demás
+        bool mejoro = true;
+        while (mejoro && cargas.size() > 1) {
+            mejoro = false;
+            vector<size_t> porUso(cargas.size());
+            for (size_t i = 0; i < porUso.size(); ++i) porUso[i] = i;
+            sort(porUso.begin(), porUso.end(), [&cargas](size_t a, size_t b) {
+                return cargas[a].usado < cargas[b].usado;
+            });
+
+            for (size_t candidata : porUso) {
+                vector<int> holgura(cargas.size());
+                for (size_t i = 0; i < cargas.size(); ++i) {
+                    holgura[i] = vehiculos[cargas[i].vehiculo].capacidad - cargas[i].usado;
+                }
+                vector<pair<size_t, size_t>> movimientos;  // (bulto, carga destino)
+                vector<size_t> propios = cargas[candidata].bultos;
+                sort(propios.begin(), propios.end(), [&bultos](size_t a, size_t b) {
+                    return bultos[a].unidades > bultos[b].unidades;
+                });
+
+                bool todos = true;
+                for (size_t b : propios) {
+                    // Mejor ajuste: la carga con menor holgura suficiente
+                    size_t destino = cargas.size();
+                    for (size_t i = 0; i < cargas.size(); ++i) {
+                        if (i == candidata || holgura[i] < bultos[b].unidades) continue;
+                        if (destino == cargas.size() || holgura[i] < holgura[destino]) destino = i;
+                    }
+                    if (destino == cargas.size()) {
+                        todos = false;
+                        break;
+                    }
+                    holgura[destino] -= bultos[b].unidades;
+                    movimientos.push_back({b, destino});
+                }
+                if (!todos) continue;
+
+                for (const auto& m : movimientos) {
+                    cargas[m.second].bultos.push_back(m.first);
+                    cargas[m.second].usado += bultos[m.first].unidades;
+                }
+                devolverVehiculo(cargas[candidata].vehiculo);
+                cargas.erase(cargas.begin() + candidata);
+                mejoro = true;
+                break;
+            }
+        }
+
+        for (auto& c : cargas) todas.push_back({zona, &bultos, c});
+    }
+
+    // 4. Reasignar vehículos: cada carga (de mayor a menor) toma el más chico que la cubre
+    for (const auto& cz : todas) devolverVehiculo(cz.carga.vehiculo);
+    sort(todas.begin(), todas.end(), [](const CargaZona& a, const CargaZona& b) {
+        return a.carga.usado > b.carga.usado;
+    });
+    for (auto& cz : todas) {
+        auto pos = find_if(libres.begin(), libres.end(), [&](size_t v) {
+            return vehiculos[v].capacidad >= cz.carga.usado;
+        });
+        // Siempre existe: la asignación anterior ya era factible
+        cz.carga.vehiculo = *pos;
+        libres.erase(pos);
+    }
+
+    // 5. Armar manifiestos
+    for (const auto& cz : todas) {
+        Manifiesto m;
+        m.vehiculo = vehiculos[cz.carga.vehiculo];
+        m.zona = cz.zona;
+        m.unidades = cz.carga.usado;
+
+        unordered_map<string, size_t> paradaPorCliente;
+        for (size_t b : cz.carga.bultos) {
+            const Bulto& bulto = (*cz.bultos)[b];
+            auto it = paradaPorCliente.find(bulto.idCliente);
+            if (it == paradaPorCliente.end()) {
+                paradaPorCliente[bulto.idCliente] = m.paradas.size();
+                m.paradas.push_back({bulto.idCliente, bulto.direccion, {}, 0});
+                it = paradaPorCliente.find(bulto.idCliente);
+            }
+            Parada& parada = m.paradas[it->second];
+            for (size_t i : bulto.pedidos) parada.pedidos.push_back(pendientes[i].idPedido);
+            parada.unidades += bulto.unidades;
+        }
+        sort(m.paradas.begin(), m.paradas.end(), [](const Parada& a, const Parada& b) {
+            return a.idCliente < b.idCliente;
+        });
+        resultado.manifiestos.push_back(move(m));
+    }
+    return resultado;
+}
+
+// Ordena las paradas de cada manifiesto por recorrido desde el almacén de la mayoría de sus pedidos.
+// Las paradas sin coordenadas quedan al final en su orden original. Un manifiesto por tarea.
+static void ordenarRecorridos(vector<Consolidacion::Manifiesto>& manifiestos, const InstantaneaPedidos& vista) {
+    vector<Almacen> almacenes;
+    Almacen::cargarDesdeArchivo(almacenes);
+    unordered_map<string, Rutas::Punto> puntoAlmacen;
+    for (const auto& a : almacenes) {
+        Rutas::Punto punto;
+        if (Rutas::coordenadaDe(a.getDireccion(), punto)) puntoAlmacen[a.getId()] = punto;
+    }
+    if (puntoAlmacen.empty()) return;
+
+    // Coordenadas resueltas antes de repartir: la caché de Rutas no se comparte entre hilos
+    vector<vector<pair<bool, Rutas::Punto>>> puntosParada(manifiestos.size());
+    vector<pair<bool, Rutas::Punto>> deposito(manifiestos.size(), {false, Rutas::Punto()});
+    for (size_t m = 0; m < manifiestos.size(); ++m) {
+        map<string, int> votos;
+        for (const auto& parada : manifiestos[m].paradas) {
+            Rutas::Punto punto;
+            bool conocida = Rutas::coordenadaDe(parada.direccion, punto);
+            puntosParada[m].push_back({conocida, punto});
+            for (const auto& idPedido : parada.pedidos) {
+                if (const Pedidos* pedido = vista.buscar(idPedido)) votos[pedido->getIdAlmacen()]++;
+            }
+        }
+        auto mayor = max_element(votos.begin(), votos.end(),
+                                 [](const pair<const string, int>& x, const pair<const string, int>& y) { return x.second < y.second; });
+        if (mayor != votos.end() && puntoAlmacen.count(mayor->first)) {
+            deposito[m] = {true, puntoAlmacen[mayor->first]};
+        }
+    }
+
+    GrupoHilos::global().paraCada(manifiestos.size(), [&](size_t m) {
+        if (!deposito[m].first) return;
+        Consolidacion::Manifiesto& manifiesto = manifiestos[m];
+
+        vector<Rutas::Parada> conCoordenadas;
+        vector<Consolidacion::Parada> resto;
+        for (size_t i = 0; i < manifiesto.paradas.size(); ++i) {
+            if (!puntosParada[m][i].first) {
+                resto.push_back(manifiesto.paradas[i]);
+                continue;
+            }
+            Rutas::Parada parada;
+            parada.id = to_string(i);
+            parada.punto = puntosParada[m][i].second;
+            conCoordenadas.push_back(parada);
+        }
+        if (conCoordenadas.empty()) return;
+
+        manifiesto.distanciaKm = Rutas::ordenarParadas(deposito[m].second, conCoordenadas);
+        vector<Consolidacion::Parada> ordenadas;
+        for (const auto& parada : conCoordenadas) ordenadas.push_back(manifiesto.paradas[stoul(parada.id)]);
+        ordenadas.insert(ordenadas.end(), resto.begin(), resto.end());
+        manifiesto.paradas.swap(ordenadas);
+    });
+}
+
+void Consolidacion::consolidarEnvios() {
+    system("cls");
+    cout << "\n--------------------------------------------------------------------------------\n";
+    cout << "                 CONSOLIDACION DE ENVIOS POR ZONA Y VEHICULO                     \n";
+    cout << "--------------------------------------------------------------------------------\n";
+
+    // Pedidos listos para envío
+    shared_ptr<const InstantaneaPedidos> vista = Pedidos::obtenerInstantanea();
+    vector<Clientes> clientes;
+    Clientes::cargarDesdeArchivo(clientes);
+    unordered_map<string, string> direccionPorCliente;
+    for (const auto& c : clientes) direccionPorCliente[c.getId()] = c.getDireccion();
+
+    vector<EnvioPendiente> pendientes;
+    for (const auto& p : vista->pedidos) {
+        if (p.getEstado() != "procesado" || !Envios::enviosDePedido(p.getId()).empty()) continue;
+        EnvioPendiente e;
+        e.idPedido = p.getId();
+        e.idCliente = p.getIdCliente();
+        auto it = direccionPorCliente.find(e.idCliente);
+        e.direccion = (it == direccionPorCliente.end()) ? "" : it->second;
+        e.unidades = p.getTotales().unidades;
+        pendientes.push_back(e);
+    }
+
+    // Vehículos: un transportista disponible = un vehículo
+    vector<Vehiculo> vehiculos;
+    for (const auto& t : Transportistas::getTransportistasDisponibles()) {
+        vehiculos.push_back({t.id, t.especificacion.tipo, t.especificacion.unidades});
+    }
+
+    if (pendientes.empty() || vehiculos.empty()) {
+        cout << "\n\tNo hay pedidos 'procesado' sin envio o no hay transportistas disponibles.\n";
+        system("pause");
+        return;
+    }
+
+    auto inicio = chrono::steady_clock::now();
+    Resultado resultado = planificar(pendientes, vehiculos);
+    ordenarRecorridos(resultado.manifiestos, *vista);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+
+    for (size_t i = 0; i < resultado.manifiestos.size(); ++i) {
+        const Manifiesto& m = resultado.manifiestos[i];
+        cout << "\nMANIFIESTO " << i + 1 << " | Transportista " << m.vehiculo.idTransportista
+             << " (" << m.vehiculo.tipo << ") | " << m.zona
+             << " | Carga " << m.unidades << "/" << m.vehiculo.capacidad;
+        if (m.distanciaKm > 0) cout << " | " << fixed << setprecision(1) << m.distanciaKm << " km";
+        cout << "\n";
+        for (const auto& parada : m.paradas) {
+            cout << "   Cliente " << left << setw(8) << parada.idCliente
+                 << setw(25) << parada.direccion.substr(0, 24)
+                 << "Pedidos:";
+            for (const auto& id : parada.pedidos) cout << " " << id;
+            cout << " (" << parada.unidades << " u.)\n";
+        }
+    }
+    if (!resultado.sinAsignar.empty()) {
+        cout << "\nSin vehiculo (" << resultado.sinAsignar.size() << "):";
+        for (const auto& p : resultado.sinAsignar) cout << " " << p.idPedido << "(" << p.unidades << " u.)";
+        cout << "\n";
+    }
+    cout << "\n" << pendientes.size() << " pedidos en " << resultado.manifiestos.size()
+         << " manifiestos; planificacion en " << fixed << setprecision(2) << ms << " ms\n";
+
+    if (resultado.manifiestos.empty()) {
+        system("pause");
+        return;
+    }
+
+    char confirmar;
+    cout << "\nConfirmar y crear los envios? (s/n): ";
+    cin >> confirmar;
+    if (tolower(confirmar) != 's') return;
+
+    // Crear un envío por pedido con el transportista del manifiesto
+    vector<string> enviados;
+    ofstream archivo("manifiestos.txt", ios::app);
+    time_t ahora = time(nullptr);
+    char fecha[20];
+    strftime(fecha, sizeof(fecha), "%Y-%m-%d %H:%M", localtime(&ahora));
+    bool sinIds = false;
+    size_t sinLugar = 0;
+
+    for (const auto& m : resultado.manifiestos) {
+        archivo << "[" << fecha << "] Transportista " << m.vehiculo.idTransportista << " (" << m.vehiculo.tipo
+                << ") " << m.zona << " carga " << m.unidades << "/" << m.vehiculo.capacidad << "\n";
+        for (const auto& parada : m.paradas) {
+            for (const auto& idPedido : parada.pedidos) {
+                Envio nuevo;
+                int idLibre = Envios::generarIdEnvio();
+                if (idLibre == 0) {
+                    sinIds = true;
+                    break;
+                }
+                nuevo.idEnvio = to_string(idLibre);
+                nuevo.idPedido = idPedido;
+                nuevo.idTransportista = m.vehiculo.idTransportista;
+                nuevo.idCliente = parada.idCliente;
+                nuevo.estado = "en camino";
+
+                // La franja del transportista puede estar ocupada por envíos anteriores
+                const Pedidos* pedido = vista->buscar(idPedido);
+                Reservas::Reserva reserva;
+                if (!Reservas::reservar(nuevo.idEnvio, nuevo.idTransportista,
+                                        Reservas::Carga::deUnidades(pedido ? pedido->getTotales().unidades : 0),
+                                        reserva)) {
+                    sinLugar++;
+                    continue;
+                }
+                if (!Envios::agregarEnvio(nuevo)) {
+                    Reservas::liberar(nuevo.idEnvio);
+                    continue;
+                }
+                Despacho::registrar(nuevo.idTransportista);
+                enviados.push_back(idPedido);
+                archivo << "    envio " << nuevo.idEnvio << " pedido " << idPedido
+                        << " cliente " << parada.idCliente << "\n";
+            }
+            if (sinIds) break;
+        }
+        if (sinIds) break;
+    }
+
+    Pedidos::actualizarEstados(enviados, "enviado");
+    auditoria.registrar(usuarioRegistrado.getNombre(), "ENVIOS",
+                        "Consolidacion: " + to_string(enviados.size()) + " pedidos en " +
+                        to_string(resultado.manifiestos.size()) + " manifiestos");
+
+    if (sinIds) cout << "\n\tSe agotaron los IDs de envio; algunos pedidos quedaron sin enviar.\n";
+    if (sinLugar > 0) {
+        cout << "\n\t" << sinLugar << " pedidos sin enviar: su transportista no tiene franjas libres en los proximos "
+             << Reservas::DIAS_AGENDA << " dias.\n";
+    }
+    cout << "\n\t" << enviados.size() << " envios creados. Manifiestos guardados en manifiestos.txt\n";
+    system("pause");
+}
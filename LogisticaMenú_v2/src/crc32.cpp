@@ -0,0 +1,30 @@
+#include "crc32.h"
+
+namespace {
+
+// Tabla de 256 entradas; se genera una vez (inicializacion estatica segura entre hilos)
+struct TablaCrc32 {
+    uint32_t valores[256];
+
+    TablaCrc32() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            valores[i] = c;
+        }
+    }
+};
+
+} // namespace
+
+uint32_t calcularCrc32(const void* datos, std::size_t tam, uint32_t crc) {
+    static const TablaCrc32 tabla;
+    const unsigned char* p = static_cast<const unsigned char*>(datos);
+    crc = ~crc;
+    for (std::size_t i = 0; i < tam; ++i) {
+        crc = tabla.valores[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
@@ -0,0 +1,67 @@
+#include "credito.h"
+#include "clientes.h"
+#include "pedidos.h"
+#include "listaespera.h"
+#include "pagos.h"
+#include "tarifas.h"
+
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+Credito::Exposicion Credito::exposicion(const string& idCliente, const string& idPedidoExcluido) {
+    Exposicion resultado;
+    int numero = 0;
+    if (Tarifas::aEntero(idCliente, numero)) resultado.facturasPendientes = Pagos::saldoCliente(numero);
+
+    const Pedidos* excluido = nullptr;
+    shared_ptr<const InstantaneaPedidos> vista = Pedidos::obtenerInstantanea();
+    if (!idPedidoExcluido.empty()) excluido = vista->buscar(idPedidoExcluido);
+
+    resultado.pedidosAbiertos = Pedidos::obtenerAgregadosCliente(idCliente).montoAbierto;
+    if (excluido != nullptr && excluido->getIdCliente() == idCliente &&
+        Pedidos::esEstadoAbierto(excluido->getEstado())) {
+        resultado.pedidosAbiertos -= excluido->getTotales().neto;
+    }
+
+    // Lo que los acumulados no cubren
+    for (const auto& pedido : vista->pedidos) {
+        if (pedido.getIdCliente() != idCliente || &pedido == excluido) continue;
+        string estado = pedido.getEstado();
+        if (estado == "retenido") {
+            resultado.pedidosRetenidos += pedido.getTotales().neto;
+        } else if (estado == "completado" || estado == "entregado") {
+            int idPedido = 0;
+            if (!Tarifas::aEntero(pedido.getId(), idPedido) || !Pagos::pedidoFacturado(idPedido)) {
+                resultado.sinFacturar += pedido.getTotales().neto;
+            }
+            continue;
+        } else if (!Pedidos::esEstadoAbierto(estado)) {
+            continue;
+        }
+        resultado.lineasEnEspera += ListaEspera::montoPendiente(pedido.getId());
+    }
+    return resultado;
+}
+
+Credito::Evaluacion Credito::evaluar(const Clientes& cliente, Dinero monto, const string& idPedidoExcluido) {
+    Evaluacion evaluacion;
+    evaluacion.limite = cliente.getLimiteCredito();
+    evaluacion.monto = monto;
+    evaluacion.exposicion = exposicion(cliente.getId(), idPedidoExcluido);
+    evaluacion.aprobado = evaluacion.limite <= Dinero() ||
+                          evaluacion.exposicion.total() + monto <= evaluacion.limite;
+    return evaluacion;
+}
+
+void Credito::mostrar(const Evaluacion& evaluacion) {
+    cout << "\t\tLímite de crédito      : $" << evaluacion.limite << "\n"
+         << "\t\tFacturas sin pagar     : $" << evaluacion.exposicion.facturasPendientes << "\n"
+         << "\t\tPedidos abiertos       : $" << evaluacion.exposicion.pedidosAbiertos << "\n"
+         << "\t\tPedidos retenidos      : $" << evaluacion.exposicion.pedidosRetenidos << "\n"
+         << "\t\tLíneas en espera       : $" << evaluacion.exposicion.lineasEnEspera << "\n"
+         << "\t\tCerrados sin facturar  : $" << evaluacion.exposicion.sinFacturar << "\n"
+         << "\t\tDisponible             : $" << evaluacion.disponible() << "\n"
+         << "\t\tEste pedido            : $" << evaluacion.monto << "\n";
+}
@@ -0,0 +1,220 @@
+#include "despacho.h"
+#include "transportistas.h"
+#include "envios.h"
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+
+// Definicion de los miembros estaticos
+vector<Despacho::EstadoTransportista> Despacho::transportistas;
+unordered_map<string, size_t> Despacho::indicePorId;
+Despacho::MonticuloMin Despacho::general;
+unordered_map<string, Despacho::MonticuloMin> Despacho::porTipo;
+Despacho::Modo Despacho::modo = Despacho::Modo::MenosCargado;
+bool Despacho::listo = false;
+unsigned long Despacho::versionTransportistas = 0;
+
+// ----------- Montículo de mínimos ------------
+
+// Orden por clave; a igual clave, el de menor posición (orden del archivo)
+bool Despacho::MonticuloMin::menor(size_t a, size_t b) const {
+    double ca = clave(a), cb = clave(b);
+    return ca < cb || (ca == cb && a < b);
+}
+
+void Despacho::MonticuloMin::intercambiar(size_t i, size_t j) {
+    swap(datos[i], datos[j]);
+    posicion[datos[i]] = i;
+    posicion[datos[j]] = j;
+}
+
+void Despacho::MonticuloMin::subir(size_t i) {
+    while (i > 0) {
+        size_t padre = (i - 1) / 2;
+        if (!menor(datos[i], datos[padre])) break;
+        intercambiar(i, padre);
+        i = padre;
+    }
+}
+
+void Despacho::MonticuloMin::bajar(size_t i) {
+    while (true) {
+        size_t menorHijo = i;
+        size_t izq = 2 * i + 1, der = 2 * i + 2;
+        if (izq < datos.size() && menor(datos[izq], datos[menorHijo])) menorHijo = izq;
+        if (der < datos.size() && menor(datos[der], datos[menorHijo])) menorHijo = der;
+        if (menorHijo == i) break;
+        intercambiar(i, menorHijo);
+        i = menorHijo;
+    }
+}
+
+void Despacho::MonticuloMin::insertar(size_t t) {
+    datos.push_back(t);
+    posicion[t] = datos.size() - 1;
+    subir(datos.size() - 1);
+}
+
+// Quita y devuelve el de menor clave
+size_t Despacho::MonticuloMin::extraerMinimo() {
+    size_t t = datos.front();
+    intercambiar(0, datos.size() - 1);
+    datos.pop_back();
+    posicion.erase(t);
+    if (!datos.empty()) bajar(0);
+    return t;
+}
+
+// La clave de 't' cambió: se reacomoda en O(log n)
+void Despacho::MonticuloMin::actualizar(size_t t) {
+    auto it = posicion.find(t);
+    if (it == posicion.end()) return;
+    size_t i = it->second;
+    subir(i);
+    bajar(posicion[t]);
+}
+
+// ----------- Despacho ------------
+
+// Peso de cada tipo: cuántos envíos simultáneos equivale a uno de moto
+static int pesoDeTipo(const string& tipo) {
+    if (tipo == "camion") return 3;
+    if (tipo == "panel" || tipo == "pickup") return 2;
+    return 1;
+}
+
+// Clave del montículo según el modo vigente
+double Despacho::clave(size_t t) {
+    const EstadoTransportista& e = transportistas[t];
+    if (modo == Modo::RoundRobinPonderado) return e.turno;
+    return static_cast<double>(e.enCurso) / e.peso;
+}
+
+// Arma el estado desde el registro de transportistas y los envíos en curso.
+// También se rearma si el registro se recargó porque cambió transportistas.bin.
+void Despacho::asegurarListo() {
+    unsigned long versionActual = Transportistas::versionRegistro();
+    if (listo && versionActual == versionTransportistas) return;
+    listo = true;
+    versionTransportistas = versionActual;
+
+    transportistas.clear();
+    indicePorId.clear();
+    general = MonticuloMin();
+    porTipo.clear();
+
+    const vector<Transportistas>& lista = Transportistas::registro();
+    unordered_map<string, int> enCurso = Envios::enCursoPorTransportista();
+
+    for (size_t i = 0; i < lista.size(); ++i) {
+        const Transportistas& t = lista[i];
+        if (!Transportistas::disponibleEnRegistro(i) || indicePorId.count(t.id)) continue;
+        EstadoTransportista e;
+        e.id = t.id;
+        e.tipo = t.especificacion.tipo;
+        e.peso = pesoDeTipo(e.tipo);
+        auto it = enCurso.find(t.id);
+        e.enCurso = (it == enCurso.end()) ? 0 : it->second;
+        e.turno = static_cast<double>(e.enCurso) / e.peso;
+        indicePorId[e.id] = transportistas.size();
+        transportistas.push_back(e);
+    }
+
+    for (size_t t = 0; t < transportistas.size(); ++t) {
+        general.insertar(t);
+        porTipo[transportistas[t].tipo].insertar(t);
+    }
+}
+
+// Reacomoda a un transportista en sus dos montículos
+void Despacho::reordenar(size_t t) {
+    general.actualizar(t);
+    porTipo[transportistas[t].tipo].actualizar(t);
+}
+
+string Despacho::asignar(const string& tipoVehiculo) {
+    asegurarListo();
+
+    MonticuloMin* monticulo = &general;
+    if (!tipoVehiculo.empty()) {
+        auto it = porTipo.find(tipoVehiculo);
+        if (it == porTipo.end()) return "";
+        monticulo = &it->second;
+    }
+    if (monticulo->vacio()) return "";
+
+    size_t t = monticulo->minimo();
+    sumarEnvio(t);
+    return transportistas[t].id;
+}
+
+// Se sacan del montículo los que no tienen lugar hasta dar con uno que sí; luego vuelven todos
+string Despacho::asignarConReserva(const string& idEnvio, const Reservas::Carga& carga,
+                                   Reservas::Reserva& reserva, const string& tipoVehiculo) {
+    asegurarListo();
+
+    MonticuloMin* monticulo = &general;
+    if (!tipoVehiculo.empty()) {
+        auto it = porTipo.find(tipoVehiculo);
+        if (it == porTipo.end()) return "";
+        monticulo = &it->second;
+    }
+
+    vector<size_t> revisados;
+    bool asignado = false;
+    while (!monticulo->vacio() && !asignado) {
+        size_t t = monticulo->extraerMinimo();
+        revisados.push_back(t);
+        asignado = Reservas::reservar(idEnvio, transportistas[t].id, carga, reserva);
+    }
+    for (size_t t : revisados) monticulo->insertar(t);
+    if (!asignado) return "";
+
+    sumarEnvio(revisados.back());
+    return transportistas[revisados.back()].id;
+}
+
+void Despacho::sumarEnvio(size_t t) {
+    EstadoTransportista& e = transportistas[t];
+    e.enCurso++;
+    e.turno += 1.0 / e.peso;
+    reordenar(t);
+}
+
+void Despacho::registrar(const string& idTransportista) {
+    asegurarListo();
+    auto it = indicePorId.find(idTransportista);
+    if (it == indicePorId.end()) return;
+    sumarEnvio(it->second);
+}
+
+void Despacho::liberar(const string& idTransportista) {
+    asegurarListo();
+    auto it = indicePorId.find(idTransportista);
+    if (it == indicePorId.end()) return;
+    EstadoTransportista& e = transportistas[it->second];
+    if (e.enCurso > 0) e.enCurso--;
+    reordenar(it->second);
+}
+
+void Despacho::invalidar() {
+    listo = false;
+}
+
+// Cambiar de modo cambia todas las claves: se rearma el estado
+void Despacho::setModo(Modo nuevoModo) {
+    if (modo == nuevoModo) return;
+    modo = nuevoModo;
+    listo = false;
+}
+
+Despacho::Modo Despacho::getModo() {
+    return modo;
+}
+
+int Despacho::enviosEnCurso(const string& idTransportista) {
+    asegurarListo();
+    auto it = indicePorId.find(idTransportista);
+    return it == indicePorId.end() ? 0 : transportistas[it->second].enCurso;
+}
@@ -12,6 +12,22 @@
 #include <algorithm>
 #include <limits>
 #include <iomanip>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include <numeric>
+#include <chrono>
+#include <cctype>
+#include "crc32.h"
+#include "despacho.h"
+#include "consolidacion.h"
+#include "eventosenvios.h"
+#include "rutas.h"
+#include "reservas.h"
+#include "archivador.h"
 
 using namespace std;
 
@@ -34,7 +50,7 @@ const int ID_ENVIO_FINAL = 3599;
 bool idEnvioDisponible(const vector<Envio>& lista, const string& id) {
     return none_of(lista.begin(), lista.end(), [&id](const Envio& e) {
         return e.idEnvio == id;
-    });
+    }) && !Archivador::contieneEnvio(id);
 }
 
 /**
@@ -51,6 +67,132 @@ string generarIdEnvioUnico(const vector<Envio>& lista) {
     return "";
 }
 
+// ----------- Formato de envios.bin ------------
+
+const char FIRMA_ENVIOS[4] = {'E', 'N', 'V', 'S'};
+const uint32_t VERSION_ENVIOS = 2;
+const uint32_t REGISTROS_POR_BLOQUE = 64;
+
+/**
+ * @brief Cabecera del archivo de envíos (32 bytes).
+ */
+struct CabeceraEnvios {
+    char firma[4];                ///< "ENVS"
+    uint32_t version;             ///< Versión del formato
+    uint32_t tamRegistro;         ///< Bytes por registro (permite agregar campos al final)
+    uint32_t registrosPorBloque;  ///< Registros cubiertos por cada CRC
+    uint64_t cantidad;            ///< Total de registros
+    uint32_t crcCabecera;         ///< CRC-32 de los campos anteriores
+    uint32_t reservado;
+};
+
+/**
+ * @brief Registro de tamaño fijo de un envío en disco.
+ */
+struct RegistroEnvio {
+    char idEnvio[16];
+    char idPedido[16];
+    char idTransportista[16];
+    char idCliente[16];
+    char estado[16];
+};
+
+// Miembros estáticos de índices y estado del archivo
+std::unordered_map<std::string, size_t> Envios::indicePorEnvio;
+std::unordered_map<std::string, std::vector<size_t>> Envios::indicePorPedido;
+bool Envios::enviosCargados = false;
+bool Envios::formatoVigente = false;
+bool Envios::cargaParcial = false;
+bool Envios::cabeceraDanada = false;
+
+// Copia un texto a un campo de tamaño fijo (siempre termina en '\0')
+static void copiarCampo(char* destino, size_t tam, const string& origen) {
+    memset(destino, 0, tam);
+    strncpy(destino, origen.c_str(), tam - 1);
+}
+
+// Lee un campo de tamaño fijo aunque no termine en '\0'
+static string leerCampo(const char* origen, size_t tam) {
+    return string(origen, strnlen(origen, tam));
+}
+
+static RegistroEnvio aRegistro(const Envio& envio) {
+    RegistroEnvio r;
+    copiarCampo(r.idEnvio, sizeof(r.idEnvio), envio.idEnvio);
+    copiarCampo(r.idPedido, sizeof(r.idPedido), envio.idPedido);
+    copiarCampo(r.idTransportista, sizeof(r.idTransportista), envio.idTransportista);
+    copiarCampo(r.idCliente, sizeof(r.idCliente), envio.idCliente);
+    copiarCampo(r.estado, sizeof(r.estado), envio.estado);
+    return r;
+}
+
+static Envio desdeRegistro(const RegistroEnvio& r) {
+    Envio envio;
+    envio.idEnvio = leerCampo(r.idEnvio, sizeof(r.idEnvio));
+    envio.idPedido = leerCampo(r.idPedido, sizeof(r.idPedido));
+    envio.idTransportista = leerCampo(r.idTransportista, sizeof(r.idTransportista));
+    envio.idCliente = leerCampo(r.idCliente, sizeof(r.idCliente));
+    envio.estado = leerCampo(r.estado, sizeof(r.estado));
+    return envio;
+}
+
+static CabeceraEnvios armarCabecera(uint64_t cantidad) {
+    CabeceraEnvios c;
+    memset(&c, 0, sizeof(c));
+    memcpy(c.firma, FIRMA_ENVIOS, sizeof(c.firma));
+    c.version = VERSION_ENVIOS;
+    c.tamRegistro = sizeof(RegistroEnvio);
+    c.registrosPorBloque = REGISTROS_POR_BLOQUE;
+    c.cantidad = cantidad;
+    c.crcCabecera = calcularCrc32(&c, offsetof(CabeceraEnvios, crcCabecera));
+    return c;
+}
+
+// Desplazamiento del inicio de un bloque dentro del archivo
+static uint64_t inicioBloque(uint64_t bloque) {
+    return sizeof(CabeceraEnvios) +
+           bloque * (static_cast<uint64_t>(REGISTROS_POR_BLOQUE) * sizeof(RegistroEnvio) + sizeof(uint32_t));
+}
+
+// CRC de los registros [desde, hasta) de la lista en memoria
+static uint32_t crcDeBloque(const vector<Envio>& lista, size_t desde, size_t hasta) {
+    uint32_t crc = 0;
+    for (size_t i = desde; i < hasta; ++i) {
+        RegistroEnvio r = aRegistro(lista[i]);
+        crc = calcularCrc32(&r, sizeof(r), crc);
+    }
+    return crc;
+}
+
+/**
+ * @brief Lee el formato antiguo (cadenas con longitud, sin cabecera).
+ */
+static vector<Envio> cargarFormatoAntiguo(ifstream& archivo, bool& completo) {
+    vector<Envio> lista;
+    archivo.clear();
+    archivo.seekg(0);
+
+    auto leerCadena = [&archivo](string& destino) {
+        size_t size = 0;
+        if (!archivo.read(reinterpret_cast<char*>(&size), sizeof(size)) || size > 256) return false;
+        destino.resize(size);
+        return size == 0 || static_cast<bool>(archivo.read(&destino[0], size));
+    };
+
+    completo = true;
+    while (archivo.peek() != EOF) {
+        Envio envio;
+        if (!leerCadena(envio.idEnvio) || !leerCadena(envio.idPedido) ||
+            !leerCadena(envio.idTransportista) || !leerCadena(envio.estado)) {
+            cerr << "\n\tAviso: envios.bin (formato antiguo) termina con un registro incompleto.\n";
+            completo = false;
+            break;
+        }
+        lista.push_back(envio);
+    }
+    return lista;
+}
+
 // ----------- Funciones privadas estáticas ------------
 /**
  * @brief Carga todos los envíos almacenados desde el archivo binario.
@@ -58,102 +200,532 @@ string generarIdEnvioUnico(const vector<Envio>& lista) {
  * @return Vector de estructuras Envio leídas desde el archivo.
  */
 vector<Envio> Envios::cargarEnviosDesdeArchivo() {
+    envios.clear();
+    enviosCargados = true;
+    formatoVigente = false;
+    cargaParcial = false;
+    cabeceraDanada = false;
+
     ifstream archivo("envios.bin", ios::binary);
-    vector<Envio> lista;
-    if (!archivo) return lista;
+    if (!archivo) {
+        formatoVigente = true;  // Se creará con el formato actual
+        reconstruirIndices();
+        return envios;
+    }
 
-    while (!archivo.eof()) {
-        Envio envio;
-        size_t size;
+    CabeceraEnvios cabecera;
+    if (!archivo.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera)) ||
+        memcmp(cabecera.firma, FIRMA_ENVIOS, sizeof(cabecera.firma)) != 0) {
+        bool completo = true;
+        envios = cargarFormatoAntiguo(archivo, completo);
+        cargaParcial = !completo;
+        reconstruirIndices();
+        return envios;
+    }
 
-        archivo.read(reinterpret_cast<char*>(&size), sizeof(size));
-        if (archivo.eof()) break;
-        envio.idEnvio.resize(size);
-        archivo.read(&envio.idEnvio[0], size);
+    if (cabecera.crcCabecera != calcularCrc32(&cabecera, offsetof(CabeceraEnvios, crcCabecera)) ||
+        cabecera.tamRegistro < sizeof(RegistroEnvio) || cabecera.registrosPorBloque == 0) {
+        cerr << "\n\tError: la cabecera de envios.bin está dañada; no se cargaron envíos.\n";
+        cabeceraDanada = true;
+        reconstruirIndices();
+        return envios;
+    }
 
-        archivo.read(reinterpret_cast<char*>(&size), sizeof(size));
-        envio.idPedido.resize(size);
-        archivo.read(&envio.idPedido[0], size);
+    bool integro = (cabecera.tamRegistro == sizeof(RegistroEnvio) &&
+                    cabecera.registrosPorBloque == REGISTROS_POR_BLOQUE);
+    vector<char> bloque;
+    for (uint64_t leidos = 0; leidos < cabecera.cantidad; ) {
+        uint64_t enBloque = min<uint64_t>(cabecera.registrosPorBloque, cabecera.cantidad - leidos);
+        bloque.resize(static_cast<size_t>(enBloque * cabecera.tamRegistro));
+        uint32_t crcGuardado = 0;
+        if (!archivo.read(bloque.data(), bloque.size()) ||
+            !archivo.read(reinterpret_cast<char*>(&crcGuardado), sizeof(crcGuardado))) {
+            cerr << "\n\tAviso: envios.bin está truncado; se cargaron " << envios.size() << " envíos.\n";
+            integro = false;
+            cargaParcial = true;
+            break;
+        }
 
-        archivo.read(reinterpret_cast<char*>(&size), sizeof(size));
-        envio.idTransportista.resize(size);
-        archivo.read(&envio.idTransportista[0], size);
+        if (calcularCrc32(bloque.data(), bloque.size()) != crcGuardado) {
+            cerr << "\n\tAviso: bloque dañado en envios.bin (registros " << leidos + 1
+                 << " a " << leidos + enBloque << "); se omite.\n";
+            integro = false;
+            cargaParcial = true;
+        } else {
+            for (uint64_t i = 0; i < enBloque; ++i) {
+                RegistroEnvio r;
+                memcpy(&r, bloque.data() + i * cabecera.tamRegistro, sizeof(r));
+                envios.push_back(desdeRegistro(r));
+            }
+        }
+        leidos += enBloque;
+    }
 
-        archivo.read(reinterpret_cast<char*>(&size), sizeof(size));
-        envio.estado.resize(size);
-        archivo.read(&envio.estado[0], size);
+    // Con bloques omitidos las posiciones ya no coinciden: la próxima escritura reescribe todo
+    formatoVigente = integro;
+    reconstruirIndices();
+    return envios;
+}
 
-        lista.push_back(envio);
+/**
+ * @brief Copia envios.bin tal como está a un archivo con fecha y hora.
+ *
+ * Se usa antes de reescribir un archivo que no se pudo cargar completo, para
+ * que los registros omitidos se puedan recuperar.
+ *
+ * @return true si la copia quedó escrita.
+ */
+static bool respaldarArchivoDanado() {
+    char sello[32];
+    time_t ahora = time(nullptr);
+    strftime(sello, sizeof(sello), "%Y%m%d_%H%M%S", localtime(&ahora));
+    string ruta = string("envios_danado_") + sello + ".bin";
+
+    ifstream origen("envios.bin", ios::binary);
+    ofstream destino(ruta, ios::binary | ios::trunc);
+    if (!origen || !destino || !(destino << origen.rdbuf())) {
+        cerr << "\n\tError: no se pudo respaldar envios.bin en " << ruta << ".\n";
+        return false;
     }
-    archivo.close();
-    return lista;
+    destino.close();
+    if (!destino) return false;
+    cerr << "\n\tAviso: envios.bin no se cargó completo; se guardó una copia en " << ruta
+         << " antes de reescribirlo.\n";
+    return true;
 }
 
 /**
  * @brief Guarda todos los envíos en un archivo binario.
  *
- * @param envios Vector de estructuras Envio a guardar.
+ * No escribe si la cabecera del archivo actual estaba dañada (no se cargó
+ * ningún envío). Si se omitieron bloques al cargar, primero respalda el archivo.
+ *
+ * @param lista Vector de estructuras Envio a guardar.
+ * @return true si el archivo quedó escrito.
  */
-void Envios::guardarEnviosEnArchivo(const vector<Envio>& envios) {
+bool Envios::guardarEnviosEnArchivo(const vector<Envio>& lista) {
+    asegurarCargados();
+    if (cabeceraDanada) {
+        cerr << "\n\tError: la cabecera de envios.bin está dañada; no se reescribe para no perder"
+                " los envíos. Restaure el archivo desde una copia de seguridad.\n";
+        return false;
+    }
+    if (cargaParcial && !respaldarArchivoDanado()) return false;
+
     ofstream archivo("envios.bin", ios::binary | ios::trunc);
-    for (const auto& envio : envios) {
-        size_t size;
+    if (!archivo) {
+        cerr << "\n\tError: no se pudo abrir envios.bin para escritura.\n";
+        return false;
+    }
 
-        size = envio.idEnvio.size();
-        archivo.write(reinterpret_cast<const char*>(&size), sizeof(size));
-        archivo.write(envio.idEnvio.c_str(), size);
+    CabeceraEnvios cabecera = armarCabecera(lista.size());
+    archivo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+
+    for (size_t desde = 0; desde < lista.size(); desde += REGISTROS_POR_BLOQUE) {
+        size_t hasta = min(lista.size(), desde + static_cast<size_t>(REGISTROS_POR_BLOQUE));
+        uint32_t crc = 0;
+        for (size_t i = desde; i < hasta; ++i) {
+            RegistroEnvio r = aRegistro(lista[i]);
+            archivo.write(reinterpret_cast<const char*>(&r), sizeof(r));
+            crc = calcularCrc32(&r, sizeof(r), crc);
+        }
+        archivo.write(reinterpret_cast<const char*>(&crc), sizeof(crc));
+    }
+    archivo.close();
 
-        size = envio.idPedido.size();
-        archivo.write(reinterpret_cast<const char*>(&size), sizeof(size));
-        archivo.write(envio.idPedido.c_str(), size);
+    if (&lista != &envios) envios = lista;
+    enviosCargados = true;
+    formatoVigente = static_cast<bool>(archivo);
+    cargaParcial = false;
+    reconstruirIndices();
+    return formatoVigente;
+}
 
-        size = envio.idTransportista.size();
-        archivo.write(reinterpret_cast<const char*>(&size), sizeof(size));
-        archivo.write(envio.idTransportista.c_str(), size);
+/**
+ * @brief Carga el archivo la primera vez que se necesita la tabla de envíos.
+ */
+void Envios::asegurarCargados() {
+    if (!enviosCargados) cargarEnviosDesdeArchivo();
+}
 
-        size = envio.estado.size();
-        archivo.write(reinterpret_cast<const char*>(&size), sizeof(size));
-        archivo.write(envio.estado.c_str(), size);
+/**
+ * @brief Reconstruye los índices por ID de envío y por ID de pedido.
+ */
+void Envios::reconstruirIndices() {
+    indicePorEnvio.clear();
+    indicePorPedido.clear();
+    indicePorEnvio.reserve(envios.size());
+    for (size_t i = 0; i < envios.size(); ++i) {
+        indicePorEnvio[envios[i].idEnvio] = i;
+        indicePorPedido[envios[i].idPedido].push_back(i);
     }
-    archivo.close();
 }
 
-// ----------- Funciones auxiliares ------------
+/**
+ * @brief Escribe en su lugar el registro 'posicion', el CRC de su bloque y la cabecera.
+ *
+ * El costo no depende del total de envíos: se tocan a lo sumo un bloque y la cabecera.
+ */
+bool Envios::escribirRegistro(size_t posicion) {
+    if (!formatoVigente) return guardarEnviosEnArchivo(envios);
+
+    fstream archivo("envios.bin", ios::binary | ios::in | ios::out);
+    if (!archivo) return guardarEnviosEnArchivo(envios);
+
+    size_t bloque = posicion / REGISTROS_POR_BLOQUE;
+    size_t desde = bloque * REGISTROS_POR_BLOQUE;
+    size_t hasta = min(envios.size(), desde + static_cast<size_t>(REGISTROS_POR_BLOQUE));
+    uint64_t base = inicioBloque(bloque);
+
+    RegistroEnvio r = aRegistro(envios[posicion]);
+    archivo.seekp(static_cast<streamoff>(base + (posicion - desde) * sizeof(RegistroEnvio)));
+    archivo.write(reinterpret_cast<const char*>(&r), sizeof(r));
+
+    uint32_t crc = crcDeBloque(envios, desde, hasta);
+    archivo.seekp(static_cast<streamoff>(base + (hasta - desde) * sizeof(RegistroEnvio)));
+    archivo.write(reinterpret_cast<const char*>(&crc), sizeof(crc));
+
+    CabeceraEnvios cabecera = armarCabecera(envios.size());
+    archivo.seekp(0);
+    archivo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+
+    if (!archivo) {
+        cerr << "\n\tError al actualizar envios.bin.\n";
+        formatoVigente = false;
+        return false;
+    }
+    return true;
+}
 
 /**
- * @brief Carga todos los transportistas disponibles desde el archivo.
+ * @brief Busca un envío por su ID usando el índice primario.
+ */
+const Envio* Envios::buscarEnvio(const string& idEnvio) {
+    asegurarCargados();
+    auto it = indicePorEnvio.find(idEnvio);
+    return it == indicePorEnvio.end() ? nullptr : &envios[it->second];
+}
+
+/**
+ * @brief Envíos de un pedido usando el índice secundario.
+ */
+vector<Envio> Envios::enviosDePedido(const string& idPedido) {
+    asegurarCargados();
+    vector<Envio> resultado;
+    auto it = indicePorPedido.find(idPedido);
+    if (it != indicePorPedido.end()) {
+        for (size_t posicion : it->second) resultado.push_back(envios[posicion]);
+    }
+    for (const auto& archivado : Archivador::enviosDePedido(idPedido)) {
+        if (!indicePorEnvio.count(archivado.idEnvio)) resultado.push_back(archivado);
+    }
+    return resultado;
+}
+
+/**
+ * @brief Envío por ID: primero los activos, después el archivo histórico.
+ */
+bool Envios::consultarEnvio(const string& idEnvio, Envio& envio) {
+    const Envio* activo = buscarEnvio(idEnvio);
+    if (activo != nullptr) {
+        envio = *activo;
+        return true;
+    }
+    return Archivador::buscarEnvio(idEnvio, envio);
+}
+
+/**
+ * @brief Agrega un envío al final: escribe el registro, el CRC del último bloque y la cabecera.
+ */
+bool Envios::agregarEnvio(const Envio& envio) {
+    asegurarCargados();
+    envios.push_back(envio);
+    indicePorEnvio[envio.idEnvio] = envios.size() - 1;
+    indicePorPedido[envio.idPedido].push_back(envios.size() - 1);
+    if (!escribirRegistro(envios.size() - 1)) {
+        // Sin guardar, el envío tampoco queda en memoria
+        envios.pop_back();
+        indicePorEnvio.erase(envio.idEnvio);
+        vector<size_t>& delPedido = indicePorPedido[envio.idPedido];
+        delPedido.pop_back();
+        if (delPedido.empty()) indicePorPedido.erase(envio.idPedido);
+        return false;
+    }
+    EventosEnvios::registrar(envio, envio.estado);
+    return true;
+}
+
+// Estado en minúsculas: "Cancelado" y "cancelado" son el mismo estado
+static string estadoEnMinusculas(const string& estado) {
+    string resultado;
+    for (char c : estado) resultado += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    return resultado;
+}
+
+// Un envío cancelado o entregado ya no ocupa su franja en la agenda
+static bool liberaFranja(const string& estado) {
+    string minusculas = estadoEnMinusculas(estado);
+    return minusculas == "cancelado" || minusculas == "entregado";
+}
+
+/**
+ * @brief Cambia el estado de un envío con una escritura puntual.
+ */
+bool Envios::actualizarEstadoEnvio(const string& idEnvio, const string& nuevoEstado) {
+    asegurarCargados();
+    auto it = indicePorEnvio.find(idEnvio);
+    if (it == indicePorEnvio.end()) return false;
+
+    // Mantener la carga del transportista al entrar o salir de "en camino"
+    Envio& envio = envios[it->second];
+    if (envio.estado == "en camino" && nuevoEstado != "en camino") {
+        Despacho::liberar(envio.idTransportista);
+    } else if (envio.estado != "en camino" && nuevoEstado == "en camino") {
+        Despacho::registrar(envio.idTransportista);
+    }
+
+    bool cambio = (envio.estado != nuevoEstado);
+    string estadoAnterior = envio.estado;
+    envio.estado = nuevoEstado;
+    if (!escribirRegistro(it->second)) {
+        envio.estado = estadoAnterior;
+        Despacho::invalidar();
+        return false;
+    }
+    if (cambio) EventosEnvios::registrar(envio, nuevoEstado);
+    if (liberaFranja(nuevoEstado)) Reservas::liberar(idEnvio);
+    return true;
+}
+
+/**
+ * @brief Un pedido está entregado cuando lo están todos sus envíos no cancelados.
  *
- * @return Vector de transportistas con disponibilidad "disponible".
+ * @return false si el pedido no tiene envíos activos o alguno sigue pendiente.
  */
-vector<Transportistas> cargarTransportistasDisponibles() {
-    vector<Transportistas> todos;
-    Transportistas::cargarDesdeArchivo(todos);
-    vector<Transportistas> disponibles;
-    for (const auto& t : todos) {
-        if (t.disponibilidad == "disponible")
-            disponibles.push_back(t);
+bool Envios::pedidoEntregado(const string& idPedido) {
+    asegurarCargados();
+    auto it = indicePorPedido.find(idPedido);
+    if (it == indicePorPedido.end()) return false;
+
+    bool alguno = false;
+    for (size_t posicion : it->second) {
+        string estado = estadoEnMinusculas(envios[posicion].estado);
+        if (estado == "cancelado") continue;
+        if (estado != "entregado") return false;
+        alguno = true;
     }
-    return disponibles;
+    return alguno;
 }
 
 /**
- * @brief Carga todos los pedidos existentes desde el archivo binario.
+ * @brief Primer ID libre del rango de envíos (índice primario y archivo histórico).
  *
- * @return Vector con la lista de pedidos.
+ * @return El ID como entero, o 0 si el rango está completo.
+ */
+int Envios::generarIdEnvio() {
+    asegurarCargados();
+    for (int i = ID_ENVIO_INICIAL; i <= ID_ENVIO_FINAL; ++i) {
+        string id = to_string(i);
+        if (!indicePorEnvio.count(id) && !Archivador::contieneEnvio(id)) return i;
+    }
+    return 0;
+}
+
+/**
+ * @brief Cuenta los envíos "en camino" de cada transportista.
  */
-vector<Pedidos> cargarPedidos() {
-    Pedidos::cargarDesdeArchivoBin(Pedidos::listaPedidos);
-    return Pedidos::listaPedidos;
+unordered_map<string, int> Envios::enCursoPorTransportista() {
+    asegurarCargados();
+    unordered_map<string, int> conteo;
+    for (const auto& envio : envios) {
+        if (envio.estado == "en camino") conteo[envio.idTransportista]++;
+    }
+    return conteo;
 }
 
+// ----------- Importación de manifiestos de entrega ------------
+
 /**
- * @brief Guarda la lista de pedidos en el archivo binario.
+ * @brief Línea válida de un manifiesto de entregas.
+ */
+struct LineaManifiesto {
+    string idEnvio;
+    string estado;
+    time_t fecha;
+    size_t numero;  ///< Número de línea en el archivo
+};
+
+// Quita espacios (y el '\r' de archivos de Windows) al inicio y al final
+static string recortar(const string& texto) {
+    size_t inicio = texto.find_first_not_of(" \t\r\n");
+    if (inicio == string::npos) return "";
+    size_t fin = texto.find_last_not_of(" \t\r\n");
+    return texto.substr(inicio, fin - inicio + 1);
+}
+
+// Estado del manifiesto con la misma escritura que usa el resto del módulo; "" si no es válido
+static string estadoDeManifiesto(const string& texto) {
+    string valor;
+    for (char c : texto) valor += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    if (valor == "en camino" || valor == "entregado") return valor;
+    if (valor == "cancelado") return "Cancelado";
+    return "";
+}
+
+// Fecha en epoch o "AAAA-MM-DD HH:MM[:SS]" (hora local); 0 si no es válida
+static time_t fechaDeManifiesto(const string& texto) {
+    if (!texto.empty() && all_of(texto.begin(), texto.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)); })) {
+        return static_cast<time_t>(strtoll(texto.c_str(), nullptr, 10));
+    }
+
+    int anio = 0, mes = 0, dia = 0, hora = 0, minuto = 0, segundo = 0;
+    int campos = sscanf(texto.c_str(), "%d-%d-%d %d:%d:%d", &anio, &mes, &dia, &hora, &minuto, &segundo);
+    if (campos != 3 && campos < 5) return 0;
+    if (mes < 1 || mes > 12 || dia < 1 || dia > 31 || hora > 23 || minuto > 59 || segundo > 60) return 0;
+
+    tm fecha{};
+    fecha.tm_year = anio - 1900;
+    fecha.tm_mon = mes - 1;
+    fecha.tm_mday = dia;
+    fecha.tm_hour = hora;
+    fecha.tm_min = minuto;
+    fecha.tm_sec = segundo;
+    fecha.tm_isdst = -1;
+    time_t resultado = mktime(&fecha);
+    return resultado == static_cast<time_t>(-1) ? 0 : resultado;
+}
+
+/**
+ * @brief Aplica un manifiesto de entregas con un cruce ordenado y un solo guardado.
  *
- * @param pedidos Vector de pedidos a guardar.
+ * Si un envío aparece varias veces, sus líneas se aplican en orden de fecha
+ * y cada cambio queda en el historial con la fecha del manifiesto.
  */
-void guardarPedidos(const vector<Pedidos>& pedidos) {
-    Pedidos::listaPedidos = pedidos;
-    Pedidos::guardarEnArchivoBin(Pedidos::listaPedidos);
+Envios::ResultadoImportacion Envios::importarManifiesto(const string& ruta) {
+    ResultadoImportacion resultado;
+    const size_t MAX_ERRORES = 20;
+    auto anotar = [&resultado, MAX_ERRORES](size_t numero, const string& motivo) {
+        if (resultado.errores.size() < MAX_ERRORES) {
+            resultado.errores.push_back("linea " + to_string(numero) + ": " + motivo);
+        }
+    };
+
+    ifstream archivo(ruta);
+    if (!archivo) {
+        resultado.errores.push_back("No se pudo abrir " + ruta);
+        return resultado;
+    }
+
+    // 1. Leer y validar el manifiesto
+    vector<LineaManifiesto> lineas;
+    string texto;
+    size_t numero = 0;
+    while (getline(archivo, texto)) {
+        numero++;
+        texto = recortar(texto);
+        if (texto.empty() || texto[0] == '#') continue;
+
+        size_t coma1 = texto.find(',');
+        size_t coma2 = (coma1 == string::npos) ? string::npos : texto.find(',', coma1 + 1);
+        if (coma2 == string::npos) {
+            resultado.lineas++;
+            resultado.invalidas++;
+            anotar(numero, "se esperaban 3 campos (idEnvio,estado,fecha)");
+            continue;
+        }
+        string id = recortar(texto.substr(0, coma1));
+        string estado = recortar(texto.substr(coma1 + 1, coma2 - coma1 - 1));
+        string fecha = recortar(texto.substr(coma2 + 1));
+        if (lineas.empty() && resultado.lineas == 0 && id == "idEnvio") continue;  // Encabezado
+
+        resultado.lineas++;
+        LineaManifiesto linea{id, estadoDeManifiesto(estado), fechaDeManifiesto(fecha), numero};
+        if (linea.idEnvio.empty() || linea.estado.empty() || linea.fecha == 0) {
+            resultado.invalidas++;
+            anotar(numero, linea.estado.empty() ? "estado no valido '" + estado + "'" : "ID o fecha no validos");
+            continue;
+        }
+        lineas.push_back(move(linea));
+    }
+
+    // 2. Ordenar el manifiesto por (ID, fecha) y los envíos por ID
+    sort(lineas.begin(), lineas.end(), [](const LineaManifiesto& a, const LineaManifiesto& b) {
+        if (a.idEnvio != b.idEnvio) return a.idEnvio < b.idEnvio;
+        if (a.fecha != b.fecha) return a.fecha < b.fecha;
+        return a.numero < b.numero;
+    });
+
+    asegurarCargados();
+    vector<size_t> orden(envios.size());
+    iota(orden.begin(), orden.end(), 0);
+    sort(orden.begin(), orden.end(), [](size_t a, size_t b) { return envios[a].idEnvio < envios[b].idEnvio; });
+
+    // 3. Cruce en una pasada: ambos recorridos avanzan siempre hacia adelante
+    vector<EventosEnvios::Evento> eventos;
+    vector<string> pedidosEntregados;
+    vector<string> cerrados;
+    size_t posicion = 0;
+    for (const auto& linea : lineas) {
+        while (posicion < orden.size() && envios[orden[posicion]].idEnvio < linea.idEnvio) ++posicion;
+        if (posicion == orden.size() || envios[orden[posicion]].idEnvio != linea.idEnvio) {
+            resultado.noEncontradas++;
+            anotar(linea.numero, "no existe el envio " + linea.idEnvio);
+            continue;
+        }
+
+        Envio& envio = envios[orden[posicion]];
+        if (envio.estado == linea.estado) {
+            resultado.sinCambio++;
+            continue;
+        }
+        if (envio.estado == "entregado" || envio.estado == "Cancelado") {
+            resultado.rechazadas++;
+            anotar(linea.numero, "el envio " + envio.idEnvio + " ya esta " + envio.estado);
+            continue;
+        }
+
+        // Mantener la carga del transportista al entrar o salir de "en camino"
+        if (envio.estado == "en camino") {
+            Despacho::liberar(envio.idTransportista);
+        } else if (linea.estado == "en camino") {
+            Despacho::registrar(envio.idTransportista);
+        }
+        envio.estado = linea.estado;
+
+        EventosEnvios::Evento evento;
+        evento.idEnvio = envio.idEnvio;
+        evento.idPedido = envio.idPedido;
+        evento.idTransportista = envio.idTransportista;
+        evento.estado = linea.estado;
+        evento.fecha = linea.fecha;
+        eventos.push_back(evento);
+
+        if (linea.estado == "entregado") pedidosEntregados.push_back(envio.idPedido);
+        if (liberaFranja(linea.estado)) cerrados.push_back(envio.idEnvio);
+        resultado.aplicadas++;
+    }
+
+    // 4. Confirmar una sola vez cada archivo
+    if (resultado.aplicadas == 0) return resultado;
+    if (!guardarEnviosEnArchivo(envios)) {
+        // Nada quedó escrito: se vuelve a lo que hay en el archivo
+        cargarEnviosDesdeArchivo();
+        Despacho::invalidar();
+        resultado.errores.push_back("No se pudo guardar envios.bin; no se aplico ningun cambio");
+        resultado.aplicadas = 0;
+        return resultado;
+    }
+    EventosEnvios::registrarVarios(eventos);
+    for (const auto& idEnvio : cerrados) Reservas::liberar(idEnvio);
+
+    // Un pedido con otros envíos todavía en camino no se da por entregado
+    sort(pedidosEntregados.begin(), pedidosEntregados.end());
+    pedidosEntregados.erase(unique(pedidosEntregados.begin(), pedidosEntregados.end()), pedidosEntregados.end());
+    pedidosEntregados.erase(remove_if(pedidosEntregados.begin(), pedidosEntregados.end(),
+        [](const string& idPedido) { return !pedidoEntregado(idPedido); }), pedidosEntregados.end());
+    Pedidos::actualizarEstados(pedidosEntregados, "entregado");
+    resultado.pedidosEntregados = pedidosEntregados.size();
+    return resultado;
 }
 
 // ----------- Métodos de Envios ------------
@@ -170,8 +742,9 @@ void Envios::crearEnvioInteractivo() {
     cout << "                    CREAR NUEVO ENVIO                        \n";
     cout << "------------------------------------------------------------\n";
 
-    vector<Transportistas> transportistas = cargarTransportistasDisponibles();
-    vector<Pedidos> pedidos = cargarPedidos();
+    vector<Transportistas> transportistas = Transportistas::getTransportistasDisponibles();
+    shared_ptr<const InstantaneaPedidos> vista = Pedidos::obtenerInstantanea();
+    const vector<Pedidos>& pedidos = vista->pedidos;
 
     if (transportistas.empty()) {
         cout << "\n\tNo hay transportistas disponibles.\n";
@@ -228,47 +801,88 @@ void Envios::crearEnvioInteractivo() {
     }
     cout << "----------------------------------------------\n";
 
-    int opcionTransportista;
-    cout << "Seleccione numero del transportista a asignar (0 para salir): ";
-    cin >> opcionTransportista;
-    if (opcionTransportista == 0) {
+    string opcion;
+    cout << "Seleccione numero del transportista a asignar (A = automatico, 0 para salir): ";
+    cin >> opcion;
+    if (opcion == "0") {
         system("pause");
         return;
     }
-    if (opcionTransportista < 1 || opcionTransportista > (int)transportistas.size()) {
-        cout << "\n\tOpcion de transportista invalida.\n";
+
+    Envio nuevo;
+    int idLibre = generarIdEnvio();
+    nuevo.idEnvio = idLibre ? to_string(idLibre) : "";
+    if (nuevo.idEnvio.empty()) {
+        cout << "\n\tNo hay IDs disponibles para nuevos envios.\n";
         system("pause");
         return;
     }
 
-    Transportistas seleccionado = transportistas[opcionTransportista - 1];
+    // La capacidad se reserva en una franja del transportista junto con la asignación
+    Reservas::Carga carga = Reservas::Carga::deUnidades(itPedido->getTotales().unidades);
+    Reservas::Reserva reserva;
+    string idTransportista;
+    bool automatico = (opcion == "A" || opcion == "a");
+    if (automatico) {
+        string tipo;
+        cout << "Tipo de vehiculo requerido (moto/pickup/panel/camion, * = cualquiera): ";
+        cin >> tipo;
+        idTransportista = Despacho::asignarConReserva(nuevo.idEnvio, carga, reserva, tipo == "*" ? "" : tipo);
+        if (idTransportista.empty()) {
+            cout << "\n\tNingun transportista de ese tipo tiene lugar en los proximos "
+                 << Reservas::DIAS_AGENDA << " dias.\n";
+            system("pause");
+            return;
+        }
+    } else {
+        int opcionTransportista = atoi(opcion.c_str());
+        if (opcionTransportista < 1 || opcionTransportista > (int)transportistas.size()) {
+            cout << "\n\tOpcion de transportista invalida.\n";
+            system("pause");
+            return;
+        }
+        idTransportista = transportistas[opcionTransportista - 1].id;
+        if (!Reservas::reservar(nuevo.idEnvio, idTransportista, carga, reserva)) {
+            cout << "\n\tEl transportista no tiene lugar para " << carga.unidades
+                 << " unidades en los proximos " << Reservas::DIAS_AGENDA << " dias.\n";
+            system("pause");
+            return;
+        }
+        Despacho::registrar(idTransportista);
+    }
 
-    Envio nuevo;
-    vector<Envio> envios = cargarEnviosDesdeArchivo();
-    nuevo.idEnvio = generarIdEnvioUnico(envios);
     nuevo.idPedido = idPedido;
-    nuevo.idTransportista = seleccionado.id;
+    nuevo.idTransportista = idTransportista;
+    nuevo.idCliente = itPedido->getIdCliente();
     nuevo.estado = "en camino";
 
-    envios.push_back(nuevo);
-    guardarEnviosEnArchivo(envios);
-
-    for (auto& p : pedidos) {
-        if (p.getId() == idPedido) {
-            p.setEstado("enviado");
+    if (!agregarEnvio(nuevo)) {
+        Reservas::liberar(nuevo.idEnvio);
+        Despacho::liberar(idTransportista);
+        cout << "\n\tNo se pudo guardar el envio.\n";
+        system("pause");
+        return;
+    }
+    Pedidos::actualizarEstado(idPedido, "enviado");
+
+    const Transportistas::Vehiculo* vehiculo = Transportistas::vehiculoDe(idTransportista);
+    auditoria.registrar(usuarioRegistrado.getNombre(), "ENVIOS", "Creado envio para pedido " + idPedido + " con transportista " + idTransportista);
+    cout << "\n\tEnvio creado exitosamente. Franja: " << Reservas::textoDia(reserva.dia);
+    if (vehiculo) {
+        for (const auto& franja : vehiculo->franjas) {
+            if (franja.horaInicio == reserva.franja) cout << " " << franja.horaInicio << ":00-" << franja.horaFin << ":00";
         }
     }
-    guardarPedidos(pedidos);
-
-    auditoria.registrar(usuarioRegistrado.getNombre(), "ENVIOS", "Creado envio para pedido " + idPedido + " con transportista " + seleccionado.id);
-    cout << "\n\tEnvio creado exitosamente.\n";
+    cout << "\n";
 }
 
 /**
  * @brief Crea un nuevo envío automáticamente con un transportista disponible.
  *
- * Utiliza el primer transportista disponible en la lista proporcionada.
- * Asigna un ID único al envío y lo marca como "en camino".
+ * El transportista lo elige Despacho (menor carga o round-robin ponderado)
+ * entre los que tienen lugar en alguna franja para las unidades del pedido;
+ * la capacidad queda reservada. Asigna un ID único al envío y lo marca como
+ * "en camino".
  *
  * @param idPedido ID del pedido al cual se le asignará el envío.
  * @param transportistasDisponibles Lista de transportistas disponibles.
@@ -279,18 +893,41 @@ void Envios::crearEnvio(const std::string& idPedido, const std::vector<Transport
         return;
     }
 
-    std::vector<Envio> envios = cargarEnviosDesdeArchivo();
-
     Envio nuevo;
-    nuevo.idEnvio = generarIdEnvioUnico(envios);
+    int idLibre = generarIdEnvio();
+    nuevo.idEnvio = idLibre ? to_string(idLibre) : "";
+    if (nuevo.idEnvio.empty()) {
+        std::cout << "No hay IDs disponibles para nuevos envios." << std::endl;
+        return;
+    }
     nuevo.idPedido = idPedido;
-    nuevo.idTransportista = transportistasDisponibles.front().id;
     nuevo.estado = "en camino";
 
-    envios.push_back(nuevo);
-    guardarEnviosEnArchivo(envios);
+    // El cliente y las unidades se toman del pedido (la instantánea ya tiene su índice por ID)
+    shared_ptr<const InstantaneaPedidos> vista = Pedidos::obtenerInstantanea();
+    Reservas::Carga carga;
+    if (const Pedidos* pedido = vista->buscar(idPedido)) {
+        nuevo.idCliente = pedido->getIdCliente();
+        carga = Reservas::Carga::deUnidades(pedido->getTotales().unidades);
+    }
 
-    std::cout << "Envio creado con exito para pedido: " << idPedido << std::endl;
+    Reservas::Reserva reserva;
+    nuevo.idTransportista = Despacho::asignarConReserva(nuevo.idEnvio, carga, reserva);
+    if (nuevo.idTransportista.empty()) {
+        std::cout << "Ningun transportista tiene lugar para el pedido en los proximos "
+                  << Reservas::DIAS_AGENDA << " dias." << std::endl;
+        return;
+    }
+
+    if (!agregarEnvio(nuevo)) {
+        Reservas::liberar(nuevo.idEnvio);
+        Despacho::liberar(nuevo.idTransportista);
+        std::cout << "No se pudo guardar el envio." << std::endl;
+        return;
+    }
+
+    std::cout << "Envio creado con exito para pedido: " << idPedido
+              << " (transportista " << nuevo.idTransportista << ")" << std::endl;
 }
 
 /**
@@ -415,43 +1052,32 @@ void modificarEstadoEnvio() {
         return;
     }
 
-    bool encontrado = false;
-    for (auto& envio : envios) {
-        if (envio.idEnvio == idEnvio) {
-            encontrado = true;
-
-            cout << "\nEstado actual: " << envio.estado << "\n";
-
-            string nuevoEstado;
-            cout << "Ingrese nuevo estado (en camino / entregado): ";
-            getline(cin, nuevoEstado);
-
-            // Validación del estado
-            if (nuevoEstado != "en camino" && nuevoEstado != "entregado") {
-                cout << "\n\tEstado invalido. Solo se permite 'en camino' o 'entregado'.\n";
-                cout << "------------------------------------------------------------------------------------\n";
-                system("pause");
-                return;
-            }
+    const Envio* envio = Envios::buscarEnvio(idEnvio);
+    bool encontrado = (envio != nullptr);
+    if (encontrado) {
+        cout << "\nEstado actual: " << envio->estado << "\n";
+
+        string nuevoEstado;
+        cout << "Ingrese nuevo estado (en camino / entregado): ";
+        getline(cin, nuevoEstado);
+
+        // Validación del estado
+        if (nuevoEstado != "en camino" && nuevoEstado != "entregado") {
+            cout << "\n\tEstado invalido. Solo se permite 'en camino' o 'entregado'.\n";
+            cout << "------------------------------------------------------------------------------------\n";
+            system("pause");
+            return;
+        }
 
-            envio.estado = nuevoEstado;
-
-            // Si se marcó como entregado, actualizar también en pedidos
-            if (nuevoEstado == "entregado") {
-                vector<Pedidos> pedidos = cargarPedidos();
-                for (auto& pedido : pedidos) {
-                    if (pedido.getId() == envio.idPedido) {
-                        pedido.setEstado("entregado");
-                        break;
-                    }
-                }
-                guardarPedidos(pedidos);
-            }
+        string idPedido = envio->idPedido;
+        Envios::actualizarEstadoEnvio(idEnvio, nuevoEstado);
 
-            Envios::guardarEnviosEnArchivo(envios);
-            cout << "\n---------------------------- Estado actualizado exitosamente ----------------------------\n";
-            break;
+        // El pedido pasa a entregado cuando ya no le queda ningún envío sin entregar
+        if (nuevoEstado == "entregado" && Envios::pedidoEntregado(idPedido)) {
+            Pedidos::actualizarEstado(idPedido, "entregado");
         }
+
+        cout << "\n---------------------------- Estado actualizado exitosamente ----------------------------\n";
     }
 
     if (!encontrado) {
@@ -502,31 +1128,25 @@ void cancelarEnvio() {
         return;
     }
 
-    bool encontrado = false;
-    for (auto& envio : envios) {
-        if (envio.idEnvio == idEnvio) {
-            encontrado = true;
-
-            if (envio.estado == "entregado") {
-                cout << "\n\tNo se puede cancelar un envío ya entregado.\n";
-                cout << "---------------------------------------------------------------------------\n";
-                system("pause");
-                return;
-            }
-            if (envio.estado != "en camino") {
-                cout << "\n\tNo se puede cancelar el envío en estado actual: " << envio.estado << "\n";
-                cout << "---------------------------------------------------------------------------\n";
-                system("pause");
-                return;
-            }
-
-            envio.estado = "Cancelado";
-            break;
+    const Envio* envio = Envios::buscarEnvio(idEnvio);
+    bool encontrado = (envio != nullptr);
+    if (encontrado) {
+        if (envio->estado == "entregado") {
+            cout << "\n\tNo se puede cancelar un envío ya entregado.\n";
+            cout << "---------------------------------------------------------------------------\n";
+            system("pause");
+            return;
+        }
+        if (envio->estado != "en camino") {
+            cout << "\n\tNo se puede cancelar el envío en estado actual: " << envio->estado << "\n";
+            cout << "---------------------------------------------------------------------------\n";
+            system("pause");
+            return;
         }
     }
 
     if (encontrado) {
-        Envios::guardarEnviosEnArchivo(envios);
+        Envios::actualizarEstadoEnvio(idEnvio, "Cancelado");
         cout << "\n----------------------------- Envío cancelado exitosamente -----------------------------\n";
     } else {
         cout << "\n\tNo se encontro el envio con ID: " << idEnvio << "\n";
@@ -576,13 +1196,25 @@ void eliminarEnvio() {
         return;
     }
 
-    auto it = std::remove_if(envios.begin(), envios.end(), [idEnvio](const Envio& envio) {
+    auto it = std::find_if(envios.begin(), envios.end(), [&idEnvio](const Envio& envio) {
         return envio.idEnvio == idEnvio;
     });
 
     if (it != envios.end()) {
-        envios.erase(it, envios.end());
-        Envios::guardarEnviosEnArchivo(envios);
+        // El evento se registra con una copia del envío eliminado, una vez guardado el archivo
+        Envio eliminado = *it;
+        envios.erase(std::remove_if(envios.begin(), envios.end(), [&idEnvio](const Envio& envio) {
+            return envio.idEnvio == idEnvio;
+        }), envios.end());
+        Despacho::invalidar();
+        if (!Envios::guardarEnviosEnArchivo(envios)) {
+            Envios::cargarEnviosDesdeArchivo();
+            cout << "\n\tNo se pudo eliminar el envio " << idEnvio << ".\n";
+            system("pause");
+            return;
+        }
+        EventosEnvios::registrar(eliminado, "eliminado");
+        Reservas::liberar(idEnvio);
         cout << "\n----------------------------- Envio eliminado exitosamente -----------------------------\n";
     } else {
         cout << "\n\tNo se encontro el envio con ID: " << idEnvio << "\n";
@@ -592,6 +1224,47 @@ void eliminarEnvio() {
     system("pause");
 }
 
+/**
+ * @brief Importa un manifiesto de entregas indicado por el usuario y muestra el resumen.
+ */
+void importarManifiestoEntregas() {
+    system("cls");
+    cout << "\n------------------------ Importar Manifiesto de Entregas ------------------------\n" << endl;
+    cout << "Formato: una linea por entrega con idEnvio,estado,fecha\n";
+    cout << "Estados: en camino / entregado / cancelado. Fecha: AAAA-MM-DD HH:MM[:SS] o epoch.\n\n";
+
+    cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // limpiar buffer
+
+    string ruta;
+    cout << "Ruta del archivo (0 para salir): ";
+    getline(cin, ruta);
+    if (ruta == "0" || ruta.empty()) return;
+
+    auto inicio = chrono::steady_clock::now();
+    Envios::ResultadoImportacion resultado = Envios::importarManifiesto(ruta);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+
+    cout << "\n\tLineas leidas:        " << resultado.lineas << "\n";
+    cout << "\tCambios aplicados:    " << resultado.aplicadas << "\n";
+    cout << "\tSin cambio:           " << resultado.sinCambio << "\n";
+    cout << "\tEnvios inexistentes:  " << resultado.noEncontradas << "\n";
+    cout << "\tLineas invalidas:     " << resultado.invalidas << "\n";
+    cout << "\tRechazadas:           " << resultado.rechazadas << "\n";
+    cout << "\tPedidos entregados:   " << resultado.pedidosEntregados << "\n";
+    cout << "\tTiempo:               " << static_cast<long>(ms + 0.5) << " ms\n";
+    if (!resultado.errores.empty()) {
+        cout << "\n\tPrimeros problemas encontrados:\n";
+        for (const auto& error : resultado.errores) cout << "\t  - " << error << "\n";
+    }
+
+    if (resultado.aplicadas > 0) {
+        auditoria.registrar(usuarioRegistrado.getNombre(), "ENVIOS",
+                            "Manifiesto de entregas " + ruta + ": " + to_string(resultado.aplicadas) + " cambios aplicados");
+    }
+    cout << "------------------------------------------------------------------------------------\n";
+    system("pause");
+}
+
 /**
  * @brief Menú principal de gestión de envíos.
  *
@@ -610,7 +1283,14 @@ void Envios::gestionEnvios() {
         cout << "   [3] Modificar estado de envio\n";
         cout << "   [4] Cancelar envio\n";
         cout << "   [5] Eliminar envio\n";
-        cout << "   [6] Volver al menu principal\n";
+        cout << "   [6] Consolidar envios por zona (manifiestos)\n";
+        cout << "   [7] Modo de asignacion de transportistas ("
+             << (Despacho::getModo() == Despacho::Modo::MenosCargado ? "menor carga" : "round-robin ponderado")
+             << ")\n";
+        cout << "   [8] Historial de un envio\n";
+        cout << "   [9] Importar manifiesto de entregas\n";
+        cout << "   [10] Planificar rutas de reparto\n";
+        cout << "   [11] Volver al menu principal\n";
         cout << "--------------------------------------------------------------------------------\n";
         cout << "                     Seleccione una opcion: ";
         cin >> opcion;
@@ -632,6 +1312,23 @@ void Envios::gestionEnvios() {
                 eliminarEnvio();
                 break;
             case 6:
+                Consolidacion::consolidarEnvios();
+                break;
+            case 7:
+                Despacho::setModo(Despacho::getModo() == Despacho::Modo::MenosCargado
+                                  ? Despacho::Modo::RoundRobinPonderado
+                                  : Despacho::Modo::MenosCargado);
+                break;
+            case 8:
+                EventosEnvios::mostrarHistorial();
+                break;
+            case 9:
+                importarManifiestoEntregas();
+                break;
+            case 10:
+                Rutas::planificarRutas();
+                break;
+            case 11:
                 cout << "\n\tSaliendo al menu principal...\n";
                 break;
             default:
@@ -639,6 +1336,6 @@ void Envios::gestionEnvios() {
                 system("pause");
                 break;
         }
-    } while (opcion != 6);
+    } while (opcion != 11);
 
 }
@@ -0,0 +1,333 @@
+#include "eventosenvios.h"
+#include "pedidos.h"
+#include "crc32.h"
+
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <unordered_map>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cctype>
+
+using namespace std;
+
+// ----------- Formato de eventos_envios.bin ------------
+
+const char* const ARCHIVO_EVENTOS = "eventos_envios.bin";
+const char FIRMA_EVENTOS[4] = {'E', 'V', 'E', 'N'};
+const uint32_t VERSION_EVENTOS = 1;
+
+// Registros leídos por cada lectura del archivo
+const size_t EVENTOS_POR_LECTURA = 256;
+
+/**
+ * @brief Cabecera del archivo de eventos (16 bytes). La cantidad se deduce del tamaño.
+ */
+struct CabeceraEventos {
+    char firma[4];         ///< "EVEN"
+    uint32_t version;
+    uint32_t tamRegistro;  ///< Bytes por registro
+    uint32_t reservado;
+};
+
+/**
+ * @brief Registro de tamaño fijo de un evento en disco.
+ */
+struct RegistroEvento {
+    char idEnvio[16];
+    char idPedido[16];
+    char idTransportista[16];
+    char idAlmacen[16];
+    char estado[16];
+    int64_t fecha;
+    int64_t fechaPedido;
+    uint32_t crc;          ///< CRC-32 de los campos anteriores
+    uint32_t reservado;
+};
+
+// Copia un texto a un campo de tamaño fijo (siempre termina en '\0')
+static void copiarCampo(char* destino, size_t tam, const string& origen) {
+    memset(destino, 0, tam);
+    strncpy(destino, origen.c_str(), tam - 1);
+}
+
+// Lee un campo de tamaño fijo aunque no termine en '\0'
+static string leerCampo(const char* origen, size_t tam) {
+    return string(origen, strnlen(origen, tam));
+}
+
+// Estado en minúsculas: "Cancelado" y "cancelado" son el mismo evento
+static string normalizarEstado(const string& estado) {
+    string resultado;
+    for (char c : estado) resultado += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    return resultado;
+}
+
+static EventosEnvios::Evento desdeRegistro(const RegistroEvento& r) {
+    EventosEnvios::Evento e;
+    e.idEnvio = leerCampo(r.idEnvio, sizeof(r.idEnvio));
+    e.idPedido = leerCampo(r.idPedido, sizeof(r.idPedido));
+    e.idTransportista = leerCampo(r.idTransportista, sizeof(r.idTransportista));
+    e.idAlmacen = leerCampo(r.idAlmacen, sizeof(r.idAlmacen));
+    e.estado = leerCampo(r.estado, sizeof(r.estado));
+    e.fecha = static_cast<time_t>(r.fecha);
+    e.fechaPedido = static_cast<time_t>(r.fechaPedido);
+    return e;
+}
+
+/**
+ * @brief Recorre el archivo en orden llamando a 'visitar' con cada evento válido.
+ *
+ * Lee por bloques de EVENTOS_POR_LECTURA registros; la memoria usada no
+ * depende del tamaño del archivo.
+ *
+ * @return Cantidad de registros descartados por CRC inválido o truncados.
+ */
+template <typename Visitante>
+static size_t recorrerEventos(Visitante visitar) {
+    ifstream archivo(ARCHIVO_EVENTOS, ios::binary);
+    if (!archivo) return 0;
+
+    CabeceraEventos cabecera;
+    if (!archivo.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera)) ||
+        memcmp(cabecera.firma, FIRMA_EVENTOS, sizeof(cabecera.firma)) != 0 ||
+        cabecera.tamRegistro < sizeof(RegistroEvento)) {
+        cerr << "\n\tError: la cabecera de " << ARCHIVO_EVENTOS << " no es válida.\n";
+        return 0;
+    }
+
+    size_t descartados = 0;
+    vector<char> buffer(EVENTOS_POR_LECTURA * cabecera.tamRegistro);
+    while (archivo) {
+        archivo.read(buffer.data(), buffer.size());
+        size_t leidos = static_cast<size_t>(archivo.gcount());
+        size_t completos = leidos / cabecera.tamRegistro;
+        if (leidos % cabecera.tamRegistro != 0) descartados++;  // Escritura interrumpida al final
+
+        for (size_t i = 0; i < completos; ++i) {
+            RegistroEvento r;
+            memcpy(&r, buffer.data() + i * cabecera.tamRegistro, sizeof(r));
+            if (r.crc != calcularCrc32(&r, offsetof(RegistroEvento, crc))) {
+                descartados++;
+                continue;
+            }
+            visitar(desdeRegistro(r));
+        }
+    }
+    return descartados;
+}
+
+// ----------- Registro de eventos ------------
+
+void EventosEnvios::Estadistica::agregar(double segundos) {
+    if (cantidad == 0 || segundos < minimo) minimo = segundos;
+    if (cantidad == 0 || segundos > maximo) maximo = segundos;
+    suma += segundos;
+    cantidad++;
+}
+
+bool EventosEnvios::registrar(const Envio& envio, const string& estado, time_t fecha) {
+    Evento e;
+    e.idEnvio = envio.idEnvio;
+    e.idPedido = envio.idPedido;
+    e.idTransportista = envio.idTransportista;
+    e.estado = estado;
+    e.fecha = fecha;
+    return registrarVarios({e});
+}
+
+bool EventosEnvios::registrarVarios(const vector<Evento>& eventos) {
+    if (eventos.empty()) return true;
+
+    // Almacén y fecha del pedido: el análisis no necesita volver a pedidos.bin
+    shared_ptr<const InstantaneaPedidos> vista = Pedidos::obtenerInstantanea();
+    time_t ahora = time(nullptr);
+
+    vector<RegistroEvento> registros(eventos.size());
+    for (size_t i = 0; i < eventos.size(); ++i) {
+        const Evento& e = eventos[i];
+        RegistroEvento& r = registros[i];
+        memset(&r, 0, sizeof(r));
+        copiarCampo(r.idEnvio, sizeof(r.idEnvio), e.idEnvio);
+        copiarCampo(r.idPedido, sizeof(r.idPedido), e.idPedido);
+        copiarCampo(r.idTransportista, sizeof(r.idTransportista), e.idTransportista);
+        copiarCampo(r.estado, sizeof(r.estado), e.estado);
+        r.fecha = static_cast<int64_t>(e.fecha != 0 ? e.fecha : ahora);
+        if (const Pedidos* pedido = vista->buscar(e.idPedido)) {
+            copiarCampo(r.idAlmacen, sizeof(r.idAlmacen), pedido->getIdAlmacen());
+            r.fechaPedido = static_cast<int64_t>(pedido->getFechaPedido());
+        }
+        r.crc = calcularCrc32(&r, offsetof(RegistroEvento, crc));
+    }
+
+    // Tamaño actual: si una escritura anterior quedó a medias se rellena hasta
+    // el siguiente registro para no desalinear los que vienen (el relleno no pasa el CRC)
+    uint64_t tamActual = 0;
+    {
+        ifstream existente(ARCHIVO_EVENTOS, ios::binary | ios::ate);
+        if (existente) tamActual = static_cast<uint64_t>(existente.tellg());
+    }
+    bool nuevo = tamActual < sizeof(CabeceraEventos);
+    size_t relleno = 0;
+    if (!nuevo) {
+        uint64_t sobrante = (tamActual - sizeof(CabeceraEventos)) % sizeof(RegistroEvento);
+        if (sobrante != 0) relleno = static_cast<size_t>(sizeof(RegistroEvento) - sobrante);
+    }
+
+    ofstream archivo(ARCHIVO_EVENTOS, ios::binary | ios::app);
+    if (!archivo) {
+        cerr << "\n\tError: no se pudo abrir " << ARCHIVO_EVENTOS << " para escritura.\n";
+        return false;
+    }
+    if (nuevo) {
+        archivo.close();
+        archivo.open(ARCHIVO_EVENTOS, ios::binary | ios::trunc);
+        CabeceraEventos cabecera;
+        memset(&cabecera, 0, sizeof(cabecera));
+        memcpy(cabecera.firma, FIRMA_EVENTOS, sizeof(cabecera.firma));
+        cabecera.version = VERSION_EVENTOS;
+        cabecera.tamRegistro = sizeof(RegistroEvento);
+        archivo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+    }
+    if (relleno > 0) {
+        vector<char> ceros(relleno, 0);
+        archivo.write(ceros.data(), ceros.size());
+    }
+    archivo.write(reinterpret_cast<const char*>(registros.data()), registros.size() * sizeof(RegistroEvento));
+    return static_cast<bool>(archivo);
+}
+
+vector<EventosEnvios::Evento> EventosEnvios::historial(const string& idEnvio) {
+    vector<Evento> resultado;
+    recorrerEventos([&](const Evento& e) {
+        if (e.idEnvio == idEnvio) resultado.push_back(e);
+    });
+    return resultado;
+}
+
+vector<EventosEnvios::Evento> EventosEnvios::cargarTodos() {
+    vector<Evento> resultado;
+    recorrerEventos([&](const Evento& e) { resultado.push_back(e); });
+    return resultado;
+}
+
+// ----------- Análisis de tiempos ------------
+
+/**
+ * @brief Una sola pasada por el historial.
+ *
+ * Solo se guarda en memoria el seguimiento de los envíos abiertos; al
+ * entregarse o cancelarse, sus tiempos se suman al total, a su transportista
+ * y a su almacén y el seguimiento se descarta.
+ */
+EventosEnvios::Analisis EventosEnvios::analizar(time_t plazo) {
+    struct Seguimiento {
+        string idTransportista;
+        string idAlmacen;
+        time_t fechaPedido = 0;
+        time_t fechaDespacho = 0;
+        bool despachado = false;
+    };
+
+    Analisis analisis;
+    unordered_map<string, Seguimiento> abiertos;
+
+    // Aplica 'accion' al total, al transportista y al almacén del envío
+    auto acumular = [&analisis](const Seguimiento& s, auto accion) {
+        accion(analisis.total);
+        accion(analisis.porTransportista[s.idTransportista]);
+        accion(analisis.porAlmacen[s.idAlmacen.empty() ? "sin almacen" : s.idAlmacen]);
+    };
+
+    analisis.descartados = recorrerEventos([&](const Evento& e) {
+        analisis.eventos++;
+        string estado = normalizarEstado(e.estado);
+
+        auto it = abiertos.find(e.idEnvio);
+        if (it == abiertos.end()) {
+            Seguimiento nuevo;
+            nuevo.idAlmacen = e.idAlmacen;
+            nuevo.fechaPedido = e.fechaPedido;
+            it = abiertos.emplace(e.idEnvio, nuevo).first;
+        }
+        Seguimiento& s = it->second;
+        s.idTransportista = e.idTransportista;
+
+        if (estado == "en camino") {
+            if (s.despachado) return;
+            s.despachado = true;
+            s.fechaDespacho = e.fecha;
+            analisis.enCurso++;
+            if (s.fechaPedido > 0 && e.fecha >= s.fechaPedido) {
+                double espera = difftime(e.fecha, s.fechaPedido);
+                acumular(s, [espera](TiemposEntrega& t) { t.pedidoADespacho.agregar(espera); });
+            }
+        } else if (estado == "entregado") {
+            if (s.despachado) {
+                analisis.enCurso--;
+                if (e.fecha >= s.fechaDespacho) {
+                    double transito = difftime(e.fecha, s.fechaDespacho);
+                    acumular(s, [transito](TiemposEntrega& t) { t.despachoAEntrega.agregar(transito); });
+                }
+            }
+            if (s.fechaPedido > 0 && e.fecha >= s.fechaPedido) {
+                double total = difftime(e.fecha, s.fechaPedido);
+                bool tarde = total > static_cast<double>(plazo);
+                acumular(s, [total, tarde](TiemposEntrega& t) {
+                    t.pedidoAEntrega.agregar(total);
+                    if (tarde) t.retrasos++;
+                });
+            }
+            abiertos.erase(it);
+        } else if (estado == "cancelado" || estado == "eliminado") {
+            if (s.despachado) analisis.enCurso--;
+            acumular(s, [](TiemposEntrega& t) { t.cancelados++; });
+            abiertos.erase(it);
+        }
+    });
+
+    return analisis;
+}
+
+// ----------- Consulta de historial ------------
+
+void EventosEnvios::mostrarHistorial() {
+    system("cls");
+    cout << "\n---------------------------- Historial de Envío ----------------------------\n" << endl;
+
+    cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // limpiar buffer
+
+    string idEnvio;
+    cout << "Ingrese ID de envio (0 para salir): ";
+    getline(cin, idEnvio);
+    if (idEnvio == "0") return;
+
+    vector<Evento> eventos = historial(idEnvio);
+    if (eventos.empty()) {
+        cout << "\n\tNo hay eventos registrados para el envío " << idEnvio << ".\n";
+        cout << "---------------------------------------------------------------------------\n";
+        system("pause");
+        return;
+    }
+
+    cout << "\nPedido: " << eventos.front().idPedido
+         << "   Almacen: " << (eventos.front().idAlmacen.empty() ? "-" : eventos.front().idAlmacen) << "\n\n";
+    cout << left << setw(22) << "Fecha"
+         << setw(16) << "Estado"
+         << setw(16) << "Transportista" << endl;
+    cout << "---------------------------------------------------------------------------\n";
+
+    for (const auto& e : eventos) {
+        char buffer[20];
+        strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", localtime(&e.fecha));
+        cout << left << setw(22) << buffer
+             << setw(16) << e.estado
+             << setw(16) << e.idTransportista << endl;
+    }
+    cout << "---------------------------------------------------------------------------\n";
+    system("pause");
+}
@@ -4,15 +4,157 @@
 #include "clientes.h"
 #include "usuarios.h"
 #include "bitacora.h"
+#include "grupohilos.h"
+#include "cartera.h"
+#include "antiguedad.h"
+#include "tarifas.h"
+#include "pagos.h"
+#include "columnar.h"
 #include <fstream>
 #include <iomanip>
 #include <cstring>
 #include <limits>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <ctime>
 
 extern usuarios usuarioRegistrado; // Usuario actualmente registrado
 extern bitacora auditoria;         // Bitcora para registrar acciones
 
+// --- Formato de facturas.bin ---
+const char FIRMA_FACTURAS[4] = {'F', 'A', 'C', 'T'};
+const uint32_t VERSION_FACTURAS = 5;   // 2: marca 'eliminada'; 3: 'importe' en centavos; 4: fechas; 5: IVA
+const int ID_FACTURA_INICIAL = 3555;   // Primer ID (mismo inicio que el rango anterior)
+const int DIAS_PLAZO_PAGO = 30;        // Vencimiento = emisin + plazo
+
+// Registro de la versin 3 (80 bytes): Factura hasta 'importe'. Desde la versin 3
+// los campos nuevos se agregan al final, as un registro anterior es un prefijo del actual
+const uint32_t TAM_FACTURA_V3 = 80;
+
+// Registro de las versiones 0 a 2 (68 bytes): Factura sin 'importe'
+struct FacturaAnterior {
+    int idFactura;
+    int idCliente;
+    int idPedido;
+    float monto;
+    bool pagada;
+    char cliente[50];
+    bool eliminada;         // Solo vlido desde la versin 2
+};
+
+// --- Formato de facturas.idx ---
+const char FIRMA_INDICE_FACTURAS[4] = {'F', 'I', 'D', 'X'};
+const uint32_t VERSION_INDICE_FACTURAS = 1;
+
+// Cabecera de facturas.idx (16 bytes)
+struct CabeceraIndiceFacturas {
+    char firma[4];          // "FIDX"
+    uint32_t version;
+    uint32_t cantidad;      // Entradas escritas (registros de facturas.bin cubiertos)
+    uint32_t reservado;
+};
+
+// Compactacin: cuando los eliminados superan esta proporcin (y este mnimo)
+const double UMBRAL_COMPACTACION = 0.25;
+const uint32_t MINIMO_COMPACTACION = 32;
+
+static_assert(sizeof(FacturaAnterior) == 68, "formato anterior de facturas.bin");
+static_assert(sizeof(Factura) == 104, "formato 5 de facturas.bin");
+static_assert(sizeof(EntradaIndiceFactura) == 12, "formato de facturas.idx");
+
+mutex Facturacion::mutexArchivo;
+unordered_map<int, uint32_t> Facturacion::posicionPorFactura;
+unordered_map<int, uint32_t> Facturacion::posicionPorPedido;
+uint32_t Facturacion::registrosIndexados = 0;
+bool Facturacion::indiceCargado = false;
+bool Facturacion::compactacionPendiente = false;
+
+// Posicin del registro i (contando desde 0) dentro del archivo
+static streamoff posicionFactura(uint32_t i) {
+    return static_cast<streamoff>(sizeof(CabeceraFacturas)) + static_cast<streamoff>(i) * sizeof(Factura);
+}
+
+// Posicin de la entrada i dentro de facturas.idx
+static streamoff posicionEntrada(uint32_t i) {
+    return static_cast<streamoff>(sizeof(CabeceraIndiceFacturas)) +
+           static_cast<streamoff>(i) * sizeof(EntradaIndiceFactura);
+}
+
+static CabeceraFacturas cabeceraNueva(int siguienteId, uint32_t cantidad) {
+    CabeceraFacturas cabecera;
+    memset(&cabecera, 0, sizeof(cabecera));
+    memcpy(cabecera.firma, FIRMA_FACTURAS, sizeof(cabecera.firma));
+    cabecera.version = VERSION_FACTURAS;
+    cabecera.tamRegistro = sizeof(Factura);
+    cabecera.siguienteId = siguienteId;
+    cabecera.cantidad = cantidad;
+    return cabecera;
+}
+
+static EntradaIndiceFactura entradaDe(const Factura& factura) {
+    EntradaIndiceFactura entrada;
+    memset(&entrada, 0, sizeof(entrada));
+    entrada.idFactura = factura.idFactura;
+    entrada.idPedido = factura.idPedido;
+    entrada.eliminada = factura.eliminada ? 1 : 0;
+    return entrada;
+}
+
 // --- Menu principal de facturacion ---
+// Emisin en 'emision' y vencimiento DIAS_PLAZO_PAGO das despus
+static void fecharFactura(Factura& factura, time_t emision) {
+    factura.fechaEmision = static_cast<int64_t>(emision);
+    factura.fechaVencimiento = factura.fechaEmision + static_cast<int64_t>(DIAS_PLAZO_PAGO) * 24 * 60 * 60;
+}
+
+// IVA de cada lnea del pedido segn la categora del producto (ver Tarifas)
+static Dinero ivaPedido(const Pedidos& pedido, const Tarifas::Tablas& tablas) {
+    Dinero impuesto;
+    for (const auto& linea : pedido.getLineas()) {
+        impuesto += tablas.iva(linea.codigoProducto, linea.precioUnitario * linea.cantidad);
+    }
+    return impuesto;
+}
+
+// --- Convierte un ID numrico sin lanzar excepciones (se usa desde varios hilos) ---
+static bool idNumerico(const string& texto, int& valor) {
+    if (texto.empty()) return false;
+    char* fin = nullptr;
+    long numero = strtol(texto.c_str(), &fin, 10);
+    if (*fin != '\0' || numero < numeric_limits<int>::min() || numero > numeric_limits<int>::max()) return false;
+    valor = static_cast<int>(numero);
+    return true;
+}
+
+static string textoFecha(int64_t segundos) {
+    time_t fecha = static_cast<time_t>(segundos);
+    const tm* local = localtime(&fecha);
+    char texto[16] = "-";
+    if (local) strftime(texto, sizeof(texto), "%Y-%m-%d", local);
+    return texto;
+}
+
+// "AAAA-MM-DD" en hora local, al inicio del da; false si no es una fecha vlida
+static bool fechaDeTexto(const string& texto, int64_t& segundos) {
+    int anio = 0, mes = 0, dia = 0;
+    if (sscanf(texto.c_str(), "%d-%d-%d", &anio, &mes, &dia) != 3 ||
+        mes < 1 || mes > 12 || dia < 1 || dia > 31) {
+        return false;
+    }
+    tm fecha{};
+    fecha.tm_year = anio - 1900;
+    fecha.tm_mon = mes - 1;
+    fecha.tm_mday = dia;
+    fecha.tm_isdst = -1;
+    time_t resultado = mktime(&fecha);
+    if (resultado == static_cast<time_t>(-1)) return false;
+    segundos = static_cast<int64_t>(resultado);
+    return true;
+}
+
 void Facturacion::mostrarMenuFacturacion() {
     int opcion;
     do {
@@ -20,8 +162,13 @@ void Facturacion::mostrarMenuFacturacion() {
         cout << "\n=========== MENU DE FACTURACION ===========\n";
         cout << "1. Crear Factura\n";
         cout << "2. Mostrar Facturas\n";
-        cout << "3. Modificar Factura\n";
+        cout << "3. Registrar pago\n";
         cout << "4. Eliminar Factura\n";
+        cout << "5. Facturar pedidos cerrados\n";
+        cout << "6. Cuentas por cobrar\n";
+        cout << "7. Antiguedad de saldos\n";
+        cout << "8. Exportar facturas (formato columnar)\n";
+        cout << "9. Consultar exportacion por fecha de emision\n";
         cout << "0. Salir\n";
         cout << "===========================================\n";
         cout << "Seleccione una opcion: ";
@@ -31,8 +178,13 @@ void Facturacion::mostrarMenuFacturacion() {
         switch (opcion) {
             case 1: crearFactura(); break;
             case 2: mostrarFacturas(); break;
-            case 3: modificarFactura(); break;
+            case 3: registrarPago(); break;
             case 4: eliminarFactura(); break;
+            case 5: facturarLote(); break;
+            case 6: mostrarCuentasPorCobrar(); break;
+            case 7: mostrarAntiguedadSaldos(); break;
+            case 8: exportarColumnar(); break;
+            case 9: consultarExportacion(); break;
             case 0: cout << "Saliendo del modulo de facturacion...\n"; break;
             default: cout << "Opcion invalida.\n"; break;
         }
@@ -40,45 +192,355 @@ void Facturacion::mostrarMenuFacturacion() {
     } while (opcion != 0);
 }
 
-// --- Genera un nuevo ID para la factura dentro del rango permitido ---
-int Facturacion::generarIdFactura() {
-    ifstream archivo(archivoFacturas, ios::binary);
-    int ultimoId = 3555;
-    Factura temp;
+// --- Convierte un facturas.bin sin cabecera o de una versin anterior al formato actual ---
+// Antes de la versin 2 el byte de 'eliminada' era relleno sin inicializar: se ignora.
+// Los eliminados de la versin 2 en adelante se descartan; 'importe' se toma del monto
+// en float (versiones 0 a 2) y las fechas de la fecha del pedido (versiones 0 a 3).
+// Antes de la versin 5 el IVA no se separaba: 'impuesto' queda en cero
+bool Facturacion::convertirFormatoAnterior() {
+    vector<Factura> facturas;
+    int siguienteId = ID_FACTURA_INICIAL;
+    uint32_t version = 0;
+    {
+        ifstream anterior(archivoFacturas, ios::binary);
+        CabeceraFacturas cabecera;
+        uint32_t cantidad = numeric_limits<uint32_t>::max();
+        uint32_t tamRegistro = sizeof(FacturaAnterior);
+        if (anterior.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera)) &&
+            memcmp(cabecera.firma, FIRMA_FACTURAS, sizeof(cabecera.firma)) == 0) {
+            bool compatible = cabecera.version < 3 ? cabecera.tamRegistro == sizeof(FacturaAnterior)
+                                                   : cabecera.tamRegistro >= TAM_FACTURA_V3 &&
+                                                     cabecera.tamRegistro < sizeof(Factura);
+            if (!compatible) {
+                cerr << "El archivo de facturas tiene un formato no compatible." << endl;
+                return false;
+            }
+            siguienteId = cabecera.siguienteId;
+            cantidad = cabecera.cantidad;
+            version = cabecera.version;
+            tamRegistro = cabecera.tamRegistro;
+        } else {
+            anterior.clear();
+            anterior.seekg(0);
+        }
 
-    // Leer el archivo para encontrar el ltimo ID usado
-    while (archivo.read(reinterpret_cast<char*>(&temp), sizeof(Factura))) {
-        if (temp.idFactura >= ultimoId) {
-            ultimoId = temp.idFactura + 1;
+        vector<char> registro(tamRegistro);
+        for (uint32_t i = 0; i < cantidad && anterior.read(registro.data(), tamRegistro); ++i) {
+            Factura factura = Factura();
+            if (version >= 3) {
+                memcpy(static_cast<void*>(&factura), registro.data(), tamRegistro);
+            } else {
+                FacturaAnterior temp;
+                memcpy(&temp, registro.data(), sizeof(temp));
+                factura.idFactura = temp.idFactura;
+                factura.idCliente = temp.idCliente;
+                factura.idPedido = temp.idPedido;
+                factura.monto = temp.monto;
+                factura.pagada = temp.pagada;
+                memcpy(factura.cliente, temp.cliente, sizeof(factura.cliente));
+                factura.eliminada = version >= 2 && temp.eliminada;
+                factura.importe = Dinero::deDecimal(temp.monto);
+            }
+            siguienteId = max(siguienteId, factura.idFactura + 1);
+            if (factura.eliminada) continue;
+            facturas.push_back(factura);
         }
     }
 
-    archivo.close();
+    // Sin fecha de emisin guardada se usa la del pedido (o la de hoy si ya no est)
+    if (version < 4) {
+        time_t hoy = time(nullptr);
+        for (auto& factura : facturas) {
+            Pedidos pedido;
+            bool conFecha = Pedidos::consultarPedido(to_string(factura.idPedido), pedido) &&
+                            pedido.getFechaPedido() > 0;
+            fecharFactura(factura, conFecha ? pedido.getFechaPedido() : hoy);
+        }
+    }
+
+    CabeceraFacturas cabecera = cabeceraNueva(siguienteId, static_cast<uint32_t>(facturas.size()));
+    {
+        ofstream nuevo("tempFacturas.bin", ios::binary | ios::trunc);
+        nuevo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+        nuevo.write(reinterpret_cast<const char*>(facturas.data()), facturas.size() * sizeof(Factura));
+        if (!nuevo.flush()) {
+            cerr << "No se pudo convertir el archivo de facturas al formato actual." << endl;
+            return false;
+        }
+    }
+    // El ndice anterior ya no corresponde: se reconstruye en el prximo uso
+    remove(archivoIndice);
+    indiceCargado = false;
+    remove(archivoFacturas);
+    return rename("tempFacturas.bin", archivoFacturas) == 0;
+}
+
+// --- Abre el archivo de facturas, lee su cabecera y pone el ndice al da ---
+bool Facturacion::abrirArchivo(fstream& archivo, CabeceraFacturas& cabecera) {
+    archivo.open(archivoFacturas, ios::binary | ios::in | ios::out);
+    if (!archivo) {
+        // No existe: se crea vaco con su cabecera
+        archivo.clear();
+        archivo.open(archivoFacturas, ios::binary | ios::in | ios::out | ios::trunc);
+        if (!archivo) return false;
+        cabecera = cabeceraNueva(ID_FACTURA_INICIAL, 0);
+        if (!escribirCabecera(archivo, cabecera)) return false;
+        remove(archivoIndice);
+        indiceCargado = false;
+        sincronizarIndice(archivo, cabecera);
+        return true;
+    }
+
+    if (!archivo.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera)) ||
+        memcmp(cabecera.firma, FIRMA_FACTURAS, sizeof(cabecera.firma)) != 0 ||
+        cabecera.version < VERSION_FACTURAS) {
+        // Archivo sin cabecera o de una versin anterior
+        archivo.close();
+        if (!convertirFormatoAnterior()) return false;
+        archivo.clear();
+        archivo.open(archivoFacturas, ios::binary | ios::in | ios::out);
+        if (!archivo || !archivo.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera))) return false;
+    }
+
+    if (cabecera.tamRegistro != sizeof(Factura)) {
+        cerr << "El archivo de facturas tiene un formato no compatible." << endl;
+        return false;
+    }
+
+    // Si el archivo qued ms corto que lo que indica la cabecera, solo se usan los registros completos
+    archivo.seekg(0, ios::end);
+    streamoff tam = archivo.tellg();
+    uint32_t completos = tam < posicionFactura(0) ? 0 :
+        static_cast<uint32_t>((tam - posicionFactura(0)) / static_cast<streamoff>(sizeof(Factura)));
+    cabecera.cantidad = min(cabecera.cantidad, completos);
+    archivo.clear();
+
+    sincronizarIndice(archivo, cabecera);
+    return true;
+}
+
+// --- Reescribe la cabecera del archivo ---
+bool Facturacion::escribirCabecera(fstream& archivo, const CabeceraFacturas& cabecera) {
+    archivo.clear();
+    archivo.seekp(0);
+    archivo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+    return static_cast<bool>(archivo.flush());
+}
+
+// --- Reescribe un registro en su posicin ---
+bool Facturacion::escribirFactura(fstream& archivo, uint32_t posicion, const Factura& factura) {
+    archivo.clear();
+    archivo.seekp(posicionFactura(posicion));
+    archivo.write(reinterpret_cast<const char*>(&factura), sizeof(Factura));
+    return static_cast<bool>(archivo.flush());
+}
+
+// --- Pone el ndice al da con la cabecera de facturas.bin ---
+void Facturacion::sincronizarIndice(fstream& archivo, const CabeceraFacturas& cabecera) {
+    if (indiceCargado && registrosIndexados == cabecera.cantidad) return;
+
+    if (!indiceCargado || registrosIndexados > cabecera.cantidad) {
+        posicionPorFactura.clear();
+        posicionPorPedido.clear();
+        registrosIndexados = 0;
+
+        // Entradas guardadas en facturas.idx (nunca ms que los registros del archivo)
+        ifstream indice(archivoIndice, ios::binary);
+        CabeceraIndiceFacturas cabeceraIndice;
+        if (indice.read(reinterpret_cast<char*>(&cabeceraIndice), sizeof(cabeceraIndice)) &&
+            memcmp(cabeceraIndice.firma, FIRMA_INDICE_FACTURAS, sizeof(cabeceraIndice.firma)) == 0 &&
+            cabeceraIndice.version == VERSION_INDICE_FACTURAS && cabeceraIndice.cantidad <= cabecera.cantidad) {
+            vector<EntradaIndiceFactura> entradas(cabeceraIndice.cantidad);
+            if (indice.read(reinterpret_cast<char*>(entradas.data()), entradas.size() * sizeof(EntradaIndiceFactura))) {
+                for (uint32_t i = 0; i < entradas.size(); ++i) {
+                    if (entradas[i].eliminada) continue;
+                    posicionPorFactura[entradas[i].idFactura] = i;
+                    posicionPorPedido[entradas[i].idPedido] = i;
+                }
+                registrosIndexados = cabeceraIndice.cantidad;
+            }
+        }
+        indiceCargado = true;
+    }
+
+    // Registros que el ndice todava no cubre (agregados sin llegar a actualizarlo)
+    if (registrosIndexados < cabecera.cantidad) {
+        vector<Factura> faltantes(cabecera.cantidad - registrosIndexados);
+        archivo.clear();
+        archivo.seekg(posicionFactura(registrosIndexados));
+        archivo.read(reinterpret_cast<char*>(faltantes.data()), faltantes.size() * sizeof(Factura));
+        archivo.clear();
+        indexarFacturas(faltantes.data(), static_cast<uint32_t>(faltantes.size()), registrosIndexados);
+    }
+}
+
+// --- Agrega registros recin escritos al ndice en memoria y en facturas.idx ---
+void Facturacion::indexarFacturas(const Factura* facturas, uint32_t cantidad, uint32_t primera) {
+    vector<EntradaIndiceFactura> entradas(cantidad);
+    for (uint32_t i = 0; i < cantidad; ++i) {
+        entradas[i] = entradaDe(facturas[i]);
+        if (facturas[i].eliminada) continue;
+        posicionPorFactura[facturas[i].idFactura] = primera + i;
+        posicionPorPedido[facturas[i].idPedido] = primera + i;
+    }
+    registrosIndexados = primera + cantidad;
+
+    // Entradas en su posicin y despus la cabecera con el nuevo total
+    fstream indice(archivoIndice, ios::binary | ios::in | ios::out);
+    if (!indice) {
+        indice.clear();
+        indice.open(archivoIndice, ios::binary | ios::in | ios::out | ios::trunc);
+    }
+    CabeceraIndiceFacturas cabeceraIndice;
+    memset(&cabeceraIndice, 0, sizeof(cabeceraIndice));
+    memcpy(cabeceraIndice.firma, FIRMA_INDICE_FACTURAS, sizeof(cabeceraIndice.firma));
+    cabeceraIndice.version = VERSION_INDICE_FACTURAS;
+    cabeceraIndice.cantidad = registrosIndexados;
+
+    indice.seekp(posicionEntrada(primera));
+    indice.write(reinterpret_cast<const char*>(entradas.data()), entradas.size() * sizeof(EntradaIndiceFactura));
+    indice.flush();
+    indice.seekp(0);
+    indice.write(reinterpret_cast<const char*>(&cabeceraIndice), sizeof(cabeceraIndice));
+    if (!indice.flush()) {
+        cerr << "No se pudo actualizar el indice de facturas (se reconstruira en el proximo uso)." << endl;
+    }
+}
 
-    // Validar que el ID no exceda el rango permitido
-    if (ultimoId > 3606) {
-        throw runtime_error("Se ha alcanzado el limite de IDs de facturas (3555 - 3606).");
+// --- Reescribe la entrada de facturas.idx de un registro ---
+void Facturacion::escribirEntradaIndice(uint32_t posicion, const Factura& factura) {
+    fstream indice(archivoIndice, ios::binary | ios::in | ios::out);
+    if (!indice) return;
+    EntradaIndiceFactura entrada = entradaDe(factura);
+    indice.seekp(posicionEntrada(posicion));
+    indice.write(reinterpret_cast<const char*>(&entrada), sizeof(entrada));
+}
+
+// --- Busca una factura vigente por ID usando el ndice ---
+// Si el registro no coincide con el ndice (archivo cambiado por fuera), se reconstruye y se reintenta
+bool Facturacion::buscarFactura(fstream& archivo, const CabeceraFacturas& cabecera, int idFactura,
+                                uint32_t& posicion, Factura& factura) {
+    for (int intento = 0; intento < 2; ++intento) {
+        auto it = posicionPorFactura.find(idFactura);
+        if (it == posicionPorFactura.end()) return false;
+
+        posicion = it->second;
+        archivo.clear();
+        archivo.seekg(posicionFactura(posicion));
+        if (posicion < cabecera.cantidad && archivo.read(reinterpret_cast<char*>(&factura), sizeof(Factura)) &&
+            factura.idFactura == idFactura && !factura.eliminada) {
+            return true;
+        }
+
+        remove(archivoIndice);
+        indiceCargado = false;
+        sincronizarIndice(archivo, cabecera);
     }
+    return false;
+}
 
-    return ultimoId;
+// --- Genera un nuevo ID para la factura: el siguiente guardado en la cabecera ---
+int Facturacion::generarIdFactura() {
+    lock_guard<mutex> bloqueo(mutexArchivo);
+    fstream archivo;
+    CabeceraFacturas cabecera;
+    if (!abrirArchivo(archivo, cabecera)) {
+        throw runtime_error("No se pudo abrir el archivo de facturas.");
+    }
+    return cabecera.siguienteId;
 }
 
-// --- Guarda una factura en el archivo binario ---
+// --- Guarda una factura al final del archivo y actualiza la cabecera y el ndice ---
+// El registro se escribe antes que la cabecera: si algo falla entre ambos,
+// la cabecera sigue describiendo un archivo vlido y el registro se sobrescribe
 void Facturacion::guardarEnArchivo(Factura factura) {
-    ofstream archivo(archivoFacturas, ios::binary | ios::app);
-    if (archivo) {
-        archivo.write(reinterpret_cast<char*>(&factura), sizeof(Factura));
-        archivo.close();
-    } else {
+    lock_guard<mutex> bloqueo(mutexArchivo);
+    fstream archivo;
+    CabeceraFacturas cabecera;
+    if (!abrirArchivo(archivo, cabecera)) {
         cerr << "No se pudo abrir el archivo para guardar la factura." << endl;
+        return;
+    }
+
+    factura.eliminada = false;
+    if (!escribirFactura(archivo, cabecera.cantidad, factura)) {
+        cerr << "No se pudo guardar la factura." << endl;
+        return;
+    }
+
+    uint32_t posicion = cabecera.cantidad;
+    cabecera.cantidad++;
+    cabecera.siguienteId = max(cabecera.siguienteId, factura.idFactura + 1);
+    if (!escribirCabecera(archivo, cabecera)) {
+        cerr << "No se pudo actualizar la cabecera del archivo de facturas." << endl;
+        return;
     }
+    indexarFacturas(&factura, 1, posicion);
+    Pagos::agregarFactura(factura);
+    Antiguedad::agregar(factura);
+}
+
+// --- Encola la compactacin si hay demasiados registros eliminados ---
+void Facturacion::programarCompactacion(const CabeceraFacturas& cabecera) {
+    if (cabecera.eliminadas < MINIMO_COMPACTACION ||
+        cabecera.eliminadas <= cabecera.cantidad * UMBRAL_COMPACTACION || compactacionPendiente) {
+        return;
+    }
+    compactacionPendiente = true;
+    // Una instancia propia: la que la programa puede no existir cuando se ejecute
+    GrupoHilos::global().encolar([]() {
+        Facturacion facturacion;
+        facturacion.compactar();
+    });
+}
+
+// --- Reescribe facturas.bin solo con los registros vigentes ---
+bool Facturacion::compactar() {
+    lock_guard<mutex> bloqueo(mutexArchivo);
+    compactacionPendiente = false;
+
+    fstream archivo;
+    CabeceraFacturas cabecera;
+    if (!abrirArchivo(archivo, cabecera)) return false;
+    if (cabecera.eliminadas == 0) return true;
+
+    vector<Factura> vigentes;
+    vigentes.reserve(cabecera.cantidad - min(cabecera.cantidad, cabecera.eliminadas));
+    Factura temp;
+    archivo.seekg(posicionFactura(0));
+    for (uint32_t i = 0; i < cabecera.cantidad &&
+         archivo.read(reinterpret_cast<char*>(&temp), sizeof(Factura)); ++i) {
+        if (!temp.eliminada) vigentes.push_back(temp);
+    }
+    archivo.close();
+
+    // El siguiente ID se conserva: un ID eliminado no se vuelve a asignar
+    CabeceraFacturas nueva = cabeceraNueva(cabecera.siguienteId, static_cast<uint32_t>(vigentes.size()));
+    {
+        ofstream temporal("tempFacturas.bin", ios::binary | ios::trunc);
+        temporal.write(reinterpret_cast<const char*>(&nueva), sizeof(nueva));
+        temporal.write(reinterpret_cast<const char*>(vigentes.data()), vigentes.size() * sizeof(Factura));
+        if (!temporal.flush()) {
+            remove("tempFacturas.bin");
+            return false;
+        }
+    }
+
+    // Primero se descarta el ndice: si algo falla a mitad, se reconstruye desde facturas.bin
+    remove(archivoIndice);
+    indiceCargado = false;
+    remove(archivoFacturas);
+    if (rename("tempFacturas.bin", archivoFacturas) != 0) return false;
+
+    fstream compactado;
+    return abrirArchivo(compactado, cabecera);
 }
 
 // --- Registra una accin en la bitcora (falta completar escritura en bitcora) ---
 void Facturacion::registrarBitacora(const Factura& factura, const string& accion, const string& usuario) {
     string descripcion = "Factura ID " + to_string(factura.idFactura) + " | Pedido: " + to_string(factura.idPedido) +
                          " | Cliente: " + to_string(factura.idCliente) +
-                         " | Monto: " + to_string(factura.monto) +
+                         " | Monto: " + factura.importe.texto() +
                          " | Pagada: " + string(factura.pagada ? "Si" : "No");
 
     // Falta: auditoria.registrar(accion, usuario, descripcion);
@@ -91,9 +553,9 @@ void Facturacion::crearFactura() {
     cin >> volver;
     if (volver == 1) return;
 
-    // Cargar pedidos disponibles
-    vector<Pedidos> listaPedidos;
-    Pedidos::cargarDesdeArchivoBin(listaPedidos);
+    // Pedidos disponibles desde la instantnea vigente (sin recargar el archivo)
+    shared_ptr<const InstantaneaPedidos> vista = Pedidos::obtenerInstantanea();
+    const vector<Pedidos>& listaPedidos = vista->pedidos;
 
     if (listaPedidos.empty()) {
         cout << "No hay pedidos registrados." << endl;
@@ -114,47 +576,49 @@ void Facturacion::crearFactura() {
     cin >> idPedidoStr;
 
     // Buscar pedido por ID
-    auto it = find_if(listaPedidos.begin(), listaPedidos.end(), [&idPedidoStr](const Pedidos& p) {
-        return p.getId() == idPedidoStr;
-    });
+    const Pedidos* it = vista->buscar(idPedidoStr);
 
-    if (it == listaPedidos.end()) {
+    if (it == nullptr) {
         cout << "ID de pedido no encontrado." << endl;
         return;
     }
 
-    // Crear nueva factura
-    Factura nueva;
-    nueva.idFactura = generarIdFactura();
+    // Un pedido se factura una sola vez (ndice idPedido -> factura)
+    {
+        lock_guard<mutex> bloqueo(mutexArchivo);
+        fstream archivo;
+        CabeceraFacturas cabecera;
+        if (abrirArchivo(archivo, cabecera)) {
+            int idPedido = 0;
+            if (idNumerico(it->getId(), idPedido) && posicionPorPedido.count(idPedido)) {
+                cout << "El pedido ya tiene una factura registrada." << endl;
+                return;
+            }
+        }
+    }
 
+    // Crear nueva factura
+    Factura nueva = Factura();
     try {
-        nueva.idPedido = stoi(it->getId());
-        nueva.idCliente = stoi(it->getIdCliente());
-    } catch (...) {
-        cerr << "Error al convertir ID de pedido o cliente a entero. Revisa las estructuras." << endl;
+        nueva.idFactura = generarIdFactura();
+    } catch (const runtime_error& e) {
+        cerr << e.what() << endl;
+        return;
+    }
+
+    if (!idNumerico(it->getId(), nueva.idPedido) || !idNumerico(it->getIdCliente(), nueva.idCliente)) {
+        cerr << "El pedido o su cliente no tienen un ID numerico; no se puede facturar." << endl;
         return;
     }
 
-    nueva.monto = 0;
     nueva.pagada = false;
-    memset(nueva.cliente, 0, sizeof(nueva.cliente)); // Inicializar nombre cliente
-
-    // Calcular monto total desde los detalles del pedido
-    string detalles = it->getDetalles();
-    size_t pos = 0;
-    while ((pos = detalles.find('\n')) != string::npos) {
-        string linea = detalles.substr(0, pos);
-        size_t precioPos = linea.find("Precio:");
-        size_t cantPos = linea.find("Cantidad:");
-
-        if (precioPos != string::npos && cantPos != string::npos) {
-            double precio = stod(linea.substr(precioPos + 7));
-            int cantidad = stoi(linea.substr(cantPos + 9, precioPos - cantPos - 9));
-            nueva.monto += precio * cantidad;
-        }
+    nueva.eliminada = false;
+    fecharFactura(nueva, time(nullptr));
 
-        detalles.erase(0, pos + 1);
-    }
+    // Monto total: neto materializado del pedido ms el IVA de sus lneas
+    nueva.impuesto = ivaPedido(*it, *Tarifas::vigentes());
+    nueva.importe = it->getTotales().neto + nueva.impuesto;
+    nueva.monto = static_cast<float>(nueva.importe.aDecimal());
 
     // Guardar y registrar factura
     guardarEnArchivo(nueva);
@@ -167,7 +631,11 @@ void Facturacion::crearFactura() {
     cout << "ID Factura : " << nueva.idFactura << endl;
     cout << "ID Cliente : " << nueva.idCliente << endl;
     cout << "ID Pedido  : " << nueva.idPedido << endl;
-    cout << "Monto Total: $" << fixed << setprecision(2) << nueva.monto << endl;
+    cout << "Subtotal   : $" << nueva.importe - nueva.impuesto << endl;
+    cout << "IVA        : $" << nueva.impuesto << endl;
+    cout << "Monto Total: $" << nueva.importe << endl;
+    cout << "Emision    : " << textoFecha(nueva.fechaEmision) << endl;
+    cout << "Vence      : " << textoFecha(nueva.fechaVencimiento) << endl;
     cout << "Estado     : " << (nueva.pagada ? "Pagada" : "No Pagada") << endl;
     cout << "=====================================\n";
     cout << "Factura creada exitosamente.\n";
@@ -175,27 +643,37 @@ void Facturacion::crearFactura() {
 
 // --- Muestra todas las facturas almacenadas ---
 void Facturacion::mostrarFacturas() {
-    ifstream archivo(archivoFacturas, ios::binary);
-    if (!archivo) {
+    lock_guard<mutex> bloqueo(mutexArchivo);
+    fstream archivo;
+    CabeceraFacturas cabecera;
+    if (!abrirArchivo(archivo, cabecera)) {
         cerr << "No se pudo abrir el archivo de facturas." << endl;
         return;
     }
 
+    bool conSaldos = asegurarPagos();
     Factura temp;
     cout << "\n--- Listado de Facturas ---\n";
-    while (archivo.read(reinterpret_cast<char*>(&temp), sizeof(Factura))) {
+    archivo.seekg(posicionFactura(0));
+    for (uint32_t i = 0; i < cabecera.cantidad &&
+         archivo.read(reinterpret_cast<char*>(&temp), sizeof(Factura)); ++i) {
+        if (temp.eliminada) continue;
         cout << "ID Factura: " << temp.idFactura
              << " | ID Cliente: " << temp.idCliente
              << " | ID Pedido: " << temp.idPedido
-             << " | Monto: $" << fixed << setprecision(2) << temp.monto
-             << " | Pagada: " << (temp.pagada ? "Si" : "No") << endl;
+             << " | Monto: $" << temp.importe
+             << " | IVA: $" << temp.impuesto
+             << " | Vence: " << textoFecha(temp.fechaVencimiento)
+             << " | Pagada: " << (temp.pagada ? "Si" : "No");
+        if (conSaldos) cout << " | Saldo: $" << Pagos::saldoFactura(temp.idFactura);
+        cout << endl;
     }
 
     archivo.close();
 }
 
-// --- Permite modificar el estado de pago de una factura ---
-void Facturacion::modificarFactura() {
+// --- Registra un pago, nota de crdito o castigo sobre una factura ---
+void Facturacion::registrarPago() {
     int volver;
     cout << "Desea regresar al menu principal? (1: Si / 0: No): ";
     cin >> volver;
@@ -203,44 +681,93 @@ void Facturacion::modificarFactura() {
 
     mostrarFacturas();
 
-    int idMod;
-    cout << "\nIngrese el ID de la factura a modificar: ";
-    cin >> idMod;
+    int idFactura;
+    cout << "\nIngrese el ID de la factura: ";
+    cin >> idFactura;
 
-    fstream archivo(archivoFacturas, ios::binary | ios::in | ios::out);
-    if (!archivo) {
-        cerr << "No se pudo abrir el archivo." << endl;
+    if (!prepararPagos()) {
+        cerr << "No se pudo abrir el libro de pagos." << endl;
+        return;
+    }
+    if (!Pagos::existeFactura(idFactura)) {
+        cout << "Factura no encontrada.\n";
         return;
     }
 
-    Factura temp;
-    bool encontrado = false;
-
-    // Buscar factura por ID y modificar
-    while (archivo.read(reinterpret_cast<char*>(&temp), sizeof(Factura))) {
-        if (temp.idFactura == idMod) {
-            encontrado = true;
-            cout << "Factura encontrada. Modifique los campos:\n";
-            cout << "Estado actual de pago: " << (temp.pagada ? "Si" : "No") << endl;
-            cout << "Desea marcar como pagada? (1: Si / 0: No): ";
-            int opcion;
-            cin >> opcion;
-            temp.pagada = (opcion == 1);
-
-            archivo.seekp(-static_cast<int>(sizeof(Factura)), ios::cur);
-            archivo.write(reinterpret_cast<char*>(&temp), sizeof(Factura));
-
-            registrarBitacora(temp, "Modificacion", usuarioRegistrado.getNombre());
-            cout << "Factura modificada correctamente.\n";
-            break;
-        }
+    // Historial de la factura y saldo actual (sin recorrer el libro completo)
+    vector<MovimientoPago> movimientos = Pagos::movimientosDe(idFactura);
+    cout << "\n--- Movimientos de la factura " << idFactura << " ---\n";
+    if (movimientos.empty()) cout << "Sin movimientos.\n";
+    for (const auto& movimiento : movimientos) {
+        cout << textoFecha(movimiento.fecha) << " | " << Pagos::nombreTipo(movimiento.tipo)
+             << " | $" << movimiento.importe << " | " << movimiento.referencia << endl;
+    }
+    Dinero saldo = Pagos::saldoFactura(idFactura);
+    cout << "Saldo pendiente: $" << saldo << endl;
+    if (saldo <= Dinero()) {
+        cout << "La factura no tiene saldo pendiente.\n";
+        return;
     }
 
-    if (!encontrado) {
-        cout << "Factura no encontrada.\n";
+    cout << "\n1. Pago\n2. Nota de credito\n3. Castigo (incobrable)\n0. Cancelar\n";
+    cout << "Tipo de movimiento: ";
+    int tipo;
+    cin >> tipo;
+    if (tipo < MOVIMIENTO_PAGO || tipo > MOVIMIENTO_CASTIGO) return;
+
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    string texto;
+    Dinero importe = saldo;
+    cout << "Importe [" << saldo << "]: ";
+    getline(cin, texto);
+    if (!texto.empty() && (!Dinero::deTexto(texto, importe) || importe <= Dinero() || importe > saldo)) {
+        cout << "Importe invalido: debe ser mayor que cero y no superar el saldo.\n";
+        return;
     }
+    string referencia;
+    cout << "Referencia (recibo, numero de nota, motivo): ";
+    getline(cin, referencia);
 
-    archivo.close();
+    Dinero nuevoSaldo;
+    if (!registrarMovimiento(idFactura, static_cast<uint8_t>(tipo), importe, referencia, nuevoSaldo)) {
+        cerr << "No se pudo registrar el movimiento." << endl;
+        return;
+    }
+    cout << Pagos::nombreTipo(static_cast<uint8_t>(tipo)) << " registrado. Saldo pendiente: $" << nuevoSaldo << endl;
+}
+
+// --- Agrega un movimiento al libro y actualiza la factura si queda saldada ---
+bool Facturacion::registrarMovimiento(int idFactura, uint8_t tipo, Dinero importe, const string& referencia,
+                                      Dinero& saldo) {
+    lock_guard<mutex> bloqueo(mutexArchivo);
+    fstream archivo;
+    CabeceraFacturas cabecera;
+    if (!abrirArchivo(archivo, cabecera) || !asegurarPagos()) return false;
+
+    Factura factura;
+    uint32_t posicion = 0;
+    if (!buscarFactura(archivo, cabecera, idFactura, posicion, factura)) return false;
+
+    MovimientoPago movimiento = MovimientoPago();
+    movimiento.idFactura = idFactura;
+    movimiento.tipo = tipo;
+    movimiento.importe = importe;
+    strncpy(movimiento.referencia, referencia.c_str(), sizeof(movimiento.referencia) - 1);
+    if (!Pagos::registrar(movimiento, saldo)) return false;
+
+    Antiguedad::ajustar(idFactura, saldo);
+    if (saldo == Dinero() && !factura.pagada) {
+        factura.pagada = true;
+        if (!escribirFactura(archivo, posicion, factura)) {
+            cerr << "No se pudo marcar la factura como pagada." << endl;
+        }
+    }
+
+    auditoria.registrar(usuarioRegistrado.getNombre(), "FACTURACION",
+                        string(Pagos::nombreTipo(tipo)) + " " + to_string(movimiento.idMovimiento) +
+                        " | Factura " + to_string(idFactura) + " | $" + importe.texto() +
+                        " | Saldo: $" + saldo.texto());
+    return true;
 }
 
 // --- Elimina una factura por ID ---
@@ -256,31 +783,418 @@ void Facturacion::eliminarFactura() {
     cout << "\nIngrese el ID de la factura a eliminar: ";
     cin >> idDel;
 
-    ifstream archivo(archivoFacturas, ios::binary);
-    ofstream temp("tempFacturas.bin", ios::binary);
-    bool eliminado = false;
+    lock_guard<mutex> bloqueo(mutexArchivo);
+    fstream archivo;
+    CabeceraFacturas cabecera;
+    if (!abrirArchivo(archivo, cabecera)) {
+        cerr << "No se pudo abrir el archivo." << endl;
+        return;
+    }
+
     Factura tempFactura;
+    uint32_t posicion = 0;
+    if (!buscarFactura(archivo, cabecera, idDel, posicion, tempFactura)) {
+        cout << "Factura no encontrada.\n";
+        return;
+    }
+
+    // Se marca el registro como eliminado; el espacio se recupera al compactar
+    tempFactura.eliminada = true;
+    cabecera.eliminadas++;
+    if (!escribirFactura(archivo, posicion, tempFactura) || !escribirCabecera(archivo, cabecera)) {
+        cerr << "No se pudo eliminar la factura." << endl;
+        return;
+    }
+    escribirEntradaIndice(posicion, tempFactura);
+    posicionPorFactura.erase(tempFactura.idFactura);
+    auto porPedido = posicionPorPedido.find(tempFactura.idPedido);
+    if (porPedido != posicionPorPedido.end() && porPedido->second == posicion) posicionPorPedido.erase(porPedido);
+    Pagos::quitarFactura(tempFactura.idFactura);
+    Antiguedad::quitar(tempFactura.idFactura);
+
+    registrarBitacora(tempFactura, "Eliminacion", usuarioRegistrado.getNombre());
+    cout << "Factura eliminada correctamente.\n";
+    programarCompactacion(cabecera);
+}
+
+// --- Factura por lote todos los pedidos cerrados sin factura ---
+ResultadoLoteFacturas Facturacion::facturarPedidosCerrados() {
+    ResultadoLoteFacturas resultado;
+
+    lock_guard<mutex> bloqueo(mutexArchivo);
+    fstream archivo;
+    CabeceraFacturas cabecera;
+    if (!abrirArchivo(archivo, cabecera)) {
+        cerr << "No se pudo abrir el archivo de facturas." << endl;
+        resultado.correcto = false;
+        return resultado;
+    }
 
-    // Copiar todas las facturas excepto la que se va a eliminar
-    while (archivo.read(reinterpret_cast<char*>(&tempFactura), sizeof(Factura))) {
-        if (tempFactura.idFactura == idDel) {
-            eliminado = true;
-            registrarBitacora(tempFactura, "Eliminacion", usuarioRegistrado.getNombre());
+    // 1. Pedidos ya facturados: ndice idPedido -> factura (sin leer el archivo)
+    const unordered_map<int, uint32_t>& facturados = posicionPorPedido;
+
+    // 2. Pedidos completados o entregados sin factura, desde la instantnea vigente
+    shared_ptr<const InstantaneaPedidos> vista = Pedidos::obtenerInstantanea();
+    vector<const Pedidos*> candidatos;
+    for (const auto& pedido : vista->pedidos) {
+        if (pedido.getEstado() != "completado" && pedido.getEstado() != "entregado") continue;
+        int idPedido = 0;
+        if (idNumerico(pedido.getId(), idPedido) && facturados.count(idPedido)) {
+            resultado.yaFacturados++;
             continue;
         }
-        temp.write(reinterpret_cast<char*>(&tempFactura), sizeof(Factura));
+        candidatos.push_back(&pedido);
     }
 
-    archivo.close();
-    temp.close();
+    // 3. Armar las facturas en paralelo; cada una ocupa su posicin, as los IDs
+    //    quedan en el orden de los pedidos sin coordinacin entre hilos
+    //    (Factura() deja todo en cero, 'eliminada' incluida)
+    vector<Factura> nuevas(candidatos.size());
+    vector<char> validas(candidatos.size(), 0);
+    const time_t emision = time(nullptr);
+    shared_ptr<const Tarifas::Tablas> tablas = Tarifas::vigentes();
+    GrupoHilos::global().paraCada(candidatos.size(), [&](size_t i) {
+        const Pedidos& pedido = *candidatos[i];
+        Factura& factura = nuevas[i];
+        factura = Factura();
+        if (!idNumerico(pedido.getId(), factura.idPedido) || !idNumerico(pedido.getIdCliente(), factura.idCliente)) {
+            return;
+        }
+        Dinero importe;
+        for (const auto& linea : pedido.getLineas()) importe += linea.precioUnitario * linea.cantidad;
+        factura.impuesto = ivaPedido(pedido, *tablas);
+        factura.importe = importe + factura.impuesto;
+        factura.monto = static_cast<float>(factura.importe.aDecimal());
+        factura.pagada = false;
+        fecharFactura(factura, emision);
+        validas[i] = 1;
+    });
 
-    // Reemplazar archivo original por el temporal
-    remove(archivoFacturas);
-    rename("tempFacturas.bin", archivoFacturas);
+    size_t destino = 0;
+    for (size_t i = 0; i < nuevas.size(); ++i) {
+        if (!validas[i]) {
+            resultado.omitidos++;
+            continue;
+        }
+        nuevas[destino] = nuevas[i];
+        nuevas[destino].idFactura = cabecera.siguienteId + static_cast<int>(destino);
+        resultado.montoTotal += nuevas[destino].importe;
+        destino++;
+    }
+    nuevas.resize(destino);
+    if (nuevas.empty()) return resultado;
 
-    if (eliminado) {
-        cout << "Factura eliminada correctamente.\n";
-    } else {
-        cout << "Factura no encontrada.\n";
+    // 4. Una sola escritura al final del archivo y despus la cabecera
+    archivo.clear();
+    archivo.seekp(posicionFactura(cabecera.cantidad));
+    archivo.write(reinterpret_cast<const char*>(nuevas.data()), nuevas.size() * sizeof(Factura));
+    if (!archivo.flush()) {
+        cerr << "No se pudieron guardar las facturas." << endl;
+        resultado.correcto = false;
+        return resultado;
+    }
+    uint32_t primera = cabecera.cantidad;
+    cabecera.cantidad += static_cast<uint32_t>(nuevas.size());
+    cabecera.siguienteId += static_cast<int>(nuevas.size());
+    if (!escribirCabecera(archivo, cabecera)) {
+        cerr << "No se pudo actualizar la cabecera del archivo de facturas." << endl;
+        resultado.correcto = false;
+        return resultado;
+    }
+    indexarFacturas(nuevas.data(), static_cast<uint32_t>(nuevas.size()), primera);
+    for (const auto& factura : nuevas) {
+        Pagos::agregarFactura(factura);
+        Antiguedad::agregar(factura);
+    }
+
+    resultado.facturas = nuevas.size();
+    return resultado;
+}
+
+// --- Men: facturacin por lote ---
+void Facturacion::facturarLote() {
+    int volver;
+    cout << "Desea regresar al menu principal? (1: Si / 0: No): ";
+    cin >> volver;
+    if (volver == 1) return;
+
+    auto inicio = chrono::steady_clock::now();
+    ResultadoLoteFacturas resultado = facturarPedidosCerrados();
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    if (!resultado.correcto) {
+        cout << "La facturacion por lote no se pudo completar.\n";
+        return;
+    }
+
+    cout << "\n=========== FACTURACION POR LOTE ===========\n";
+    cout << "Facturas generadas     : " << resultado.facturas << endl;
+    cout << "Pedidos ya facturados  : " << resultado.yaFacturados << endl;
+    cout << "Pedidos omitidos       : " << resultado.omitidos << endl;
+    cout << "Monto total facturado  : $" << resultado.montoTotal << endl;
+    cout << "Tiempo                 : " << fixed << setprecision(3) << segundos << " s\n";
+    cout << "============================================\n";
+
+    if (resultado.facturas > 0) {
+        auditoria.registrar(usuarioRegistrado.getNombre(), "FACTURACION",
+                            "Facturacion por lote: " + to_string(resultado.facturas) + " facturas");
+    }
+}
+
+// --- Lee las facturas vigentes ---
+bool Facturacion::cargarFacturas(vector<Factura>& facturas) {
+    lock_guard<mutex> bloqueo(mutexArchivo);
+    return leerFacturasVigentes(facturas);
+}
+
+// --- Lee las facturas vigentes (con mutexArchivo ya tomado) ---
+bool Facturacion::leerFacturasVigentes(vector<Factura>& facturas) {
+    fstream archivo;
+    CabeceraFacturas cabecera;
+    if (!abrirArchivo(archivo, cabecera)) return false;
+
+    facturas.resize(cabecera.cantidad);
+    archivo.seekg(posicionFactura(0));
+    archivo.read(reinterpret_cast<char*>(facturas.data()), facturas.size() * sizeof(Factura));
+    if (!archivo) return false;
+    facturas.erase(remove_if(facturas.begin(), facturas.end(),
+                             [](const Factura& f) { return f.eliminada; }), facturas.end());
+    return true;
+}
+
+// --- Men: cuentas por cobrar ---
+void Facturacion::mostrarCuentasPorCobrar() {
+    // Saldos y lo aplicado salen del libro de pagos: un pago parcial reduce lo pendiente
+    vector<Factura> facturas;
+    {
+        lock_guard<mutex> bloqueo(mutexArchivo);
+        if (!leerFacturasVigentes(facturas) || !asegurarPagos()) {
+            cerr << "No se pudo abrir el archivo de facturas." << endl;
+            return;
+        }
+    }
+
+    auto inicio = chrono::steady_clock::now();
+    Cartera::Columnas columnas;
+    for (const auto& factura : facturas) columnas.agregar(factura, Pagos::resumenFactura(factura.idFactura));
+    facturas = vector<Factura>();
+    Cartera::Resumen resumen = Cartera::resumir(columnas);
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    cout << "\n=========== CUENTAS POR COBRAR ===========\n";
+    cout << "Facturas vigentes : " << resumen.facturas << " (" << resumen.abiertas << " con saldo)\n";
+    cout << "Total por cobrar  : $" << resumen.totalAbierto << endl;
+    cout << "Total cobrado     : $" << resumen.totalCobrado << endl;
+    cout << "Notas de credito  : $" << resumen.totalNotasCredito << endl;
+    cout << "Castigos          : $" << resumen.totalCastigos << endl;
+
+    const size_t maximo = 10;
+    cout << "\n--- Clientes con mayor saldo ---\n";
+    for (size_t i = 0; i < resumen.porCliente.size() && i < maximo; ++i) {
+        const Cartera::SaldoCliente& saldo = resumen.porCliente[i];
+        if (saldo.abierto == Dinero()) break;
+        cout << "Cliente " << saldo.idCliente
+             << " | Saldo: $" << saldo.abierto
+             << " | Facturas abiertas: " << saldo.facturasAbiertas
+             << " | Cobrado: $" << saldo.cobrado << endl;
+    }
+    cout << "==========================================\n";
+    cout << "Calculado en " << fixed << setprecision(3) << segundos << " s ("
+         << (Cartera::usaAvx2() ? "AVX2" : "escalar") << ")\n";
+}
+
+// --- Saldos del libro de pagos: se recorre el libro solo la primera vez ---
+bool Facturacion::asegurarPagos() {
+    if (Pagos::iniciado()) return true;
+    vector<Factura> facturas;
+    return leerFacturasVigentes(facturas) && Pagos::iniciar(facturas);
+}
+
+// --- Pedidos con factura vigente: claves del ndice idPedido -> factura ---
+bool Facturacion::pedidosFacturados(unordered_set<int>& pedidos) {
+    pedidos.clear();
+    // Sin facturas.bin no hay pedidos facturados (abrirlo lo creara)
+    if (!ifstream(archivoFacturas, ios::binary)) return true;
+
+    lock_guard<mutex> bloqueo(mutexArchivo);
+    fstream archivo;
+    CabeceraFacturas cabecera;
+    if (!abrirArchivo(archivo, cabecera)) return false;
+    pedidos.reserve(posicionPorPedido.size());
+    for (const auto& par : posicionPorPedido) pedidos.insert(par.first);
+    return true;
+}
+
+bool Facturacion::prepararPagos() {
+    lock_guard<mutex> bloqueo(mutexArchivo);
+    return asegurarPagos();
+}
+
+// --- Carga la antigedad de saldos al primer uso y la lleva hasta hoy ---
+// Con mutexArchivo tomado ninguna factura se crea ni cambia mientras se carga
+bool Facturacion::prepararAntiguedad() {
+    lock_guard<mutex> bloqueo(mutexArchivo);
+    time_t hoy = time(nullptr);
+    if (!Antiguedad::iniciada()) {
+        vector<Factura> facturas;
+        if (!leerFacturasVigentes(facturas) || !asegurarPagos()) return false;
+        // Con pagos parciales cuenta solo lo pendiente
+        for (auto& factura : facturas) factura.importe = Pagos::saldoFactura(factura.idFactura);
+        facturas.erase(remove_if(facturas.begin(), facturas.end(),
+                                 [](const Factura& f) { return f.importe <= Dinero(); }), facturas.end());
+        Antiguedad::reiniciar(facturas, hoy);
+    }
+    Antiguedad::avanzarHasta(hoy);
+    return true;
+}
+
+// --- Men: antigedad de saldos ---
+void Facturacion::mostrarAntiguedadSaldos() {
+    auto inicio = chrono::steady_clock::now();
+    if (!prepararAntiguedad()) {
+        cerr << "No se pudo abrir el archivo de facturas." << endl;
+        return;
+    }
+    Antiguedad::Tramos totales = Antiguedad::totales();
+    vector<pair<int, Antiguedad::Tramos>> clientes = Antiguedad::porCliente();
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    // Primero los clientes con ms saldo en el tramo ms antiguo
+    sort(clientes.begin(), clientes.end(), [](const pair<int, Antiguedad::Tramos>& a,
+                                              const pair<int, Antiguedad::Tramos>& b) {
+        for (int t = Antiguedad::TRAMOS - 1; t >= 0; --t) {
+            if (a.second.importe[t] != b.second.importe[t]) return a.second.importe[t] > b.second.importe[t];
+        }
+        return a.first < b.first;
+    });
+
+    cout << "\n=========== ANTIGUEDAD DE SALDOS ===========\n";
+    cout << "Dias desde el vencimiento (plazo de pago: " << DIAS_PLAZO_PAGO << " dias)\n";
+    for (int t = 0; t < Antiguedad::TRAMOS; ++t) {
+        cout << left << setw(6) << Antiguedad::nombreTramo(t) << right
+             << ": $" << totales.importe[t] << " (" << totales.facturas[t] << " facturas)\n";
+    }
+    cout << "Total : $" << totales.total() << endl;
+
+    const size_t maximo = 10;
+    cout << "\n--- Clientes con saldos mas antiguos ---\n";
+    for (size_t i = 0; i < clientes.size() && i < maximo; ++i) {
+        cout << "Cliente " << clientes[i].first;
+        for (int t = 0; t < Antiguedad::TRAMOS; ++t) {
+            cout << " | " << Antiguedad::nombreTramo(t) << ": $" << clientes[i].second.importe[t];
+        }
+        cout << endl;
     }
+    cout << "============================================\n";
+    cout << "Calculado en " << fixed << setprecision(3) << segundos << " s\n";
+}
+
+// --- Exporta las facturas vigentes a facturas.col ---
+void Facturacion::exportarColumnar() {
+    vector<Factura> facturas;
+    if (!cargarFacturas(facturas) || !prepararPagos()) {
+        cerr << "No se pudo abrir el archivo de facturas." << endl;
+        return;
+    }
+
+    auto inicio = chrono::steady_clock::now();
+    // Saldo de cada factura segn el libro de pagos (una factura con abonos no debe todo su importe)
+    vector<Dinero> saldos;
+    saldos.reserve(facturas.size());
+    for (const auto& factura : facturas) saldos.push_back(Pagos::saldoFactura(factura.idFactura));
+    ArchivoColumnar lector;
+    if (!ArchivoColumnar::exportarFacturas(facturas, saldos, archivoColumnar) || !lector.abrir(archivoColumnar)) {
+        cout << "No se pudo escribir " << archivoColumnar << ".\n";
+        return;
+    }
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    cout << "\n=========== EXPORTACION COLUMNAR ===========\n";
+    cout << "Archivo  : " << archivoColumnar << endl;
+    cout << "Facturas : " << lector.getFilas() << " en " << lector.getBloques() << " bloques\n";
+    cout << left << setw(18) << "Columna" << setw(10) << "Tipo" << setw(12) << "Bytes"
+         << "Bloques plana/dicc./RLE" << right << endl;
+    uint64_t totalBytes = 0;
+    for (size_t c = 0; c < lector.getColumnas().size(); ++c) {
+        const ArchivoColumnar::Columna& columna = lector.getColumnas()[c];
+        uint64_t bytes = 0;
+        size_t porCodificacion[4] = {0, 0, 0, 0};
+        for (size_t b = 0; b < lector.getBloques(); ++b) {
+            const ArchivoColumnar::Bloque& bloque = lector.getBloque(b, c);
+            bytes += bloque.bytes;
+            if (bloque.codificacion < 4) porCodificacion[bloque.codificacion]++;
+        }
+        totalBytes += bytes;
+        cout << left << setw(18) << columna.nombre << setw(10) << ArchivoColumnar::nombreTipo(columna.tipo)
+             << setw(12) << bytes << right
+             << porCodificacion[ArchivoColumnar::CODIFICACION_PLANA] << "/"
+             << porCodificacion[ArchivoColumnar::CODIFICACION_DICCIONARIO] << "/"
+             << porCodificacion[ArchivoColumnar::CODIFICACION_RLE] << endl;
+    }
+    cout << "Datos    : " << totalBytes << " bytes (" << facturas.size() * sizeof(Factura)
+         << " en facturas.bin)\n";
+    cout << "Tiempo   : " << fixed << setprecision(3) << segundos << " s\n";
+    cout << "============================================\n";
+
+    auditoria.registrar(usuarioRegistrado.getNombre(), "FACTURACION",
+                        "Exportacion columnar: " + to_string(facturas.size()) + " facturas");
+}
+
+// --- Totales de un rango de fechas de emisin ledos de facturas.col ---
+void Facturacion::consultarExportacion() {
+    ArchivoColumnar lector;
+    if (!lector.abrir(archivoColumnar)) {
+        cout << "No hay una exportacion valida; use primero la opcion 8.\n";
+        return;
+    }
+    if (lector.indiceColumna("saldo") < 0) {
+        cout << "La exportacion es anterior a la columna de saldo; vuelva a exportar con la opcion 8.\n";
+        return;
+    }
+
+    string texto;
+    int64_t desde = 0, hasta = 0;
+    cout << "Fecha de emision desde (AAAA-MM-DD): ";
+    cin >> texto;
+    if (!fechaDeTexto(texto, desde)) {
+        cout << "Fecha invalida.\n";
+        return;
+    }
+    cout << "Fecha de emision hasta (AAAA-MM-DD): ";
+    cin >> texto;
+    if (!fechaDeTexto(texto, hasta) || hasta < desde) {
+        cout << "Fecha invalida.\n";
+        return;
+    }
+    hasta += 24 * 60 * 60 - 1;   // Hasta el final del da
+
+    auto inicio = chrono::steady_clock::now();
+    ArchivoColumnar::Resultado resultado;
+    if (!lector.leer({"importe", "impuesto", "saldo"}, {{"fechaEmision", desde, hasta}}, resultado)) {
+        cout << "El archivo " << archivoColumnar << " esta danado; vuelva a exportar.\n";
+        return;
+    }
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    int64_t importe = 0, impuesto = 0, abierto = 0;
+    size_t abiertas = 0;
+    for (size_t i = 0; i < resultado.filas(); ++i) {
+        importe += resultado.valores[0][i];
+        impuesto += resultado.valores[1][i];
+        if (resultado.valores[2][i] > 0) {
+            abierto += resultado.valores[2][i];
+            abiertas++;
+        }
+    }
+
+    cout << "\n========= FACTURAS POR FECHA DE EMISION =========\n";
+    cout << "Periodo            : " << textoFecha(desde) << " a " << textoFecha(hasta) << endl;
+    cout << "Facturas           : " << resultado.filas() << " (" << abiertas << " sin pagar)\n";
+    cout << "Importe facturado  : $" << Dinero::deCentavos(importe) << endl;
+    cout << "IVA incluido       : $" << Dinero::deCentavos(impuesto) << endl;
+    cout << "Saldo sin pagar    : $" << Dinero::deCentavos(abierto) << endl;
+    cout << "Bloques leidos     : " << resultado.bloquesLeidos << " (omitidos " << resultado.bloquesOmitidos
+         << ", " << resultado.bytesLeidos << " bytes)\n";
+    cout << "Tiempo             : " << fixed << setprecision(3) << segundos << " s\n";
+    cout << "=================================================\n";
 }
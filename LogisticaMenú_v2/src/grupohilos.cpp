@@ -0,0 +1,77 @@
+#include "grupohilos.h"
+#include <algorithm>
+
+using namespace std;
+
+// Grupo al que pertenece el hilo actual (nullptr fuera de los grupos)
+static thread_local const GrupoHilos* grupoDelHilo = nullptr;
+
+GrupoHilos::GrupoHilos(size_t cantidad) {
+    if (cantidad == 0) cantidad = max(1u, thread::hardware_concurrency());
+    hilos.reserve(cantidad);
+    for (size_t i = 0; i < cantidad; ++i) {
+        hilos.emplace_back(&GrupoHilos::trabajar, this);
+    }
+}
+
+GrupoHilos::~GrupoHilos() {
+    {
+        lock_guard<std::mutex> bloqueo(mutex);
+        detener = true;
+    }
+    hayTrabajo.notify_all();
+    for (auto& hilo : hilos) hilo.join();
+}
+
+// Bucle de cada hilo: toma tareas hasta que se pide detener y la cola está vacía
+void GrupoHilos::trabajar() {
+    grupoDelHilo = this;
+    while (true) {
+        function<void()> tarea;
+        {
+            unique_lock<std::mutex> bloqueo(mutex);
+            hayTrabajo.wait(bloqueo, [this] { return detener || !cola.empty(); });
+            if (cola.empty()) return;
+            tarea = move(cola.front());
+            cola.pop();
+        }
+        tarea();
+    }
+}
+
+// Bloques de tamaño parejo, unos cuantos por hilo para equilibrar tareas desiguales.
+// Desde un hilo del mismo grupo se ejecuta en línea: esperar a la cola podría bloquearlo.
+void GrupoHilos::paraCada(size_t cantidad, const function<void(size_t)>& tarea) {
+    if (cantidad == 0) return;
+    if (cantidad == 1 || hilos.size() == 1 || grupoDelHilo == this) {
+        for (size_t i = 0; i < cantidad; ++i) tarea(i);
+        return;
+    }
+
+    size_t bloques = min(cantidad, hilos.size() * 4);
+    size_t tamBloque = (cantidad + bloques - 1) / bloques;
+    vector<future<void>> pendientes;
+    pendientes.reserve(bloques);
+    for (size_t inicio = 0; inicio < cantidad; inicio += tamBloque) {
+        size_t fin = min(cantidad, inicio + tamBloque);
+        pendientes.push_back(encolar([&tarea, inicio, fin]() {
+            for (size_t i = inicio; i < fin; ++i) tarea(i);
+        }));
+    }
+
+    // Se espera a todos los bloques antes de relanzar: usan 'tarea' por referencia
+    exception_ptr error;
+    for (auto& pendiente : pendientes) {
+        try {
+            pendiente.get();
+        } catch (...) {
+            if (!error) error = current_exception();
+        }
+    }
+    if (error) rethrow_exception(error);
+}
+
+GrupoHilos& GrupoHilos::global() {
+    static GrupoHilos grupo;
+    return grupo;
+}
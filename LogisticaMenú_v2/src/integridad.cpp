@@ -0,0 +1,256 @@
+#include "integridad.h"
+#include "grupohilos.h"
+#include "archivador.h"
+#include "clientes.h"
+#include "almacen.h"
+#include "producto.h"
+#include "transportistas.h"
+#include "pedidos.h"
+#include "envios.h"
+#include "facturacion.h"
+#include "bitacora.h"
+#include "usuarios.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <unordered_set>
+#include <unordered_map>
+#include <chrono>
+#include <cstdlib>
+
+using namespace std;
+
+extern usuarios usuarioRegistrado;
+extern bitacora auditoria;
+
+namespace {
+
+enum IndiceRelacion {
+    CLIENTES, ALMACENES, PRODUCTOS, TRANSPORTISTAS, PEDIDOS, ENVIOS, FACTURAS, RELACIONES
+};
+
+const char* NOMBRE_RELACION[RELACIONES] = {
+    "Clientes", "Almacenes", "Productos", "Transportistas", "Pedidos", "Envios", "Facturas"
+};
+
+// Registros y claves de todos los archivos
+struct Datos {
+    vector<Clientes> clientes;
+    vector<Almacen> almacenes;
+    vector<Producto> productos;
+    vector<Transportistas> transportistas;
+    vector<Pedidos> pedidos;
+    vector<Envio> envios;
+    vector<Factura> facturas;
+
+    unordered_set<string> claves[RELACIONES];
+};
+
+// Referencia a un pedido que no está en pedidos.bin: puede estar en el histórico
+struct PedidoAusente {
+    string idPedido;
+    string detalle;
+};
+
+// Conjunto hash de las claves de un archivo; las repetidas se anotan como duplicadas
+template <typename Registro, typename Clave>
+void indexar(const vector<Registro>& registros, Clave clave, unordered_set<string>& claves,
+             Integridad::Relacion& relacion) {
+    relacion.registros = registros.size();
+    claves.reserve(registros.size());
+    for (const auto& registro : registros) {
+        string valor = clave(registro);
+        if (!claves.insert(valor).second) relacion.anotar(relacion.duplicados, "ID repetido " + valor);
+    }
+}
+
+void cargar(int indice, Datos& datos, Integridad::Relacion& relacion) {
+    unordered_set<string>& claves = datos.claves[indice];
+    switch (indice) {
+        case CLIENTES:
+            Clientes::cargarDesdeArchivo(datos.clientes);
+            indexar(datos.clientes, [](const Clientes& c) { return c.getId(); }, claves, relacion);
+            break;
+        case ALMACENES:
+            Almacen::cargarDesdeArchivo(datos.almacenes);
+            indexar(datos.almacenes, [](const Almacen& a) { return a.getId(); }, claves, relacion);
+            break;
+        case PRODUCTOS:
+            // Los pedidos referencian el código del producto, no su ID
+            Producto::cargarDesdeArchivoBin(datos.productos);
+            indexar(datos.productos, [](const Producto& p) { return p.getCodigo(); }, claves, relacion);
+            break;
+        case TRANSPORTISTAS:
+            Transportistas::cargarDesdeArchivo(datos.transportistas);
+            indexar(datos.transportistas, [](const Transportistas& t) { return t.id; }, claves, relacion);
+            break;
+        case PEDIDOS:
+            Pedidos::cargarDesdeArchivoBin(datos.pedidos);
+            indexar(datos.pedidos, [](const Pedidos& p) { return p.getId(); }, claves, relacion);
+            break;
+        case ENVIOS:
+            datos.envios = Envios::cargarEnviosDesdeArchivo();
+            indexar(datos.envios, [](const Envio& e) { return e.idEnvio; }, claves, relacion);
+            break;
+        case FACTURAS: {
+            // Sin facturas.bin no hay nada que revisar (abrirlo lo crearía)
+            if (ifstream("facturas.bin", ios::binary)) {
+                Facturacion facturacion;
+                facturacion.cargarFacturas(datos.facturas);
+            }
+            indexar(datos.facturas, [](const Factura& f) { return to_string(f.idFactura); }, claves, relacion);
+            break;
+        }
+    }
+}
+
+void revisarPedidos(const Datos& datos, Integridad::Relacion& relacion) {
+    for (const auto& pedido : datos.pedidos) {
+        const string origen = "Pedido " + pedido.getId();
+        if (!datos.claves[CLIENTES].count(pedido.getIdCliente())) {
+            relacion.anotar(relacion.huerfanos, origen + ": cliente " + pedido.getIdCliente() + " no existe");
+        }
+        // Un pedido solo con líneas en espera todavía no tiene almacén
+        if (!pedido.getIdAlmacen().empty() && !datos.claves[ALMACENES].count(pedido.getIdAlmacen())) {
+            relacion.anotar(relacion.huerfanos, origen + ": almacen " + pedido.getIdAlmacen() + " no existe");
+        }
+        for (const auto& linea : pedido.getLineas()) {
+            if (!datos.claves[PRODUCTOS].count(linea.codigoProducto)) {
+                relacion.anotar(relacion.huerfanos, origen + ": producto " + linea.codigoProducto + " no existe");
+            }
+        }
+    }
+}
+
+void revisarEnvios(const Datos& datos, Integridad::Relacion& relacion, vector<PedidoAusente>& ausentes) {
+    for (const auto& envio : datos.envios) {
+        const string origen = "Envio " + envio.idEnvio;
+        if (!datos.claves[PEDIDOS].count(envio.idPedido)) {
+            ausentes.push_back({envio.idPedido, origen + ": pedido " + envio.idPedido + " no existe"});
+        }
+        if (!datos.claves[TRANSPORTISTAS].count(envio.idTransportista)) {
+            relacion.anotar(relacion.huerfanos, origen + ": transportista " + envio.idTransportista + " no existe");
+        }
+        if (!datos.claves[CLIENTES].count(envio.idCliente)) {
+            relacion.anotar(relacion.huerfanos, origen + ": cliente " + envio.idCliente + " no existe");
+        }
+    }
+}
+
+void revisarFacturas(const Datos& datos, Integridad::Relacion& relacion, vector<PedidoAusente>& ausentes) {
+    unordered_map<int, int> facturaPorPedido;
+    facturaPorPedido.reserve(datos.facturas.size());
+    for (const auto& factura : datos.facturas) {
+        const string origen = "Factura " + to_string(factura.idFactura);
+        const string idPedido = to_string(factura.idPedido);
+        const string idCliente = to_string(factura.idCliente);
+
+        auto insertado = facturaPorPedido.emplace(factura.idPedido, factura.idFactura);
+        if (!insertado.second) {
+            relacion.anotar(relacion.duplicados, origen + ": pedido " + idPedido + " ya facturado en " +
+                                                 to_string(insertado.first->second));
+        }
+        if (!datos.claves[PEDIDOS].count(idPedido)) {
+            ausentes.push_back({idPedido, origen + ": pedido " + idPedido + " no existe"});
+        }
+        if (!datos.claves[CLIENTES].count(idCliente)) {
+            relacion.anotar(relacion.huerfanos, origen + ": cliente " + idCliente + " no existe");
+        }
+    }
+}
+
+double segundosDesde(chrono::steady_clock::time_point inicio) {
+    return chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+}
+
+} // namespace
+
+void Integridad::Relacion::anotar(size_t& contador, const string& detalle) {
+    contador++;
+    if (ejemplos.size() < MAXIMO_EJEMPLOS) ejemplos.push_back(detalle);
+}
+
+size_t Integridad::Informe::problemas() const {
+    size_t total = 0;
+    for (const auto& relacion : relaciones) total += relacion.huerfanos + relacion.duplicados;
+    return total;
+}
+
+Integridad::Informe Integridad::verificar() {
+    Informe informe;
+    informe.relaciones.resize(RELACIONES);
+    for (int i = 0; i < RELACIONES; ++i) informe.relaciones[i].nombre = NOMBRE_RELACION[i];
+
+    // Cada archivo se lee y se indexa en su propio hilo
+    Datos datos;
+    auto inicio = chrono::steady_clock::now();
+    GrupoHilos::global().paraCada(RELACIONES, [&](size_t i) {
+        cargar(static_cast<int>(i), datos, informe.relaciones[i]);
+    });
+    informe.segundosCarga = segundosDesde(inicio);
+
+    // Una pasada por relación, en paralelo; los conjuntos de claves ya no cambian
+    inicio = chrono::steady_clock::now();
+    vector<PedidoAusente> ausentes[RELACIONES];
+    const int revisadas[] = {PEDIDOS, ENVIOS, FACTURAS};
+    GrupoHilos::global().paraCada(3, [&](size_t i) {
+        int indice = revisadas[i];
+        if (indice == PEDIDOS) revisarPedidos(datos, informe.relaciones[indice]);
+        else if (indice == ENVIOS) revisarEnvios(datos, informe.relaciones[indice], ausentes[indice]);
+        else revisarFacturas(datos, informe.relaciones[indice], ausentes[indice]);
+    });
+
+    // El índice del histórico no se comparte entre hilos: se consulta aquí
+    for (int indice : revisadas) {
+        for (const auto& ausente : ausentes[indice]) {
+            if (!Archivador::contienePedido(ausente.idPedido)) {
+                informe.relaciones[indice].anotar(informe.relaciones[indice].huerfanos, ausente.detalle);
+            }
+        }
+    }
+    informe.segundosRevision = segundosDesde(inicio);
+    return informe;
+}
+
+void Integridad::mostrar(const Informe& informe) {
+    cout << "\n\t\t============= INTEGRIDAD DE DATOS =============\n";
+    cout << "\t\t" << left << setw(16) << "Archivo" << right << setw(10) << "Registros"
+         << setw(11) << "Huerfanos" << setw(12) << "Duplicados" << "\n";
+    cout << "\t\t" << string(49, '-') << "\n";
+    for (const auto& relacion : informe.relaciones) {
+        cout << "\t\t" << left << setw(16) << relacion.nombre << right << setw(10) << relacion.registros
+             << setw(11) << relacion.huerfanos << setw(12) << relacion.duplicados << "\n";
+    }
+    cout << "\t\t" << string(49, '-') << "\n";
+
+    for (const auto& relacion : informe.relaciones) {
+        if (relacion.ejemplos.empty()) continue;
+        size_t total = relacion.huerfanos + relacion.duplicados;
+        cout << "\n\t\t" << relacion.nombre << " (" << total << " problemas";
+        if (total > relacion.ejemplos.size()) cout << ", primeros " << relacion.ejemplos.size();
+        cout << "):\n";
+        for (const auto& ejemplo : relacion.ejemplos) cout << "\t\t  - " << ejemplo << "\n";
+    }
+
+    cout << "\n\t\tProblemas encontrados: " << informe.problemas() << "\n";
+    cout << "\t\tCarga: " << fixed << setprecision(3) << informe.segundosCarga << " s, revision: "
+         << informe.segundosRevision << " s\n";
+    cout << "\t\t===============================================\n";
+}
+
+void Integridad::verificarInteractivo() {
+    system("cls");
+    cout << "\n\t\tVerificando archivos de datos...\n";
+    Informe informe = verificar();
+    mostrar(informe);
+    auditoria.registrar(usuarioRegistrado.getNombre(), "INTEGRIDAD",
+                        "Verificacion de integridad: " + to_string(informe.problemas()) + " problemas");
+    system("pause");
+}
+
+int Integridad::verificarDesdeLineaDeComandos() {
+    Informe informe = verificar();
+    mostrar(informe);
+    return informe.problemas() == 0 ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+#include "listaespera.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+using namespace std;
+
+// Definicion de los miembros estaticos
+unordered_map<string, vector<ListaEspera::Entrada>> ListaEspera::colas;
+unordered_map<string, int> ListaEspera::pendientesPorPedido;
+unordered_map<string, Dinero> ListaEspera::montoPorPedido;
+unordered_map<string, int> ListaEspera::unidadesPorProducto;
+uint64_t ListaEspera::siguienteSecuencia = 0;
+bool ListaEspera::cargado = false;
+
+// Comparador de heap: true si 'a' se atiende despues que 'b'
+bool ListaEspera::atiendeDespues(const Entrada& a, const Entrada& b) {
+    if (a.prioridad != b.prioridad) return a.prioridad < b.prioridad;
+    if (a.fecha != b.fecha) return a.fecha > b.fecha;
+    return a.secuencia > b.secuencia;
+}
+
+// Carga el archivo la primera vez que se usa la lista
+void ListaEspera::asegurarCargado() {
+    if (cargado) return;
+    cargado = true;
+    cargarDesdeArchivo();
+}
+
+// Resta una linea al contador del pedido
+void ListaEspera::descontarPedido(const string& idPedido) {
+    auto it = pendientesPorPedido.find(idPedido);
+    if (it != pendientesPorPedido.end() && --it->second <= 0) {
+        pendientesPorPedido.erase(it);
+        montoPorPedido.erase(idPedido);
+    }
+}
+
+// Suma (o resta) unidades al total en espera del producto
+void ListaEspera::ajustarUnidades(const string& codigoProducto, int delta) {
+    auto it = unidadesPorProducto.find(codigoProducto);
+    if (it == unidadesPorProducto.end()) it = unidadesPorProducto.emplace(codigoProducto, 0).first;
+    it->second += delta;
+    if (it->second <= 0) unidadesPorProducto.erase(it);
+}
+
+// Pone en espera una linea del pedido
+void ListaEspera::agregar(Entrada entrada) {
+    asegurarCargado();
+    if (entrada.cantidad <= 0) return;
+
+    entrada.secuencia = siguienteSecuencia++;
+    vector<Entrada>& cola = colas[entrada.codigoProducto];
+    pendientesPorPedido[entrada.idPedido]++;
+    montoPorPedido[entrada.idPedido] += entrada.cantidad * entrada.precioUnitario;
+    ajustarUnidades(entrada.codigoProducto, entrada.cantidad);
+    cola.push_back(move(entrada));
+    push_heap(cola.begin(), cola.end(), atiendeDespues);
+    guardarEnArchivo();
+}
+
+// Reparte la mercancia recibida: se toma siempre la cabeza de la cola del producto
+vector<ListaEspera::Asignacion> ListaEspera::asignarEntrada(const string& codigoProducto,
+                                                          const string& idAlmacen,
+                                                          int cantidad,
+                                                          const PedidoVigente& vigente) {
+    asegurarCargado();
+    vector<Asignacion> asignaciones;
+
+    auto it = colas.find(codigoProducto);
+    if (it == colas.end() || cantidad <= 0) return asignaciones;
+
+    vector<Entrada>& cola = it->second;
+    bool huboCambios = false;
+
+    while (cantidad > 0 && !cola.empty()) {
+        Entrada& cabeza = cola.front();
+
+        // Pedido cancelado o cerrado por otra via: se descarta la linea
+        if (vigente && !vigente(cabeza.idPedido)) {
+            montoPorPedido[cabeza.idPedido] -= cabeza.cantidad * cabeza.precioUnitario;
+            ajustarUnidades(codigoProducto, -cabeza.cantidad);
+            descontarPedido(cabeza.idPedido);
+            pop_heap(cola.begin(), cola.end(), atiendeDespues);
+            cola.pop_back();
+            huboCambios = true;
+            continue;
+        }
+
+        int toma = min(cantidad, cabeza.cantidad);
+        asignaciones.push_back({cabeza.idPedido, cabeza.idCliente, codigoProducto,
+                                idAlmacen, toma, cabeza.precioUnitario});
+        cantidad -= toma;
+        cabeza.cantidad -= toma;
+        montoPorPedido[cabeza.idPedido] -= toma * cabeza.precioUnitario;
+        ajustarUnidades(codigoProducto, -toma);
+        huboCambios = true;
+
+        // La clave de orden no cambia con una atencion parcial; solo se saca al completarse
+        if (cabeza.cantidad == 0) {
+            descontarPedido(cabeza.idPedido);
+            pop_heap(cola.begin(), cola.end(), atiendeDespues);
+            cola.pop_back();
+        }
+    }
+
+    if (cola.empty()) colas.erase(it);
+    if (huboCambios) guardarEnArchivo();
+    return asignaciones;
+}
+
+// Quita las lineas de un pedido; se rehace solo el heap de los productos afectados
+void ListaEspera::retirarPedido(const string& idPedido) {
+    asegurarCargado();
+    montoPorPedido.erase(idPedido);
+    if (pendientesPorPedido.erase(idPedido) == 0) return;
+
+    for (auto it = colas.begin(); it != colas.end(); ) {
+        vector<Entrada>& cola = it->second;
+        auto fin = remove_if(cola.begin(), cola.end(),
+            [&idPedido](const Entrada& e) { return e.idPedido == idPedido; });
+        for (auto e = fin; e != cola.end(); ++e) ajustarUnidades(e->codigoProducto, -e->cantidad);
+        if (fin != cola.end()) {
+            cola.erase(fin, cola.end());
+            make_heap(cola.begin(), cola.end(), atiendeDespues);
+        }
+        it = cola.empty() ? colas.erase(it) : next(it);
+    }
+    guardarEnArchivo();
+}
+
+// Lineas en espera de un pedido
+int ListaEspera::lineasPendientes(const string& idPedido) {
+    asegurarCargado();
+    auto it = pendientesPorPedido.find(idPedido);
+    return it == pendientesPorPedido.end() ? 0 : it->second;
+}
+
+// Valor de las lineas en espera de un pedido
+Dinero ListaEspera::montoPendiente(const string& idPedido) {
+    asegurarCargado();
+    auto it = montoPorPedido.find(idPedido);
+    return it == montoPorPedido.end() ? Dinero() : it->second;
+}
+
+// Unidades en espera de un producto
+int ListaEspera::unidadesEnEspera(const string& codigoProducto) {
+    asegurarCargado();
+    auto it = unidadesPorProducto.find(codigoProducto);
+    return it == unidadesPorProducto.end() ? 0 : it->second;
+}
+
+// Escribe una cadena con su longitud
+static void escribirCadena(ofstream& archivo, const string& texto) {
+    size_t len = texto.size();
+    archivo.write(reinterpret_cast<const char*>(&len), sizeof(len));
+    archivo.write(texto.c_str(), len);
+}
+
+// Lee una cadena con su longitud
+static bool leerCadena(ifstream& archivo, string& texto) {
+    size_t len = 0;
+    if (!archivo.read(reinterpret_cast<char*>(&len), sizeof(len)) || len > 1024) return false;
+    texto.resize(len);
+    return len == 0 || static_cast<bool>(archivo.read(&texto[0], len));
+}
+
+// Guarda todas las lineas en espera en listaespera.bin
+void ListaEspera::guardarEnArchivo() {
+    ofstream archivo("listaespera.bin", ios::binary | ios::trunc);
+    if (!archivo) {
+        cerr << "\n\t\tError: No se pudo abrir listaespera.bin para escritura\n";
+        return;
+    }
+
+    size_t cantidad = 0;
+    for (const auto& par : colas) cantidad += par.second.size();
+    archivo.write(reinterpret_cast<const char*>(&cantidad), sizeof(cantidad));
+
+    for (const auto& par : colas) {
+        for (const auto& entrada : par.second) {
+            escribirCadena(archivo, entrada.idPedido);
+            escribirCadena(archivo, entrada.idCliente);
+            escribirCadena(archivo, entrada.codigoProducto);
+            archivo.write(reinterpret_cast<const char*>(&entrada.cantidad), sizeof(entrada.cantidad));
+            double precio = entrada.precioUnitario.aDecimal();   // En archivo como double
+            archivo.write(reinterpret_cast<const char*>(&precio), sizeof(precio));
+            archivo.write(reinterpret_cast<const char*>(&entrada.prioridad), sizeof(entrada.prioridad));
+            archivo.write(reinterpret_cast<const char*>(&entrada.fecha), sizeof(entrada.fecha));
+            archivo.write(reinterpret_cast<const char*>(&entrada.secuencia), sizeof(entrada.secuencia));
+        }
+    }
+}
+
+// Carga listaespera.bin y arma un heap por producto
+void ListaEspera::cargarDesdeArchivo() {
+    colas.clear();
+    pendientesPorPedido.clear();
+    montoPorPedido.clear();
+    unidadesPorProducto.clear();
+    siguienteSecuencia = 0;
+
+    ifstream archivo("listaespera.bin", ios::binary);
+    if (!archivo) return;
+
+    size_t cantidad = 0;
+    if (!archivo.read(reinterpret_cast<char*>(&cantidad), sizeof(cantidad))) return;
+
+    for (size_t i = 0; i < cantidad; ++i) {
+        Entrada entrada;
+        double precio = 0.0;
+        if (!leerCadena(archivo, entrada.idPedido) ||
+            !leerCadena(archivo, entrada.idCliente) ||
+            !leerCadena(archivo, entrada.codigoProducto) ||
+            !archivo.read(reinterpret_cast<char*>(&entrada.cantidad), sizeof(entrada.cantidad)) ||
+            !archivo.read(reinterpret_cast<char*>(&precio), sizeof(precio)) ||
+            !archivo.read(reinterpret_cast<char*>(&entrada.prioridad), sizeof(entrada.prioridad)) ||
+            !archivo.read(reinterpret_cast<char*>(&entrada.fecha), sizeof(entrada.fecha)) ||
+            !archivo.read(reinterpret_cast<char*>(&entrada.secuencia), sizeof(entrada.secuencia))) {
+            cerr << "\n\t\tAdvertencia: listaespera.bin incompleto, se cargaron " << i << " lineas\n";
+            break;
+        }
+        entrada.precioUnitario = Dinero::deDecimal(precio);
+        siguienteSecuencia = max(siguienteSecuencia, entrada.secuencia + 1);
+        pendientesPorPedido[entrada.idPedido]++;
+        montoPorPedido[entrada.idPedido] += entrada.cantidad * entrada.precioUnitario;
+        ajustarUnidades(entrada.codigoProducto, entrada.cantidad);
+        colas[entrada.codigoProducto].push_back(move(entrada));
+    }
+
+    for (auto& par : colas) {
+        make_heap(par.second.begin(), par.second.end(), atiendeDespues);
+    }
+}
@@ -2,6 +2,8 @@
 #include "usuarios.h"
 #include <iostream>
 #include "globals.h"
+#include "archivador.h"
+#include "integridad.h"
 //#include "backup_manager.h"
 
 //JENNIFER BARRIOS COORD: EQ3
@@ -22,7 +24,10 @@ void MenuArchivo::mostrar() {
              << "\t\t========================================\n"
              << "\t\t 1. Cerrar sesion\n"
              << "\t\t 2. Backup\n"
-             << "\t\t 3. Volver al menu principal\n"
+             << "\t\t 3. Archivar historico\n"
+             << "\t\t 4. Consultar historico\n"
+             << "\t\t 5. Verificar integridad de datos\n"
+             << "\t\t 6. Volver al menu principal\n"
              << "\t\t========================================\n"
              << "\t\tIngresa tu opcion: ";
         cin >> opcion;
@@ -40,6 +45,15 @@ void MenuArchivo::mostrar() {
                // BackupManager::mostrarMenuBackup();  // Llamar al men de backup
                 break;
             case 3:
+                Archivador::archivarInteractivo();
+                break;
+            case 4:
+                Archivador::consultarInteractivo();
+                break;
+            case 5:
+                Integridad::verificarInteractivo();
+                break;
+            case 6:
                 return;
             default:
                 cout << "\n\t\tOpcion invalida...";
@@ -5,6 +5,7 @@
 #include "MenuAlmacenes.h"
 #include "MenuAdministracion.h"
 #include "MenuTransportistas.h"
+#include "tarifas.h"
 #include <iostream>
 #include <limits>
 
@@ -45,8 +46,13 @@ void MenuCatalogos::mostrar(vector<Clientes>& clientes,
             cout << "\t\t6. Administracin\n";
         }
 
+        // Tarifas y descuentos: tambin restringido a nivel alto
+        if(usuarioActual.getNivelAcceso() >= 3) {
+            cout << "\t\t7. Tarifas y descuentos\n";
+        }
+
         // Opcin para volver al men principal
-        cout << "\t\t7. Volver al men principal\n"
+        cout << "\t\t8. Volver al men principal\n"
              << "\t\t====================================\n"
              << "\t\tSeleccione una opcin: ";
 
@@ -97,6 +103,16 @@ void MenuCatalogos::mostrar(vector<Clientes>& clientes,
                 break;
 
             case 7:
+                // Solo disponible si el usuario tiene nivel 3 o superior
+                if(usuarioActual.getNivelAcceso() >= 3) {
+                    Tarifas::menuInteractivo(clientes, productos);
+                } else {
+                    cout << "\n\t\tAcceso denegado. Nivel insuficiente.\n";
+                    system("pause");
+                }
+                break;
+
+            case 8:
                 // Volver al men principal (salir del bucle)
                 return;
 
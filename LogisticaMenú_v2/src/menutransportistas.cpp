@@ -5,6 +5,7 @@
 #include <vector>
 #include "globals.h"
 #include "transportistas.h"
+#include "reservas.h"
 
 using namespace std;
 
@@ -20,7 +21,8 @@ void MenuTransportistas::mostrar(std::vector<Transportistas>& listaTransportista
              << "\t\t2. Mostrar transportistas\n"
              << "\t\t3. Modificar transportista\n"
              << "\t\t4. Eliminar transportista\n"
-             << "\t\t5. Volver al men� principal\n"
+             << "\t\t5. Agenda de franjas\n"
+             << "\t\t6. Volver al men� principal\n"
              << "\t\t===========================\n"
              << "\t\tSeleccione una opci�n: ";
 
@@ -76,6 +78,10 @@ void MenuTransportistas::mostrar(std::vector<Transportistas>& listaTransportista
             }
 
             case 5:
+                Reservas::mostrarAgenda();
+                break;
+
+            case 6:
                 // Guardar cambios al salir
                 Transportistas().guardarEnArchivo(listaTransportistas);
                 return;
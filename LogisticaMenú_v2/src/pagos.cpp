@@ -0,0 +1,264 @@
+#include "pagos.h"
+
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <ctime>
+
+using namespace std;
+
+// --- Formato de pagos.bin: cabecera y registros MovimientoPago ---
+const char ARCHIVO_PAGOS[] = "pagos.bin";
+const char FIRMA_PAGOS[4] = {'P', 'A', 'G', 'O'};
+const uint32_t VERSION_PAGOS = 1;
+const int ID_MOVIMIENTO_INICIAL = 1;
+
+struct CabeceraPagos {
+    char firma[4];          // "PAGO"
+    uint32_t version;
+    uint32_t tamRegistro;   // sizeof(MovimientoPago)
+    int32_t siguienteId;
+    uint32_t cantidad;      // Registros escritos después de la cabecera
+    uint32_t reservado;
+};
+
+static_assert(sizeof(CabeceraPagos) == 24, "formato de pagos.bin");
+static_assert(sizeof(MovimientoPago) == 64, "formato de pagos.bin");
+
+mutex Pagos::mutexPagos;
+bool Pagos::cargado = false;
+unordered_map<int, Pagos::EstadoFactura> Pagos::porFactura;
+unordered_map<int, int> Pagos::facturasPorPedido;
+unordered_map<int, Dinero> Pagos::porCliente;
+
+static streamoff posicionMovimiento(uint32_t i) {
+    return static_cast<streamoff>(sizeof(CabeceraPagos)) + static_cast<streamoff>(i) * sizeof(MovimientoPago);
+}
+
+// Abre pagos.bin y lee su cabecera; si no existe lo crea vacío
+static bool abrirLibro(fstream& archivo, CabeceraPagos& cabecera) {
+    archivo.open(ARCHIVO_PAGOS, ios::binary | ios::in | ios::out);
+    if (!archivo) {
+        archivo.clear();
+        archivo.open(ARCHIVO_PAGOS, ios::binary | ios::in | ios::out | ios::trunc);
+        if (!archivo) return false;
+        memset(&cabecera, 0, sizeof(cabecera));
+        memcpy(cabecera.firma, FIRMA_PAGOS, sizeof(cabecera.firma));
+        cabecera.version = VERSION_PAGOS;
+        cabecera.tamRegistro = sizeof(MovimientoPago);
+        cabecera.siguienteId = ID_MOVIMIENTO_INICIAL;
+        archivo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+        return static_cast<bool>(archivo.flush());
+    }
+
+    if (!archivo.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera)) ||
+        memcmp(cabecera.firma, FIRMA_PAGOS, sizeof(cabecera.firma)) != 0 ||
+        cabecera.version != VERSION_PAGOS || cabecera.tamRegistro != sizeof(MovimientoPago)) {
+        cerr << "El archivo de pagos tiene un formato no compatible." << endl;
+        return false;
+    }
+
+    // Si quedó más corto que lo que indica la cabecera, solo cuentan los registros completos
+    archivo.seekg(0, ios::end);
+    streamoff tam = archivo.tellg();
+    uint32_t completos = tam < posicionMovimiento(0) ? 0 :
+        static_cast<uint32_t>((tam - posicionMovimiento(0)) / static_cast<streamoff>(sizeof(MovimientoPago)));
+    cabecera.cantidad = min(cabecera.cantidad, completos);
+    archivo.clear();
+    return true;
+}
+
+const char* Pagos::nombreTipo(uint8_t tipo) {
+    switch (tipo) {
+        case MOVIMIENTO_PAGO: return "Pago";
+        case MOVIMIENTO_NOTA_CREDITO: return "Nota de credito";
+        case MOVIMIENTO_CASTIGO: return "Castigo";
+        default: return "?";
+    }
+}
+
+// El registro se escribe antes que la cabecera: si algo falla entre ambos,
+// la cabecera sigue describiendo un libro válido y el registro se sobrescribe
+bool Pagos::agregarAlLibro(MovimientoPago& movimiento, uint32_t& posicion) {
+    fstream archivo;
+    CabeceraPagos cabecera;
+    if (!abrirLibro(archivo, cabecera)) return false;
+
+    movimiento.idMovimiento = cabecera.siguienteId;
+    posicion = cabecera.cantidad;
+    archivo.seekp(posicionMovimiento(posicion));
+    archivo.write(reinterpret_cast<const char*>(&movimiento), sizeof(movimiento));
+    if (!archivo.flush()) return false;
+
+    cabecera.cantidad++;
+    cabecera.siguienteId++;
+    archivo.seekp(0);
+    archivo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+    return static_cast<bool>(archivo.flush());
+}
+
+// Descuenta un movimiento ya escrito del saldo de su factura y de su cliente
+void Pagos::aplicar(const MovimientoPago& movimiento, uint32_t posicion) {
+    auto it = porFactura.find(movimiento.idFactura);
+    if (it == porFactura.end()) return;   // Factura eliminada: el movimiento queda solo en el libro
+    it->second.saldo -= movimiento.importe;
+    switch (movimiento.tipo) {
+        case MOVIMIENTO_PAGO: it->second.pagos += movimiento.importe; break;
+        case MOVIMIENTO_NOTA_CREDITO: it->second.notasCredito += movimiento.importe; break;
+        case MOVIMIENTO_CASTIGO: it->second.castigos += movimiento.importe; break;
+    }
+    it->second.movimientos.push_back(posicion);
+    porCliente[it->second.idCliente] -= movimiento.importe;
+}
+
+bool Pagos::iniciar(const vector<Factura>& facturas) {
+    lock_guard<mutex> bloqueo(mutexPagos);
+    porFactura.clear();
+    porCliente.clear();
+    facturasPorPedido.clear();
+    cargado = false;
+
+    for (const auto& factura : facturas) {
+        if (factura.eliminada) continue;
+        EstadoFactura& estado = porFactura[factura.idFactura];
+        estado.idCliente = factura.idCliente;
+        estado.idPedido = factura.idPedido;
+        estado.saldo = factura.importe;
+        porCliente[factura.idCliente] += factura.importe;
+        facturasPorPedido[factura.idPedido]++;
+    }
+
+    // Única pasada por el libro, por bloques
+    {
+        fstream archivo;
+        CabeceraPagos cabecera;
+        if (!abrirLibro(archivo, cabecera)) return false;
+        const uint32_t porBloque = 4096;
+        vector<MovimientoPago> bloque;
+        archivo.seekg(posicionMovimiento(0));
+        for (uint32_t leidos = 0; leidos < cabecera.cantidad; ) {
+            bloque.resize(min(porBloque, cabecera.cantidad - leidos));
+            if (!archivo.read(reinterpret_cast<char*>(bloque.data()), bloque.size() * sizeof(MovimientoPago))) {
+                return false;
+            }
+            for (size_t i = 0; i < bloque.size(); ++i) aplicar(bloque[i], leidos + static_cast<uint32_t>(i));
+            leidos += static_cast<uint32_t>(bloque.size());
+        }
+    }
+
+    // Pagadas sin movimientos que lo expliquen (anteriores al libro): pago de apertura
+    for (const auto& factura : facturas) {
+        if (factura.eliminada || !factura.pagada) continue;
+        Dinero saldo = porFactura[factura.idFactura].saldo;
+        if (saldo <= Dinero()) continue;
+
+        MovimientoPago apertura = MovimientoPago();
+        apertura.idFactura = factura.idFactura;
+        apertura.idCliente = factura.idCliente;
+        apertura.tipo = MOVIMIENTO_PAGO;
+        apertura.fecha = factura.fechaEmision;
+        apertura.importe = saldo;
+        strncpy(apertura.referencia, "Saldo de apertura", sizeof(apertura.referencia) - 1);
+        uint32_t posicion = 0;
+        if (!agregarAlLibro(apertura, posicion)) return false;
+        aplicar(apertura, posicion);
+    }
+
+    cargado = true;
+    return true;
+}
+
+bool Pagos::iniciado() {
+    lock_guard<mutex> bloqueo(mutexPagos);
+    return cargado;
+}
+
+void Pagos::agregarFactura(const Factura& factura) {
+    lock_guard<mutex> bloqueo(mutexPagos);
+    if (!cargado || factura.eliminada || porFactura.count(factura.idFactura)) return;
+    EstadoFactura& estado = porFactura[factura.idFactura];
+    estado.idCliente = factura.idCliente;
+    estado.idPedido = factura.idPedido;
+    estado.saldo = factura.importe;
+    porCliente[factura.idCliente] += factura.importe;
+    facturasPorPedido[factura.idPedido]++;
+}
+
+void Pagos::quitarFactura(int idFactura) {
+    lock_guard<mutex> bloqueo(mutexPagos);
+    auto it = porFactura.find(idFactura);
+    if (it == porFactura.end()) return;
+    porCliente[it->second.idCliente] -= it->second.saldo;
+    auto pedido = facturasPorPedido.find(it->second.idPedido);
+    if (pedido != facturasPorPedido.end() && --pedido->second <= 0) facturasPorPedido.erase(pedido);
+    porFactura.erase(it);
+}
+
+bool Pagos::registrar(MovimientoPago& movimiento, Dinero& saldo) {
+    lock_guard<mutex> bloqueo(mutexPagos);
+    auto it = porFactura.find(movimiento.idFactura);
+    if (!cargado || it == porFactura.end() || movimiento.importe <= Dinero() ||
+        movimiento.importe > it->second.saldo) {
+        return false;
+    }
+
+    movimiento.idCliente = it->second.idCliente;
+    movimiento.fecha = static_cast<int64_t>(time(nullptr));
+    uint32_t posicion = 0;
+    if (!agregarAlLibro(movimiento, posicion)) return false;
+    aplicar(movimiento, posicion);
+    saldo = it->second.saldo;
+    return true;
+}
+
+bool Pagos::existeFactura(int idFactura) {
+    lock_guard<mutex> bloqueo(mutexPagos);
+    return porFactura.count(idFactura) > 0;
+}
+
+Dinero Pagos::saldoFactura(int idFactura) {
+    lock_guard<mutex> bloqueo(mutexPagos);
+    auto it = porFactura.find(idFactura);
+    return it != porFactura.end() ? it->second.saldo : Dinero();
+}
+
+Dinero Pagos::saldoCliente(int idCliente) {
+    lock_guard<mutex> bloqueo(mutexPagos);
+    auto it = porCliente.find(idCliente);
+    return it != porCliente.end() ? it->second : Dinero();
+}
+
+bool Pagos::pedidoFacturado(int idPedido) {
+    lock_guard<mutex> bloqueo(mutexPagos);
+    return facturasPorPedido.count(idPedido) > 0;
+}
+
+Pagos::ResumenFactura Pagos::resumenFactura(int idFactura) {
+    lock_guard<mutex> bloqueo(mutexPagos);
+    ResumenFactura resumen;
+    auto it = porFactura.find(idFactura);
+    if (it == porFactura.end()) return resumen;
+    resumen.saldo = it->second.saldo;
+    resumen.pagos = it->second.pagos;
+    resumen.notasCredito = it->second.notasCredito;
+    resumen.castigos = it->second.castigos;
+    return resumen;
+}
+
+// Solo se leen los registros de la factura, por su posición en el libro
+vector<MovimientoPago> Pagos::movimientosDe(int idFactura) {
+    lock_guard<mutex> bloqueo(mutexPagos);
+    vector<MovimientoPago> movimientos;
+    auto it = porFactura.find(idFactura);
+    if (it == porFactura.end() || it->second.movimientos.empty()) return movimientos;
+
+    fstream archivo;
+    CabeceraPagos cabecera;
+    if (!abrirLibro(archivo, cabecera)) return movimientos;
+    for (uint32_t posicion : it->second.movimientos) {
+        MovimientoPago movimiento;
+        archivo.seekg(posicionMovimiento(posicion));
+        if (archivo.read(reinterpret_cast<char*>(&movimiento), sizeof(movimiento))) movimientos.push_back(movimiento);
+    }
+    return movimientos;
+}
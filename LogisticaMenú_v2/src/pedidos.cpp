@@ -12,14 +12,30 @@
 #include <algorithm>         // Para funciones como find_if, any_of
 #include <limits>            // Para lmites de tipos numricos
 #include <ctime>             // Para manejo de fechas/horas
+#include <unordered_set>     // Para pedidos ya escritos
 #include "envios.h"          // Para manejo de envos
 #include "transportistas.h"  // Para manejo de transportistas
+#include "abastecimiento.h"  // Para elegir el almacn de origen
+#include "Inventario.h"      // Para existencias por almacn
+#include "listaespera.h"     // Para lneas en espera de mercanca
+#include "archivador.h"      // Para pedidos ya archivados
+#include "tarifas.h"         // Para descuentos por cliente, categora y volumen
+#include "credito.h"         // Para el lmite de crdito del cliente
 
 using namespace std;
 
 // Definicin del vector esttico que almacena todos los pedidos
 std::vector<Pedidos> Pedidos::listaPedidos;
 
+// Acumulados por cliente de los pedidos en listaPedidos
+std::unordered_map<std::string, Pedidos::AgregadosCliente> Pedidos::agregadosClientes;
+
+// ltima instantnea publicada (se accede solo con atomic_load/atomic_store)
+std::shared_ptr<const InstantaneaPedidos> Pedidos::instantanea;
+
+// Fin del ltimo registro vlido de pedidos.bin (-1 si no se conoce)
+std::streamoff Pedidos::finArchivoBin = -1;
+
 // Rango de IDs disponibles para nuevos pedidos
 const int CODIGO_INICIAL = 3400;
 const int CODIGO_FINAL = 3500;
@@ -46,7 +62,8 @@ string Pedidos::generarIdUnico(const vector<Pedidos>& lista) {
 // Devuelve true si el ID est disponible, false si ya existe
 bool Pedidos::idDisponible(const vector<Pedidos>& lista, const string& id) {
     return none_of(lista.begin(), lista.end(),
-        [&id](const Pedidos& p) { return p.id == id; });
+        [&id](const Pedidos& p) { return p.id == id; }) &&
+        !Archivador::contienePedido(id);  // Un ID archivado no se reutiliza
 }
 
 // Funcin para validar si un cliente existe
@@ -73,6 +90,328 @@ bool Pedidos::validarAlmacen(const string& idAlmacen, const vector<Almacen>& alm
         [&idAlmacen](const Almacen& a) { return a.getId() == idAlmacen; });
 }
 
+// Funcin para agregar una lnea al pedido
+// Actualiza los totales materializados sin recorrer las dems lneas
+void Pedidos::agregarDetalle(const DetallePedido& detalle) {
+    detalles.push_back(detalle);
+    totales.neto += detalle.cantidad * detalle.precioUnitario;
+    totales.lineas++;
+    totales.unidades += detalle.cantidad;
+}
+
+// Funcin para quitar todas las lneas del pedido y reiniciar sus totales
+void Pedidos::limpiarDetalles() {
+    detalles.clear();
+    totales = TotalesPedido();
+}
+
+// Funcin para recalcular los totales desde las lneas (solo al cargar de archivo)
+void Pedidos::recalcularTotales() {
+    totales = TotalesPedido();
+    for (const auto& detalle : detalles) {
+        totales.neto += detalle.cantidad * detalle.precioUnitario;
+        totales.lineas++;
+        totales.unidades += detalle.cantidad;
+    }
+}
+
+// Funcin para saber si un estado cuenta como monto abierto del cliente
+bool Pedidos::esEstadoAbierto(const string& estado) {
+    return estado == "pendiente" || estado == "procesado";
+}
+
+// Funcin para sumar (signo = 1) o restar (signo = -1) el aporte de un pedido
+// a los acumulados de su cliente
+void Pedidos::aplicarAgregados(const Pedidos& pedido, int signo) {
+    aplicarAgregados(agregadosClientes, pedido, signo);
+}
+
+// Variante que acumula sobre un mapa cualquiera (usada al armar instantneas)
+void Pedidos::aplicarAgregados(unordered_map<string, AgregadosCliente>& destino,
+                               const Pedidos& pedido, int signo) {
+    AgregadosCliente& agregados = destino[pedido.idCliente];
+    agregados.cantidadPedidos += signo;
+    if (pedido.estado != "cancelado") {
+        agregados.valorHistorico += signo * pedido.totales.neto;
+    }
+    if (esEstadoAbierto(pedido.estado)) {
+        agregados.montoAbierto += signo * pedido.totales.neto;
+    }
+}
+
+// Funcin para cambiar el estado de un pedido de listaPedidos
+// Mantiene los acumulados del cliente al da
+void Pedidos::cambiarEstado(Pedidos& pedido, const string& nuevoEstado) {
+    aplicarAgregados(pedido, -1);
+    pedido.estado = nuevoEstado;
+    aplicarAgregados(pedido, 1);
+}
+
+// Funcin para reconstruir los acumulados por cliente desde una lista completa
+// Parte de los acumulados de los pedidos ya archivados
+void Pedidos::reconstruirAgregados(const vector<Pedidos>& lista) {
+    agregadosClientes = Archivador::agregadosArchivados();
+    for (const auto& pedido : lista) {
+        aplicarAgregados(pedido, 1);
+    }
+}
+
+// Funcin para consultar los acumulados de un cliente
+// Devuelve valores en cero si el cliente no tiene pedidos
+Pedidos::AgregadosCliente Pedidos::obtenerAgregadosCliente(const string& idCliente) {
+    auto it = agregadosClientes.find(idCliente);
+    return it != agregadosClientes.end() ? it->second : AgregadosCliente();
+}
+
+// Funcin para repartir un pedido entre los almacenes que lo surten
+// Devuelve una parte por almacn (la primera conserva el ID del pedido)
+// o false si no hay IDs o existencias suficientes
+bool Pedidos::dividirPorAlmacen(const Pedidos& pedido, vector<Pedidos>& partes) {
+    vector<Abastecimiento::LineaSolicitada> lineas;
+    unordered_map<string, vector<size_t>> lineasPorProducto;  // cdigo -> posiciones en detalles
+    vector<int> porAsignar;
+    for (size_t i = 0; i < pedido.detalles.size(); ++i) {
+        const auto& detalle = pedido.detalles[i];
+        lineas.push_back({detalle.codigoProducto, detalle.cantidad});
+        lineasPorProducto[detalle.codigoProducto].push_back(i);
+        porAsignar.push_back(max(detalle.cantidad, 0));
+    }
+
+    Abastecimiento::Plan plan = Abastecimiento::planificar(lineas, pedido.idCliente);
+    if (!plan.completo) {
+        cerr << "\n\t\tError: Las existencias por almacn no cubren el pedido.\n";
+        return false;
+    }
+
+    // Reservar un ID por cada parte adicional
+    vector<Pedidos> ocupados = listaPedidos;
+    partes.clear();
+    for (size_t k = 0; k < plan.almacenes.size(); ++k) {
+        Pedidos parte;
+        parte.id = (k == 0) ? pedido.id : generarIdUnico(ocupados);
+        if (parte.id.empty()) {
+            cerr << "\n\t\tError: No hay IDs disponibles para dividir el pedido\n";
+            partes.clear();
+            return false;
+        }
+        parte.idCliente = pedido.idCliente;
+        parte.idAlmacen = plan.almacenes[k];
+        parte.fechaPedido = pedido.fechaPedido;
+        parte.estado = pedido.estado;
+        ocupados.push_back(parte);
+        partes.push_back(parte);
+    }
+
+    // El plan consolida las lneas por producto: lo asignado se reparte entre
+    // las lneas originales en orden para que cada una conserve su precio
+    for (const auto& asignacion : plan.asignaciones) {
+        size_t k = find(plan.almacenes.begin(), plan.almacenes.end(), asignacion.idAlmacen) - plan.almacenes.begin();
+        int resto = asignacion.cantidad;
+        for (size_t i : lineasPorProducto[asignacion.codigoProducto]) {
+            if (resto == 0) break;
+            int toma = min(resto, porAsignar[i]);
+            if (toma == 0) continue;
+            partes[k].agregarDetalle({asignacion.codigoProducto, toma, pedido.detalles[i].precioUnitario});
+            porAsignar[i] -= toma;
+            resto -= toma;
+        }
+    }
+
+    Abastecimiento::confirmar(plan);
+    return true;
+}
+
+// Funcin para ubicar un pedido de listaPedidos por ID
+// Usa el ndice de la instantnea vigente y verifica la posicin antes de confiar en ella
+Pedidos* Pedidos::buscarEnLista(const string& idPedido) {
+    shared_ptr<const InstantaneaPedidos> vista = obtenerInstantanea();
+    auto pos = vista->indicePorId.find(idPedido);
+    if (pos != vista->indicePorId.end() && pos->second < listaPedidos.size() &&
+        listaPedidos[pos->second].id == idPedido) {
+        return &listaPedidos[pos->second];
+    }
+    auto it = find_if(listaPedidos.begin(), listaPedidos.end(),
+        [&idPedido](const Pedidos& p) { return p.id == idPedido; });
+    return it != listaPedidos.end() ? &(*it) : nullptr;
+}
+
+// Funcin para cambiar el estado de un pedido desde otros mdulos (p. ej. envos)
+// Ubica el pedido por ndice, ajusta los acumulados y guarda una sola vez
+bool Pedidos::actualizarEstado(const string& idPedido, const string& nuevoEstado) {
+    if (listaPedidos.empty()) {
+        cargarDesdeArchivoBin(listaPedidos);
+        reconstruirAgregados(listaPedidos);
+    }
+    Pedidos* pedido = buscarEnLista(idPedido);
+    if (pedido == nullptr) return false;
+    cambiarEstado(*pedido, nuevoEstado);
+    return confirmarCambios();
+}
+
+// Funcin para cambiar el estado de varios pedidos con un solo guardado
+bool Pedidos::actualizarEstados(const vector<string>& idsPedido, const string& nuevoEstado) {
+    if (idsPedido.empty()) return true;
+    if (listaPedidos.empty()) {
+        cargarDesdeArchivoBin(listaPedidos);
+        reconstruirAgregados(listaPedidos);
+    }
+    for (const auto& id : idsPedido) {
+        Pedidos* pedido = buscarEnLista(id);
+        if (pedido != nullptr) cambiarEstado(*pedido, nuevoEstado);
+    }
+    return confirmarCambios();
+}
+
+// Funcin para saber si un pedido puede recibir mercanca en espera
+bool Pedidos::admiteReposicion(const string& idPedido) {
+    if (listaPedidos.empty()) {
+        cargarDesdeArchivoBin(listaPedidos);
+        reconstruirAgregados(listaPedidos);
+    }
+    // Un pedido retenido por crdito conserva sus lneas en espera hasta que se libere
+    const Pedidos* pedido = buscarEnLista(idPedido);
+    return pedido != nullptr && (esEstadoAbierto(pedido->estado) || pedido->estado == "retenido");
+}
+
+// Funcin para incorporar a los pedidos la mercanca asignada desde la lista de espera
+// Si el pedido ya tiene otro almacn de origen, lo recibido forma un pedido aparte
+// del mismo cliente; el pedido original pasa a "procesado" cuando no le queda nada en espera
+void Pedidos::aplicarReposicion(const vector<ListaEspera::Asignacion>& asignaciones) {
+    if (asignaciones.empty()) return;
+    if (listaPedidos.empty()) {
+        cargarDesdeArchivoBin(listaPedidos);
+        reconstruirAgregados(listaPedidos);
+    }
+
+    unordered_map<string, size_t> partesNuevas;  // "pedido|almacn" -> posicin en listaPedidos
+    vector<string> tocados;
+
+    for (const auto& asignacion : asignaciones) {
+        Pedidos* original = buscarEnLista(asignacion.idPedido);
+        if (original == nullptr) continue;
+        DetallePedido detalle{asignacion.codigoProducto, asignacion.cantidad, asignacion.precioUnitario};
+
+        if (original->idAlmacen.empty() || original->idAlmacen == asignacion.idAlmacen) {
+            aplicarAgregados(*original, -1);
+            original->idAlmacen = asignacion.idAlmacen;
+            original->agregarDetalle(detalle);
+            aplicarAgregados(*original, 1);
+        } else {
+            string clave = asignacion.idPedido + "|" + asignacion.idAlmacen;
+            auto parte = partesNuevas.find(clave);
+            if (parte == partesNuevas.end()) {
+                Pedidos nuevaParte;
+                nuevaParte.id = generarIdUnico(listaPedidos);
+                if (nuevaParte.id.empty()) {
+                    cerr << "\n\t\tError: No hay IDs disponibles para la reposicin del pedido "
+                         << asignacion.idPedido << "\n";
+                    continue;
+                }
+                nuevaParte.idCliente = original->idCliente;
+                nuevaParte.idAlmacen = asignacion.idAlmacen;
+                // Un pedido retenido por crdito sigue retenido tambin en lo que se repone
+                nuevaParte.estado = original->estado == "retenido" ? "retenido" : "procesado";
+                listaPedidos.push_back(nuevaParte);
+                aplicarAgregados(nuevaParte, 1);
+                parte = partesNuevas.emplace(clave, listaPedidos.size() - 1).first;
+                auditoria.registrar(usuarioRegistrado.getNombre(), "PEDIDOS",
+                                    "Pedido creado por reposicion - ID: " + nuevaParte.id +
+                                    " - Origen: " + asignacion.idPedido);
+            }
+            Pedidos& destino = listaPedidos[parte->second];
+            aplicarAgregados(destino, -1);
+            destino.agregarDetalle(detalle);
+            aplicarAgregados(destino, 1);
+        }
+        tocados.push_back(asignacion.idPedido);
+    }
+
+    for (const auto& id : tocados) {
+        Pedidos* pedido = buscarEnLista(id);
+        if (pedido != nullptr && pedido->estado == "pendiente" &&
+            !pedido->detalles.empty() && ListaEspera::lineasPendientes(id) == 0) {
+            cambiarEstado(*pedido, "procesado");
+        }
+    }
+    // Solo se escriben los pedidos que recibieron mercanca y las partes nuevas
+    for (const auto& parte : partesNuevas) tocados.push_back(listaPedidos[parte.second].id);
+    confirmarCambios(tocados);
+}
+
+// Funcin para armar una instantnea con su ndice por ID y sus acumulados
+shared_ptr<const InstantaneaPedidos> Pedidos::construirInstantanea(vector<Pedidos> lista) {
+    auto nueva = make_shared<InstantaneaPedidos>();
+    nueva->pedidos = move(lista);
+    nueva->agregados = Archivador::agregadosArchivados();
+    nueva->indicePorId.reserve(nueva->pedidos.size());
+    for (size_t i = 0; i < nueva->pedidos.size(); ++i) {
+        nueva->indicePorId[nueva->pedidos[i].id] = i;
+        aplicarAgregados(nueva->agregados, nueva->pedidos[i], 1);
+    }
+    return nueva;
+}
+
+// Funcin para consultar un pedido por ID, activo o archivado
+bool Pedidos::consultarPedido(const string& idPedido, Pedidos& pedido) {
+    shared_ptr<const InstantaneaPedidos> vista = obtenerInstantanea();
+    const Pedidos* activo = vista->buscar(idPedido);
+    if (activo != nullptr) {
+        pedido = *activo;
+        return true;
+    }
+    return Archivador::buscarPedido(idPedido, pedido);
+}
+
+// Funcin para publicar una nueva instantnea a partir de una lista de pedidos
+// Los lectores que ya tienen la anterior la siguen usando hasta soltarla
+void Pedidos::publicarInstantanea(const vector<Pedidos>& lista) {
+    atomic_store(&instantanea, construirInstantanea(lista));
+}
+
+// Funcin para obtener la instantnea vigente
+// Solo la primera vez (sin publicacin previa) se lee pedidos.bin
+shared_ptr<const InstantaneaPedidos> Pedidos::obtenerInstantanea() {
+    shared_ptr<const InstantaneaPedidos> actual = atomic_load(&instantanea);
+    if (actual) return actual;
+
+    vector<Pedidos> lista;
+    cargarDesdeArchivoBin(lista);
+    shared_ptr<const InstantaneaPedidos> candidata = construirInstantanea(move(lista));
+
+    // Si otro hilo public mientras se lea el archivo, se usa la suya
+    atomic_compare_exchange_strong(&instantanea, &actual, candidata);
+    return atomic_load(&instantanea);
+}
+
+// Funcin para guardar listaPedidos y publicarla a los lectores
+// Devuelve false si no se pudo guardar (la instantnea anterior sigue vigente)
+bool Pedidos::confirmarCambios() {
+    if (!guardarEnArchivoBin(listaPedidos)) return false;
+    publicarInstantanea(listaPedidos);
+    return true;
+}
+
+// Funcin para guardar solo algunos pedidos de listaPedidos y publicar la lista
+// Si no se pueden agregar al final de pedidos.bin se guarda el archivo completo
+bool Pedidos::confirmarCambios(const vector<string>& idsPedido) {
+    vector<const Pedidos*> cambiados;
+    unordered_set<string> vistos;
+    for (const auto& id : idsPedido) {
+        const Pedidos* pedido = buscarEnLista(id);
+        if (pedido != nullptr && vistos.insert(id).second) cambiados.push_back(pedido);
+    }
+    if (cambiados.empty()) return true;
+    if (!anexarEnArchivoBin(cambiados)) return confirmarCambios();
+    publicarInstantanea(listaPedidos);
+    return true;
+}
+
+// Funcin para buscar un pedido por ID dentro de la instantnea
+const Pedidos* InstantaneaPedidos::buscar(const string& id) const {
+    auto it = indicePorId.find(id);
+    return it == indicePorId.end() ? nullptr : &pedidos[it->second];
+}
+
 // Funcin para obtener detalles bsicos de un pedido
 // Devuelve un string con informacin resumida del pedido
 string Pedidos::getDetalles() const {
@@ -89,6 +428,11 @@ void Pedidos::gestionPedidos(const vector<Clientes>& clientes,
                            const vector<Almacen>& almacenes) {
     // Carga los pedidos desde archivo al iniciar
     cargarDesdeArchivoBin(listaPedidos);
+    reconstruirAgregados(listaPedidos);
+    publicarInstantanea(listaPedidos);
+
+    // ndice de existencias por almacn para el abastecimiento automtico
+    Abastecimiento::construirIndice(Inventario::cargarInventarioDesdeArchivo(), almacenes);
 
     int opcion;
     do {
@@ -102,15 +446,16 @@ void Pedidos::gestionPedidos(const vector<Clientes>& clientes,
         cout << "\t\t 3. Modificar pedido existente" << endl;
         cout << "\t\t 4. Cancelar pedido" << endl;
         cout << "\t\t 5. Completar pedido (envo)" << endl;
-        cout << "\t\t 6. Volver al men principal" << endl;
+        cout << "\t\t 6. Liberar pedido retenido por crdito" << endl;
+        cout << "\t\t 7. Volver al men principal" << endl;
         cout << "\t\t========================================" << endl;
         cout << "\t\tOpcion a escoger: ";
 
         // Validacin de entrada
-        while (!(cin >> opcion) || opcion < 1 || opcion > 6) {
+        while (!(cin >> opcion) || opcion < 1 || opcion > 7) {
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
-            cout << "\t\tEntrada invlida. Ingrese un nmero del 1 al 6: ";
+            cout << "\t\tEntrada invlida. Ingrese un nmero del 1 al 7: ";
         }
 
         // Switch para manejar las opciones del men
@@ -131,13 +476,16 @@ void Pedidos::gestionPedidos(const vector<Clientes>& clientes,
                 completarPedido(productos);
                 break;
             case 6:
-                guardarEnArchivoBin(listaPedidos);
+                liberarPedido(clientes);
+                break;
+            case 7:
+                confirmarCambios();
                 auditoria.registrar(usuarioRegistrado.getNombre(),
                                   "PEDIDOS",
                                   "Salida de gestin de pedidos");
                 break;
         }
-    } while(opcion != 6);
+    } while(opcion != 7);
 }
 
 // Funcin para crear un nuevo pedido
@@ -194,19 +542,28 @@ void Pedidos::crearPedido(const std::vector<Clientes>& clientes,
         cerr << "\t\tCliente no vlido. Intente nuevamente.\n";
     }
 
-    // Seleccin de almacn
-    cout << "\n\t\t--- ALMACENES DISPONIBLES ---\n";
-    for (const auto& almacen : almacenes) {
-        cout << "\t\tID: " << almacen.getId() << " | Direccin: " << almacen.getDireccion()
-             << " | Estado: " << almacen.getEstado() << endl;
-    }
+    // Seleccin de almacn: automtica si hay existencias por almacn registradas
+    bool abastecimientoAutomatico = Abastecimiento::indiceDisponible();
+    unordered_map<string, int> solicitado;  // Unidades ya pedidas por producto
+    vector<ListaEspera::Entrada> enEspera;  // Faltantes que quedarn en espera
+    int prioridad = -1;                     // Se pregunta la primera vez que se usa la espera
 
-    while (true) {
-        cout << "\n\t\tIngrese ID del almacn: ";
-        cin >> nuevo.idAlmacen;
+    if (abastecimientoAutomatico) {
+        cout << "\n\t\tEl almacn de origen se asignar segn existencias (solo almacenes operativos).\n";
+    } else {
+        cout << "\n\t\t--- ALMACENES DISPONIBLES ---\n";
+        for (const auto& almacen : almacenes) {
+            cout << "\t\tID: " << almacen.getId() << " | Direccin: " << almacen.getDireccion()
+                 << " | Estado: " << almacen.getEstado() << endl;
+        }
+
+        while (true) {
+            cout << "\n\t\tIngrese ID del almacn: ";
+            cin >> nuevo.idAlmacen;
 
-        if (validarAlmacen(nuevo.idAlmacen, almacenes)) break;
-        cerr << "\t\tAlmacn no vlido. Intente nuevamente.\n";
+            if (validarAlmacen(nuevo.idAlmacen, almacenes)) break;
+            cerr << "\t\tAlmacn no vlido. Intente nuevamente.\n";
+        }
     }
 
     // Agregar productos al pedido
@@ -240,15 +597,24 @@ void Pedidos::crearPedido(const std::vector<Clientes>& clientes,
             cerr << "\t\tProducto no vlido. Intente nuevamente.\n";
         }
 
+        // Stock disponible: existencias en almacenes operativos o stock global
+        int disponible = abastecimientoAutomatico
+            ? Abastecimiento::disponibleTotal(detalle.codigoProducto) - solicitado[detalle.codigoProducto]
+            : productoSeleccionado->getStock();
+
         // Manejo de cantidad del producto
         bool productoAgregado = false;
         while (!productoAgregado) {
             cout << "\t\tIngrese cantidad (Stock disponible: "
-                 << productoSeleccionado->getStock() << "): ";
+                 << disponible << "): ";
 
             if (cin >> detalle.cantidad && detalle.cantidad > 0) {
-                if (detalle.cantidad <= productoSeleccionado->getStock()) {
-                    nuevo.detalles.push_back(detalle);
+                // Precio de lista con los descuentos del cliente, la categora y el volumen
+                detalle.precioUnitario = Tarifas::precioUnitario(nuevo.idCliente, detalle.codigoProducto,
+                                                                 detalle.cantidad, productoSeleccionado->getPrecio());
+                if (detalle.cantidad <= disponible) {
+                    nuevo.agregarDetalle(detalle);
+                    solicitado[detalle.codigoProducto] += detalle.cantidad;
                     productoAgregado = true;
 
                     // Actualizar stock
@@ -259,17 +625,18 @@ void Pedidos::crearPedido(const std::vector<Clientes>& clientes,
                 } else {
                     // Manejo de stock insuficiente
                     cout << "\t\tNo hay suficiente stock. Stock disponible: "
-                         << productoSeleccionado->getStock() << "\n";
+                         << disponible << "\n";
                     cout << "\t\t1. Ingresar otra cantidad\n";
                     cout << "\t\t2. Elegir otro producto\n";
                     cout << "\t\t3. Cancelar agregar producto\n";
+                    cout << "\t\t4. Surtir lo disponible y dejar el resto en espera\n";
                     cout << "\t\tOpcin: ";
 
                     int opcion;
-                    while (!(cin >> opcion) || opcion < 1 || opcion > 3) {
+                    while (!(cin >> opcion) || opcion < 1 || opcion > 4) {
                         cin.clear();
                         cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                        cout << "\t\tOpcin invlida. Ingrese 1, 2 o 3: ";
+                        cout << "\t\tOpcin invlida. Ingrese 1, 2, 3 o 4: ";
                     }
 
                     if (opcion == 2) break;
@@ -277,6 +644,39 @@ void Pedidos::crearPedido(const std::vector<Clientes>& clientes,
                         productoAgregado = true;
                         continuar = 'n';
                     }
+                    if (opcion == 4) {
+                        if (prioridad < 0) {
+                            cout << "\t\tPrioridad del pedido en espera (0 normal - 9 urgente): ";
+                            while (!(cin >> prioridad) || prioridad < 0 || prioridad > 9) {
+                                cin.clear();
+                                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                                cout << "\t\tPrioridad invlida. Ingrese un valor de 0 a 9: ";
+                            }
+                        }
+
+                        // La parte con existencias entra al pedido como una lnea normal
+                        int faltante = detalle.cantidad - max(disponible, 0);
+                        if (disponible > 0) {
+                            DetallePedido surtido = detalle;
+                            surtido.cantidad = disponible;
+                            nuevo.agregarDetalle(surtido);
+                            solicitado[detalle.codigoProducto] += disponible;
+                            const_cast<Producto*>(productoSeleccionado)->setStock(
+                                productoSeleccionado->getStock() - disponible);
+                        }
+
+                        ListaEspera::Entrada entrada;
+                        entrada.idCliente = nuevo.idCliente;
+                        entrada.codigoProducto = detalle.codigoProducto;
+                        entrada.cantidad = faltante;
+                        entrada.precioUnitario = detalle.precioUnitario;
+                        entrada.prioridad = prioridad;
+                        entrada.fecha = nuevo.fechaPedido;
+                        enEspera.push_back(entrada);
+
+                        productoAgregado = true;
+                        cout << "\t\t" << faltante << " unidades quedan en espera de mercanca.\n";
+                    }
                 }
             } else {
                 cin.clear();
@@ -286,7 +686,7 @@ void Pedidos::crearPedido(const std::vector<Clientes>& clientes,
         }
 
         // Preguntar si desea agregar ms productos
-        if (productoAgregado && !nuevo.detalles.empty()) {
+        if (productoAgregado && (!nuevo.detalles.empty() || !enEspera.empty())) {
             cout << "\n\t\tDesea agregar otro producto? (s/n): ";
             cin >> continuar;
         } else if (!productoAgregado) {
@@ -294,16 +694,100 @@ void Pedidos::crearPedido(const std::vector<Clientes>& clientes,
         }
     } while (continuar == 's' || continuar == 'S');
 
-    // Guardar el pedido si tiene productos
-    if (!nuevo.detalles.empty()) {
+    // Guardar el pedido si tiene productos (surtidos o en espera)
+    if (!nuevo.detalles.empty() || !enEspera.empty()) {
+        // Lmite de crdito: exposicin del cliente (O(1)) ms lo surtido y lo que queda en espera
+        Dinero montoPedido = nuevo.totales.neto;
+        for (const auto& entrada : enEspera) montoPedido += entrada.cantidad * entrada.precioUnitario;
+        auto cliente = find_if(clientes.begin(), clientes.end(),
+            [&nuevo](const Clientes& c) { return c.getId() == nuevo.idCliente; });
+        Credito::Evaluacion credito = Credito::evaluar(*cliente, montoPedido);
+        bool retenido = false;
+        if (!credito.aprobado) {
+            cout << "\n\t\tATENCIN! El pedido supera el lmite de crdito del cliente.\n";
+            Credito::mostrar(credito);
+            cout << "\t\t1. Retener el pedido (queda \"retenido\" hasta liberarlo)\n";
+            cout << "\t\t2. Rechazar el pedido\n";
+            cout << "\t\tOpcin: ";
+            int opcion;
+            while (!(cin >> opcion) || opcion < 1 || opcion > 2) {
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                cout << "\t\tOpcin invlida. Ingrese 1 o 2: ";
+            }
+            if (opcion == 2) {
+                // Devolver el stock descontado al agregar las lneas
+                for (const auto& detalle : nuevo.detalles) {
+                    auto it = find_if(productos.begin(), productos.end(),
+                        [&detalle](const Producto& p) { return p.getCodigo() == detalle.codigoProducto; });
+                    const_cast<Producto&>(*it).setStock(it->getStock() + detalle.cantidad);
+                }
+                auditoria.registrar(usuarioRegistrado.getNombre(), "PEDIDOS",
+                                    "Pedido rechazado por limite de credito - Cliente: " + nuevo.idCliente +
+                                    " - Monto: " + montoPedido.texto());
+                cout << "\n\t\tPedido rechazado." << endl;
+                system("pause");
+                return;
+            }
+            retenido = true;
+        }
+
+        // Con lneas en espera el pedido queda pendiente hasta recibir la mercanca
+        nuevo.estado = retenido ? "retenido" : (enEspera.empty() ? "procesado" : "pendiente");
+
+        vector<Pedidos> partes;
+        if (nuevo.detalles.empty()) {
+            // Solo lneas en espera: el almacn se define al recibir la mercanca
+            partes.push_back(nuevo);
+        } else if (abastecimientoAutomatico) {
+            if (!dividirPorAlmacen(nuevo, partes)) {
+                // Devolver el stock descontado al agregar las lneas
+                for (const auto& detalle : nuevo.detalles) {
+                    auto it = find_if(productos.begin(), productos.end(),
+                        [&detalle](const Producto& p) { return p.getCodigo() == detalle.codigoProducto; });
+                    const_cast<Producto&>(*it).setStock(it->getStock() + detalle.cantidad);
+                }
+                system("pause");
+                return;
+            }
+        } else {
+            partes.push_back(nuevo);
+        }
+
         Producto::guardarEnArchivoBin(productos);
 
-        nuevo.estado = "procesado";
-        listaPedidos.push_back(nuevo);
-        guardarEnArchivoBin(listaPedidos);
+        for (const auto& parte : partes) {
+            listaPedidos.push_back(parte);
+            aplicarAgregados(parte, 1);
+            auditoria.registrar(usuarioRegistrado.getNombre(), "PEDIDOS",
+                                "Pedido creado - ID: " + parte.id + " - Almacen: " + parte.idAlmacen);
+        }
+        confirmarCambios();
+
+        // Las lneas en espera quedan asociadas al ID original del pedido
+        for (auto& entrada : enEspera) {
+            entrada.idPedido = nuevo.id;
+            auditoria.registrar(usuarioRegistrado.getNombre(), "PEDIDOS",
+                                "Linea en espera - Pedido: " + nuevo.id + " - Producto: " +
+                                entrada.codigoProducto + " x" + to_string(entrada.cantidad));
+            ListaEspera::agregar(entrada);
+        }
 
-        auditoria.registrar(usuarioRegistrado.getNombre(), "PEDIDOS", "Pedido creado - ID: " + nuevo.id);
-        cout << "\n\t\tPedido registrado exitosamente!" << endl;
+        if (partes.size() > 1) {
+            cout << "\n\t\tEl pedido se dividi en " << partes.size() << " pedidos por almacn:" << endl;
+        }
+        for (const auto& parte : partes) {
+            cout << "\t\tPedido " << parte.id << " -> Almacn " << parte.idAlmacen
+                 << " (" << parte.totales.lineas << " lneas)" << endl;
+        }
+        if (retenido) {
+            auditoria.registrar(usuarioRegistrado.getNombre(), "PEDIDOS",
+                                "Pedido retenido por limite de credito - ID: " + nuevo.id +
+                                " - Monto: " + montoPedido.texto());
+            cout << "\n\t\tPedido registrado como RETENIDO hasta que se libere el crdito." << endl;
+        } else {
+            cout << "\n\t\tPedido registrado exitosamente!" << endl;
+        }
     } else {
         cout << "\n\t\tNo se cre el pedido porque no contiene productos." << endl;
     }
@@ -312,12 +796,14 @@ void Pedidos::crearPedido(const std::vector<Clientes>& clientes,
 
 // Funcin para consultar todos los pedidos
 // Muestra una lista detallada de todos los pedidos registrados
+// Lee de la instantnea vigente: no recarga el archivo ni bloquea a los escritores
 void Pedidos::consultarPedidos() {
     system("cls");
-    Pedidos::cargarDesdeArchivoBin(listaPedidos);
+    shared_ptr<const InstantaneaPedidos> vista = obtenerInstantanea();
+    const vector<Pedidos>& pedidos = vista->pedidos;
     cout << "\n\t\t[CONSULTANDO PEDIDOS...]" << endl;
 
-    if (listaPedidos.empty()) {
+    if (pedidos.empty()) {
         cout << "\n\t\tNo hay pedidos registrados." << endl;
         system("pause");
         return;
@@ -325,7 +811,7 @@ void Pedidos::consultarPedidos() {
 
     // Mostrar detalles de cada pedido
     cout << "\n\t\t=== LISTA DE PEDIDOS ===" << endl;
-    for (const auto& pedido : listaPedidos) {
+    for (const auto& pedido : pedidos) {
         cout << "\t\tID: " << pedido.id << endl;
         cout << "\t\tCliente: " << pedido.idCliente << endl;
         cout << "\t\tAlmacn: " << pedido.idAlmacen << endl;
@@ -338,19 +824,29 @@ void Pedidos::consultarPedidos() {
         cout << "\t\tEstado: " << pedido.estado << endl;
         cout << "\t\tProductos:" << endl;
 
-        // Calcular y mostrar total
-        double total = 0.0;
         for (const auto& detalle : pedido.detalles) {
             cout << "\t\t  - " << detalle.codigoProducto
                  << " x" << detalle.cantidad
                  << " @ $" << detalle.precioUnitario << endl;
-            total += detalle.cantidad * detalle.precioUnitario;
         }
 
-        cout << "\t\tTotal: $" << fixed << setprecision(2) << total << endl;
+        // Total materializado del pedido
+        cout << "\t\tTotal: $" << fixed << setprecision(2) << pedido.totales.neto
+             << " (" << pedido.totales.lineas << " lineas, "
+             << pedido.totales.unidades << " unidades)" << endl;
         cout << "\t\t----------------------------" << endl;
     }
 
+    // Resumen por cliente desde los acumulados
+    cout << "\n\t\t=== RESUMEN POR CLIENTE ===" << endl;
+    for (const auto& par : vista->agregados) {
+        if (par.second.cantidadPedidos == 0) continue;
+        cout << "\t\tCliente: " << par.first
+             << " | Pedidos: " << par.second.cantidadPedidos
+             << " | Abierto: $" << fixed << setprecision(2) << par.second.montoAbierto
+             << " | Historico: $" << par.second.valorHistorico << endl;
+    }
+
     auditoria.registrar(usuarioRegistrado.getNombre(), "PEDIDOS", "Consulta de pedidos");
     system("pause");
 }
@@ -391,6 +887,9 @@ void Pedidos::modificarPedido(const vector<Clientes>& clientes,
     if (it != listaPedidos.end()) {
         cout << "\n\t\t=== MODIFICAR PEDIDO (ID: " << id << ") ===" << endl;
 
+        // Se retira el aporte del pedido y se vuelve a sumar al final
+        aplicarAgregados(*it, -1);
+
         // Modificar estado
         cout << "\t\tNuevo estado (pendiente/procesado/enviado/cancelado): ";
         cin >> it->estado;
@@ -401,7 +900,7 @@ void Pedidos::modificarPedido(const vector<Clientes>& clientes,
         cin >> opcion;
 
         if (opcion == 's' || opcion == 'S') {
-            it->detalles.clear();
+            it->limpiarDetalles();
             char continuar;
             do {
                 DetallePedido detalle;
@@ -430,15 +929,19 @@ void Pedidos::modificarPedido(const vector<Clientes>& clientes,
                     cerr << "\t\tCantidad invlida. Ingrese un nmero positivo: ";
                 }
 
-                it->detalles.push_back(detalle);
+                detalle.precioUnitario = Tarifas::precioUnitario(it->idCliente, detalle.codigoProducto,
+                                                                 detalle.cantidad, detalle.precioUnitario);
+                it->agregarDetalle(detalle);
 
                 cout << "\n\t\tDesea agregar otro producto? (s/n): ";
                 cin >> continuar;
             } while (continuar == 's' || continuar == 'S');
         }
 
+        aplicarAgregados(*it, 1);
+
         // Guardar cambios
-        guardarEnArchivoBin(listaPedidos);
+        confirmarCambios();
         auditoria.registrar(usuarioRegistrado.getNombre(), "PEDIDOS", "Pedido modificado - ID: " + id);
         cout << "\n\t\tPedido modificado exitosamente!" << endl;
     } else {
@@ -491,8 +994,9 @@ void Pedidos::cancelarPedido() {
 
     if (it != listaPedidos.end()) {
         // Cambiar estado a cancelado
-        it->estado = "cancelado";
-        guardarEnArchivoBin(listaPedidos);
+        cambiarEstado(*it, "cancelado");
+        confirmarCambios();
+        ListaEspera::retirarPedido(id);
         auditoria.registrar(usuarioRegistrado.getNombre(), "PEDIDOS", "Pedido cancelado - ID: " + id);
         cout << "\n\t\tPedido cancelado exitosamente!" << endl;
     } else {
@@ -501,13 +1005,89 @@ void Pedidos::cancelarPedido() {
     system("pause");
 }
 
+// Funcin para liberar un pedido retenido por lmite de crdito
+// Vuelve a evaluar el crdito; si sigue excedido solo un administrador puede forzarlo
+void Pedidos::liberarPedido(const vector<Clientes>& clientes) {
+    system("cls");
+    cout << "\n\t\t[LIBERANDO PEDIDO RETENIDO...]" << endl;
+
+    vector<const Pedidos*> retenidos;
+    for (const auto& pedido : listaPedidos) {
+        if (pedido.estado == "retenido") retenidos.push_back(&pedido);
+    }
+    if (retenidos.empty()) {
+        cout << "\n\t\tNo hay pedidos retenidos por crdito." << endl;
+        system("pause");
+        return;
+    }
+
+    cout << "\n\t\t=== PEDIDOS RETENIDOS POR CRDITO ===" << endl;
+    cout << "\t\t" << string(55, '-') << endl;
+    cout << "\t\t" << left << setw(10) << "ID" << setw(15) << "Cliente"
+         << setw(15) << "Almacn" << setw(15) << "Monto" << endl;
+    cout << "\t\t" << string(55, '-') << endl;
+    for (const Pedidos* pedido : retenidos) {
+        cout << "\t\t" << setw(10) << pedido->id
+             << setw(15) << pedido->idCliente
+             << setw(15) << (pedido->idAlmacen.empty() ? "-" : pedido->idAlmacen)
+             << "$" << pedido->totales.neto + ListaEspera::montoPendiente(pedido->id) << endl;
+    }
+    cout << "\t\t" << string(55, '-') << endl;
+
+    string id;
+    cout << "\n\t\tIngrese ID del pedido a liberar (o 0 para volver): ";
+    cin >> id;
+    if (id == "0") return;
+
+    auto it = find_if(listaPedidos.begin(), listaPedidos.end(),
+        [&id](const Pedidos& p) { return p.id == id && p.estado == "retenido"; });
+    if (it == listaPedidos.end()) {
+        cout << "\t\tPedido retenido no encontrado." << endl;
+        system("pause");
+        return;
+    }
+
+    auto cliente = find_if(clientes.begin(), clientes.end(),
+        [&it](const Clientes& c) { return c.getId() == it->idCliente; });
+    if (cliente != clientes.end()) {
+        // El pedido retenido se saca de la exposicin y se evala como nuevo:
+        // lo surtido ms lo que an est en espera, igual que al crearlo
+        Dinero montoPedido = it->totales.neto + ListaEspera::montoPendiente(id);
+        Credito::Evaluacion credito = Credito::evaluar(*cliente, montoPedido, id);
+        if (!credito.aprobado) {
+            cout << "\n\t\tEl pedido sigue superando el lmite de crdito.\n";
+            Credito::mostrar(credito);
+            if (usuarioRegistrado.getNivelAcceso() < 3) {
+                cout << "\t\tSolo un administrador puede liberarlo." << endl;
+                system("pause");
+                return;
+            }
+            char confirmacion;
+            cout << "\t\tLiberar de todos modos? (s/n): ";
+            cin >> confirmacion;
+            if (confirmacion != 's' && confirmacion != 'S') return;
+            auditoria.registrar(usuarioRegistrado.getNombre(), "PEDIDOS",
+                                "Limite de credito excedido autorizado - Pedido: " + id);
+        }
+    }
+
+    // Con lneas an en espera vuelve a pendiente; si no, queda listo para despacho
+    cambiarEstado(*it, ListaEspera::lineasPendientes(id) > 0 ? "pendiente" : "procesado");
+    confirmarCambios();
+    auditoria.registrar(usuarioRegistrado.getNombre(), "PEDIDOS",
+                        "Pedido liberado - ID: " + id + " - Estado: " + it->estado);
+    cout << "\n\t\tPedido " << id << " liberado (" << it->estado << ")." << endl;
+    system("pause");
+}
+
 // Funcin para guardar pedidos en archivo binario
 // Recibe la lista de pedidos a guardar
-void Pedidos::guardarEnArchivoBin(const vector<Pedidos>& lista) {
+// Devuelve true si el archivo qued escrito completo
+bool Pedidos::guardarEnArchivoBin(const vector<Pedidos>& lista) {
     ofstream archivo("pedidos.bin", ios::binary | ios::out);
     if (!archivo.is_open()) {
         cerr << "\n\t\tError crtico: No se pudo abrir archivo de pedidos!\n";
-        return;
+        return false;
     }
 
     try {
@@ -517,51 +1097,127 @@ void Pedidos::guardarEnArchivoBin(const vector<Pedidos>& lista) {
 
         // Escribir cada pedido
         for (const auto& pedido : lista) {
-            // Escribir campos bsicos
-            size_t idSize = pedido.id.size();
-            archivo.write(reinterpret_cast<const char*>(&idSize), sizeof(idSize));
-            archivo.write(pedido.id.c_str(), idSize);
-
-            size_t clienteSize = pedido.idCliente.size();
-            archivo.write(reinterpret_cast<const char*>(&clienteSize), sizeof(clienteSize));
-            archivo.write(pedido.idCliente.c_str(), clienteSize);
-
-            size_t almacenSize = pedido.idAlmacen.size();
-            archivo.write(reinterpret_cast<const char*>(&almacenSize), sizeof(almacenSize));
-            archivo.write(pedido.idAlmacen.c_str(), almacenSize);
-
-            archivo.write(reinterpret_cast<const char*>(&pedido.fechaPedido), sizeof(pedido.fechaPedido));
-
-            size_t estadoSize = pedido.estado.size();
-            archivo.write(reinterpret_cast<const char*>(&estadoSize), sizeof(estadoSize));
-            archivo.write(pedido.estado.c_str(), estadoSize);
-
-            // Escribir detalles del pedido
-            size_t detallesSize = pedido.detalles.size();
-            archivo.write(reinterpret_cast<const char*>(&detallesSize), sizeof(detallesSize));
-
-            for (const auto& detalle : pedido.detalles) {
-                size_t codigoSize = detalle.codigoProducto.size();
-                archivo.write(reinterpret_cast<const char*>(&codigoSize), sizeof(codigoSize));
-                archivo.write(detalle.codigoProducto.c_str(), codigoSize);
-
-                archivo.write(reinterpret_cast<const char*>(&detalle.cantidad), sizeof(detalle.cantidad));
-                archivo.write(reinterpret_cast<const char*>(&detalle.precioUnitario), sizeof(detalle.precioUnitario));
-            }
+            escribirPedido(archivo, pedido);
         }
 
         archivo.flush();
         if (!archivo) {
             throw runtime_error("Error al escribir en archivo");
         }
+        finArchivoBin = archivo.tellp();
     } catch (const exception& e) {
         cerr << "\n\t\tError al guardar pedidos: " << e.what() << "\n";
         archivo.close();
         remove("pedidos.bin");
-        return;
+        finArchivoBin = -1;
+        return false;
     }
 
     archivo.close();
+    return true;
+}
+
+// Funcin para agregar al final de pedidos.bin la versin actual de algunos pedidos
+// Al cargar, el ltimo registro de cada ID reemplaza a los anteriores. El contador
+// se actualiza despus de escribir los registros: si se interrumpe, quedan fuera.
+// Devuelve false si hay que guardar el archivo completo (posicin desconocida,
+// error de escritura o demasiadas versiones viejas acumuladas)
+bool Pedidos::anexarEnArchivoBin(const vector<const Pedidos*>& pedidos) {
+    if (finArchivoBin < 0) return false;
+    fstream archivo("pedidos.bin", ios::binary | ios::in | ios::out);
+    size_t cantidad = 0;
+    if (!archivo || !archivo.read(reinterpret_cast<char*>(&cantidad), sizeof(cantidad))) return false;
+
+    // Las versiones viejas se descartan al reescribir el archivo completo
+    cantidad += pedidos.size();
+    if (cantidad > 2 * listaPedidos.size() + 64) return false;
+
+    archivo.seekp(finArchivoBin);
+    for (const Pedidos* pedido : pedidos) escribirPedido(archivo, *pedido);
+    streamoff fin = archivo.tellp();
+    archivo.flush();
+    archivo.seekp(0);
+    archivo.write(reinterpret_cast<const char*>(&cantidad), sizeof(cantidad));
+    archivo.flush();
+    if (!archivo) {
+        finArchivoBin = -1;
+        return false;
+    }
+    finArchivoBin = fin;
+    return true;
+}
+
+// Funcin para escribir un pedido con el formato de pedidos.bin
+// (campos con su longitud delante y luego las lneas)
+void Pedidos::escribirPedido(ostream& archivo, const Pedidos& pedido) {
+    size_t idSize = pedido.id.size();
+    archivo.write(reinterpret_cast<const char*>(&idSize), sizeof(idSize));
+    archivo.write(pedido.id.c_str(), idSize);
+
+    size_t clienteSize = pedido.idCliente.size();
+    archivo.write(reinterpret_cast<const char*>(&clienteSize), sizeof(clienteSize));
+    archivo.write(pedido.idCliente.c_str(), clienteSize);
+
+    size_t almacenSize = pedido.idAlmacen.size();
+    archivo.write(reinterpret_cast<const char*>(&almacenSize), sizeof(almacenSize));
+    archivo.write(pedido.idAlmacen.c_str(), almacenSize);
+
+    archivo.write(reinterpret_cast<const char*>(&pedido.fechaPedido), sizeof(pedido.fechaPedido));
+
+    size_t estadoSize = pedido.estado.size();
+    archivo.write(reinterpret_cast<const char*>(&estadoSize), sizeof(estadoSize));
+    archivo.write(pedido.estado.c_str(), estadoSize);
+
+    // Escribir detalles del pedido
+    size_t detallesSize = pedido.detalles.size();
+    archivo.write(reinterpret_cast<const char*>(&detallesSize), sizeof(detallesSize));
+
+    for (const auto& detalle : pedido.detalles) {
+        size_t codigoSize = detalle.codigoProducto.size();
+        archivo.write(reinterpret_cast<const char*>(&codigoSize), sizeof(codigoSize));
+        archivo.write(detalle.codigoProducto.c_str(), codigoSize);
+
+        archivo.write(reinterpret_cast<const char*>(&detalle.cantidad), sizeof(detalle.cantidad));
+        double precio = detalle.precioUnitario.aDecimal();
+        archivo.write(reinterpret_cast<const char*>(&precio), sizeof(precio));
+    }
+}
+
+// Funcin para leer un pedido escrito por escribirPedido
+// Devuelve false si los datos se acaban o una longitud no es razonable
+bool Pedidos::leerPedido(istream& archivo, Pedidos& pedido) {
+    const size_t LONGITUD_MAXIMA = 1 << 20;
+    auto leerTexto = [&](string& destino) {
+        size_t tam = 0;
+        if (!archivo.read(reinterpret_cast<char*>(&tam), sizeof(tam)) || tam > LONGITUD_MAXIMA) return false;
+        destino.resize(tam);
+        return tam == 0 || static_cast<bool>(archivo.read(&destino[0], tam));
+    };
+
+    pedido.detalles.clear();
+    if (!leerTexto(pedido.id) || !leerTexto(pedido.idCliente) || !leerTexto(pedido.idAlmacen)) return false;
+    if (!archivo.read(reinterpret_cast<char*>(&pedido.fechaPedido), sizeof(pedido.fechaPedido))) return false;
+    if (!leerTexto(pedido.estado)) return false;
+
+    // Leer detalles del pedido
+    size_t detallesSize = 0;
+    if (!archivo.read(reinterpret_cast<char*>(&detallesSize), sizeof(detallesSize)) ||
+        detallesSize > LONGITUD_MAXIMA) return false;
+
+    for (size_t j = 0; j < detallesSize; ++j) {
+        DetallePedido detalle;
+        if (!leerTexto(detalle.codigoProducto)) return false;
+        archivo.read(reinterpret_cast<char*>(&detalle.cantidad), sizeof(detalle.cantidad));
+        // El precio se guarda como double (formato original) y se lleva al centavo
+        double precio = 0.0;
+        archivo.read(reinterpret_cast<char*>(&precio), sizeof(precio));
+        if (!archivo) return false;
+        detalle.precioUnitario = Dinero::deDecimal(precio);
+        pedido.detalles.push_back(detalle);
+    }
+
+    pedido.recalcularTotales();
+    return true;
 }
 
 // Funcin para cargar pedidos desde archivo binario
@@ -575,57 +1231,27 @@ void Pedidos::cargarDesdeArchivoBin(vector<Pedidos>& lista) {
         return;
     }
 
+    finArchivoBin = -1;
     try {
         // Leer cantidad de pedidos
-        size_t cantidad;
+        size_t cantidad = 0;
         archivo.read(reinterpret_cast<char*>(&cantidad), sizeof(cantidad));
 
-        for (size_t i = 0; i < cantidad; ++i) {
+        // Un ID repetido es una versin ms nueva agregada por anexarEnArchivoBin
+        unordered_map<string, size_t> posicion;
+        size_t leidos = 0;
+        for (; leidos < cantidad; ++leidos) {
             Pedidos pedido;
-
-            // Leer campos bsicos
-            size_t idSize;
-            archivo.read(reinterpret_cast<char*>(&idSize), sizeof(idSize));
-            pedido.id.resize(idSize);
-            archivo.read(&pedido.id[0], idSize);
-
-            size_t clienteSize;
-            archivo.read(reinterpret_cast<char*>(&clienteSize), sizeof(clienteSize));
-            pedido.idCliente.resize(clienteSize);
-            archivo.read(&pedido.idCliente[0], clienteSize);
-
-            size_t almacenSize;
-            archivo.read(reinterpret_cast<char*>(&almacenSize), sizeof(almacenSize));
-            pedido.idAlmacen.resize(almacenSize);
-            archivo.read(&pedido.idAlmacen[0], almacenSize);
-
-            archivo.read(reinterpret_cast<char*>(&pedido.fechaPedido), sizeof(pedido.fechaPedido));
-
-            size_t estadoSize;
-            archivo.read(reinterpret_cast<char*>(&estadoSize), sizeof(estadoSize));
-            pedido.estado.resize(estadoSize);
-            archivo.read(&pedido.estado[0], estadoSize);
-
-            // Leer detalles del pedido
-            size_t detallesSize;
-            archivo.read(reinterpret_cast<char*>(&detallesSize), sizeof(detallesSize));
-
-            for (size_t j = 0; j < detallesSize; ++j) {
-                DetallePedido detalle;
-
-                size_t codigoSize;
-                archivo.read(reinterpret_cast<char*>(&codigoSize), sizeof(codigoSize));
-                detalle.codigoProducto.resize(codigoSize);
-                archivo.read(&detalle.codigoProducto[0], codigoSize);
-
-                archivo.read(reinterpret_cast<char*>(&detalle.cantidad), sizeof(detalle.cantidad));
-                archivo.read(reinterpret_cast<char*>(&detalle.precioUnitario), sizeof(detalle.precioUnitario));
-
-                pedido.detalles.push_back(detalle);
+            if (!leerPedido(archivo, pedido)) break;
+            auto previo = posicion.find(pedido.id);
+            if (previo != posicion.end()) {
+                lista[previo->second] = move(pedido);
+            } else {
+                posicion.emplace(pedido.id, lista.size());
+                lista.push_back(move(pedido));
             }
-
-            lista.push_back(pedido);
         }
+        if (leidos == cantidad && archivo) finArchivoBin = archivo.tellg();
 
         if (archivo.bad()) {
             throw runtime_error("Error de lectura del archivo");
@@ -718,18 +1344,22 @@ void Pedidos::completarPedido(std::vector<Producto>& productos) {
     cout << "\t\tFecha: " << buffer << endl;
     cout << "\t\tEstado actual: " << pedidoSeleccionado.estado << endl;
 
-    // Mostrar productos y calcular total
+    // Mostrar productos y total materializado
     cout << "\n\t\tPRODUCTOS INCLUIDOS:" << endl;
     cout << "\t\t" << string(40, '-') << endl;
-    double total = 0.0;
     for (const auto& detalle : pedidoSeleccionado.detalles) {
         cout << "\t\t- Cdigo: " << detalle.codigoProducto
              << " | Cantidad: " << detalle.cantidad
              << " | Precio unitario: $" << fixed << setprecision(2) << detalle.precioUnitario << endl;
-        total += detalle.cantidad * detalle.precioUnitario;
     }
     cout << "\t\t" << string(40, '-') << endl;
-    cout << "\t\tTOTAL DEL PEDIDO: $" << fixed << setprecision(2) << total << endl;
+    cout << "\t\tTOTAL DEL PEDIDO: $" << fixed << setprecision(2) << pedidoSeleccionado.totales.neto << endl;
+
+    int lineasEnEspera = ListaEspera::lineasPendientes(pedidoSeleccionado.id);
+    if (lineasEnEspera > 0) {
+        cout << "\t\tAVISO: " << lineasEnEspera
+             << " lnea(s) en espera de mercanca se descartarn al completar." << endl;
+    }
 
     // Confirmacin final
     cout << "\n\t\tDesea completar y enviar este pedido? (s/n): ";
@@ -738,15 +1368,16 @@ void Pedidos::completarPedido(std::vector<Producto>& productos) {
 
     if (tolower(confirmacion) == 's') {
         // Actualizar estado
-        pedidoSeleccionado.estado = "completado";
+        cambiarEstado(pedidoSeleccionado, "completado");
 
         // Registrar envo
         cout << "\n\t\tRegistrando envo para el pedido " << pedidoSeleccionado.id << "..." << endl;
         Envios::crearEnvio(pedidoSeleccionado.id, Transportistas::getTransportistasDisponibles());
 
         // Guardar cambios
-        guardarEnArchivoBin(listaPedidos);
+        confirmarCambios();
         Producto::guardarEnArchivoBin(productos);
+        ListaEspera::retirarPedido(pedidoSeleccionado.id);
 
         // Registrar en bitcora
         auditoria.registrar(usuarioRegistrado.getNombre(),
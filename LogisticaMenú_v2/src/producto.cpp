@@ -17,14 +17,14 @@ const int CODIGO_INICIAL = 3209;
 const int CODIGO_FINAL = 3259;
 
 //: Constructor por defecto que inicializa los valores numricos
-Producto::Producto() : precio(0.0), stock(0), stockMinimo(0) {}
+Producto::Producto() : precio(), stock(0), stockMinimo(0) {}
 
 //: Mtodos getter para acceder a los atributos del producto
 string Producto::getId() const { return id; }
 string Producto::getCodigo() const { return codigo; }
 string Producto::getNombre() const { return nombre; }
 string Producto::getDescripcion() const { return descripcion; }
-double Producto::getPrecio() const { return precio; }
+Dinero Producto::getPrecio() const { return precio; }
 int Producto::getStock() const { return stock; }
 int Producto::getStockMinimo() const { return stockMinimo; }
 
@@ -33,7 +33,7 @@ void Producto::setId(const string& id) { this->id = id; }
 void Producto::setCodigo(const string& codigo) { this->codigo = codigo; }
 void Producto::setNombre(const string& nombre) { this->nombre = nombre; }
 void Producto::setDescripcion(const string& descripcion) { this->descripcion = descripcion; }
-void Producto::setPrecio(double precio) { this->precio = precio; }
+void Producto::setPrecio(Dinero precio) { this->precio = precio; }
 void Producto::setStock(int stock) { this->stock = stock; }
 void Producto::setStockMinimo(int stockMinimo) { this->stockMinimo = stockMinimo; }
 
@@ -113,7 +113,7 @@ void Producto::agregar(vector<Producto>& lista, const string& usuarioActual) {
             return;
         }
     }
-    nuevo.setPrecio(precio);
+    nuevo.setPrecio(Dinero::deDecimal(precio));
 
     //: Solicita stock inicial
     cout << "\t\tStock inicial: ";
@@ -209,10 +209,10 @@ void Producto::modificar(vector<Producto>& lista, const string& usuarioActual, c
         string precioStr;
         getline(cin, precioStr);
         if (!precioStr.empty()) {
-            try {
-                double nuevoPrecio = stod(precioStr);
+            Dinero nuevoPrecio;
+            if (Dinero::deTexto(precioStr, nuevoPrecio) && nuevoPrecio >= Dinero()) {
                 it->setPrecio(nuevoPrecio);
-            } catch (...) {
+            } else {
                 cout << "\t\tPrecio no vlido. Se mantiene el actual.\n";
             }
         }
@@ -306,7 +306,8 @@ void Producto::guardarEnArchivoBin(const vector<Producto>& productos) {
             archivo.write(reinterpret_cast<const char*>(&descSize), sizeof(descSize));
             archivo.write(producto.descripcion.c_str(), descSize);
 
-            archivo.write(reinterpret_cast<const char*>(&producto.precio), sizeof(producto.precio));
+            double precio = producto.precio.aDecimal();   // En archivo como double (formato original)
+            archivo.write(reinterpret_cast<const char*>(&precio), sizeof(precio));
             archivo.write(reinterpret_cast<const char*>(&producto.stock), sizeof(producto.stock));
             archivo.write(reinterpret_cast<const char*>(&producto.stockMinimo), sizeof(producto.stockMinimo));
         }
@@ -361,7 +362,9 @@ void Producto::cargarDesdeArchivoBin(vector<Producto>& productos) {
             producto.descripcion.resize(descSize);
             archivo.read(&producto.descripcion[0], descSize);
 
-            archivo.read(reinterpret_cast<char*>(&producto.precio), sizeof(producto.precio));
+            double precio = 0.0;
+            archivo.read(reinterpret_cast<char*>(&precio), sizeof(precio));
+            producto.precio = Dinero::deDecimal(precio);
             archivo.read(reinterpret_cast<char*>(&producto.stock), sizeof(producto.stock));
             archivo.read(reinterpret_cast<char*>(&producto.stockMinimo), sizeof(producto.stockMinimo));
 
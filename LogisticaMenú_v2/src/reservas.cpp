@@ -0,0 +1,425 @@
+#include "reservas.h"
+#include "crc32.h"
+
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+
+using namespace std;
+
+// ----------- Formato de reservas.bin ------------
+
+const char* const ARCHIVO_RESERVAS = "reservas.bin";
+const char FIRMA_RESERVAS[4] = {'R', 'E', 'S', 'V'};
+// Versión 1: la franja era la posición en las franjas del vehículo; desde la 2 es su hora de inicio
+const uint32_t VERSION_RESERVAS = 2;
+
+const uint32_t TIPO_RESERVA = 1;
+const uint32_t TIPO_LIBERACION = 2;
+
+// Registros de más que se toleran antes de compactar (además del doble de las vigentes)
+const size_t REGISTROS_SIN_COMPACTAR = 64;
+
+/**
+ * @brief Cabecera del archivo de reservas (16 bytes).
+ */
+struct CabeceraReservas {
+    char firma[4];         ///< "RESV"
+    uint32_t version;
+    uint32_t tamRegistro;  ///< Bytes por registro
+    uint32_t reservado;
+};
+
+/**
+ * @brief Reserva o liberación de una franja.
+ */
+struct RegistroReserva {
+    char idEnvio[16];
+    char idTransportista[16];
+    int32_t dia;
+    int32_t franja;
+    int32_t unidades;
+    uint32_t tipo;         ///< TIPO_RESERVA o TIPO_LIBERACION
+    double pesoKg;
+    double volumenM3;
+    uint32_t crc;          ///< CRC-32 de los campos anteriores
+    uint32_t reservado;
+};
+
+// Copia un texto a un campo de tamaño fijo (siempre termina en '\0')
+static void copiarCampo(char* destino, size_t tam, const string& origen) {
+    memset(destino, 0, tam);
+    strncpy(destino, origen.c_str(), tam - 1);
+}
+
+// Lee un campo de tamaño fijo aunque no termine en '\0'
+static string leerCampo(const char* origen, size_t tam) {
+    return string(origen, strnlen(origen, tam));
+}
+
+static CabeceraReservas cabeceraNueva() {
+    CabeceraReservas cabecera;
+    memset(&cabecera, 0, sizeof(cabecera));
+    memcpy(cabecera.firma, FIRMA_RESERVAS, sizeof(cabecera.firma));
+    cabecera.version = VERSION_RESERVAS;
+    cabecera.tamRegistro = sizeof(RegistroReserva);
+    return cabecera;
+}
+
+static RegistroReserva registroDe(const Reservas::Reserva& reserva, bool liberacion) {
+    RegistroReserva r;
+    memset(&r, 0, sizeof(r));
+    copiarCampo(r.idEnvio, sizeof(r.idEnvio), reserva.idEnvio);
+    copiarCampo(r.idTransportista, sizeof(r.idTransportista), reserva.idTransportista);
+    r.dia = reserva.dia;
+    r.franja = reserva.franja;
+    r.unidades = reserva.carga.unidades;
+    r.tipo = liberacion ? TIPO_LIBERACION : TIPO_RESERVA;
+    r.pesoKg = reserva.carga.pesoKg;
+    r.volumenM3 = reserva.carga.volumenM3;
+    r.crc = calcularCrc32(&r, offsetof(RegistroReserva, crc));
+    return r;
+}
+
+static bool debeCompactar(size_t registros, size_t vigentes) {
+    return registros > 2 * vigentes + REGISTROS_SIN_COMPACTAR;
+}
+
+// Definicion de los miembros estaticos
+unordered_map<string, unordered_map<int, Reservas::Dia>> Reservas::tabla;
+unordered_map<string, Reservas::Reserva> Reservas::porEnvio;
+bool Reservas::cargadas = false;
+size_t Reservas::registrosEnArchivo = 0;
+uint32_t Reservas::versionArchivo = VERSION_RESERVAS;
+mutex Reservas::mutex;
+
+// ----------- Fechas ------------
+
+// Días civiles desde 1970-01-01 (algoritmo de Howard Hinnant)
+static int diasDesdeCivil(int anio, int mes, int diaMes) {
+    anio -= mes <= 2;
+    int era = (anio >= 0 ? anio : anio - 399) / 400;
+    int anioEra = anio - era * 400;
+    int diaAnio = (153 * (mes + (mes > 2 ? -3 : 9)) + 2) / 5 + diaMes - 1;
+    int diaEra = anioEra * 365 + anioEra / 4 - anioEra / 100 + diaAnio;
+    return era * 146097 + diaEra - 719468;
+}
+
+int Reservas::diaDe(time_t fecha) {
+    tm local = *localtime(&fecha);
+    return diasDesdeCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+}
+
+string Reservas::textoDia(int dia) {
+    int z = dia + 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    int diaEra = z - era * 146097;
+    int anioEra = (diaEra - diaEra / 1460 + diaEra / 36524 - diaEra / 146096) / 365;
+    int diaAnio = diaEra - (365 * anioEra + anioEra / 4 - anioEra / 100);
+    int mp = (5 * diaAnio + 2) / 153;
+    int diaMes = diaAnio - (153 * mp + 2) / 5 + 1;
+    int mes = mp + (mp < 10 ? 3 : -9);
+    int anio = anioEra + era * 400 + (mes <= 2);
+
+    ostringstream texto;
+    texto << anio << "-" << setw(2) << setfill('0') << mes << "-" << setw(2) << setfill('0') << diaMes;
+    return texto.str();
+}
+
+// ----------- Tabla en memoria ------------
+
+Reservas::Carga Reservas::Carga::deUnidades(int unidades) {
+    Carga carga;
+    carga.unidades = unidades;
+    carga.pesoKg = unidades * KG_POR_UNIDAD;
+    carga.volumenM3 = unidades * M3_POR_UNIDAD;
+    return carga;
+}
+
+// Suma (signo 1) o resta (signo -1) la carga de una reserva en su franja
+void Reservas::aplicar(const Reserva& reserva, int signo) {
+    Carga& ocupada = tabla[reserva.idTransportista][reserva.dia].porFranja[reserva.franja];
+    ocupada.unidades += signo * reserva.carga.unidades;
+    ocupada.pesoKg += signo * reserva.carga.pesoKg;
+    ocupada.volumenM3 += signo * reserva.carga.volumenM3;
+}
+
+// Reproduce reservas.bin; los registros con CRC inválido o truncados se omiten.
+// Después descarta las reservas de días pasados y compacta si hace falta.
+void Reservas::asegurarCargadas() {
+    if (cargadas) return;
+    cargadas = true;
+    tabla.clear();
+    porEnvio.clear();
+    registrosEnArchivo = 0;
+    versionArchivo = VERSION_RESERVAS;
+
+    ifstream archivo(ARCHIVO_RESERVAS, ios::binary);
+    if (!archivo) return;
+
+    CabeceraReservas cabecera;
+    if (!archivo.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera)) ||
+        memcmp(cabecera.firma, FIRMA_RESERVAS, sizeof(cabecera.firma)) != 0 ||
+        cabecera.version == 0 || cabecera.version > VERSION_RESERVAS ||
+        cabecera.tamRegistro < sizeof(RegistroReserva)) {
+        cerr << "\n\tError: la cabecera de " << ARCHIVO_RESERVAS << " no es válida.\n";
+        return;
+    }
+    versionArchivo = cabecera.version;
+
+    vector<char> buffer(cabecera.tamRegistro);
+    while (archivo.read(buffer.data(), buffer.size())) {
+        registrosEnArchivo++;
+        RegistroReserva r;
+        memcpy(&r, buffer.data(), sizeof(r));
+        if (r.crc != calcularCrc32(&r, offsetof(RegistroReserva, crc))) continue;
+
+        string idEnvio = leerCampo(r.idEnvio, sizeof(r.idEnvio));
+        if (r.tipo == TIPO_LIBERACION) {
+            auto it = porEnvio.find(idEnvio);
+            if (it == porEnvio.end()) continue;
+            aplicar(it->second, -1);
+            porEnvio.erase(it);
+        } else if (r.tipo == TIPO_RESERVA && !porEnvio.count(idEnvio)) {
+            Reserva reserva;
+            reserva.idEnvio = idEnvio;
+            reserva.idTransportista = leerCampo(r.idTransportista, sizeof(r.idTransportista));
+            reserva.dia = r.dia;
+            reserva.franja = r.franja;
+            if (versionArchivo < 2) {
+                // Posición de la franja -> hora de inicio, con las franjas actuales del vehículo
+                const Transportistas::Vehiculo* vehiculo = Transportistas::vehiculoDe(reserva.idTransportista);
+                if (!vehiculo || r.franja < 0 || static_cast<size_t>(r.franja) >= vehiculo->franjas.size()) continue;
+                reserva.franja = vehiculo->franjas[r.franja].horaInicio;
+            }
+            reserva.carga.unidades = r.unidades;
+            reserva.carga.pesoKg = r.pesoKg;
+            reserva.carga.volumenM3 = r.volumenM3;
+            aplicar(reserva, 1);
+            porEnvio[idEnvio] = reserva;
+        }
+    }
+    archivo.close();
+
+    // Las franjas de días pasados ya no se pueden reservar: no hace falta seguir sus reservas
+    int hoy = diaDe(time(nullptr));
+    for (auto it = porEnvio.begin(); it != porEnvio.end();) {
+        if (it->second.dia < hoy) it = porEnvio.erase(it);
+        else ++it;
+    }
+    for (auto& porDia : tabla) {
+        for (auto it = porDia.second.begin(); it != porDia.second.end();) {
+            if (it->first < hoy) it = porDia.second.erase(it);
+            else ++it;
+        }
+    }
+
+    if (versionArchivo != VERSION_RESERVAS || debeCompactar(registrosEnArchivo, porEnvio.size())) compactar();
+}
+
+// Reescribe reservas.bin solo con las reservas vigentes, en un temporal que luego lo reemplaza
+bool Reservas::compactar() {
+    const string temporal = string(ARCHIVO_RESERVAS) + ".tmp";
+    {
+        ofstream archivo(temporal, ios::binary | ios::trunc);
+        if (!archivo) return false;
+        CabeceraReservas cabecera = cabeceraNueva();
+        archivo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+        for (const auto& par : porEnvio) {
+            RegistroReserva r = registroDe(par.second, false);
+            archivo.write(reinterpret_cast<const char*>(&r), sizeof(r));
+        }
+        if (!archivo) {
+            archivo.close();
+            remove(temporal.c_str());
+            return false;
+        }
+    }
+    // En Windows rename no sobrescribe
+    remove(ARCHIVO_RESERVAS);
+    if (rename(temporal.c_str(), ARCHIVO_RESERVAS) != 0) {
+        cerr << "\n\tError: no se pudo reemplazar " << ARCHIVO_RESERVAS << ".\n";
+        return false;
+    }
+    registrosEnArchivo = porEnvio.size();
+    versionArchivo = VERSION_RESERVAS;
+    return true;
+}
+
+// Agrega un registro al final; si una escritura anterior quedó a medias se rellena hasta alinear
+bool Reservas::escribir(const Reserva& reserva, bool liberacion) {
+    // Un archivo de la versión anterior se convierte antes de agregarle registros
+    if (versionArchivo != VERSION_RESERVAS && !compactar()) return false;
+    RegistroReserva r = registroDe(reserva, liberacion);
+
+    uint64_t tamActual = 0;
+    {
+        ifstream existente(ARCHIVO_RESERVAS, ios::binary | ios::ate);
+        if (existente) tamActual = static_cast<uint64_t>(existente.tellg());
+    }
+    bool nuevo = tamActual < sizeof(CabeceraReservas);
+
+    ofstream archivo(ARCHIVO_RESERVAS, ios::binary | (nuevo ? ios::trunc : ios::app));
+    if (!archivo) {
+        cerr << "\n\tError: no se pudo abrir " << ARCHIVO_RESERVAS << " para escritura.\n";
+        return false;
+    }
+    if (nuevo) {
+        CabeceraReservas cabecera = cabeceraNueva();
+        archivo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+    } else {
+        uint64_t sobrante = (tamActual - sizeof(CabeceraReservas)) % sizeof(RegistroReserva);
+        if (sobrante != 0) {
+            vector<char> ceros(sizeof(RegistroReserva) - sobrante, 0);
+            archivo.write(ceros.data(), ceros.size());
+        }
+    }
+    archivo.write(reinterpret_cast<const char*>(&r), sizeof(r));
+    if (!archivo) return false;
+    registrosEnArchivo = nuevo ? 1 : registrosEnArchivo + 1;
+    return true;
+}
+
+// Primera franja con lugar en las tres medidas; las de hoy que ya terminaron no cuentan
+bool Reservas::buscarFranja(const string& idTransportista, const Carga& carga, time_t desde,
+                            int& dia, int& franja) {
+    const Transportistas::Vehiculo* vehiculo = Transportistas::vehiculoDe(idTransportista);
+    if (!vehiculo || vehiculo->franjas.empty()) return false;
+    if (carga.unidades > vehiculo->unidades || carga.pesoKg > vehiculo->pesoKg ||
+        carga.volumenM3 > vehiculo->volumenM3) return false;
+
+    if (desde == 0) desde = time(nullptr);
+    int primerDia = diaDe(desde);
+    int horaActual = localtime(&desde)->tm_hour;
+    auto porDia = tabla.find(idTransportista);
+
+    for (int d = primerDia; d < primerDia + DIAS_AGENDA; ++d) {
+        const Dia* ocupacion = nullptr;
+        if (porDia != tabla.end()) {
+            auto it = porDia->second.find(d);
+            if (it != porDia->second.end()) ocupacion = &it->second;
+        }
+        for (const auto& f : vehiculo->franjas) {
+            if (d == primerDia && f.horaFin <= horaActual) continue;
+            Carga usada;
+            if (ocupacion) {
+                auto it = ocupacion->porFranja.find(f.horaInicio);
+                if (it != ocupacion->porFranja.end()) usada = it->second;
+            }
+            if (usada.unidades + carga.unidades <= vehiculo->unidades &&
+                usada.pesoKg + carga.pesoKg <= vehiculo->pesoKg + 1e-9 &&
+                usada.volumenM3 + carga.volumenM3 <= vehiculo->volumenM3 + 1e-9) {
+                dia = d;
+                franja = f.horaInicio;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// ----------- Operaciones ------------
+
+bool Reservas::reservar(const string& idEnvio, const string& idTransportista,
+                        const Carga& carga, Reserva& reserva, time_t desde) {
+    lock_guard<std::mutex> bloqueo(mutex);
+    asegurarCargadas();
+    if (porEnvio.count(idEnvio)) return false;
+
+    Reserva nueva;
+    nueva.idEnvio = idEnvio;
+    nueva.idTransportista = idTransportista;
+    nueva.carga = carga;
+    if (!buscarFranja(idTransportista, carga, desde, nueva.dia, nueva.franja)) return false;
+    if (!escribir(nueva, false)) return false;
+
+    aplicar(nueva, 1);
+    porEnvio[idEnvio] = nueva;
+    reserva = nueva;
+    return true;
+}
+
+bool Reservas::hayLugar(const string& idTransportista, const Carga& carga, time_t desde) {
+    lock_guard<std::mutex> bloqueo(mutex);
+    asegurarCargadas();
+    int dia, franja;
+    return buscarFranja(idTransportista, carga, desde, dia, franja);
+}
+
+bool Reservas::liberar(const string& idEnvio) {
+    lock_guard<std::mutex> bloqueo(mutex);
+    asegurarCargadas();
+    auto it = porEnvio.find(idEnvio);
+    if (it == porEnvio.end()) return false;
+    if (!escribir(it->second, true)) return false;
+
+    aplicar(it->second, -1);
+    porEnvio.erase(it);
+    // Si falla, el registro sigue siendo válido y se vuelve a intentar en la próxima liberación
+    if (debeCompactar(registrosEnArchivo, porEnvio.size())) compactar();
+    return true;
+}
+
+bool Reservas::reservaDe(const string& idEnvio, Reserva& reserva) {
+    lock_guard<std::mutex> bloqueo(mutex);
+    asegurarCargadas();
+    auto it = porEnvio.find(idEnvio);
+    if (it == porEnvio.end()) return false;
+    reserva = it->second;
+    return true;
+}
+
+Reservas::Carga Reservas::ocupado(const string& idTransportista, int dia, int franja) {
+    lock_guard<std::mutex> bloqueo(mutex);
+    asegurarCargadas();
+    auto porDia = tabla.find(idTransportista);
+    if (porDia == tabla.end()) return Carga();
+    auto it = porDia->second.find(dia);
+    if (it == porDia->second.end()) return Carga();
+    auto ocupada = it->second.porFranja.find(franja);
+    return ocupada == it->second.porFranja.end() ? Carga() : ocupada->second;
+}
+
+// ----------- Menú ------------
+
+void Reservas::mostrarAgenda() {
+    system("cls");
+    cout << "\n--------------------------------------------------------------------------------\n";
+    cout << "                    AGENDA DE FRANJAS DE LOS TRANSPORTISTAS                      \n";
+    cout << "--------------------------------------------------------------------------------\n";
+
+    vector<Transportistas> transportistas = Transportistas::getTransportistasDisponibles();
+    if (transportistas.empty()) {
+        cout << "\n\tNo hay transportistas disponibles.\n";
+        system("pause");
+        return;
+    }
+
+    int hoy = diaDe(time(nullptr));
+    for (const auto& t : transportistas) {
+        const Transportistas::Vehiculo& v = t.especificacion;
+        cout << "\n" << t.id << " - " << t.nombre << " (" << v.tipo << ", " << v.unidades << " u, "
+             << v.pesoKg << " kg, " << v.volumenM3 << " m3 por franja)\n";
+
+        bool algunaReserva = false;
+        for (int d = hoy; d < hoy + DIAS_AGENDA; ++d) {
+            for (const auto& f : v.franjas) {
+                Carga usada = ocupado(t.id, d, f.horaInicio);
+                if (usada.unidades == 0 && usada.pesoKg <= 0 && usada.volumenM3 <= 0) continue;
+                algunaReserva = true;
+                cout << "    " << textoDia(d) << "  " << setw(2) << setfill('0') << f.horaInicio
+                     << ":00-" << setw(2) << f.horaFin << ":00" << setfill(' ')
+                     << "  " << usada.unidades << "/" << v.unidades << " u\n";
+            }
+        }
+        if (!algunaReserva) cout << "    Sin reservas en los proximos " << DIAS_AGENDA << " dias\n";
+    }
+    system("pause");
+}
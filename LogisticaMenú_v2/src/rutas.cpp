@@ -0,0 +1,521 @@
+#include "rutas.h"
+#include "grupohilos.h"
+#include "pedidos.h"
+#include "envios.h"
+#include "almacen.h"
+#include "clientes.h"
+#include "transportistas.h"
+#include "bitacora.h"
+#include "usuarios.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <chrono>
+#include <cmath>
+#include <cctype>
+#include <cstdlib>
+#include <set>
+#include <cstdint>
+
+using namespace std;
+
+extern bitacora auditoria;
+extern usuarios usuarioRegistrado;
+
+// Vecinos más cercanos considerados por parada al calcular ahorros
+const size_t VECINOS_AHORRO = 40;
+
+// Pasadas máximas de 2-opt por ruta
+const int MAX_PASADAS_2OPT = 50;
+
+const double RADIO_TIERRA_KM = 6371.0;
+
+// Miembros estáticos
+unordered_map<string, Rutas::Punto> Rutas::coordenadas;
+bool Rutas::coordenadasCargadas = false;
+unordered_map<string, string> Rutas::direccionAlmacen;
+unordered_map<string, string> Rutas::direccionCliente;
+unordered_map<string, double> Rutas::distanciasAlmacenCliente;
+vector<Rutas::Punto> Rutas::puntosMatriz;
+shared_ptr<const Rutas::MatrizDistancias> Rutas::matrizCache;
+
+// Minúsculas, sin espacios al inicio o al final y con espacios simples
+static string normalizarDireccion(const string& direccion) {
+    string resultado;
+    bool espacio = false;
+    for (char c : direccion) {
+        if (isspace(static_cast<unsigned char>(c))) {
+            espacio = !resultado.empty();
+            continue;
+        }
+        if (espacio) resultado += ' ';
+        espacio = false;
+        resultado += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+    return resultado;
+}
+
+// ----------- Coordenadas ------------
+
+// Lee coordenadas.txt: "latitud,longitud,direccion" (la dirección puede tener comas)
+void Rutas::asegurarCoordenadas() {
+    if (coordenadasCargadas) return;
+    coordenadasCargadas = true;
+    coordenadas.clear();
+
+    ifstream archivo("coordenadas.txt");
+    if (!archivo) return;
+
+    string linea;
+    size_t numero = 0;
+    while (getline(archivo, linea)) {
+        numero++;
+        if (linea.empty() || linea[0] == '#') continue;
+
+        size_t coma1 = linea.find(',');
+        size_t coma2 = (coma1 == string::npos) ? string::npos : linea.find(',', coma1 + 1);
+        if (coma2 == string::npos) {
+            cerr << "\n\tAviso: coordenadas.txt linea " << numero << " sin formato latitud,longitud,direccion\n";
+            continue;
+        }
+
+        char* fin = nullptr;
+        string textoLatitud = linea.substr(0, coma1);
+        string textoLongitud = linea.substr(coma1 + 1, coma2 - coma1 - 1);
+        Punto punto;
+        punto.latitud = strtod(textoLatitud.c_str(), &fin);
+        bool valido = (fin != textoLatitud.c_str());
+        punto.longitud = strtod(textoLongitud.c_str(), &fin);
+        valido = valido && (fin != textoLongitud.c_str()) &&
+                 fabs(punto.latitud) <= 90.0 && fabs(punto.longitud) <= 180.0;
+
+        string direccion = normalizarDireccion(linea.substr(coma2 + 1));
+        if (!valido || direccion.empty()) {
+            cerr << "\n\tAviso: coordenadas.txt linea " << numero << " no valida\n";
+            continue;
+        }
+        coordenadas[direccion] = punto;
+    }
+}
+
+bool Rutas::coordenadaDe(const string& direccion, Punto& punto) {
+    asegurarCoordenadas();
+    auto it = coordenadas.find(normalizarDireccion(direccion));
+    if (it == coordenadas.end()) return false;
+    punto = it->second;
+    return true;
+}
+
+void Rutas::recargarCoordenadas() {
+    coordenadasCargadas = false;
+    direccionAlmacen.clear();
+    direccionCliente.clear();
+    distanciasAlmacenCliente.clear();
+    puntosMatriz.clear();
+    matrizCache.reset();
+}
+
+double Rutas::distanciaKm(const Punto& a, const Punto& b) {
+    const double radianes = 3.14159265358979323846 / 180.0;
+    double dLat = (b.latitud - a.latitud) * radianes;
+    double dLon = (b.longitud - a.longitud) * radianes;
+    double h = sin(dLat / 2) * sin(dLat / 2) +
+               cos(a.latitud * radianes) * cos(b.latitud * radianes) * sin(dLon / 2) * sin(dLon / 2);
+    return 2.0 * RADIO_TIERRA_KM * asin(min(1.0, sqrt(h)));
+}
+
+// Las direcciones se cargan la primera vez y de nuevo solo si aparece un ID desconocido
+double Rutas::distanciaAlmacenCliente(const string& idAlmacen, const string& idCliente) {
+    string clave = idAlmacen + "|" + idCliente;
+    auto memo = distanciasAlmacenCliente.find(clave);
+    if (memo != distanciasAlmacenCliente.end()) return memo->second;
+
+    if (!direccionAlmacen.count(idAlmacen)) {
+        vector<Almacen> almacenes;
+        Almacen::cargarDesdeArchivo(almacenes);
+        for (const auto& a : almacenes) direccionAlmacen[a.getId()] = a.getDireccion();
+        direccionAlmacen.emplace(idAlmacen, "");  // No volver a leer por un ID inexistente
+    }
+    if (!direccionCliente.count(idCliente)) {
+        vector<Clientes> clientes;
+        Clientes::cargarDesdeArchivo(clientes);
+        for (const auto& c : clientes) direccionCliente[c.getId()] = c.getDireccion();
+        direccionCliente.emplace(idCliente, "");
+    }
+
+    Punto origen, destino;
+    double distancia = SIN_DISTANCIA;
+    if (coordenadaDe(direccionAlmacen[idAlmacen], origen) && coordenadaDe(direccionCliente[idCliente], destino)) {
+        distancia = distanciaKm(origen, destino);
+    }
+    distanciasAlmacenCliente[clave] = distancia;
+    return distancia;
+}
+
+// ----------- Matriz de distancias ------------
+
+// Cada hilo llena filas completas; la matriz se guarda entera para leer sin calcular índices triangulares
+Rutas::MatrizDistancias::MatrizDistancias(const vector<Punto>& puntos)
+    : n(puntos.size()), datos(puntos.size() * puntos.size(), 0.0f) {
+    GrupoHilos::global().paraCada(n, [this, &puntos](size_t i) {
+        for (size_t j = 0; j < n; ++j) {
+            if (i != j) datos[i * n + j] = static_cast<float>(distanciaKm(puntos[i], puntos[j]));
+        }
+    });
+}
+
+// Se reutiliza la última matriz si los puntos son los mismos (p. ej. al volver a planificar)
+shared_ptr<const Rutas::MatrizDistancias> Rutas::obtenerMatriz(const vector<Punto>& puntos) {
+    if (matrizCache && puntosMatriz == puntos) return matrizCache;
+    matrizCache = make_shared<const MatrizDistancias>(puntos);
+    puntosMatriz = puntos;
+    return matrizCache;
+}
+
+// ----------- Mejora de recorridos ------------
+
+// Longitud de depósito -> recorrido -> depósito
+double Rutas::longitudRecorrido(const MatrizDistancias& matriz, const vector<size_t>& recorrido) {
+    if (recorrido.empty()) return 0.0;
+    double total = matriz(0, recorrido.front()) + matriz(recorrido.back(), 0);
+    for (size_t i = 1; i < recorrido.size(); ++i) total += matriz(recorrido[i - 1], recorrido[i]);
+    return total;
+}
+
+// 2-opt con primera mejora: invierte tramos mientras acorten el recorrido
+void Rutas::mejorar2Opt(const MatrizDistancias& matriz, vector<size_t>& recorrido) {
+    if (recorrido.size() < 3) return;
+
+    // Con el depósito en ambos extremos los cortes en los bordes se tratan igual que los internos
+    vector<size_t> r;
+    r.reserve(recorrido.size() + 2);
+    r.push_back(0);
+    r.insert(r.end(), recorrido.begin(), recorrido.end());
+    r.push_back(0);
+
+    bool mejoro = true;
+    for (int pasada = 0; mejoro && pasada < MAX_PASADAS_2OPT; ++pasada) {
+        mejoro = false;
+        for (size_t i = 1; i + 1 < r.size(); ++i) {
+            for (size_t j = i + 1; j + 1 < r.size(); ++j) {
+                double antes = matriz(r[i - 1], r[i]) + matriz(r[j], r[j + 1]);
+                double despues = matriz(r[i - 1], r[j]) + matriz(r[i], r[j + 1]);
+                if (despues + 1e-9 < antes) {
+                    reverse(r.begin() + i, r.begin() + j + 1);
+                    mejoro = true;
+                }
+            }
+        }
+    }
+    recorrido.assign(r.begin() + 1, r.end() - 1);
+}
+
+// ----------- Planificación ------------
+
+Rutas::Plan Rutas::planificar(const Punto& deposito, const vector<Parada>& paradas,
+                              const vector<VehiculoRuta>& vehiculos) {
+    Plan plan;
+    int capacidadMaxima = 0;
+    for (const auto& v : vehiculos) capacidadMaxima = max(capacidadMaxima, v.capacidad);
+
+    // Paradas que caben en algún vehículo; el resto queda sin asignar
+    vector<size_t> validas;
+    for (size_t i = 0; i < paradas.size(); ++i) {
+        if (paradas[i].demanda <= capacidadMaxima && !vehiculos.empty()) {
+            validas.push_back(i);
+        } else {
+            plan.sinAsignar.push_back(paradas[i]);
+        }
+    }
+    if (validas.empty()) return plan;
+
+    // Índice 0 = depósito; índice k = validas[k - 1]
+    vector<Punto> puntos;
+    puntos.reserve(validas.size() + 1);
+    puntos.push_back(deposito);
+    for (size_t i : validas) puntos.push_back(paradas[i].punto);
+    shared_ptr<const MatrizDistancias> matriz = obtenerMatriz(puntos);
+    const MatrizDistancias& d = *matriz;
+    size_t n = validas.size();
+    auto demanda = [&](size_t k) { return paradas[validas[k - 1]].demanda; };
+
+    // 1. Ahorros s(i,j) = d(0,i) + d(0,j) - d(i,j) solo con los vecinos más cercanos de cada parada
+    struct Ahorro {
+        float valor;
+        uint32_t a, b;
+    };
+    vector<vector<Ahorro>> porParada(n + 1);
+    size_t vecinos = min(n - 1, VECINOS_AHORRO);
+    GrupoHilos::global().paraCada(n, [&](size_t indice) {
+        size_t i = indice + 1;
+        vector<size_t> candidatos;
+        candidatos.reserve(n - 1);
+        for (size_t j = 1; j <= n; ++j) {
+            if (j != i) candidatos.push_back(j);
+        }
+        if (vecinos < candidatos.size()) {
+            nth_element(candidatos.begin(), candidatos.begin() + vecinos, candidatos.end(),
+                        [&](size_t x, size_t y) { return d(i, x) < d(i, y); });
+            candidatos.resize(vecinos);
+        }
+        for (size_t j : candidatos) {
+            float valor = d(0, i) + d(0, j) - d(i, j);
+            if (valor > 0) {
+                porParada[i].push_back({valor, static_cast<uint32_t>(min(i, j)), static_cast<uint32_t>(max(i, j))});
+            }
+        }
+    });
+
+    vector<Ahorro> ahorros;
+    for (auto& lista : porParada) ahorros.insert(ahorros.end(), lista.begin(), lista.end());
+    sort(ahorros.begin(), ahorros.end(), [](const Ahorro& x, const Ahorro& y) {
+        if (x.valor != y.valor) return x.valor > y.valor;
+        if (x.a != y.a) return x.a < y.a;
+        return x.b < y.b;
+    });
+    ahorros.erase(unique(ahorros.begin(), ahorros.end(), [](const Ahorro& x, const Ahorro& y) {
+        return x.a == y.a && x.b == y.b;
+    }), ahorros.end());
+
+    // 2. Uniones de Clarke-Wright: solo por los extremos y sin superar la capacidad mayor
+    vector<vector<size_t>> rutas(n + 1);
+    vector<size_t> rutaDe(n + 1);
+    vector<int> carga(n + 1, 0);
+    for (size_t k = 1; k <= n; ++k) {
+        rutas[k] = {k};
+        rutaDe[k] = k;
+        carga[k] = demanda(k);
+    }
+
+    for (const auto& ahorro : ahorros) {
+        size_t ra = rutaDe[ahorro.a], rb = rutaDe[ahorro.b];
+        if (ra == rb || carga[ra] + carga[rb] > capacidadMaxima) continue;
+
+        vector<size_t>& primera = rutas[ra];
+        vector<size_t>& segunda = rutas[rb];
+        bool aEsExtremo = (primera.front() == ahorro.a || primera.back() == ahorro.a);
+        bool bEsExtremo = (segunda.front() == ahorro.b || segunda.back() == ahorro.b);
+        if (!aEsExtremo || !bEsExtremo) continue;
+
+        // Orientar para que 'a' quede al final de la primera y 'b' al inicio de la segunda
+        if (primera.back() != ahorro.a) reverse(primera.begin(), primera.end());
+        if (segunda.front() != ahorro.b) reverse(segunda.begin(), segunda.end());
+
+        for (size_t k : segunda) rutaDe[k] = ra;
+        primera.insert(primera.end(), segunda.begin(), segunda.end());
+        carga[ra] += carga[rb];
+        segunda.clear();
+        carga[rb] = 0;
+    }
+
+    // 3. Cada ruta al vehículo más chico que la lleva, empezando por las más cargadas.
+    //    Si ninguno libre la lleva, el más grande se llena con el comienzo de la ruta
+    //    y el resto vuelve a la lista como una ruta nueva.
+    multiset<pair<int, size_t>, greater<pair<int, size_t>>> pendientes;  // (carga, ruta)
+    for (size_t r = 1; r <= n; ++r) {
+        if (!rutas[r].empty()) pendientes.insert({carga[r], r});
+    }
+
+    multiset<pair<int, size_t>> libres;  // (capacidad, posición del vehículo)
+    for (size_t v = 0; v < vehiculos.size(); ++v) libres.insert({vehiculos[v].capacidad, v});
+
+    vector<pair<size_t, size_t>> asignadas;  // (ruta, vehículo)
+    while (!pendientes.empty()) {
+        size_t r = pendientes.begin()->second;
+        pendientes.erase(pendientes.begin());
+        if (libres.empty()) {
+            for (size_t k : rutas[r]) plan.sinAsignar.push_back(paradas[validas[k - 1]]);
+            continue;
+        }
+
+        auto it = libres.lower_bound({carga[r], 0});
+        if (it == libres.end()) {
+            it = prev(libres.end());
+            int cargaPrimera = 0;
+            size_t corte = 0;
+            while (corte < rutas[r].size() && cargaPrimera + demanda(rutas[r][corte]) <= it->first) {
+                cargaPrimera += demanda(rutas[r][corte++]);
+            }
+            // Una parada que no cabe ni en el vehículo libre más grande queda sin asignar
+            size_t inicioResto = max<size_t>(corte, 1);
+            if (corte == 0) plan.sinAsignar.push_back(paradas[validas[rutas[r].front() - 1]]);
+
+            vector<size_t> resto(rutas[r].begin() + inicioResto, rutas[r].end());
+            if (!resto.empty()) {
+                int cargaResto = 0;
+                for (size_t k : resto) cargaResto += demanda(k);
+                rutas.push_back(move(resto));
+                carga.push_back(cargaResto);
+                pendientes.insert({cargaResto, rutas.size() - 1});
+            }
+            rutas[r].resize(corte);
+            carga[r] = cargaPrimera;
+            if (corte == 0) continue;
+        }
+        asignadas.push_back({r, it->second});
+        libres.erase(it);
+    }
+
+    // 4. 2-opt de cada ruta en paralelo
+    plan.rutas.resize(asignadas.size());
+    GrupoHilos::global().paraCada(asignadas.size(), [&](size_t i) {
+        vector<size_t>& recorrido = rutas[asignadas[i].first];
+        mejorar2Opt(d, recorrido);
+
+        Ruta& ruta = plan.rutas[i];
+        ruta.vehiculo = vehiculos[asignadas[i].second];
+        ruta.carga = carga[asignadas[i].first];
+        ruta.distanciaKm = longitudRecorrido(d, recorrido);
+        for (size_t k : recorrido) ruta.paradas.push_back(paradas[validas[k - 1]]);
+    });
+
+    for (const auto& ruta : plan.rutas) plan.distanciaTotalKm += ruta.distanciaKm;
+    return plan;
+}
+
+// Vecino más cercano desde el depósito y luego 2-opt; no usa la matriz en caché
+double Rutas::ordenarParadas(const Punto& deposito, vector<Parada>& paradas) {
+    if (paradas.empty()) return 0.0;
+
+    vector<Punto> puntos;
+    puntos.reserve(paradas.size() + 1);
+    puntos.push_back(deposito);
+    for (const auto& p : paradas) puntos.push_back(p.punto);
+    MatrizDistancias d(puntos);
+
+    vector<size_t> recorrido;
+    vector<bool> visitada(puntos.size(), false);
+    size_t actual = 0;
+    for (size_t paso = 0; paso < paradas.size(); ++paso) {
+        size_t siguiente = 0;
+        for (size_t k = 1; k < puntos.size(); ++k) {
+            if (!visitada[k] && (siguiente == 0 || d(actual, k) < d(actual, siguiente))) siguiente = k;
+        }
+        visitada[siguiente] = true;
+        recorrido.push_back(siguiente);
+        actual = siguiente;
+    }
+    mejorar2Opt(d, recorrido);
+
+    vector<Parada> ordenadas;
+    ordenadas.reserve(paradas.size());
+    for (size_t k : recorrido) ordenadas.push_back(paradas[k - 1]);
+    paradas.swap(ordenadas);
+    return longitudRecorrido(d, recorrido);
+}
+
+// ----------- Menú ------------
+
+void Rutas::planificarRutas() {
+    system("cls");
+    cout << "\n--------------------------------------------------------------------------------\n";
+    cout << "                      PLANIFICACION DE RUTAS DE REPARTO                          \n";
+    cout << "--------------------------------------------------------------------------------\n";
+
+    recargarCoordenadas();  // Toma los cambios de coordenadas.txt, almacenes y clientes
+
+    vector<Almacen> almacenes;
+    Almacen::cargarDesdeArchivo(almacenes);
+    cout << "Almacenes operativos:\n";
+    for (const auto& a : almacenes) {
+        if (a.getEstado() == "operativo") cout << "   " << a.getId() << " - " << a.getNombre() << " (" << a.getDireccion() << ")\n";
+    }
+
+    string idAlmacen;
+    cout << "\nIngrese el ID del almacen de salida (0 para salir): ";
+    cin >> idAlmacen;
+    if (idAlmacen == "0") return;
+
+    auto itAlmacen = find_if(almacenes.begin(), almacenes.end(), [&](const Almacen& a) { return a.getId() == idAlmacen; });
+    Punto deposito;
+    if (itAlmacen == almacenes.end() || !coordenadaDe(itAlmacen->getDireccion(), deposito)) {
+        cout << "\n\tAlmacen inexistente o sin coordenadas en coordenadas.txt.\n";
+        system("pause");
+        return;
+    }
+
+    // Paradas: pedidos "procesado" del almacén que aún no tienen envío
+    vector<Clientes> clientes;
+    Clientes::cargarDesdeArchivo(clientes);
+    unordered_map<string, string> direccionPorCliente;
+    for (const auto& c : clientes) direccionPorCliente[c.getId()] = c.getDireccion();
+
+    shared_ptr<const InstantaneaPedidos> vista = Pedidos::obtenerInstantanea();
+    vector<Parada> paradas;
+    vector<string> sinCoordenadas;
+    for (const auto& p : vista->pedidos) {
+        if (p.getEstado() != "procesado" || p.getIdAlmacen() != idAlmacen) continue;
+        if (!Envios::enviosDePedido(p.getId()).empty()) continue;
+
+        Parada parada;
+        parada.id = p.getId();
+        string direccion = direccionPorCliente[p.getIdCliente()];
+        parada.descripcion = "Cliente " + p.getIdCliente() + " - " + direccion;
+        parada.demanda = p.getTotales().unidades;
+        if (coordenadaDe(direccion, parada.punto)) {
+            paradas.push_back(parada);
+        } else {
+            sinCoordenadas.push_back(p.getId());
+        }
+    }
+
+    vector<VehiculoRuta> vehiculos;
+    for (const auto& t : Transportistas::getTransportistasDisponibles()) {
+        vehiculos.push_back({t.id, t.especificacion.tipo, t.especificacion.unidades});
+    }
+
+    if (paradas.empty() || vehiculos.empty()) {
+        cout << "\n\tNo hay pedidos con coordenadas para ese almacen o no hay transportistas disponibles.\n";
+        system("pause");
+        return;
+    }
+
+    auto inicio = chrono::steady_clock::now();
+    Plan plan = planificar(deposito, paradas, vehiculos);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+
+    ostringstream texto;
+    texto << fixed << setprecision(1);
+    for (size_t i = 0; i < plan.rutas.size(); ++i) {
+        const Ruta& ruta = plan.rutas[i];
+        texto << "\nRUTA " << i + 1 << " | Transportista " << ruta.vehiculo.id << " (" << ruta.vehiculo.tipo
+              << ") | Carga " << ruta.carga << "/" << ruta.vehiculo.capacidad
+              << " | " << ruta.distanciaKm << " km\n";
+        for (size_t k = 0; k < ruta.paradas.size(); ++k) {
+            texto << "   " << setw(3) << k + 1 << ". Pedido " << left << setw(8) << ruta.paradas[k].id << right
+                  << ruta.paradas[k].descripcion << " (" << ruta.paradas[k].demanda << " u.)\n";
+        }
+    }
+    if (!plan.sinAsignar.empty()) {
+        texto << "\nSin vehiculo (" << plan.sinAsignar.size() << "):";
+        for (const auto& p : plan.sinAsignar) texto << " " << p.id;
+        texto << "\n";
+    }
+    if (!sinCoordenadas.empty()) {
+        texto << "\nSin coordenadas (" << sinCoordenadas.size() << "):";
+        for (const auto& id : sinCoordenadas) texto << " " << id;
+        texto << "\n";
+    }
+    texto << "\n" << paradas.size() << " paradas en " << plan.rutas.size() << " rutas, "
+          << plan.distanciaTotalKm << " km en total\n";
+
+    cout << texto.str();
+    cout << "Planificacion en " << static_cast<long>(ms + 0.5) << " ms\n";
+
+    // Las rutas quedan en rutas.txt para entregarlas a los transportistas
+    ofstream archivo("rutas.txt", ios::app);
+    time_t ahora = time(nullptr);
+    char fecha[20];
+    strftime(fecha, sizeof(fecha), "%Y-%m-%d %H:%M", localtime(&ahora));
+    archivo << "=== [" << fecha << "] Almacen " << idAlmacen << " ===" << texto.str() << "\n";
+
+    auditoria.registrar(usuarioRegistrado.getNombre(), "ENVIOS",
+                        "Rutas planificadas desde almacen " + idAlmacen + ": " + to_string(plan.rutas.size()) + " rutas");
+    cout << "\n\tRutas guardadas en rutas.txt\n";
+    system("pause");
+}
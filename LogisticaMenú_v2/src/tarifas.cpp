@@ -0,0 +1,504 @@
+#include "tarifas.h"
+#include "clientes.h"
+#include "producto.h"
+#include "bitacora.h"
+#include "usuarios.h"
+
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+extern usuarios usuarioRegistrado;
+extern bitacora auditoria;
+
+// --- Formato de tarifas.bin ---
+// Cabecera, descuentos por nivel y categoría, IVA por categoría, tramos de volumen
+// y al final las asignaciones de nivel (clientes) y de categoría (productos)
+const char ARCHIVO_TARIFAS[] = "tarifas.bin";
+const char FIRMA_TARIFAS[4] = {'T', 'A', 'R', 'F'};
+const uint32_t VERSION_TARIFAS = 1;
+
+struct CabeceraTarifas {
+    char firma[4];
+    uint32_t version;
+    uint32_t niveles;
+    uint32_t categorias;
+    uint32_t tramosVolumen;
+    uint32_t clientes;
+    uint32_t productos;
+    uint32_t reservado;
+};
+
+struct AsignacionTarifa {
+    int32_t id;
+    int32_t valor;
+};
+
+static_assert(sizeof(CabeceraTarifas) == 32, "formato de tarifas.bin");
+static_assert(sizeof(Tarifas::DescuentoVolumen) == 8, "formato de tarifas.bin");
+
+// --- Valores por defecto (se generan al compilar) ---
+
+// 2.5 % más por cada nivel de cliente, igual en todas las categorías
+constexpr array<int32_t, Tarifas::NIVELES * Tarifas::CATEGORIAS> generarDescuentosNivel() {
+    array<int32_t, Tarifas::NIVELES * Tarifas::CATEGORIAS> tabla{};
+    for (int nivel = 0; nivel < Tarifas::NIVELES; ++nivel) {
+        for (int categoria = 0; categoria < Tarifas::CATEGORIAS; ++categoria) {
+            tabla[nivel * Tarifas::CATEGORIAS + categoria] = nivel * 250;
+        }
+    }
+    return tabla;
+}
+
+// IVA general de 12 %; la última categoría es exenta
+constexpr array<int32_t, Tarifas::CATEGORIAS> generarIva() {
+    array<int32_t, Tarifas::CATEGORIAS> tabla{};
+    for (int categoria = 0; categoria < Tarifas::CATEGORIAS; ++categoria) {
+        tabla[categoria] = categoria == Tarifas::CATEGORIAS - 1 ? 0 : 1200;
+    }
+    return tabla;
+}
+
+constexpr auto DESCUENTO_NIVEL_POR_DEFECTO = generarDescuentosNivel();
+constexpr auto IVA_POR_DEFECTO = generarIva();
+constexpr Tarifas::DescuentoVolumen VOLUMEN_POR_DEFECTO[] = {{10, 200}, {50, 400}, {100, 600}, {500, 1000}};
+
+static_assert(DESCUENTO_NIVEL_POR_DEFECTO[Tarifas::NIVELES * Tarifas::CATEGORIAS - 1] == 750,
+              "descuento del nivel más alto");
+static_assert(IVA_POR_DEFECTO[0] == 1200 && IVA_POR_DEFECTO[Tarifas::CATEGORIAS - 1] == 0, "IVA por defecto");
+
+shared_ptr<const Tarifas::Vigentes> Tarifas::actual;
+
+// ----------- Auxiliares ------------
+
+// ID numérico sin lanzar excepciones (las tablas se consultan desde varios hilos)
+bool Tarifas::aEntero(const string& texto, int& valor) {
+    if (texto.empty()) return false;
+    char* fin = nullptr;
+    long numero = strtol(texto.c_str(), &fin, 10);
+    if (*fin != '\0' || numero < numeric_limits<int>::min() || numero > numeric_limits<int>::max()) return false;
+    valor = static_cast<int>(numero);
+    return true;
+}
+
+// Porcentaje de un importe redondeado al centavo (la mitad se aleja de cero)
+static Dinero porcentaje(Dinero importe, int32_t puntos) {
+    int64_t producto = importe.centavos() * puntos;
+    int64_t mitad = Tarifas::CIEN_POR_CIENTO / 2;
+    return Dinero::deCentavos(producto >= 0 ? (producto + mitad) / Tarifas::CIEN_POR_CIENTO
+                                            : -((-producto + mitad) / Tarifas::CIEN_POR_CIENTO));
+}
+
+static bool puntosValidos(int32_t puntos) {
+    return puntos >= 0 && puntos <= Tarifas::CIEN_POR_CIENTO;
+}
+
+static bool reglasValidas(const Tarifas::Reglas& reglas) {
+    for (int32_t puntos : reglas.descuentoNivel) if (!puntosValidos(puntos)) return false;
+    for (int32_t puntos : reglas.iva) if (!puntosValidos(puntos)) return false;
+    if (reglas.volumen.size() > static_cast<size_t>(Tarifas::TRAMOS_VOLUMEN)) return false;
+    int32_t anterior = 0;
+    for (const auto& tramo : reglas.volumen) {
+        if (tramo.desde <= anterior || tramo.desde > Tarifas::CANTIDAD_MAXIMA_TRAMO ||
+            !puntosValidos(tramo.descuento)) return false;
+        anterior = tramo.desde;
+    }
+    for (const auto& asignacion : reglas.nivelCliente) {
+        if (asignacion.second < 0 || asignacion.second >= Tarifas::NIVELES) return false;
+    }
+    for (const auto& asignacion : reglas.categoriaProducto) {
+        if (asignacion.second < 0 || asignacion.second >= Tarifas::CATEGORIAS) return false;
+    }
+    return true;
+}
+
+// Asignaciones por ID -> arreglo desde el menor ID (los IDs de clientes y productos son rangos cortos)
+static void compilarAsignaciones(const map<int, int>& asignaciones, int& primero, vector<uint8_t>& tabla) {
+    tabla.clear();
+    primero = 0;
+    if (asignaciones.empty()) return;
+    primero = asignaciones.begin()->first;
+    tabla.assign(static_cast<size_t>(asignaciones.rbegin()->first - primero) + 1, 0);
+    for (const auto& asignacion : asignaciones) {
+        tabla[static_cast<size_t>(asignacion.first - primero)] = static_cast<uint8_t>(asignacion.second);
+    }
+}
+
+static int buscarAsignacion(const string& id, int primero, const vector<uint8_t>& tabla) {
+    int numero = 0;
+    if (!Tarifas::aEntero(id, numero) || numero < primero) return 0;
+    size_t posicion = static_cast<size_t>(numero) - static_cast<size_t>(primero);
+    return posicion < tabla.size() ? tabla[posicion] : 0;
+}
+
+// ----------- Reglas y tablas ------------
+
+Tarifas::Reglas Tarifas::Reglas::porDefecto() {
+    Reglas reglas;
+    reglas.descuentoNivel = DESCUENTO_NIVEL_POR_DEFECTO;
+    reglas.iva = IVA_POR_DEFECTO;
+    reglas.volumen.assign(begin(VOLUMEN_POR_DEFECTO), end(VOLUMEN_POR_DEFECTO));
+    return reglas;
+}
+
+shared_ptr<const Tarifas::Tablas> Tarifas::compilar(const Reglas& reglas) {
+    auto tablas = make_shared<Tablas>();
+    tablas->descuentoNivel = reglas.descuentoNivel;
+    tablas->ivaCategoria = reglas.iva;
+
+    // Un valor por cada cantidad hasta el último tramo; de ahí en adelante vale el último
+    if (!reglas.volumen.empty()) {
+        tablas->descuentoCantidad.assign(static_cast<size_t>(reglas.volumen.back().desde) + 1, 0);
+        for (size_t t = 0; t < reglas.volumen.size(); ++t) {
+            size_t desde = static_cast<size_t>(reglas.volumen[t].desde);
+            size_t hasta = t + 1 < reglas.volumen.size() ? static_cast<size_t>(reglas.volumen[t + 1].desde)
+                                                         : tablas->descuentoCantidad.size();
+            fill(tablas->descuentoCantidad.begin() + desde, tablas->descuentoCantidad.begin() + hasta,
+                 reglas.volumen[t].descuento);
+        }
+    }
+
+    compilarAsignaciones(reglas.nivelCliente, tablas->primerCliente, tablas->nivelPorCliente);
+    compilarAsignaciones(reglas.categoriaProducto, tablas->primerProducto, tablas->categoriaPorProducto);
+    return tablas;
+}
+
+int Tarifas::Tablas::nivelDe(const string& idCliente) const {
+    return buscarAsignacion(idCliente, primerCliente, nivelPorCliente);
+}
+
+int Tarifas::Tablas::categoriaDe(const string& codigoProducto) const {
+    return buscarAsignacion(codigoProducto, primerProducto, categoriaPorProducto);
+}
+
+int32_t Tarifas::Tablas::descuento(int nivel, int categoria, int cantidad) const {
+    int32_t total = descuentoNivel[static_cast<size_t>(nivel * CATEGORIAS + categoria)];
+    if (cantidad > 0 && !descuentoCantidad.empty()) {
+        total += descuentoCantidad[min(static_cast<size_t>(cantidad), descuentoCantidad.size() - 1)];
+    }
+    return min(total, CIEN_POR_CIENTO);
+}
+
+Dinero Tarifas::Tablas::precioUnitario(const string& idCliente, const string& codigoProducto,
+                                       int cantidad, Dinero precioLista) const {
+    int32_t puntos = descuento(nivelDe(idCliente), categoriaDe(codigoProducto), cantidad);
+    return precioLista - porcentaje(precioLista, puntos);
+}
+
+Dinero Tarifas::Tablas::iva(const string& codigoProducto, Dinero subtotal) const {
+    return porcentaje(subtotal, ivaCategoria[static_cast<size_t>(categoriaDe(codigoProducto))]);
+}
+
+// ----------- Vigentes ------------
+
+// La primera vez se lee tarifas.bin; si otro hilo publicó mientras tanto, se usa la suya
+shared_ptr<const Tarifas::Vigentes> Tarifas::obtener() {
+    shared_ptr<const Vigentes> vigente = atomic_load(&actual);
+    if (vigente) return vigente;
+
+    auto candidata = make_shared<Vigentes>();
+    if (!leerArchivo(candidata->reglas)) candidata->reglas = Reglas::porDefecto();
+    candidata->tablas = compilar(candidata->reglas);
+
+    shared_ptr<const Vigentes> publicada = candidata;
+    atomic_compare_exchange_strong(&actual, &vigente, publicada);
+    return atomic_load(&actual);
+}
+
+shared_ptr<const Tarifas::Tablas> Tarifas::vigentes() {
+    return obtener()->tablas;
+}
+
+Dinero Tarifas::precioUnitario(const string& idCliente, const string& codigoProducto,
+                               int cantidad, Dinero precioLista) {
+    return vigentes()->precioUnitario(idCliente, codigoProducto, cantidad, precioLista);
+}
+
+Dinero Tarifas::iva(const string& codigoProducto, Dinero subtotal) {
+    return vigentes()->iva(codigoProducto, subtotal);
+}
+
+Tarifas::Reglas Tarifas::reglas() {
+    return obtener()->reglas;
+}
+
+bool Tarifas::guardar(const Reglas& nuevas) {
+    if (!reglasValidas(nuevas) || !escribirArchivo(nuevas)) return false;
+    auto vigente = make_shared<Vigentes>();
+    vigente->reglas = nuevas;
+    vigente->tablas = compilar(nuevas);
+    atomic_store(&actual, shared_ptr<const Vigentes>(vigente));
+    return true;
+}
+
+const char* Tarifas::nombreNivel(int nivel) {
+    static const char* nombres[NIVELES] = {"General", "Frecuente", "Mayorista", "Preferente"};
+    return nivel >= 0 && nivel < NIVELES ? nombres[nivel] : "?";
+}
+
+const char* Tarifas::nombreCategoria(int categoria) {
+    static const char* nombres[CATEGORIAS] = {"General", "Alimentos", "Bebidas", "Limpieza",
+                                              "Ferreteria", "Oficina", "Electronica", "Exenta de IVA"};
+    return categoria >= 0 && categoria < CATEGORIAS ? nombres[categoria] : "?";
+}
+
+// ----------- Archivo ------------
+
+bool Tarifas::leerArchivo(Reglas& reglas) {
+    ifstream archivo(ARCHIVO_TARIFAS, ios::binary);
+    if (!archivo) return false;
+
+    CabeceraTarifas cabecera;
+    if (!archivo.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera)) ||
+        memcmp(cabecera.firma, FIRMA_TARIFAS, sizeof(cabecera.firma)) != 0 ||
+        cabecera.version != VERSION_TARIFAS || cabecera.niveles != NIVELES ||
+        cabecera.categorias != CATEGORIAS || cabecera.tramosVolumen > TRAMOS_VOLUMEN) {
+        cerr << "El archivo de tarifas no es compatible; se usan los valores por defecto." << endl;
+        return false;
+    }
+
+    Reglas leidas;
+    leidas.volumen.resize(cabecera.tramosVolumen);
+    vector<AsignacionTarifa> clientes(cabecera.clientes), productos(cabecera.productos);
+    archivo.read(reinterpret_cast<char*>(leidas.descuentoNivel.data()), sizeof(leidas.descuentoNivel));
+    archivo.read(reinterpret_cast<char*>(leidas.iva.data()), sizeof(leidas.iva));
+    archivo.read(reinterpret_cast<char*>(leidas.volumen.data()), leidas.volumen.size() * sizeof(DescuentoVolumen));
+    archivo.read(reinterpret_cast<char*>(clientes.data()), clientes.size() * sizeof(AsignacionTarifa));
+    archivo.read(reinterpret_cast<char*>(productos.data()), productos.size() * sizeof(AsignacionTarifa));
+    for (const auto& asignacion : clientes) leidas.nivelCliente[asignacion.id] = asignacion.valor;
+    for (const auto& asignacion : productos) leidas.categoriaProducto[asignacion.id] = asignacion.valor;
+
+    if (!archivo || !reglasValidas(leidas)) {
+        cerr << "El archivo de tarifas esta danado; se usan los valores por defecto." << endl;
+        return false;
+    }
+    reglas = move(leidas);
+    return true;
+}
+
+// Se escribe en un temporal y se reemplaza: un corte a mitad no deja un archivo a medias
+bool Tarifas::escribirArchivo(const Reglas& reglas) {
+    vector<AsignacionTarifa> clientes, productos;
+    for (const auto& asignacion : reglas.nivelCliente) clientes.push_back({asignacion.first, asignacion.second});
+    for (const auto& asignacion : reglas.categoriaProducto) productos.push_back({asignacion.first, asignacion.second});
+
+    CabeceraTarifas cabecera;
+    memset(&cabecera, 0, sizeof(cabecera));
+    memcpy(cabecera.firma, FIRMA_TARIFAS, sizeof(cabecera.firma));
+    cabecera.version = VERSION_TARIFAS;
+    cabecera.niveles = NIVELES;
+    cabecera.categorias = CATEGORIAS;
+    cabecera.tramosVolumen = static_cast<uint32_t>(reglas.volumen.size());
+    cabecera.clientes = static_cast<uint32_t>(clientes.size());
+    cabecera.productos = static_cast<uint32_t>(productos.size());
+
+    {
+        ofstream temporal("tempTarifas.bin", ios::binary | ios::trunc);
+        temporal.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+        temporal.write(reinterpret_cast<const char*>(reglas.descuentoNivel.data()), sizeof(reglas.descuentoNivel));
+        temporal.write(reinterpret_cast<const char*>(reglas.iva.data()), sizeof(reglas.iva));
+        temporal.write(reinterpret_cast<const char*>(reglas.volumen.data()),
+                       reglas.volumen.size() * sizeof(DescuentoVolumen));
+        temporal.write(reinterpret_cast<const char*>(clientes.data()), clientes.size() * sizeof(AsignacionTarifa));
+        temporal.write(reinterpret_cast<const char*>(productos.data()), productos.size() * sizeof(AsignacionTarifa));
+        if (!temporal.flush()) {
+            remove("tempTarifas.bin");
+            return false;
+        }
+    }
+    remove(ARCHIVO_TARIFAS);
+    return rename("tempTarifas.bin", ARCHIVO_TARIFAS) == 0;
+}
+
+// ----------- Menú ------------
+
+static string textoPuntos(int32_t puntos) {
+    return Dinero::deCentavos(puntos).texto() + "%";
+}
+
+// Lee un entero entre minimo y maximo, repitiendo hasta que sea válido
+static int leerEntero(const string& mensaje, int minimo, int maximo) {
+    int valor;
+    cout << mensaje;
+    while (!(cin >> valor) || valor < minimo || valor > maximo) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "\t\tValor invalido (" << minimo << " - " << maximo << "): ";
+    }
+    return valor;
+}
+
+// Lee un porcentaje con hasta dos decimales y lo devuelve en puntos básicos
+static int32_t leerPorcentaje(const string& mensaje) {
+    string texto;
+    Dinero valor;
+    cout << mensaje;
+    while (!(cin >> texto) || !Dinero::deTexto(texto, valor) ||
+           valor.centavos() < 0 || valor.centavos() > Tarifas::CIEN_POR_CIENTO) {
+        cin.clear();
+        cout << "\t\tPorcentaje invalido (0 - 100, hasta 2 decimales): ";
+    }
+    return static_cast<int32_t>(valor.centavos());
+}
+
+void Tarifas::mostrarTablas(const Reglas& reglas) {
+    cout << "\n\t\t--- Descuento por nivel de cliente y categoria ---\n\t\t" << setw(14) << left << "Categoria";
+    for (int nivel = 0; nivel < NIVELES; ++nivel) cout << setw(12) << nombreNivel(nivel);
+    cout << setw(8) << "IVA" << right << "\n";
+    for (int categoria = 0; categoria < CATEGORIAS; ++categoria) {
+        cout << "\t\t" << categoria << ". " << setw(11) << left << nombreCategoria(categoria);
+        for (int nivel = 0; nivel < NIVELES; ++nivel) {
+            cout << setw(12) << textoPuntos(reglas.descuentoNivel[nivel * CATEGORIAS + categoria]);
+        }
+        cout << setw(8) << textoPuntos(reglas.iva[categoria]) << right << "\n";
+    }
+
+    cout << "\n\t\t--- Descuento adicional por volumen (unidades por linea) ---\n";
+    if (reglas.volumen.empty()) cout << "\t\tSin descuentos por volumen.\n";
+    for (const auto& tramo : reglas.volumen) {
+        cout << "\t\tDesde " << setw(6) << tramo.desde << " unidades: " << textoPuntos(tramo.descuento) << "\n";
+    }
+
+    cout << "\n\t\t--- Clientes con nivel asignado ---\n";
+    if (reglas.nivelCliente.empty()) cout << "\t\tTodos los clientes en nivel General.\n";
+    for (const auto& asignacion : reglas.nivelCliente) {
+        cout << "\t\tCliente " << asignacion.first << ": " << nombreNivel(asignacion.second) << "\n";
+    }
+
+    cout << "\n\t\t--- Productos con categoria asignada ---\n";
+    if (reglas.categoriaProducto.empty()) cout << "\t\tTodos los productos en categoria General.\n";
+    for (const auto& asignacion : reglas.categoriaProducto) {
+        cout << "\t\tProducto " << asignacion.first << ": " << nombreCategoria(asignacion.second) << "\n";
+    }
+}
+
+void Tarifas::menuInteractivo(const vector<Clientes>& clientes, const vector<Producto>& productos) {
+    int opcion;
+    do {
+        system("cls");
+        cout << "\t\t====================================\n"
+             << "\t\t|      TARIFAS Y DESCUENTOS        |\n"
+             << "\t\t====================================\n"
+             << "\t\t1. Ver tablas\n"
+             << "\t\t2. Nivel de un cliente\n"
+             << "\t\t3. Categoria de un producto\n"
+             << "\t\t4. Descuento por nivel y categoria\n"
+             << "\t\t5. Descuentos por volumen\n"
+             << "\t\t6. IVA por categoria\n"
+             << "\t\t7. Restaurar valores por defecto\n"
+             << "\t\t8. Volver\n"
+             << "\t\t====================================\n";
+        opcion = leerEntero("\t\tSeleccione una opcion: ", 1, 8);
+        if (opcion == 8) return;
+
+        Reglas nuevas = reglas();
+        string descripcion;
+        switch (opcion) {
+            case 1:
+                mostrarTablas(nuevas);
+                system("pause");
+                continue;
+
+            case 2: {
+                string id;
+                cout << "\t\tID del cliente: ";
+                cin >> id;
+                int numero = 0;
+                bool existe = any_of(clientes.begin(), clientes.end(),
+                                     [&id](const Clientes& c) { return c.getId() == id; });
+                if (!existe || !aEntero(id, numero)) {
+                    cout << "\t\tCliente no encontrado.\n";
+                    system("pause");
+                    continue;
+                }
+                for (int nivel = 0; nivel < NIVELES; ++nivel) cout << "\t\t" << nivel << ". " << nombreNivel(nivel) << "\n";
+                int nivel = leerEntero("\t\tNivel: ", 0, NIVELES - 1);
+                if (nivel == 0) nuevas.nivelCliente.erase(numero);
+                else nuevas.nivelCliente[numero] = nivel;
+                descripcion = "Cliente " + id + " en nivel " + nombreNivel(nivel);
+                break;
+            }
+
+            case 3: {
+                string codigo;
+                cout << "\t\tCodigo del producto: ";
+                cin >> codigo;
+                int numero = 0;
+                bool existe = any_of(productos.begin(), productos.end(),
+                                     [&codigo](const Producto& p) { return p.getCodigo() == codigo; });
+                if (!existe || !aEntero(codigo, numero)) {
+                    cout << "\t\tProducto no encontrado.\n";
+                    system("pause");
+                    continue;
+                }
+                for (int c = 0; c < CATEGORIAS; ++c) cout << "\t\t" << c << ". " << nombreCategoria(c) << "\n";
+                int categoria = leerEntero("\t\tCategoria: ", 0, CATEGORIAS - 1);
+                if (categoria == 0) nuevas.categoriaProducto.erase(numero);
+                else nuevas.categoriaProducto[numero] = categoria;
+                descripcion = "Producto " + codigo + " en categoria " + nombreCategoria(categoria);
+                break;
+            }
+
+            case 4: {
+                int nivel = leerEntero("\t\tNivel (0 - " + to_string(NIVELES - 1) + "): ", 0, NIVELES - 1);
+                int categoria = leerEntero("\t\tCategoria (0 - " + to_string(CATEGORIAS - 1) + "): ", 0, CATEGORIAS - 1);
+                int32_t puntos = leerPorcentaje("\t\tDescuento (%): ");
+                nuevas.descuentoNivel[nivel * CATEGORIAS + categoria] = puntos;
+                descripcion = string("Descuento ") + nombreNivel(nivel) + "/" + nombreCategoria(categoria) +
+                              ": " + textoPuntos(puntos);
+                break;
+            }
+
+            case 5: {
+                int tramos = leerEntero("\t\tCantidad de tramos (0 - " + to_string(TRAMOS_VOLUMEN) + "): ",
+                                        0, TRAMOS_VOLUMEN);
+                nuevas.volumen.clear();
+                int minimo = 1;
+                for (int t = 0; t < tramos && minimo <= CANTIDAD_MAXIMA_TRAMO; ++t) {
+                    DescuentoVolumen tramo;
+                    tramo.desde = leerEntero("\t\tTramo " + to_string(t + 1) + " desde (unidades): ",
+                                             minimo, CANTIDAD_MAXIMA_TRAMO);
+                    tramo.descuento = leerPorcentaje("\t\tDescuento (%): ");
+                    nuevas.volumen.push_back(tramo);
+                    minimo = tramo.desde + 1;
+                }
+                descripcion = "Descuentos por volumen: " + to_string(nuevas.volumen.size()) + " tramos";
+                break;
+            }
+
+            case 6: {
+                int categoria = leerEntero("\t\tCategoria (0 - " + to_string(CATEGORIAS - 1) + "): ", 0, CATEGORIAS - 1);
+                int32_t puntos = leerPorcentaje("\t\tIVA (%): ");
+                nuevas.iva[categoria] = puntos;
+                descripcion = string("IVA ") + nombreCategoria(categoria) + ": " + textoPuntos(puntos);
+                break;
+            }
+
+            case 7: {
+                cout << "\t\tSe conservan los niveles de clientes y las categorias de productos.\n";
+                Reglas defecto = Reglas::porDefecto();
+                defecto.nivelCliente = nuevas.nivelCliente;
+                defecto.categoriaProducto = nuevas.categoriaProducto;
+                nuevas = defecto;
+                descripcion = "Tablas restauradas a los valores por defecto";
+                break;
+            }
+        }
+
+        if (guardar(nuevas)) {
+            auditoria.registrar(usuarioRegistrado.getNombre(), "TARIFAS", descripcion);
+            cout << "\t\tTarifas actualizadas.\n";
+        } else {
+            cout << "\t\tNo se pudieron guardar las tarifas.\n";
+        }
+        system("pause");
+    } while (true);
+}
@@ -9,12 +9,27 @@
 #include <cerrno>
 #include <vector>
 #include "globals.h"
+#include "bitacora.h"
+#include "despacho.h"
+#include <cctype>
+#include <cstdlib>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 using namespace std;
 
 const int CODIGO_INICIAL = 3311;
 const int CODIGO_FINAL = 3361;
 
+// Registro en memoria de transportistas.bin
+std::vector<Transportistas> Transportistas::cache;
+std::vector<bool> Transportistas::disponibles;
+std::unordered_map<std::string, std::vector<size_t>> Transportistas::indicePorTipo;
+std::unordered_map<std::string, size_t> Transportistas::indicePorId;
+Transportistas::FirmaArchivo Transportistas::firmaCache;
+bool Transportistas::cacheCargado = false;
+unsigned long Transportistas::version = 0;
+
 std::string Transportistas::generarIdUnico(const std::vector<Transportistas>& lista) {
     for (int i = CODIGO_INICIAL; i <= CODIGO_FINAL; ++i) {
         std::string id = to_string(i);
@@ -64,8 +79,11 @@ void Transportistas::agregar(std::vector<Transportistas>& lista, const std::stri
     cout << "\t\tDisponibilidad (disponible/Diurna/Nocturna/24-7): ";
     getline(cin, nuevo.disponibilidad);
 
+    pedirEspecificacion(nuevo);
+
     lista.push_back(nuevo);
     guardarEnArchivo(lista);
+    bitacora::registrar(usuarioActual, "TRANSPORTISTAS", "Transportista agregado - ID: " + nuevo.id);
     cout << "\n\t\tTransportista registrado exitosamente!\n";
     system("pause");
 }
@@ -77,7 +95,10 @@ void Transportistas::mostrar(const std::vector<Transportistas>& lista) {
              << " | Nombre: " << t.nombre
              << " | Tel: " << t.telefono
              << " | Vehículo: " << t.vehiculo
-             << " | Disponibilidad: " << t.disponibilidad << "\n";
+             << " | Disponibilidad: " << t.disponibilidad << "\n"
+             << "    " << t.especificacion.tipo
+             << " | " << t.especificacion.unidades << " u, " << t.especificacion.pesoKg << " kg, "
+             << t.especificacion.volumenM3 << " m3 | Franjas: " << textoFranjas(t.especificacion.franjas) << "\n";
     }
     system("pause");
 }
@@ -102,7 +123,10 @@ void Transportistas::modificar(std::vector<Transportistas>& lista, const std::st
         cout << "Nueva disponibilidad (" << it->disponibilidad << "): ";
         getline(cin, it->disponibilidad);
 
+        pedirEspecificacion(*it);
+
         guardarEnArchivo(lista);
+        bitacora::registrar(usuarioActual, "TRANSPORTISTAS", "Transportista modificado - ID: " + id);
         cout << "Transportista modificado!\n";
     } else {
         cout << "Transportista no encontrado.\n";
@@ -122,6 +146,7 @@ void Transportistas::eliminar(std::vector<Transportistas>& lista, const std::str
         if (tolower(confirmar) == 's') {
             lista.erase(it);
             guardarEnArchivo(lista);
+            bitacora::registrar(usuarioActual, "TRANSPORTISTAS", "Transportista eliminado - ID: " + id);
             cout << "Transportista eliminado!\n";
         } else {
             cout << "Operación cancelada.\n";
@@ -132,7 +157,8 @@ void Transportistas::eliminar(std::vector<Transportistas>& lista, const std::str
     system("pause");
 }
 
-void Transportistas::cargarDesdeArchivo(std::vector<Transportistas>& lista) {
+// Lee y separa las líneas de transportistas.bin (crea el archivo si no existe)
+void Transportistas::leerArchivo(std::vector<Transportistas>& lista) {
     lista.clear();
     std::ifstream archivo("transportistas.bin", ios::binary);
 
@@ -141,8 +167,10 @@ void Transportistas::cargarDesdeArchivo(std::vector<Transportistas>& lista) {
         return;
     }
 
+    // Después de la disponibilidad: tipo,unidades,kg,m3,franjas (las líneas antiguas no los tienen)
     std::string linea;
     while (std::getline(archivo, linea)) {
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
         std::istringstream ss(linea);
         Transportistas transp;
 
@@ -150,36 +178,251 @@ void Transportistas::cargarDesdeArchivo(std::vector<Transportistas>& lista) {
             std::getline(ss, transp.nombre, ',') &&
             std::getline(ss, transp.telefono, ',') &&
             std::getline(ss, transp.vehiculo, ',') &&
-            std::getline(ss, transp.disponibilidad)) {
+            std::getline(ss, transp.disponibilidad, ',')) {
+            std::string tipo, unidades, peso, volumen, franjas;
+            Vehiculo& v = transp.especificacion;
+            if (std::getline(ss, tipo, ',') && std::getline(ss, unidades, ',') &&
+                std::getline(ss, peso, ',') && std::getline(ss, volumen, ',') &&
+                std::getline(ss, franjas)) {
+                v.tipo = esTipoVehiculo(tipo) ? tipo : "otro";
+                v.unidades = atoi(unidades.c_str());
+                v.pesoKg = atof(peso.c_str());
+                v.volumenM3 = atof(volumen.c_str());
+                if (!leerFranjas(franjas, v.franjas)) v.franjas = vehiculoDeTipo(tipo).franjas;
+            } else {
+                // Línea antigua: el tipo no está registrado hasta que se modifique el transportista
+                v = vehiculoDeTipo("otro");
+            }
             lista.push_back(transp);
         }
     }
 }
 
+// Copia del registro; solo lee el disco si el archivo cambió desde la última carga
+void Transportistas::cargarDesdeArchivo(std::vector<Transportistas>& lista) {
+    lista = registro();
+}
+
 void Transportistas::guardarEnArchivo(const std::vector<Transportistas>& lista) {
-    std::ofstream archivo("transportistas.bin", ios::binary);
+    {
+        std::ofstream archivo("transportistas.bin", ios::binary);
+
+        for (const auto& transp : lista) {
+            archivo << transp.id << ","
+                    << transp.nombre << ","
+                    << transp.telefono << ","
+                    << transp.vehiculo << ","
+                    << transp.disponibilidad << ","
+                    << transp.especificacion.tipo << ","
+                    << transp.especificacion.unidades << ","
+                    << transp.especificacion.pesoKg << ","
+                    << transp.especificacion.volumenM3 << ","
+                    << textoFranjas(transp.especificacion.franjas) << "\n";
+        }
+    }
+
+    // Lo guardado pasa a ser el registro, sin volver a leer el archivo
+    if (&lista != &cache) cache = lista;
+    firmaCache = firmaActual();
+    cacheCargado = true;
+    reconstruirIndices();
+
+    // La asignación de envíos debe ver los cambios de disponibilidad o vehículo
+    Despacho::invalidar();
+}
+
+// ----------- Registro en memoria ------------
+
+bool Transportistas::FirmaArchivo::operator==(const FirmaArchivo& otra) const {
+    return existe == otra.existe && inodo == otra.inodo && tamano == otra.tamano &&
+           modificado == otra.modificado && nanosegundos == otra.nanosegundos;
+}
+
+// Datos de stat() del archivo; en Windows el inodo es 0 y basta con fecha y tamaño
+Transportistas::FirmaArchivo Transportistas::firmaActual() {
+    FirmaArchivo firma;
+    struct stat info;
+    if (stat("transportistas.bin", &info) != 0) return firma;
+
+    firma.existe = true;
+    firma.inodo = static_cast<unsigned long long>(info.st_ino);
+    firma.tamano = static_cast<long long>(info.st_size);
+    firma.modificado = info.st_mtime;
+#if defined(__linux__)
+    firma.nanosegundos = info.st_mtim.tv_nsec;
+#endif
+    return firma;
+}
+
+// Bitmap de disponibilidad, índice por tipo de vehículo e índice por ID
+void Transportistas::reconstruirIndices() {
+    disponibles.assign(cache.size(), false);
+    indicePorTipo.clear();
+    indicePorId.clear();
+    for (size_t i = 0; i < cache.size(); ++i) {
+        disponibles[i] = estaDisponible(cache[i]);
+        indicePorTipo[cache[i].especificacion.tipo].push_back(i);
+        indicePorId.emplace(cache[i].id, i);
+    }
+    version++;
+}
+
+void Transportistas::asegurarRegistro() {
+    FirmaArchivo firma = firmaActual();
+    if (cacheCargado && firma == firmaCache) return;
+
+    leerArchivo(cache);
+    firmaCache = firma.existe ? firma : firmaActual();  // leerArchivo lo crea si faltaba
+    cacheCargado = true;
+    reconstruirIndices();
+}
+
+const std::vector<Transportistas>& Transportistas::registro() {
+    asegurarRegistro();
+    return cache;
+}
+
+bool Transportistas::disponibleEnRegistro(size_t posicion) {
+    asegurarRegistro();
+    return posicion < disponibles.size() && disponibles[posicion];
+}
+
+unsigned long Transportistas::versionRegistro() {
+    asegurarRegistro();
+    return version;
+}
+
+// Disponibilidad sin distinguir mayúsculas ni espacios al final (p. ej. "Disponible\r")
+bool Transportistas::estaDisponible(const Transportistas& t) {
+    std::string valor;
+    for (char c : t.disponibilidad) {
+        if (!isspace(static_cast<unsigned char>(c))) valor += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+    return valor == "disponible";
+}
+
+// Disponibles según el bitmap; con tipo, solo se recorren las posiciones de ese tipo
+std::vector<Transportistas> Transportistas::getTransportistasDisponibles(const std::string& tipo) {
+    asegurarRegistro();
+    std::vector<Transportistas> resultado;
+
+    if (tipo.empty()) {
+        for (size_t i = 0; i < cache.size(); ++i) {
+            if (disponibles[i]) resultado.push_back(cache[i]);
+        }
+        return resultado;
+    }
+
+    auto it = indicePorTipo.find(tipo);
+    if (it == indicePorTipo.end()) return resultado;
+    for (size_t posicion : it->second) {
+        if (disponibles[posicion]) resultado.push_back(cache[posicion]);
+    }
+    return resultado;
+}
+
+// ----------- Especificación del vehículo ------------
+
+// Capacidad típica por tipo; dos viajes al día si no se indican franjas
+Transportistas::Vehiculo Transportistas::vehiculoDeTipo(const std::string& tipo) {
+    Vehiculo v;
+    v.tipo = tipo;
+    if (tipo == "camion") {
+        v.unidades = 400; v.pesoKg = 5000; v.volumenM3 = 25;
+    } else if (tipo == "panel") {
+        v.unidades = 150; v.pesoKg = 1500; v.volumenM3 = 8;
+    } else if (tipo == "pickup") {
+        v.unidades = 80; v.pesoKg = 800; v.volumenM3 = 3;
+    } else if (tipo == "moto") {
+        v.unidades = 20; v.pesoKg = 150; v.volumenM3 = 0.5;
+    } else {
+        v.tipo = "otro";
+        v.unidades = 50; v.pesoKg = 500; v.volumenM3 = 2;
+    }
+    v.franjas = {{8, 12}, {13, 17}};
+    return v;
+}
+
+bool Transportistas::esTipoVehiculo(const std::string& tipo) {
+    return tipo == "moto" || tipo == "pickup" || tipo == "panel" || tipo == "camion" || tipo == "otro";
+}
 
-    for (const auto& transp : lista) {
-        archivo << transp.id << ","
-                << transp.nombre << ","
-                << transp.telefono << ","
-                << transp.vehiculo << ","
-                << transp.disponibilidad << "\n";
+// Franjas "inicio-fin" separadas por ';', en horas enteras, ordenadas y sin solaparse
+bool Transportistas::leerFranjas(const std::string& texto, std::vector<Franja>& franjas) {
+    std::vector<Franja> resultado;
+    std::istringstream ss(texto);
+    std::string parte;
+    while (std::getline(ss, parte, ';')) {
+        Franja f;
+        char guion = 0;
+        std::istringstream campo(parte);
+        if (!(campo >> f.horaInicio >> guion >> f.horaFin) || guion != '-') return false;
+        if (f.horaInicio < 0 || f.horaFin > 24 || f.horaInicio >= f.horaFin) return false;
+        if (!resultado.empty() && f.horaInicio < resultado.back().horaFin) return false;
+        resultado.push_back(f);
     }
+    if (resultado.empty()) return false;
+    franjas = resultado;
+    return true;
+}
+
+std::string Transportistas::textoFranjas(const std::vector<Franja>& franjas) {
+    std::string texto;
+    for (const auto& f : franjas) {
+        if (!texto.empty()) texto += ";";
+        texto += to_string(f.horaInicio) + "-" + to_string(f.horaFin);
+    }
+    return texto;
+}
+
+const Transportistas::Vehiculo* Transportistas::vehiculoDe(const std::string& id) {
+    asegurarRegistro();
+    auto it = indicePorId.find(id);
+    return it == indicePorId.end() ? nullptr : &cache[it->second].especificacion;
 }
 
-// Método estático para obtener transportistas disponibles
-    std::vector<Transportistas> Transportistas::getTransportistasDisponibles() {
-    std::vector<Transportistas> listaCompleta;
-    cargarDesdeArchivo(listaCompleta);
+// Pide tipo, capacidad y franjas; Enter deja el valor actual
+// El tipo se elige de la lista y es obligatorio en un transportista nuevo
+void Transportistas::pedirEspecificacion(Transportistas& t) {
+    Vehiculo& v = t.especificacion;
+    std::string entrada;
+
+    while (true) {
+        cout << "\t\tTipo de vehiculo (moto/pickup/panel/camion/otro)";
+        if (!v.tipo.empty()) cout << " [" << v.tipo << "]";
+        cout << ": ";
+        if (!getline(cin, entrada)) {
+            if (v.tipo.empty()) v = vehiculoDeTipo("otro");
+            break;
+        }
+        for (char& c : entrada) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        if (entrada.empty() && !v.tipo.empty()) break;
+        if (esTipoVehiculo(entrada)) {
+            if (entrada != v.tipo) {
+                Vehiculo porTipo = vehiculoDeTipo(entrada);
+                if (!v.franjas.empty()) porTipo.franjas = v.franjas;
+                v = porTipo;
+            }
+            break;
+        }
+        cout << "\t\tTipo no valido.\n";
+    }
 
-    // Filtrar solo los transportistas con disponibilidad "disponible"
-    listaCompleta.erase(
-        std::remove_if(listaCompleta.begin(), listaCompleta.end(),
-            [](const Transportistas& t) {
-                return t.disponibilidad != "disponible";
-            }),
-        listaCompleta.end());
+    cout << "\t\tCapacidad en unidades [" << v.unidades << "]: ";
+    getline(cin, entrada);
+    if (atoi(entrada.c_str()) > 0) v.unidades = atoi(entrada.c_str());
 
-    return listaCompleta;
+    cout << "\t\tCapacidad en kg [" << v.pesoKg << "]: ";
+    getline(cin, entrada);
+    if (atof(entrada.c_str()) > 0) v.pesoKg = atof(entrada.c_str());
+
+    cout << "\t\tCapacidad en m3 [" << v.volumenM3 << "]: ";
+    getline(cin, entrada);
+    if (atof(entrada.c_str()) > 0) v.volumenM3 = atof(entrada.c_str());
+
+    cout << "\t\tFranjas diarias, p. ej. 8-12;13-17 [" << textoFranjas(v.franjas) << "]: ";
+    getline(cin, entrada);
+    if (!entrada.empty() && !leerFranjas(entrada, v.franjas)) {
+        cout << "\t\tFranjas no validas; se conservan las anteriores.\n";
+    }
 }
@@ -0,0 +1,537 @@
+// Servidor de consultas de seguimiento de envíos (solo Linux)
+//
+// Proceso opcional de larga duración: mantiene en memoria envios.bin,
+// pedidos.bin y eventos_envios.bin del directorio de trabajo y responde
+// consultas por un socket de dominio Unix. Un solo hilo atiende todas las
+// conexiones con epoll; los archivos se vuelven a cargar cuando cambian
+// (se revisan con stat() una vez por segundo), así que la aplicación puede
+// seguir trabajando normalmente en el mismo directorio. Los pedidos y envíos
+// archivados (carpeta historico) se consultan a través de Archivador.
+//
+// Protocolo: cada mensaje (consulta o respuesta) es una longitud de 4 bytes
+// en orden de red seguida de ese número de bytes de texto. Consultas:
+//   PING
+//   ESTADO <idEnvio>      datos y estado actual de un envío
+//   PEDIDO <idPedido>     estado del pedido y sus envíos
+//   RASTREO <idEnvio>     historial de cambios de estado del envío
+//   ESTADISTICAS          contadores del servidor
+// La respuesta empieza con "OK" o "ERROR <motivo>" y sigue con líneas clave=valor.
+//
+// Uso: servidor_seguimiento [--dir directorio] [--socket ruta]
+//      servidor_seguimiento [--socket ruta] --consultar "ESTADO 3500"
+
+#include "envios.h"
+#include "pedidos.h"
+#include "eventosenvios.h"
+#include "archivador.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+#include <cstdint>
+#include <cctype>
+#include <ctime>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/stat.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <csignal>
+#include <cerrno>
+#include <chrono>
+#endif
+
+using namespace std;
+
+#ifdef __linux__
+
+// Ruta por defecto del socket
+static const char* SOCKET_POR_DEFECTO = "/tmp/logistica_seguimiento.sock";
+
+// Tamaño máximo de una consulta; una mayor cierra la conexión
+static const uint32_t MAX_CONSULTA = 4096;
+
+// Salida pendiente a partir de la cual se deja de leer a ese cliente
+static const size_t LIMITE_SALIDA = 1 << 20;
+
+static volatile sig_atomic_t detener = 0;
+
+static void alRecibirSenal(int) {
+    detener = 1;
+}
+
+// ----------- Datos en memoria ------------
+
+// Versión de un archivo para detectar cambios
+struct FirmaArchivo {
+    bool existe = false;
+    ino_t inodo = 0;
+    off_t tamano = 0;
+    time_t segundos = 0;
+    long nanosegundos = 0;
+
+    bool operator!=(const FirmaArchivo& otra) const {
+        return existe != otra.existe || inodo != otra.inodo || tamano != otra.tamano ||
+               segundos != otra.segundos || nanosegundos != otra.nanosegundos;
+    }
+};
+
+static FirmaArchivo firmaDe(const char* ruta) {
+    FirmaArchivo firma;
+    struct stat info;
+    if (stat(ruta, &info) != 0) return firma;
+    firma.existe = true;
+    firma.inodo = info.st_ino;
+    firma.tamano = info.st_size;
+    firma.segundos = info.st_mtim.tv_sec;
+    firma.nanosegundos = info.st_mtim.tv_nsec;
+    return firma;
+}
+
+struct Datos {
+    FirmaArchivo historico, envios, pedidos, eventos;
+    unordered_map<string, vector<EventosEnvios::Evento>> historialPorEnvio;
+    unsigned long consultas = 0;
+    unsigned long conexiones = 0;
+    unsigned long recargas = 0;
+    time_t inicio = time(nullptr);
+};
+
+// Vuelve a cargar los archivos que cambiaron desde la última revisión
+static void recargarSiCambio(Datos& datos, bool forzar) {
+    bool recargo = false;
+
+    // Primero el histórico: los acumulados de la instantánea de pedidos parten de él
+    FirmaArchivo firma = firmaDe("historico/indice.bin");
+    if (forzar || firma != datos.historico) {
+        Archivador::recargar();
+        datos.historico = firma;
+        recargo = true;
+    }
+
+    firma = firmaDe("envios.bin");
+    if (forzar || firma != datos.envios) {
+        Envios::cargarEnviosDesdeArchivo();
+        datos.envios = firma;
+        recargo = true;
+    }
+
+    firma = firmaDe("pedidos.bin");
+    if (forzar || firma != datos.pedidos) {
+        vector<Pedidos> lista;
+        Pedidos::cargarDesdeArchivoBin(lista);
+        Pedidos::publicarInstantanea(lista);
+        datos.pedidos = firma;
+        recargo = true;
+    }
+
+    firma = firmaDe("eventos_envios.bin");
+    if (forzar || firma != datos.eventos) {
+        datos.historialPorEnvio.clear();
+        for (auto& evento : EventosEnvios::cargarTodos()) {
+            datos.historialPorEnvio[evento.idEnvio].push_back(move(evento));
+        }
+        datos.eventos = firma;
+        recargo = true;
+    }
+
+    if (recargo) datos.recargas++;
+}
+
+// ----------- Consultas ------------
+
+static string formatoFecha(time_t fecha) {
+    char buffer[20];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", localtime(&fecha));
+    return buffer;
+}
+
+static string responderEstado(const Datos& datos, const string& idEnvio) {
+    Envio envio;
+    if (!Envios::consultarEnvio(idEnvio, envio)) return "ERROR envio no encontrado";
+
+    ostringstream r;
+    r << "OK\n"
+      << "envio=" << envio.idEnvio << "\n"
+      << "pedido=" << envio.idPedido << "\n"
+      << "transportista=" << envio.idTransportista << "\n"
+      << "cliente=" << envio.idCliente << "\n"
+      << "estado=" << envio.estado << "\n";
+    auto it = datos.historialPorEnvio.find(idEnvio);
+    if (it != datos.historialPorEnvio.end() && !it->second.empty()) {
+        r << "actualizado=" << formatoFecha(it->second.back().fecha) << "\n";
+    }
+    return r.str();
+}
+
+static string responderPedido(const string& idPedido) {
+    Pedidos pedido;
+    if (!Pedidos::consultarPedido(idPedido, pedido)) return "ERROR pedido no encontrado";
+
+    ostringstream r;
+    r << "OK\n"
+      << "pedido=" << pedido.getId() << "\n"
+      << "cliente=" << pedido.getIdCliente() << "\n"
+      << "almacen=" << pedido.getIdAlmacen() << "\n"
+      << "fecha=" << formatoFecha(pedido.getFechaPedido()) << "\n"
+      << "estado=" << pedido.getEstado() << "\n"
+      << "unidades=" << pedido.getTotales().unidades << "\n";
+    for (const auto& envio : Envios::enviosDePedido(idPedido)) {
+        r << "envio=" << envio.idEnvio << "|" << envio.estado << "|" << envio.idTransportista << "\n";
+    }
+    return r.str();
+}
+
+static string responderRastreo(const Datos& datos, const string& idEnvio) {
+    auto it = datos.historialPorEnvio.find(idEnvio);
+    if (it == datos.historialPorEnvio.end()) {
+        Envio envio;
+        return Envios::consultarEnvio(idEnvio, envio) ? "OK\n" : "ERROR envio no encontrado";
+    }
+
+    ostringstream r;
+    r << "OK\n";
+    for (const auto& evento : it->second) {
+        r << "evento=" << formatoFecha(evento.fecha) << "|" << evento.estado
+          << "|" << evento.idTransportista << "\n";
+    }
+    return r.str();
+}
+
+static string responderEstadisticas(const Datos& datos, size_t abiertas) {
+    ostringstream r;
+    r << "OK\n"
+      << "consultas=" << datos.consultas << "\n"
+      << "conexiones=" << datos.conexiones << "\n"
+      << "conexiones_abiertas=" << abiertas << "\n"
+      << "recargas=" << datos.recargas << "\n"
+      << "activo_desde=" << formatoFecha(datos.inicio) << "\n";
+    return r.str();
+}
+
+// Interpreta "COMANDO argumento"
+static string atenderConsulta(Datos& datos, const string& consulta, size_t abiertas) {
+    datos.consultas++;
+
+    string comando, argumento;
+    istringstream entrada(consulta);
+    entrada >> comando >> argumento;
+    for (char& c : comando) c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+
+    if (comando == "PING") return "OK pong";
+    if (comando == "ESTADISTICAS") return responderEstadisticas(datos, abiertas);
+    if (argumento.empty()) return "ERROR falta el ID";
+    if (comando == "ESTADO") return responderEstado(datos, argumento);
+    if (comando == "PEDIDO") return responderPedido(argumento);
+    if (comando == "RASTREO") return responderRastreo(datos, argumento);
+    return "ERROR comando desconocido";
+}
+
+// ----------- Conexiones ------------
+
+struct Conexion {
+    string entrada;
+    string salida;
+    size_t enviado = 0;       ///< Bytes de 'salida' ya enviados
+    uint32_t interes = 0;     ///< Eventos registrados en epoll
+};
+
+static void agregarMensaje(string& destino, const string& texto) {
+    uint32_t longitud = htonl(static_cast<uint32_t>(texto.size()));
+    destino.append(reinterpret_cast<const char*>(&longitud), sizeof(longitud));
+    destino.append(texto);
+}
+
+// Registra en epoll lo que hace falta según el estado de la conexión
+static void actualizarInteres(int epoll, int fd, Conexion& conexion) {
+    uint32_t interes = EPOLLRDHUP;
+    size_t pendiente = conexion.salida.size() - conexion.enviado;
+    if (pendiente > 0) interes |= EPOLLOUT;
+    if (pendiente < LIMITE_SALIDA) interes |= EPOLLIN;
+    if (interes == conexion.interes) return;
+
+    epoll_event ev{};
+    ev.events = interes;
+    ev.data.fd = fd;
+    epoll_ctl(epoll, EPOLL_CTL_MOD, fd, &ev);
+    conexion.interes = interes;
+}
+
+// Envía lo pendiente; false si la conexión se debe cerrar
+static bool escribirPendiente(int fd, Conexion& conexion) {
+    while (conexion.enviado < conexion.salida.size()) {
+        ssize_t n = send(fd, conexion.salida.data() + conexion.enviado,
+                         conexion.salida.size() - conexion.enviado, MSG_NOSIGNAL);
+        if (n > 0) {
+            conexion.enviado += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    if (conexion.enviado == conexion.salida.size()) {
+        conexion.salida.clear();
+        conexion.enviado = 0;
+    }
+    return true;
+}
+
+// Lee lo disponible y responde cada consulta completa; false si se debe cerrar
+static bool leerConsultas(int fd, Conexion& conexion, Datos& datos, size_t abiertas) {
+    char buffer[65536];
+    while (true) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            conexion.entrada.append(buffer, static_cast<size_t>(n));
+            if (static_cast<size_t>(n) < sizeof(buffer)) break;
+        } else if (n == 0) {
+            return false;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    // Se recorren los mensajes completos y se borra lo consumido una sola vez
+    size_t posicion = 0;
+    while (conexion.entrada.size() - posicion >= sizeof(uint32_t)) {
+        uint32_t longitud;
+        memcpy(&longitud, conexion.entrada.data() + posicion, sizeof(longitud));
+        longitud = ntohl(longitud);
+        if (longitud > MAX_CONSULTA) {
+            agregarMensaje(conexion.salida, "ERROR consulta demasiado larga");
+            escribirPendiente(fd, conexion);
+            return false;
+        }
+        if (conexion.entrada.size() - posicion - sizeof(uint32_t) < longitud) break;
+
+        string consulta = conexion.entrada.substr(posicion + sizeof(uint32_t), longitud);
+        posicion += sizeof(uint32_t) + longitud;
+        agregarMensaje(conexion.salida, atenderConsulta(datos, consulta, abiertas));
+    }
+    conexion.entrada.erase(0, posicion);
+
+    return escribirPendiente(fd, conexion);
+}
+
+// Crea el socket de escucha; si ya existe un socket viejo en la ruta, lo reemplaza
+static int abrirSocket(const string& ruta) {
+    sockaddr_un direccion{};
+    if (ruta.size() >= sizeof(direccion.sun_path)) {
+        cerr << "La ruta del socket es demasiado larga: " << ruta << "\n";
+        return -1;
+    }
+    direccion.sun_family = AF_UNIX;
+    strncpy(direccion.sun_path, ruta.c_str(), sizeof(direccion.sun_path) - 1);
+
+    struct stat info;
+    if (lstat(ruta.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            cerr << "La ruta existe y no es un socket: " << ruta << "\n";
+            return -1;
+        }
+        unlink(ruta.c_str());
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&direccion), sizeof(direccion)) != 0 ||
+        listen(fd, SOMAXCONN) != 0) {
+        perror("bind/listen");
+        close(fd);
+        return -1;
+    }
+    chmod(ruta.c_str(), 0660);  // Solo el usuario y su grupo
+    return fd;
+}
+
+// Bucle principal: un hilo, epoll en modo por nivel
+static int servir(const string& rutaSocket) {
+    Datos datos;
+    recargarSiCambio(datos, true);
+
+    int servidor = abrirSocket(rutaSocket);
+    if (servidor < 0) return 1;
+
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll < 0) {
+        perror("epoll_create1");
+        close(servidor);
+        return 1;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = servidor;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, servidor, &ev);
+
+    signal(SIGINT, alRecibirSenal);
+    signal(SIGTERM, alRecibirSenal);
+    signal(SIGPIPE, SIG_IGN);
+
+    cerr << "[seguimiento] escuchando en " << rutaSocket << endl;
+
+    unordered_map<int, Conexion> conexiones;
+    auto cerrar = [&](int fd) {
+        epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        conexiones.erase(fd);
+    };
+
+    const int MAX_EVENTOS = 256;
+    epoll_event eventos[MAX_EVENTOS];
+    auto ultimaRevision = chrono::steady_clock::now();
+
+    while (!detener) {
+        int n = epoll_wait(epoll, eventos, MAX_EVENTOS, 1000);
+        if (n < 0 && errno != EINTR) {
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            int fd = eventos[i].data.fd;
+
+            if (fd == servidor) {
+                while (true) {
+                    int cliente = accept4(servidor, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (cliente < 0) break;  // EAGAIN: no hay más pendientes
+                    epoll_event evCliente{};
+                    evCliente.events = EPOLLIN | EPOLLRDHUP;
+                    evCliente.data.fd = cliente;
+                    epoll_ctl(epoll, EPOLL_CTL_ADD, cliente, &evCliente);
+                    conexiones[cliente].interes = evCliente.events;
+                    datos.conexiones++;
+                }
+                continue;
+            }
+
+            auto it = conexiones.find(fd);
+            if (it == conexiones.end()) continue;
+            Conexion& conexion = it->second;
+            uint32_t ocurrido = eventos[i].events;
+
+            bool seguir = !(ocurrido & EPOLLERR);
+            if (seguir && (ocurrido & EPOLLOUT)) seguir = escribirPendiente(fd, conexion);
+            if (seguir && (ocurrido & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))) {
+                seguir = leerConsultas(fd, conexion, datos, conexiones.size());
+            }
+
+            if (seguir) {
+                actualizarInteres(epoll, fd, conexion);
+            } else {
+                cerrar(fd);
+            }
+        }
+
+        // Revisar los archivos a lo sumo una vez por segundo
+        auto ahora = chrono::steady_clock::now();
+        if (ahora - ultimaRevision >= chrono::seconds(1)) {
+            recargarSiCambio(datos, false);
+            ultimaRevision = ahora;
+        }
+    }
+
+    for (auto& par : conexiones) close(par.first);
+    close(epoll);
+    close(servidor);
+    unlink(rutaSocket.c_str());
+    cerr << "[seguimiento] detenido; consultas atendidas: " << datos.consultas << endl;
+    return 0;
+}
+
+// Cliente mínimo: envía una consulta y muestra la respuesta
+static int consultar(const string& rutaSocket, const string& consulta) {
+    sockaddr_un direccion{};
+    if (rutaSocket.size() >= sizeof(direccion.sun_path)) return 1;
+    direccion.sun_family = AF_UNIX;
+    strncpy(direccion.sun_path, rutaSocket.c_str(), sizeof(direccion.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&direccion), sizeof(direccion)) != 0) {
+        perror("connect");
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+
+    string mensaje;
+    agregarMensaje(mensaje, consulta);
+    if (send(fd, mensaje.data(), mensaje.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(mensaje.size())) {
+        close(fd);
+        return 1;
+    }
+
+    auto leerExacto = [fd](char* destino, size_t tam) {
+        size_t leidos = 0;
+        while (leidos < tam) {
+            ssize_t n = recv(fd, destino + leidos, tam - leidos, 0);
+            if (n <= 0) return false;
+            leidos += static_cast<size_t>(n);
+        }
+        return true;
+    };
+
+    uint32_t longitud;
+    if (!leerExacto(reinterpret_cast<char*>(&longitud), sizeof(longitud))) {
+        close(fd);
+        return 1;
+    }
+    string respuesta(ntohl(longitud), '\0');
+    bool ok = respuesta.empty() || leerExacto(&respuesta[0], respuesta.size());
+    close(fd);
+    if (!ok) return 1;
+
+    cout << respuesta;
+    if (respuesta.empty() || respuesta.back() != '\n') cout << "\n";
+    return respuesta.compare(0, 2, "OK") == 0 ? 0 : 2;
+}
+
+int main(int argc, char* argv[]) {
+    string directorio, rutaSocket = SOCKET_POR_DEFECTO, consulta;
+    bool modoConsulta = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--dir" && i + 1 < argc) {
+            directorio = argv[++i];
+        } else if (arg == "--socket" && i + 1 < argc) {
+            rutaSocket = argv[++i];
+        } else if (arg == "--consultar" && i + 1 < argc) {
+            consulta = argv[++i];
+            modoConsulta = true;
+        } else {
+            cerr << "Uso: " << argv[0] << " [--dir directorio] [--socket ruta] [--consultar \"ESTADO id\"]\n";
+            return 1;
+        }
+    }
+
+    if (modoConsulta) return consultar(rutaSocket, consulta);
+
+    if (!directorio.empty() && chdir(directorio.c_str()) != 0) {
+        perror("chdir");
+        return 1;
+    }
+    return servir(rutaSocket);
+}
+
+#else
+
+int main() {
+    cerr << "El servidor de seguimiento solo esta disponible en Linux.\n";
+    return 1;
+}
+
+#endif // __linux__